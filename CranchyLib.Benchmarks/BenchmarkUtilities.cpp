@@ -0,0 +1,262 @@
+#include "BenchmarkUtilities.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <sstream>
+
+
+
+
+
+
+namespace
+{
+    /* Constant-initialized, so allocations made during static initialization are counted too. */
+    std::atomic<uint64_t> allocationCount{ 0 };
+}
+
+
+/* Replacing the global operator new makes every allocation of the process visible to Measure(). The nothrow variants
+   of the standard library forward to these. */
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/* std::pmr::new_delete_resource() may go through the aligned forms even for ordinary alignments. */
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = _aligned_malloc(size != 0 ? size : 1, static_cast<std::size_t>(alignment)))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    _aligned_free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    _aligned_free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    _aligned_free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    _aligned_free(memory);
+}
+
+
+
+
+
+
+MemoryUtilities::External::Backend BenchmarkUtilities::forwardBackend = MemoryUtilities::External::GetDefaultBackend();
+std::atomic<uint64_t> BenchmarkUtilities::backendCallCount{ 0 };
+
+
+
+
+BenchmarkResult BenchmarkUtilities::Measure(const BenchmarkOptions& options, const std::string& suite, const std::string& name, const std::string& variant,
+                                            uint64_t byteCount, const std::function<void()>& operation)
+{
+    /* One untimed run warms up caches, page tables and lazily allocated buffers. */
+    operation();
+
+    const uint64_t callsBefore = backendCallCount.load();
+    const uint64_t allocationsBefore = allocationCount.load();
+    const auto startTime = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    uint64_t iterations = 0;
+
+    while (iterations < options.minimumIterations || elapsed < options.minimumDuration)
+    {
+        operation();
+        ++iterations;
+        elapsed = std::chrono::steady_clock::now() - startTime;
+    }
+
+    const uint64_t calls = backendCallCount.load() - callsBefore;
+    const uint64_t allocations = allocationCount.load() - allocationsBefore;
+    const double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+    BenchmarkResult result;
+    result.suite = suite;
+    result.name = name;
+    result.variant = variant;
+    result.byteCount = byteCount;
+    result.iterations = iterations;
+    result.nanosecondsPerOperation = nanoseconds / static_cast<double>(iterations);
+    result.gigabytesPerSecond = result.nanosecondsPerOperation > 0.0 ? static_cast<double>(byteCount) / result.nanosecondsPerOperation : 0.0;
+    result.syscallsPerOperation = static_cast<double>(calls) / static_cast<double>(iterations);
+    result.allocationsPerOperation = static_cast<double>(allocations) / static_cast<double>(iterations);
+    result.peakWorkingSetBytes = GetPeakWorkingSetBytes();
+
+    return result;
+}
+
+
+
+
+void BenchmarkUtilities::InstallCountingBackend()
+{
+    if (MemoryUtilities::External::GetBackend().ReadMemory == CountingReadMemory)
+        return;
+
+    forwardBackend = MemoryUtilities::External::GetBackend();
+
+    MemoryUtilities::External::Backend countingBackend;
+    countingBackend.ReadMemory = CountingReadMemory;
+    countingBackend.WriteMemory = CountingWriteMemory;
+    countingBackend.ProtectMemory = CountingProtectMemory;
+    countingBackend.QueryMemory = CountingQueryMemory;
+    MemoryUtilities::External::SetBackend(countingBackend);
+}
+
+uint64_t BenchmarkUtilities::GetBackendCallCount()
+{
+    return backendCallCount.load();
+}
+
+uint64_t BenchmarkUtilities::GetAllocationCount()
+{
+    return allocationCount.load();
+}
+
+uint64_t BenchmarkUtilities::GetPeakWorkingSetBytes()
+{
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == FALSE)
+        return 0;
+
+    return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+}
+
+
+
+
+std::string BenchmarkUtilities::FormatByteCount(uint64_t byteCount)
+{
+    char buffer[32];
+    if (byteCount >= 1024 * 1024 * 1024 && byteCount % (1024 * 1024 * 1024) == 0)
+        std::snprintf(buffer, sizeof(buffer), "%lluGiB", static_cast<unsigned long long>(byteCount >> 30));
+    else if (byteCount >= 1024 * 1024 && byteCount % (1024 * 1024) == 0)
+        std::snprintf(buffer, sizeof(buffer), "%lluMiB", static_cast<unsigned long long>(byteCount >> 20));
+    else if (byteCount >= 1024 && byteCount % 1024 == 0)
+        std::snprintf(buffer, sizeof(buffer), "%lluKiB", static_cast<unsigned long long>(byteCount >> 10));
+    else
+        std::snprintf(buffer, sizeof(buffer), "%lluB", static_cast<unsigned long long>(byteCount));
+
+    return buffer;
+}
+
+void BenchmarkUtilities::PrintResult(const BenchmarkResult& result)
+{
+    std::printf("%-12s %-28s %-20s %10s %14.1f ns/op %9.3f GB/s %8.2f syscalls/op %8.2f allocs/op %8.1f MiB peak",
+                result.suite.c_str(), result.name.c_str(), result.variant.c_str(), FormatByteCount(result.byteCount).c_str(),
+                result.nanosecondsPerOperation, result.gigabytesPerSecond, result.syscallsPerOperation, result.allocationsPerOperation,
+                static_cast<double>(result.peakWorkingSetBytes) / (1024.0 * 1024.0));
+
+    if (result.speedup > 0.0)
+        std::printf(" %7.2fx", result.speedup);
+
+    std::printf("\n");
+}
+
+std::string BenchmarkUtilities::ResultsToJson(const std::vector<BenchmarkResult>& results)
+{
+    /* Names are produced by the suites themselves, so there is nothing to escape. */
+    std::ostringstream json;
+    json << "{\n  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult& result = results[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    { \"suite\": \"" << result.suite << "\""
+             << ", \"name\": \"" << result.name << "\""
+             << ", \"variant\": \"" << result.variant << "\""
+             << ", \"bytes\": " << result.byteCount
+             << ", \"iterations\": " << result.iterations
+             << ", \"ns_per_op\": " << result.nanosecondsPerOperation
+             << ", \"gb_per_s\": " << result.gigabytesPerSecond
+             << ", \"syscalls_per_op\": " << result.syscallsPerOperation
+             << ", \"allocations_per_op\": " << result.allocationsPerOperation
+             << ", \"peak_rss_bytes\": " << result.peakWorkingSetBytes
+             << ", \"speedup\": " << result.speedup
+             << " }";
+    }
+
+    json << "\n  ]\n}\n";
+    return json.str();
+}
+
+
+
+
+BOOL WINAPI BenchmarkUtilities::CountingReadMemory(HANDLE hProcess, LPCVOID baseAddress, LPVOID buffer, SIZE_T size, SIZE_T* bytesRead)
+{
+    backendCallCount.fetch_add(1, std::memory_order_relaxed);
+    return forwardBackend.ReadMemory(hProcess, baseAddress, buffer, size, bytesRead);
+}
+
+BOOL WINAPI BenchmarkUtilities::CountingWriteMemory(HANDLE hProcess, LPVOID baseAddress, LPCVOID buffer, SIZE_T size, SIZE_T* bytesWritten)
+{
+    backendCallCount.fetch_add(1, std::memory_order_relaxed);
+    return forwardBackend.WriteMemory(hProcess, baseAddress, buffer, size, bytesWritten);
+}
+
+BOOL WINAPI BenchmarkUtilities::CountingProtectMemory(HANDLE hProcess, LPVOID address, SIZE_T size, DWORD newProtect, PDWORD oldProtect)
+{
+    backendCallCount.fetch_add(1, std::memory_order_relaxed);
+    return forwardBackend.ProtectMemory(hProcess, address, size, newProtect, oldProtect);
+}
+
+SIZE_T WINAPI BenchmarkUtilities::CountingQueryMemory(HANDLE hProcess, LPCVOID address, PMEMORY_BASIC_INFORMATION buffer, SIZE_T length)
+{
+    backendCallCount.fetch_add(1, std::memory_order_relaxed);
+    return forwardBackend.QueryMemory(hProcess, address, buffer, length);
+}
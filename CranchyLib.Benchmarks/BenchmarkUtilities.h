@@ -0,0 +1,118 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+/**
+* @brief Settings shared by every benchmark suite.
+* @param minimumDuration - Every measurement repeats its operation until at least this much time has passed.
+* @param minimumIterations - ...and at least this many times.
+* @param quick - Skips the largest sizes so a full run finishes in seconds.
+* @param imagePaths - Real binaries the scan suite measures in addition to its synthetic images.
+*/
+struct BenchmarkOptions
+{
+	std::chrono::milliseconds minimumDuration{ 200 };
+	uint64_t				  minimumIterations = 3;
+	bool					  quick				= false;
+	std::vector<std::string>  imagePaths;
+};
+
+
+/**
+* @brief One measured data point.
+* @param suite - Suite that produced the result, e.g. "remote_read".
+* @param name - Operation that was measured, e.g. "GetBytes".
+* @param variant - Mechanism or configuration the operation ran with, e.g. "ReadProcessMemory".
+* @param byteCount - Bytes processed by a single operation.
+* @param iterations - Number of times the operation was run.
+* @param nanosecondsPerOperation - Mean wall time of one operation.
+* @param gigabytesPerSecond - 'byteCount' / 'nanosecondsPerOperation', in GB/s (10^9 bytes).
+* @param syscallsPerOperation - Mean number of External backend calls (each one is a system call with the default backend).
+* @param allocationsPerOperation - Mean number of heap allocations (operator new calls, on any thread).
+* @param peakWorkingSetBytes - Peak resident set of the process once the measurement finished; it only grows, so compare it between consecutive rows.
+* @param speedup - Reference implementation time / this time, for suites that compare against one; 0 otherwise.
+*/
+struct BenchmarkResult
+{
+	std::string suite;
+	std::string name;
+	std::string variant;
+	uint64_t	byteCount				= 0;
+	uint64_t	iterations				= 0;
+	double		nanosecondsPerOperation = 0.0;
+	double		gigabytesPerSecond		= 0.0;
+	double		syscallsPerOperation	= 0.0;
+	double		allocationsPerOperation = 0.0;
+	uint64_t	peakWorkingSetBytes		= 0;
+	double		speedup					= 0.0;
+};
+
+
+
+
+
+
+class BenchmarkUtilities
+{
+	// Description: Timing, call counting and reporting helpers used by the benchmark suites.
+	// Search Tags: #benchmark, #timing, #json, #report.
+public:
+	/**
+	* @brief Runs 'operation' repeatedly for at least 'options.minimumDuration' and 'options.minimumIterations' runs,
+	*        counting the External backend calls and heap allocations it makes.
+	* @return Filled result; 'suite', 'name', 'variant' and 'byteCount' are taken from the parameters.
+	*/
+	static BenchmarkResult Measure(const BenchmarkOptions& options, const std::string& suite, const std::string& name, const std::string& variant,
+								   uint64_t byteCount, const std::function<void()>& operation);
+
+
+
+
+	/**
+	* @brief Installs an External backend that forwards to the default one and counts every call. Idempotent.
+	*/
+	static void InstallCountingBackend();
+	static uint64_t GetBackendCallCount();
+	/**
+	* @brief Number of operator new calls made by the process so far. The benchmark executable replaces the global operator new to count them.
+	*/
+	static uint64_t GetAllocationCount();
+	/**
+	* @return Peak working set of the process in bytes, 0 if it couldn't be queried.
+	*/
+	static uint64_t GetPeakWorkingSetBytes();
+
+
+
+
+	static std::string FormatByteCount(uint64_t byteCount);
+	static void PrintResult(const BenchmarkResult& result);
+	/**
+	* @brief Serializes results as { "results": [ ... ] }.
+	*/
+	static std::string ResultsToJson(const std::vector<BenchmarkResult>& results);
+
+
+
+
+private:
+	static BOOL   WINAPI CountingReadMemory(HANDLE hProcess, LPCVOID baseAddress, LPVOID buffer, SIZE_T size, SIZE_T* bytesRead);
+	static BOOL   WINAPI CountingWriteMemory(HANDLE hProcess, LPVOID baseAddress, LPCVOID buffer, SIZE_T size, SIZE_T* bytesWritten);
+	static BOOL   WINAPI CountingProtectMemory(HANDLE hProcess, LPVOID address, SIZE_T size, DWORD newProtect, PDWORD oldProtect);
+	static SIZE_T WINAPI CountingQueryMemory(HANDLE hProcess, LPCVOID address, PMEMORY_BASIC_INFORMATION buffer, SIZE_T length);
+
+	static MemoryUtilities::External::Backend forwardBackend;
+	static std::atomic<uint64_t>			  backendCallCount;
+};
@@ -0,0 +1,100 @@
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtilities.h"
+#include "FileUtilities.h"
+#include "MemoryTracing.h"
+#include "RemoteReadBenchmarks.h"
+#include "ScanBenchmarks.h"
+#include "WindowsUtilities.h"
+
+
+
+
+
+
+static void PrintUsage()
+{
+    std::printf("Usage: CranchyLib.Benchmarks [--suite remote_read|scan|all] [--json <path>] [--quick] [--duration <ms>]\n"
+                "                            [--image <path>]... [--system-images] [--trace <path>]\n");
+}
+
+
+
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    std::string suite = "all";
+    std::string jsonPath;
+    std::string tracePath;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+
+        if (argument == "--child" && i + 2 < argc) // Started by RemoteReadBenchmarks::Run().
+            return RemoteReadBenchmarks::RunChild(argv[i + 1], static_cast<DWORD>(std::strtoul(argv[i + 2], nullptr, 10)));
+        else if (argument == "--suite" && i + 1 < argc)
+            suite = argv[++i];
+        else if (argument == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (argument == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (argument == "--duration" && i + 1 < argc)
+            options.minimumDuration = std::chrono::milliseconds(std::strtoul(argv[++i], nullptr, 10));
+        else if (argument == "--quick")
+            options.quick = true;
+        else if (argument == "--image" && i + 1 < argc)
+            options.imagePaths.push_back(argv[++i]);
+        else if (argument == "--system-images")
+        {
+            /* GetSystemDirectory() returns the Windows directory. */
+            for (const char* fileName : { "ntdll.dll", "kernel32.dll", "user32.dll" })
+            {
+                options.imagePaths.push_back(WindowsUtilities::GetSystemDirectory() + "\\System32\\" + fileName);
+            }
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+
+    std::vector<BenchmarkResult> results;
+    bool succeeded = true;
+
+    if (tracePath.empty() == false)
+        MemoryUtilities::Tracer::Enable();
+
+    if (suite == "remote_read" || suite == "all")
+        succeeded &= RemoteReadBenchmarks::Run(options, results);
+
+    if (suite == "scan" || suite == "all")
+        succeeded &= ScanBenchmarks::Run(options, results);
+
+
+    for (const BenchmarkResult& result : results)
+    {
+        BenchmarkUtilities::PrintResult(result);
+    }
+
+    if (jsonPath.empty() == false && FileUtilities::WriteFileContents(jsonPath, BenchmarkUtilities::ResultsToJson(results)) == false)
+    {
+        std::printf("Failed to write %s\n", jsonPath.c_str());
+        return 1;
+    }
+
+    if (tracePath.empty() == false && FileUtilities::WriteFileContents(tracePath, MemoryUtilities::Tracer::ExportChromeTrace()) == false)
+    {
+        std::printf("Failed to write %s\n", tracePath.c_str());
+        return 1;
+    }
+
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+#include "RemoteReadBenchmarks.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "MemoryAsync.h"
+#include "MemoryChannel.h"
+#include "WindowsUtilities.h"
+
+
+
+
+
+
+namespace
+{
+    const size_t   kBufferSize	   = 64 * 1024 * 1024;
+    const size_t   kChainDepth	   = 4;
+    const size_t   kBatchedChains  = 64;
+    const int32_t  kInt32Value	   = 0x12345678;
+    const float	   kFloatValue	   = 1234.5f;
+    const double   kDoubleValue	   = 6789.25;
+    const char	   kStringValue[]  = "CranchyLib remote read benchmark string";
+    const wchar_t  kWStringValue[] = L"CranchyLib remote read benchmark string";
+    const uintptr_t kChainOffsets[kChainDepth] = { 0x10, 0x28, 0x08, 0x30 };
+
+    /* Published by the child through a SharedChannel state block. */
+    struct ChildLayout
+    {
+        uint64_t bufferAddress	   = 0;
+        uint64_t bufferSize		   = 0;
+        uint64_t chainAddress	   = 0;
+        uint64_t chainTarget	   = 0; // Address AddressFollowPointerChain must resolve to.
+        uint64_t int32Address	   = 0;
+        uint64_t floatAddress	   = 0;
+        uint64_t doubleAddress	   = 0;
+        uint64_t stringAddress	   = 0;
+        uint64_t wideStringAddress = 0;
+    };
+
+    uint8_t PatternByte(size_t index)
+    {
+        return static_cast<uint8_t>((index * 31 + 7) ^ (index >> 12));
+    }
+
+    std::string LayoutChannelName(const std::string& channelName)
+    {
+        return channelName + ".Layout";
+    }
+
+    std::string MirrorChannelName(const std::string& channelName)
+    {
+        return channelName + ".Mirror";
+    }
+}
+
+
+
+
+
+
+int RemoteReadBenchmarks::RunChild(const std::string& channelName, DWORD parentProcessId)
+{
+    HANDLE hParent = OpenProcess(SYNCHRONIZE, FALSE, parentProcessId);
+    if (hParent == nullptr)
+        return 1;
+
+    /* Known contents the parent verifies before measuring. */
+    uint8_t* buffer = static_cast<uint8_t*>(VirtualAlloc(nullptr, kBufferSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (buffer == nullptr)
+        return 1;
+
+    for (size_t i = 0; i < kBufferSize; ++i)
+    {
+        buffer[i] = PatternByte(i);
+    }
+
+    /* Pointer chain: every node is a separate allocation, like objects scattered over a real heap. */
+    static uintptr_t root = 0;
+    std::vector<uintptr_t*> nodes;
+    for (size_t i = 0; i < kChainDepth; ++i)
+    {
+        nodes.push_back(new uintptr_t[16]());
+    }
+
+    root = reinterpret_cast<uintptr_t>(nodes[0]);
+    for (size_t level = 0; level + 1 < kChainDepth; ++level)
+    {
+        nodes[level][kChainOffsets[level] / sizeof(uintptr_t)] = reinterpret_cast<uintptr_t>(nodes[level + 1]);
+    }
+
+    static int32_t int32Value = kInt32Value;
+    static float floatValue = kFloatValue;
+    static double doubleValue = kDoubleValue;
+    static char stringValue[sizeof(kStringValue)];
+    static wchar_t wideStringValue[sizeof(kWStringValue) / sizeof(wchar_t)];
+    std::memcpy(stringValue, kStringValue, sizeof(kStringValue));
+    std::memcpy(wideStringValue, kWStringValue, sizeof(kWStringValue));
+
+    ChildLayout layout;
+    layout.bufferAddress = reinterpret_cast<uintptr_t>(buffer);
+    layout.bufferSize = kBufferSize;
+    layout.chainAddress = reinterpret_cast<uintptr_t>(&root);
+    layout.chainTarget = reinterpret_cast<uintptr_t>(nodes[kChainDepth - 1]) + kChainOffsets[kChainDepth - 1];
+    layout.int32Address = reinterpret_cast<uintptr_t>(&int32Value);
+    layout.floatAddress = reinterpret_cast<uintptr_t>(&floatValue);
+    layout.doubleAddress = reinterpret_cast<uintptr_t>(&doubleValue);
+    layout.stringAddress = reinterpret_cast<uintptr_t>(stringValue);
+    layout.wideStringAddress = reinterpret_cast<uintptr_t>(wideStringValue);
+
+
+    /* The mirror lets the parent read the same bytes with plain loads. Published before the layout, which signals readiness. */
+    MemoryUtilities::SharedChannel mirrorChannel;
+    MemoryUtilities::SharedChannel layoutChannel;
+    if (mirrorChannel.Create(MirrorChannelName(channelName), kBufferSize) == false || mirrorChannel.PublishState(buffer, kBufferSize) == false)
+        return 1;
+
+    if (layoutChannel.Create(LayoutChannelName(channelName), sizeof(ChildLayout)) == false || layoutChannel.PublishState(layout) == false)
+        return 1;
+
+    WaitForSingleObject(hParent, INFINITE);
+    CloseHandle(hParent);
+    return 0;
+}
+
+
+
+
+bool RemoteReadBenchmarks::Run(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+{
+    using namespace MemoryUtilities;
+    const std::string kSuite = "remote_read";
+
+    const std::string channelName = "Local\\CranchyLib.Benchmarks." + std::to_string(GetCurrentProcessId());
+    std::string commandLine = "\"" + WindowsUtilities::GetExecutablePath() + "\" --child " + channelName + " " + std::to_string(GetCurrentProcessId());
+
+    STARTUPINFOA si = { 0 };
+    si.cb = sizeof(si);
+    PROCESS_INFORMATION pi = { 0 };
+    if (CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi) == FALSE)
+    {
+        std::printf("remote_read: failed to start the child process.\n");
+        return false;
+    }
+
+
+    /* Wait for the child to publish its layout. */
+    SharedChannel layoutChannel;
+    SharedChannel mirrorChannel;
+    ChildLayout layout;
+    bool childReady = false;
+    for (int attempt = 0; attempt < 1000 && childReady == false; ++attempt)
+    {
+        childReady = layoutChannel.Open(LayoutChannelName(channelName)) && layoutChannel.GetStateVersion() != 0
+                     && layoutChannel.ReadState(layout) && mirrorChannel.Open(MirrorChannelName(channelName));
+        if (childReady == false)
+            Sleep(10);
+    }
+
+    const HANDLE hProcess = pi.hProcess;
+    auto stopChild = [&]()
+    {
+        TerminateProcess(pi.hProcess, 0);
+        CloseHandle(pi.hThread);
+        CloseHandle(pi.hProcess);
+    };
+
+    if (childReady == false)
+    {
+        std::printf("remote_read: the child process didn't publish its memory layout.\n");
+        stopChild();
+        return false;
+    }
+
+
+    /* Make sure we're reading what we think we're reading. */
+    const std::vector<uint8_t> verifyBytes = External::GetBytes(hProcess, static_cast<uintptr_t>(layout.bufferAddress), kBufferSize);
+    bool contentsMatch = verifyBytes.size() == kBufferSize
+                         && External::AddressFollowPointerChain(hProcess, static_cast<uintptr_t>(layout.chainAddress),
+                                                                std::vector<uintptr_t>(kChainOffsets, kChainOffsets + kChainDepth)) == layout.chainTarget
+                         && External::GetInt32(hProcess, static_cast<uintptr_t>(layout.int32Address)) == kInt32Value
+                         && External::GetString(hProcess, static_cast<uintptr_t>(layout.stringAddress)) == kStringValue;
+
+    for (size_t i = 0; contentsMatch && i < kBufferSize; ++i)
+    {
+        contentsMatch = verifyBytes[i] == PatternByte(i);
+    }
+
+    if (contentsMatch == false)
+    {
+        std::printf("remote_read: child memory doesn't have the expected contents.\n");
+        stopChild();
+        return false;
+    }
+
+
+    BenchmarkUtilities::InstallCountingBackend();
+    AsyncMemory asyncMemory;
+    std::vector<uint8_t> readBuffer(kBufferSize);
+    volatile uint64_t sink = 0;
+
+    /* The caller-buffer overloads exist so polling loops don't allocate; any allocation there is a regression. */
+    bool allocationFree = true;
+    auto pushAllocationFree = [&](const BenchmarkResult& result)
+    {
+        if (result.allocationsPerOperation != 0.0)
+        {
+            std::printf("remote_read: %s (%s) allocated %.2f times per operation.\n", result.name.c_str(), result.variant.c_str(), result.allocationsPerOperation);
+            allocationFree = false;
+        }
+
+        results.push_back(result);
+    };
+
+    const uintptr_t bufferAddress = static_cast<uintptr_t>(layout.bufferAddress);
+    const size_t maximumSize = options.quick ? 4 * 1024 * 1024 : kBufferSize;
+
+    /* Raw bytes, every mechanism, 4 B to 64 MiB in steps of 16x. */
+    for (size_t size = 4; size <= maximumSize; size *= 16)
+    {
+        results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetBytes", "ReadProcessMemory", size, [&]()
+        {
+            const std::vector<uint8_t> bytes = External::GetBytes(hProcess, bufferAddress, size);
+            sink = sink + bytes.size();
+        }));
+
+        pushAllocationFree(BenchmarkUtilities::Measure(options, kSuite, "GetBytes", "ReadProcessMemory, caller buffer", size, [&]()
+        {
+            sink = sink + External::GetBytes(hProcess, bufferAddress, readBuffer.data(), size);
+        }));
+
+        results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetBytes", "AsyncMemory", size, [&]()
+        {
+            const AsyncResult result = asyncMemory.Read(hProcess, bufferAddress, readBuffer.data(), size).get();
+            sink = sink + result.bytesTransferred;
+        }));
+
+        results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetBytes", "SharedChannel", size, [&]()
+        {
+            mirrorChannel.ReadState(readBuffer.data(), size);
+            sink = sink + readBuffer[size - 1];
+        }));
+    }
+
+
+    /* Typed getters. */
+    results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetInt32", "ReadProcessMemory", sizeof(int32_t), [&]()
+    {
+        sink = sink + External::GetInt32(hProcess, static_cast<uintptr_t>(layout.int32Address));
+    }));
+
+    results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetFloat", "ReadProcessMemory", sizeof(float), [&]()
+    {
+        sink = sink + static_cast<uint64_t>(External::GetFloat(hProcess, static_cast<uintptr_t>(layout.floatAddress)));
+    }));
+
+    results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetDouble", "ReadProcessMemory", sizeof(double), [&]()
+    {
+        sink = sink + static_cast<uint64_t>(External::GetDouble(hProcess, static_cast<uintptr_t>(layout.doubleAddress)));
+    }));
+
+
+    /* Pointer chains: one at a time, and many resolved together level by level. */
+    const std::vector<uintptr_t> chainOffsets(kChainOffsets, kChainOffsets + kChainDepth);
+    results.push_back(BenchmarkUtilities::Measure(options, kSuite, "AddressFollowPointerChain", "ReadProcessMemory", kChainDepth * sizeof(uintptr_t), [&]()
+    {
+        sink = sink + External::AddressFollowPointerChain(hProcess, static_cast<uintptr_t>(layout.chainAddress), chainOffsets);
+    }));
+
+    std::vector<External::BatchPointerChain> chains(kBatchedChains);
+    for (External::BatchPointerChain& chain : chains)
+    {
+        chain.memoryAddress = static_cast<uintptr_t>(layout.chainAddress);
+        chain.memoryOffsets = &chainOffsets;
+    }
+
+    BenchmarkResult batchedChains = BenchmarkUtilities::Measure(options, kSuite, "AddressFollowPointerChain", "Batched", kBatchedChains * kChainDepth * sizeof(uintptr_t), [&]()
+    {
+        sink = sink + External::AddressFollowPointerChainBatch(hProcess, chains);
+    });
+
+    /* Report per chain, so both pointer chain rows compare directly. */
+    batchedChains.byteCount /= kBatchedChains;
+    batchedChains.nanosecondsPerOperation /= kBatchedChains;
+    batchedChains.syscallsPerOperation /= kBatchedChains;
+    batchedChains.allocationsPerOperation /= kBatchedChains;
+    results.push_back(batchedChains);
+
+
+    /* Strings. */
+    results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetString", "ReadProcessMemory", sizeof(kStringValue), [&]()
+    {
+        sink = sink + External::GetString(hProcess, static_cast<uintptr_t>(layout.stringAddress)).size();
+    }));
+
+    std::string stringBuffer;
+    pushAllocationFree(BenchmarkUtilities::Measure(options, kSuite, "GetString", "ReadProcessMemory, caller buffer", sizeof(kStringValue), [&]()
+    {
+        External::GetString(hProcess, static_cast<uintptr_t>(layout.stringAddress), stringBuffer);
+        sink = sink + stringBuffer.size();
+    }));
+
+    results.push_back(BenchmarkUtilities::Measure(options, kSuite, "GetWString", "ReadProcessMemory", sizeof(kWStringValue), [&]()
+    {
+        sink = sink + External::GetWString(hProcess, static_cast<uintptr_t>(layout.wideStringAddress)).size();
+    }));
+
+
+    /* Patching the value over itself: read and compare, then protect, write and restore. */
+    const std::vector<uint8_t> int32Bytes(reinterpret_cast<const uint8_t*>(&kInt32Value), reinterpret_cast<const uint8_t*>(&kInt32Value) + sizeof(kInt32Value));
+    pushAllocationFree(BenchmarkUtilities::Measure(options, kSuite, "PatchBytes", "ReadProcessMemory", sizeof(kInt32Value), [&]()
+    {
+        sink = sink + External::PatchBytes(hProcess, static_cast<uintptr_t>(layout.int32Address), int32Bytes, int32Bytes);
+    }));
+
+
+    stopChild();
+    return allocationFree;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <windows.h>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtilities.h"
+
+
+
+
+
+
+class RemoteReadBenchmarks
+{
+	// Description: Measures External reads against a child process with known memory contents: raw byte reads from 4 B to 64 MiB,
+	//              typed getters, pointer chain walks, string reads and byte patches, each through every available mechanism
+	//              (ReadProcessMemory via External, AsyncMemory worker pool, SharedChannel mapping), plus the caller-buffer overloads,
+	//              which must not allocate.
+	// Search Tags: #benchmark, #external, #readprocessmemory, #latency, #throughput.
+public:
+	/**
+	* @brief Entry point of the child process: allocates the known memory, publishes its layout on 'channelName'
+	*        and waits until the parent process exits.
+	* @return Process exit code.
+	*/
+	static int RunChild(const std::string& channelName, DWORD parentProcessId);
+
+	/**
+	* @brief Spawns the child process (this executable with "--child"), runs every measurement against it and appends the results.
+	* @return false if the child couldn't be started, its memory didn't have the expected contents
+	*         or a caller-buffer read allocated on the heap.
+	*/
+	static bool Run(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results);
+};
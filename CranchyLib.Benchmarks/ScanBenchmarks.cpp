@@ -0,0 +1,993 @@
+#include "ScanBenchmarks.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "FileUtilities.h"
+#include "MemoryArena.h"
+#include "MemoryImages.h"
+#include "MemoryReferences.h"
+#include "MemoryRtti.h"
+#include "MemoryRules.h"
+#include "MemorySignatureCache.h"
+#include "MemorySignatures.h"
+#include "MemoryStrings.h"
+#include "MemoryUtilities.h"
+#include "WindowsUtilities.h"
+
+
+
+
+
+
+namespace
+{
+    const size_t   kMinimumImageSize	 = 1024 * 1024;
+    const size_t   kMaximumImageSize	 = 1024 * 1024 * 1024;
+    const size_t   kQuickMaximumSize	 = 16 * 1024 * 1024;
+    const size_t   kShapeImageSize		 = 64 * 1024 * 1024;
+    const size_t   kQuickShapeImageSize	 = 4 * 1024 * 1024;
+    const size_t   kPlantTailBytes		 = 64;		  // The planted match ends this far before the end of the scanned range.
+    const size_t   kHistogramSampleBytes = 16 * 1024 * 1024;
+    const size_t   kFindAllImageSize	 = 64 * 1024 * 1024;
+    const size_t   kQuickFindAllSize	 = 4 * 1024 * 1024;
+    const size_t   kSignatureCount		 = 1024;	  // Addresses signed per real binary.
+    const size_t   kQuickSignatureCount	 = 128;
+    const uint64_t kImageSeed			 = 0x5EED5CA4;
+
+    const size_t   kPatternLengths[]	 = { 4, 8, 16, 32, 64 };
+    const int	   kWildcardPercents[]	 = { 0, 25, 50 };
+
+    /* x86-64 opcodes weighted roughly by how often compilers emit them. */
+    const uint8_t  kCommonOpcodes[]		 = { 0x8B, 0x8B, 0x8B, 0x89, 0x89, 0x8D, 0x8D, 0xE8, 0xE8, 0x83, 0x83, 0x0F, 0x85, 0x33,
+                                             0x3B, 0x74, 0x75, 0xEB, 0xFF, 0xC7, 0x48, 0x50, 0x53, 0x57, 0x5B, 0x5F, 0xC3, 0x90 };
+
+
+    struct XorShift64
+    {
+        uint64_t state;
+
+        explicit XorShift64(uint64_t seed) : state(seed != 0 ? seed : 0x9E3779B97F4A7C15ull) {}
+
+        uint64_t Next()
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    };
+
+
+    /* Frozen copy of the original Internal::ScanForBytesPattern, kept as the reference every optimization is measured against. */
+    uintptr_t NaiveScan(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern)
+    {
+        const size_t patternLength = bytesPattern.size();
+        if (patternLength == 0 || size < patternLength)
+            return 0x0;
+
+        for (size_t offset = 0; offset <= size - patternLength; ++offset)
+        {
+            bool match = true;
+            for (size_t j = 0; j < patternLength; ++j)
+            {
+                if (bytesPattern[j].has_value() && startingAddress[offset + j] != bytesPattern[j].value())
+                {
+                    match = false;
+                    break;
+                }
+            }
+
+            if (match)
+                return reinterpret_cast<uintptr_t>(startingAddress + offset);
+        }
+
+        return 0x0;
+    }
+
+
+    size_t NaiveCount(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern)
+    {
+        size_t matchCount = 0;
+        for (uintptr_t match = NaiveScan(startingAddress, size, bytesPattern); match != 0x0;)
+        {
+            ++matchCount;
+
+            const size_t consumed = static_cast<size_t>(match - reinterpret_cast<uintptr_t>(startingAddress)) + 1;
+            match = NaiveScan(startingAddress + consumed, size - consumed, bytesPattern);
+        }
+
+        return matchCount;
+    }
+
+
+    std::string PatternToString(const std::vector<std::optional<uint8_t>>& bytesPattern)
+    {
+        std::string memoryPattern;
+        for (const std::optional<uint8_t>& patternByte : bytesPattern)
+        {
+            if (memoryPattern.empty() == false)
+                memoryPattern += ' ';
+
+            if (patternByte.has_value())
+            {
+                memoryPattern += MemoryUtilities::Convertion::Int16_ToHEXChar(patternByte.value() >> 4);
+                memoryPattern += MemoryUtilities::Convertion::Int16_ToHEXChar(patternByte.value() & 0x0F);
+            }
+            else
+                memoryPattern += "??";
+        }
+
+        return memoryPattern;
+    }
+
+    std::string ShapeToString(const ScanBenchmarks::PatternShape& shape)
+    {
+        return "len=" + std::to_string(shape.length) + " wild=" + std::to_string(shape.wildcardPercent) + "% anchor=" + (shape.rareAnchor ? "rare" : "common");
+    }
+
+
+    /* Writes the pattern's concrete bytes near the end of the first 'size' bytes of 'image' and restores them on destruction. */
+    class PlantedPattern
+    {
+    public:
+        PlantedPattern(std::vector<uint8_t>& image, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern)
+            : image(image), offset(size - kPlantTailBytes - bytesPattern.size()),
+              original(image.begin() + offset, image.begin() + offset + bytesPattern.size())
+        {
+            for (size_t i = 0; i < bytesPattern.size(); ++i)
+            {
+                if (bytesPattern[i].has_value())
+                    image[offset + i] = bytesPattern[i].value();
+            }
+        }
+
+        ~PlantedPattern()
+        {
+            std::copy(original.begin(), original.end(), image.begin() + offset);
+        }
+
+    private:
+        std::vector<uint8_t>& image;
+        size_t				  offset;
+        std::vector<uint8_t>  original;
+    };
+
+
+    /* Bytes a first-match scan has to look at before it returns 'match'. */
+    uint64_t ScannedBytes(const uint8_t* startingAddress, size_t size, size_t patternLength, uintptr_t match)
+    {
+        if (match == 0x0)
+            return size;
+
+        return static_cast<uint64_t>(match - reinterpret_cast<uintptr_t>(startingAddress)) + patternLength;
+    }
+
+
+    /* Measures 'scan' and records its speedup over the naive reference on the same input.
+       The reference is measured into 'naive' unless it already holds a result, so several variants can share one. */
+    bool MeasureAgainstNaive(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results, const std::string& name, const std::string& variant,
+                             const uint8_t* data, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+                             const std::function<uintptr_t()>& scan, BenchmarkResult& naive)
+    {
+        const uintptr_t expectedMatch = NaiveScan(data, size, bytesPattern);
+        const uintptr_t match = scan();
+        if (match != expectedMatch)
+        {
+            std::printf("scan: %s [%s] returned a different match than the naive scanner.\n", name.c_str(), variant.c_str());
+            return false;
+        }
+
+        const uint64_t scannedBytes = ScannedBytes(data, size, bytesPattern.size(), expectedMatch);
+        volatile uintptr_t sink = 0;
+
+        if (naive.iterations == 0)
+        {
+            naive = BenchmarkUtilities::Measure(options, "scan", "NaiveScan", variant, scannedBytes, [&]()
+            {
+                sink = NaiveScan(data, size, bytesPattern);
+            });
+            results.push_back(naive);
+        }
+
+        BenchmarkResult result = BenchmarkUtilities::Measure(options, "scan", name, variant, scannedBytes, [&]()
+        {
+            sink = scan();
+        });
+
+        result.speedup = result.nanosecondsPerOperation > 0.0 ? naive.nanosecondsPerOperation / result.nanosecondsPerOperation : 0.0;
+        results.push_back(result);
+        return true;
+    }
+
+
+    std::vector<size_t> ThreadCounts()
+    {
+        const size_t hardwareThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        std::vector<size_t> threadCounts;
+        for (size_t threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+        {
+            threadCounts.push_back(threadCount);
+        }
+
+        threadCounts.push_back(hardwareThreads);
+        return threadCounts;
+    }
+}
+
+
+
+
+
+
+std::vector<uint8_t> ScanBenchmarks::GenerateImage(E_ImageKind kind, size_t size, uint64_t seed)
+{
+    std::vector<uint8_t> image(size, 0x00);
+    XorShift64 random(seed);
+
+    switch (kind)
+    {
+    case E_ImageKind::Random:
+    {
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            const uint64_t value = random.Next();
+            std::memcpy(&image[i], &value, sizeof(value));
+        }
+
+        for (; i < size; ++i)
+        {
+            image[i] = static_cast<uint8_t>(random.Next());
+        }
+        break;
+    }
+
+    case E_ImageKind::Code:
+    {
+        /* Not valid machine code, just its byte statistics: REX prefixes, a skewed opcode set, ModRM bytes,
+           small displacements and rel32/imm32 operands whose high bytes are mostly 00 or FF, with int3 padding between "functions". */
+        size_t i = 0;
+        while (i < size)
+        {
+            const uint64_t bits = random.Next();
+
+            if ((bits & 0x3F) == 0) // Function boundary.
+            {
+                const size_t padding = std::min<size_t>(size - i, (bits >> 6) & 0x0F);
+                std::fill(image.begin() + i, image.begin() + i + padding, static_cast<uint8_t>(0xCC));
+                i += padding;
+                continue;
+            }
+
+            uint8_t instruction[12];
+            size_t length = 0;
+
+            if ((bits >> 6) & 1)
+                instruction[length++] = ((bits >> 7) & 1) ? 0x48 : 0x4C;
+
+            instruction[length++] = kCommonOpcodes[((bits >> 8) & 0xFF) % sizeof(kCommonOpcodes)];
+            instruction[length++] = static_cast<uint8_t>(bits >> 16); // ModRM.
+
+            switch ((bits >> 24) & 3)
+            {
+            case 0: // No operand.
+                break;
+            case 1: // disp8.
+                instruction[length++] = static_cast<uint8_t>((bits >> 28) & 0x78);
+                break;
+            default: // rel32 / imm32.
+            {
+                const uint8_t high = ((bits >> 32) & 1) ? 0xFF : 0x00;
+                instruction[length++] = static_cast<uint8_t>(bits >> 40);
+                instruction[length++] = static_cast<uint8_t>(bits >> 48);
+                instruction[length++] = high;
+                instruction[length++] = high;
+                break;
+            }
+            }
+
+            length = std::min<size_t>(length, size - i);
+            std::memcpy(&image[i], instruction, length);
+            i += length;
+        }
+        break;
+    }
+
+    case E_ImageKind::Zero:
+        break;
+    }
+
+    return image;
+}
+
+std::string ScanBenchmarks::ImageKindToString(E_ImageKind kind)
+{
+    switch (kind)
+    {
+    case E_ImageKind::Random:
+        return "random";
+    case E_ImageKind::Code:
+        return "code";
+    case E_ImageKind::Zero:
+        return "zero";
+    }
+
+    return "unknown";
+}
+
+
+
+
+std::vector<std::optional<uint8_t>> ScanBenchmarks::MakePattern(const std::vector<uint8_t>& image, const PatternShape& shape, uint64_t seed)
+{
+    if (shape.length == 0)
+        return {};
+
+    std::array<uint64_t, 256> histogram = {};
+    const size_t sampleSize = std::min<size_t>(image.size(), kHistogramSampleBytes);
+    for (size_t i = 0; i < sampleSize; ++i)
+    {
+        ++histogram[image[i]];
+    }
+
+    const auto anchor = shape.rareAnchor ? std::min_element(histogram.begin(), histogram.end()) : std::max_element(histogram.begin(), histogram.end());
+
+    XorShift64 random(seed);
+    std::vector<std::optional<uint8_t>> bytesPattern(shape.length);
+    bytesPattern[0] = static_cast<uint8_t>(anchor - histogram.begin());
+    for (size_t i = 1; i < shape.length; ++i)
+    {
+        bytesPattern[i] = static_cast<uint8_t>(random.Next());
+    }
+
+    /* Spread the wildcards evenly over everything after the anchor. */
+    const size_t wildcardCount = (shape.length - 1) * static_cast<size_t>(shape.wildcardPercent) / 100;
+    for (size_t i = 0; i < wildcardCount; ++i)
+    {
+        bytesPattern[1 + i * (shape.length - 1) / wildcardCount] = std::nullopt;
+    }
+
+    return bytesPattern;
+}
+
+
+
+
+uintptr_t ScanBenchmarks::ParallelScan(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern, ThreadingUtilities::ThreadPool& pool)
+{
+    /* The calling thread scans the last chunk, so a single-worker pool scans everything in place. */
+    const size_t chunkCount = pool.GetThreadCount();
+    if (chunkCount <= 1 || bytesPattern.empty() || size < bytesPattern.size())
+        return MemoryUtilities::Internal::ScanForBytesPattern(startingAddress, size, bytesPattern);
+
+    /* Chunks overlap by patternLength - 1 bytes, so a match straddling two chunks is still found by the first one. */
+    const size_t chunkSize = (size + chunkCount - 1) / chunkCount;
+    std::vector<uintptr_t> matches(chunkCount, 0x0);
+
+    ThreadingUtilities::TaskGroup group(pool);
+    ThreadingUtilities::ParallelFor(group, 0, chunkCount, 1, [&](size_t firstChunk, size_t lastChunk)
+    {
+        for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+        {
+            const size_t chunkStart = chunk * chunkSize;
+            if (chunkStart >= size)
+                continue;
+
+            const size_t chunkEnd = std::min<size_t>(size, chunkStart + chunkSize + bytesPattern.size() - 1);
+            matches[chunk] = MemoryUtilities::Internal::ScanForBytesPattern(startingAddress + chunkStart, chunkEnd - chunkStart, bytesPattern);
+        }
+    });
+
+    for (uintptr_t match : matches)
+    {
+        if (match != 0x0)
+            return match;
+    }
+
+    return 0x0;
+}
+
+
+
+
+bool ScanBenchmarks::Run(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results)
+{
+    using namespace MemoryUtilities;
+
+    const size_t maximumSize = options.quick ? kQuickMaximumSize : kMaximumImageSize;
+    const size_t shapeSize = options.quick ? kQuickShapeImageSize : kShapeImageSize;
+    const std::vector<size_t> threadCounts = ThreadCounts();
+    const PatternShape defaultShape;
+    bool succeeded = true;
+
+
+    for (E_ImageKind kind : { E_ImageKind::Random, E_ImageKind::Code, E_ImageKind::Zero })
+    {
+        /* One image per kind; smaller sizes scan a prefix of it. */
+        std::vector<uint8_t> image = GenerateImage(kind, maximumSize, kImageSeed);
+        const std::string kindName = ImageKindToString(kind);
+
+
+        /* Image size sweep with the default pattern. */
+        for (size_t size = kMinimumImageSize; size <= maximumSize; size *= 4)
+        {
+            const std::vector<std::optional<uint8_t>> bytesPattern = MakePattern(image, defaultShape, kImageSeed + size);
+            PlantedPattern planted(image, size, bytesPattern);
+
+            BenchmarkResult naive;
+            const std::string variant = kindName + " " + BenchmarkUtilities::FormatByteCount(size) + " " + ShapeToString(defaultShape);
+            succeeded &= MeasureAgainstNaive(options, results, "ScanForBytesPattern", variant, image.data(), size, bytesPattern, [&]()
+            {
+                return Internal::ScanForBytesPattern(image.data(), size, bytesPattern);
+            }, naive);
+        }
+
+
+        /* Pattern length, wildcard density and anchor rarity sweep at a fixed size. */
+        for (size_t length : kPatternLengths)
+        {
+            for (int wildcardPercent : kWildcardPercents)
+            {
+                for (bool rareAnchor : { true, false })
+                {
+                    PatternShape shape;
+                    shape.length = length;
+                    shape.wildcardPercent = wildcardPercent;
+                    shape.rareAnchor = rareAnchor;
+
+                    const std::vector<std::optional<uint8_t>> bytesPattern = MakePattern(image, shape, kImageSeed + length * 131 + wildcardPercent);
+                    PlantedPattern planted(image, shapeSize, bytesPattern);
+
+                    BenchmarkResult naive;
+                    const std::string variant = kindName + " " + BenchmarkUtilities::FormatByteCount(shapeSize) + " " + ShapeToString(shape);
+                    succeeded &= MeasureAgainstNaive(options, results, "ScanForBytesPattern", variant, image.data(), shapeSize, bytesPattern, [&]()
+                    {
+                        return Internal::ScanForBytesPattern(image.data(), shapeSize, bytesPattern);
+                    }, naive);
+                }
+            }
+        }
+
+
+        /* Thread count sweep on the whole image; every row is compared against the single-threaded naive scan. */
+        {
+            const std::vector<std::optional<uint8_t>> bytesPattern = MakePattern(image, defaultShape, kImageSeed);
+            PlantedPattern planted(image, maximumSize, bytesPattern);
+
+            BenchmarkResult naive;
+            for (size_t threadCount : threadCounts)
+            {
+                ThreadingUtilities::ThreadPool pool(threadCount);
+                const std::string variant = kindName + " " + BenchmarkUtilities::FormatByteCount(maximumSize) + " " + ShapeToString(defaultShape)
+                                            + " threads=" + std::to_string(threadCount);
+                succeeded &= MeasureAgainstNaive(options, results, "ParallelScan", variant, image.data(), maximumSize, bytesPattern, [&]()
+                {
+                    return ParallelScan(image.data(), maximumSize, bytesPattern, pool);
+                }, naive);
+            }
+        }
+    }
+
+
+    /* Find-all scans with a pattern that matches often: results on the default heap, and in an arena reset before every scan. */
+    {
+        const size_t findAllSize = options.quick ? kQuickFindAllSize : kFindAllImageSize;
+        const std::vector<uint8_t> image = GenerateImage(E_ImageKind::Code, findAllSize, kImageSeed);
+
+        /* The image's most frequent byte followed by a wildcard, like a find-all for an opcode. */
+        PatternShape shape;
+        shape.length = 1;
+        shape.rareAnchor = false;
+        std::vector<std::optional<uint8_t>> bytesPattern = MakePattern(image, shape, kImageSeed);
+        bytesPattern.push_back(std::nullopt);
+        const std::string variant = "code " + BenchmarkUtilities::FormatByteCount(findAllSize) + " \"" + PatternToString(bytesPattern) + "\"";
+
+        MemoryArena arena;
+        size_t heapMatchCount = 0;
+        size_t arenaMatchCount = 0;
+
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "ScanForAllBytesPattern", variant + " heap", findAllSize, [&]()
+        {
+            std::pmr::vector<uintptr_t> matches;
+            heapMatchCount = Internal::ScanForAllBytesPattern(image.data(), findAllSize, bytesPattern, matches);
+        }));
+
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "ScanForAllBytesPattern", variant + " arena", findAllSize, [&]()
+        {
+            arena.Reset();
+            std::pmr::vector<uintptr_t> matches(&arena);
+            arenaMatchCount = Internal::ScanForAllBytesPattern(image.data(), findAllSize, bytesPattern, matches);
+        }));
+
+        const MemoryArena::Statistics arenaStatistics = arena.GetStatistics();
+        std::printf("scan: find-all found %zu matches; arena peak %s in %zu blocks\n", arenaMatchCount,
+                    BenchmarkUtilities::FormatByteCount(arenaStatistics.peakBytesUsed).c_str(), arenaStatistics.blockCount);
+
+        if (heapMatchCount != arenaMatchCount || heapMatchCount != NaiveCount(image.data(), findAllSize, bytesPattern))
+        {
+            std::printf("scan: ScanForAllBytesPattern found a different number of matches than the naive scanner.\n");
+            succeeded = false;
+        }
+    }
+
+
+    /* Nibble masks: a pattern keeping only the high nibble of two bytes, like "48 8? ?? 4?" for a register-agnostic ModRM,
+       against the same pattern with those bytes wildcarded whole. The masked pattern must find a subset of the matches. */
+    {
+        const size_t maskedSize = options.quick ? kQuickFindAllSize : kFindAllImageSize;
+        const std::vector<uint8_t> image = GenerateImage(E_ImageKind::Code, maskedSize, kImageSeed);
+
+        /* Taken from the middle of the image, so both forms match at least once. */
+        std::vector<std::optional<uint8_t>> bytesPattern(image.begin() + maskedSize / 2, image.begin() + maskedSize / 2 + 4);
+
+        MaskedPattern maskedPattern = Convertion::BytesPattern_ToMaskedPattern(bytesPattern);
+        for (size_t i = 1; i < maskedPattern.masks.size(); i += 2)
+        {
+            maskedPattern.masks[i] = 0xF0;
+            maskedPattern.values[i] &= 0xF0;
+            bytesPattern[i] = std::nullopt;
+        }
+
+        size_t naiveMatchCount = 0;
+        for (size_t offset = 0; offset + maskedPattern.values.size() <= maskedSize; ++offset)
+        {
+            size_t i = 0;
+            while (i < maskedPattern.values.size() && (image[offset + i] & maskedPattern.masks[i]) == maskedPattern.values[i])
+            {
+                ++i;
+            }
+
+            naiveMatchCount += i == maskedPattern.values.size() ? 1 : 0;
+        }
+
+        const std::string variant = "code " + BenchmarkUtilities::FormatByteCount(maskedSize) + " \"" + PatternToString(bytesPattern) + "\"";
+        size_t maskedMatchCount = 0;
+        size_t wildcardMatchCount = 0;
+
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "ScanForAllMaskedPattern", variant + " nibble masks", maskedSize, [&]()
+        {
+            std::pmr::vector<uintptr_t> matches;
+            maskedMatchCount = Internal::ScanForAllMaskedPattern(image.data(), maskedSize, maskedPattern, matches);
+        }));
+
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "ScanForAllBytesPattern", variant + " byte wildcards", maskedSize, [&]()
+        {
+            std::pmr::vector<uintptr_t> matches;
+            wildcardMatchCount = Internal::ScanForAllBytesPattern(image.data(), maskedSize, bytesPattern, matches);
+        }));
+
+        std::printf("scan: nibble masks matched %zu times, byte wildcards %zu times\n", maskedMatchCount, wildcardMatchCount);
+        if (maskedMatchCount != naiveMatchCount || maskedMatchCount > wildcardMatchCount)
+        {
+            std::printf("scan: ScanForAllMaskedPattern found a different number of matches than the naive masked scanner.\n");
+            succeeded = false;
+        }
+    }
+
+
+    /* Fuzzy scans for a signature broken by a target update: two concrete bytes of the planted pattern are changed. */
+    {
+        const size_t fuzzySize = options.quick ? kQuickFindAllSize : kFindAllImageSize;
+        std::vector<uint8_t> image = GenerateImage(E_ImageKind::Code, fuzzySize, kImageSeed);
+
+        PatternShape shape;
+        const std::vector<std::optional<uint8_t>> bytesPattern = MakePattern(image, shape, kImageSeed + 41);
+        PlantedPattern planted(image, fuzzySize, bytesPattern);
+        const uintptr_t plantedAddress = reinterpret_cast<uintptr_t>(image.data() + fuzzySize - kPlantTailBytes - bytesPattern.size());
+
+        std::vector<std::optional<uint8_t>> brokenPattern = bytesPattern;
+        size_t changedBytes = 0;
+        for (size_t i = brokenPattern.size(); i-- > 0 && changedBytes < 2;)
+        {
+            if (brokenPattern[i].has_value())
+            {
+                brokenPattern[i] = static_cast<uint8_t>(brokenPattern[i].value() ^ 0xFF);
+                ++changedBytes;
+            }
+        }
+
+        const std::string variant = "code " + BenchmarkUtilities::FormatByteCount(fuzzySize) + " " + ShapeToString(shape) + " broken=2";
+        for (size_t maxMismatches : { 0, 1, 2, 4 })
+        {
+            std::vector<FuzzyMatch> matches;
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "FuzzyScanForBytesPattern", variant + " k=" + std::to_string(maxMismatches), fuzzySize, [&]()
+            {
+                matches = Internal::FuzzyScanForBytesPattern(image.data(), fuzzySize, brokenPattern, maxMismatches);
+            }));
+
+            /* The planted copy must be recovered, with its two mismatches, exactly when k allows it. */
+            const bool recovered = std::any_of(matches.begin(), matches.end(), [&](const FuzzyMatch& match)
+            {
+                return match.address == plantedAddress && match.mismatches == changedBytes;
+            });
+
+            if (recovered != (maxMismatches >= changedBytes))
+            {
+                std::printf("scan: FuzzyScanForBytesPattern with k=%zu %s the planted match.\n", maxMismatches, recovered ? "unexpectedly found" : "missed");
+                succeeded = false;
+            }
+        }
+    }
+
+
+    /* Rule sets: N patterns compiled into one automaton against N separate find-all passes. */
+    {
+        const size_t rulesSize = options.quick ? kQuickFindAllSize : kFindAllImageSize;
+        const std::vector<uint8_t> image = GenerateImage(E_ImageKind::Code, rulesSize, kImageSeed);
+
+        for (size_t ruleCount : { 1, 8, 64 })
+        {
+            RuleSet ruleSet;
+            std::vector<std::vector<std::optional<uint8_t>>> bytesPatterns;
+            for (size_t i = 0; i < ruleCount; ++i)
+            {
+                PatternShape shape;
+                shape.length = 8;
+                bytesPatterns.push_back(MakePattern(image, shape, kImageSeed + 42 + i));
+                ruleSet.AddRule(PatternToString(bytesPatterns.back()));
+            }
+
+            if (ruleSet.Compile() == false)
+            {
+                std::printf("scan: RuleSet failed to compile %zu rules: %s\n", ruleCount, ruleSet.GetCompileError().c_str());
+                succeeded = false;
+                continue;
+            }
+
+            const std::string variant = "code " + BenchmarkUtilities::FormatByteCount(rulesSize) + " rules=" + std::to_string(ruleCount);
+            std::vector<RuleMatch> ruleMatches;
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "RuleSet::ScanBuffer", variant + " states=" + std::to_string(ruleSet.GetStateCount()), rulesSize, [&]()
+            {
+                ruleMatches.clear();
+                ruleSet.ScanBuffer(image.data(), rulesSize, reinterpret_cast<uintptr_t>(image.data()), ruleMatches);
+            }));
+
+            size_t passMatchCount = 0;
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "ScanForAllBytesPattern", variant + " one pass per rule", rulesSize, [&]()
+            {
+                std::pmr::vector<uintptr_t> matches;
+                for (const std::vector<std::optional<uint8_t>>& bytesPattern : bytesPatterns)
+                {
+                    Internal::ScanForAllBytesPattern(image.data(), rulesSize, bytesPattern, matches);
+                }
+                passMatchCount = matches.size();
+            }));
+
+            if (ruleMatches.size() != passMatchCount)
+            {
+                std::printf("scan: RuleSet found %zu matches for %zu rules, the find-all passes %zu.\n", ruleMatches.size(), ruleCount, passMatchCount);
+                succeeded = false;
+            }
+        }
+    }
+
+
+    /* Cancellation and deadline latency: how long a stopped scan keeps running, with the default chunk size. */
+    {
+        const size_t imageSize = kShapeImageSize;
+        const std::vector<uint8_t> image = GenerateImage(E_ImageKind::Code, imageSize, kImageSeed);
+
+        /* Random bytes the image doesn't contain make the scan run to the end unless it's stopped. */
+        XorShift64 random(kImageSeed + 40);
+        std::vector<std::optional<uint8_t>> bytesPattern;
+        for (size_t i = 0; i < 32; ++i)
+        {
+            bytesPattern.push_back(static_cast<uint8_t>(random.Next()));
+        }
+
+        if (NaiveCount(image.data(), imageSize, bytesPattern) != 0)
+        {
+            std::printf("scan: the random pattern occurs in the image, cancellation latency skipped.\n");
+        }
+        else
+        {
+            CancellationToken token;
+            ScanOptions scanOptions;
+            scanOptions.cancellationToken = &token;
+
+            std::chrono::steady_clock::time_point returnTime;
+            uintptr_t match = 0x0;
+            E_ScanStatus cancelStatus = E_ScanStatus::Completed;
+            std::thread scanThread([&]()
+            {
+                cancelStatus = Internal::ScanForBytesPattern(image.data(), imageSize, bytesPattern, scanOptions, match);
+                returnTime = std::chrono::steady_clock::now();
+            });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            const std::chrono::steady_clock::time_point cancelTime = std::chrono::steady_clock::now();
+            token.Cancel();
+            scanThread.join();
+
+            scanOptions.cancellationToken = nullptr;
+            scanOptions.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(2);
+            const E_ScanStatus deadlineStatus = Internal::ScanForBytesPattern(image.data(), imageSize, bytesPattern, scanOptions, match);
+            const std::chrono::steady_clock::time_point deadlineReturnTime = std::chrono::steady_clock::now();
+
+            /* A scan that finished before it could be stopped says nothing about latency. */
+            if (cancelStatus == E_ScanStatus::Cancelled)
+                std::printf("scan: cancelled %s scan returned %.3f ms after Cancel()\n", BenchmarkUtilities::FormatByteCount(imageSize).c_str(),
+                            std::chrono::duration<double, std::milli>(returnTime - cancelTime).count());
+            if (deadlineStatus == E_ScanStatus::DeadlineExceeded)
+                std::printf("scan: deadline-bounded %s scan returned %.3f ms after its deadline\n", BenchmarkUtilities::FormatByteCount(imageSize).c_str(),
+                            std::chrono::duration<double, std::milli>(deadlineReturnTime - scanOptions.deadline).count());
+        }
+    }
+
+
+    /* Pattern parsing. */
+    {
+        const std::vector<uint8_t> image = GenerateImage(E_ImageKind::Code, kMinimumImageSize, kImageSeed);
+        for (size_t length : kPatternLengths)
+        {
+            PatternShape shape;
+            shape.length = length;
+
+            const std::string memoryPattern = PatternToString(MakePattern(image, shape, kImageSeed + length));
+            volatile size_t sink = 0;
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "MemoryPattern_ToBytesPattern", ShapeToString(shape), memoryPattern.size(), [&]()
+            {
+                sink = Convertion::MemoryPattern_ToBytesPattern(memoryPattern).size();
+            }));
+        }
+    }
+
+
+    /* Real binaries: their own bytes are scanned for a 16-byte run taken from three quarters in, with the 4 bytes a rel32 would occupy wildcarded. */
+    std::vector<std::string> allSignatures;
+    for (const std::string& imagePath : options.imagePaths)
+    {
+        const std::string contents = FileUtilities::ReadFileContents(imagePath);
+        if (contents.size() < kPlantTailBytes * 4)
+        {
+            std::printf("scan: couldn't read %s\n", imagePath.c_str());
+            succeeded = false;
+            continue;
+        }
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(contents.data());
+        const size_t sourceOffset = contents.size() / 4 * 3;
+        std::vector<std::optional<uint8_t>> bytesPattern(data + sourceOffset, data + sourceOffset + defaultShape.length);
+        std::fill(bytesPattern.begin() + 4, bytesPattern.begin() + 8, std::nullopt);
+
+        const std::string fileName = imagePath.substr(imagePath.find_last_of("\\/") + 1);
+        BenchmarkResult naive;
+        for (size_t threadCount : threadCounts)
+        {
+            if (threadCount != 1 && threadCount != threadCounts.back())
+                continue;
+
+            ThreadingUtilities::ThreadPool pool(threadCount);
+            const std::string variant = fileName + " " + BenchmarkUtilities::FormatByteCount(contents.size()) + " threads=" + std::to_string(threadCount);
+            succeeded &= MeasureAgainstNaive(options, results, "ParallelScan", variant, data, contents.size(), bytesPattern, [&]()
+            {
+                return ParallelScan(data, contents.size(), bytesPattern, pool);
+            }, naive);
+        }
+
+        /* Signatures for instructions spread over the middle half of the file; starting the decoder a few instructions
+           early lets it fall into step with the real instruction boundaries. */
+        SignatureGenerator generator;
+        generator.LoadBuffer(data, contents.size(), 0x0, sizeof(void*) == 8);
+
+        std::vector<uintptr_t> addresses;
+        const size_t addressCount = options.quick ? kQuickSignatureCount : kSignatureCount;
+        for (size_t i = 0; i < addressCount; ++i)
+        {
+            size_t offset = contents.size() / 4 + contents.size() / 2 * i / addressCount;
+            for (size_t step = 0; step < 8 && offset < contents.size(); ++step)
+            {
+                DecodedInstruction instruction;
+                offset += InstructionDecoder::Decode(data + offset, contents.size() - offset, generator.Is64Bit(), instruction) ? instruction.length : 1;
+            }
+
+            if (offset < contents.size())
+                addresses.push_back(offset);
+        }
+
+        std::vector<std::string> signatures;
+        for (size_t threadCount : threadCounts)
+        {
+            if (threadCount != 1 && threadCount != threadCounts.back())
+                continue;
+
+            ThreadingUtilities::ThreadPool pool(threadCount);
+            const std::string variant = fileName + " " + std::to_string(addresses.size()) + " addresses threads=" + std::to_string(threadCount);
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "SignatureGenerator::Generate", variant, contents.size() * addresses.size(), [&]()
+            {
+                signatures = generator.Generate(addresses, pool);
+            }));
+
+            /* Every signature must match its own address and nothing else. */
+            size_t generatedCount = 0;
+            size_t totalLength = 0;
+            for (size_t i = 0; i < signatures.size(); ++i)
+            {
+                if (signatures[i].empty())
+                    continue;
+
+                std::pmr::vector<uintptr_t> matches;
+                Internal::ScanForAllMemoryPattern(data, contents.size(), signatures[i], matches);
+                if (matches.size() != 1 || matches[0] != reinterpret_cast<uintptr_t>(data + addresses[i]))
+                {
+                    std::printf("scan: signature \"%s\" for offset 0x%zX matched %zu times.\n", signatures[i].c_str(), static_cast<size_t>(addresses[i]), matches.size());
+                    succeeded = false;
+                }
+
+                ++generatedCount;
+                totalLength += Convertion::MemoryPattern_ToMaskedPattern(signatures[i]).values.size();
+            }
+
+            std::printf("scan: %zu of %zu addresses got a signature, %.1f bytes on average\n", generatedCount, signatures.size(),
+                        generatedCount != 0 ? static_cast<double>(totalLength) / generatedCount : 0.0);
+        }
+
+
+        /* Resolving the generated signatures at startup: every one scanned for (cold), against the results saved by a previous
+           run, each checked with one compare (warm). Loading the file and hashing the module's code count towards the warm time. */
+        signatures.erase(std::remove(signatures.begin(), signatures.end(), std::string()), signatures.end());
+        char tempDirectory[MAX_PATH] = { 0 };
+        GetTempPathA(MAX_PATH, tempDirectory);
+        const std::string cachePath = std::string(tempDirectory) + fileName + ".sigcache";
+
+        ModuleImage module;
+        module.LoadBuffer(data, contents.size(), 0x0);
+
+        std::vector<uintptr_t> coldAddresses;
+        const std::string cacheVariant = fileName + " " + std::to_string(signatures.size()) + " signatures";
+        const BenchmarkResult cold = BenchmarkUtilities::Measure(options, "scan", "SignatureCache::Resolve", cacheVariant + " cold", contents.size(), [&]()
+        {
+            SignatureCache cache;
+            cache.Attach(module);
+            coldAddresses = cache.Resolve(signatures);
+            cache.Save(cachePath);
+        });
+        results.push_back(cold);
+
+        std::vector<uintptr_t> warmAddresses;
+        SignatureCache::Statistics warmStatistics;
+        BenchmarkResult warm = BenchmarkUtilities::Measure(options, "scan", "SignatureCache::Resolve", cacheVariant + " warm", contents.size(), [&]()
+        {
+            SignatureCache cache;
+            cache.Load(cachePath);
+            cache.Attach(module);
+            warmAddresses = cache.Resolve(signatures);
+            warmStatistics = cache.GetStatistics();
+        });
+        warm.speedup = warm.nanosecondsPerOperation > 0.0 ? cold.nanosecondsPerOperation / warm.nanosecondsPerOperation : 0.0;
+        results.push_back(warm);
+        DeleteFileA(cachePath.c_str());
+
+        if (warmAddresses != coldAddresses || warmStatistics.hits != signatures.size())
+        {
+            std::printf("scan: the warm signature cache resolved differently (%zu of %zu hits).\n", warmStatistics.hits, signatures.size());
+            succeeded = false;
+        }
+
+        allSignatures.insert(allSignatures.end(), signatures.begin(), signatures.end());
+    }
+
+
+    /* Offline: every real binary mapped from disk and checked against the signatures of all of them, as a CI job would. */
+    if (options.imagePaths.empty() == false && allSignatures.empty() == false)
+    {
+        uint64_t totalFileSize = 0;
+        for (const std::string& imagePath : options.imagePaths)
+        {
+            ModuleImage file;
+            totalFileSize += file.LoadFile(imagePath) ? file.GetSize() : 0;
+        }
+
+        std::vector<OfflineScanResult> reference;
+        for (size_t threadCount : threadCounts)
+        {
+            if (threadCount != 1 && threadCount != threadCounts.back())
+                continue;
+
+            ThreadingUtilities::ThreadPool pool(threadCount);
+            std::vector<OfflineScanResult> offlineResults;
+            const std::string variant = std::to_string(options.imagePaths.size()) + " files " + std::to_string(allSignatures.size()) + " signatures threads=" + std::to_string(threadCount);
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "OfflineScanner::ScanFiles", variant, totalFileSize * allSignatures.size(), [&]()
+            {
+                offlineResults = OfflineScanner::ScanFiles(options.imagePaths, allSignatures, pool);
+            }));
+
+            if (reference.empty())
+                reference = offlineResults;
+
+            for (size_t i = 0; i < offlineResults.size(); ++i)
+            {
+                if (offlineResults[i].loaded == false || offlineResults[i].rvas != reference[i].rvas || offlineResults[i].identity != reference[i].identity)
+                {
+                    std::printf("scan: offline results for %s differ between thread counts.\n", offlineResults[i].filePath.c_str());
+                    succeeded = false;
+                }
+            }
+        }
+    }
+
+
+    /* Cross-reference index of every real binary, built from its file; the index must not depend on how it was split up. */
+    for (const std::string& imagePath : options.imagePaths)
+    {
+        ModuleImage file;
+        if (file.LoadFile(imagePath) == false)
+            continue;
+
+        const std::string fileName = imagePath.substr(imagePath.find_last_of("\\/") + 1);
+        std::vector<CodeReference> reference;
+        for (size_t threadCount : threadCounts)
+        {
+            if (threadCount != 1 && threadCount != threadCounts.back())
+                continue;
+
+            ThreadingUtilities::ThreadPool pool(threadCount);
+            ReferenceIndex index;
+            results.push_back(BenchmarkUtilities::Measure(options, "scan", "ReferenceIndex::Build", fileName + " threads=" + std::to_string(threadCount), file.GetSize(), [&]()
+            {
+                index.Build(file, pool);
+            }));
+
+            if (reference.empty())
+            {
+                reference = index.GetReferences();
+                std::printf("scan: %s holds %zu code references.\n", fileName.c_str(), reference.size());
+            }
+            else if (index.GetReferences().size() != reference.size() || std::equal(reference.begin(), reference.end(), index.GetReferences().begin(), [](const CodeReference& left, const CodeReference& right)
+                {
+                    return left.sourceRva == right.sourceRva && left.targetRva == right.targetRva && left.type == right.type;
+                }) == false)
+            {
+                std::printf("scan: the reference index of %s differs between thread counts.\n", fileName.c_str());
+                succeeded = false;
+            }
+        }
+
+        /* Strings of the same file: the index once, then every string's users looked up through both indexes. */
+        StringIndex stringIndex;
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "StringIndex::Build", fileName, file.GetSize(), [&]()
+        {
+            stringIndex.Build(file);
+        }));
+
+        ReferenceIndex referenceIndex;
+        referenceIndex.Build(file);
+        size_t referencedStrings = 0;
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "StringIndex::FindReferencesTo", fileName + " " + std::to_string(stringIndex.GetStringCount()) + " strings", stringIndex.GetStringCount(), [&]()
+        {
+            referencedStrings = 0;
+            for (const auto& entry : stringIndex.GetStrings())
+            {
+                referencedStrings += stringIndex.FindReferencesTo(entry.first, referenceIndex).empty() == false;
+            }
+        }));
+        std::printf("scan: %s holds %zu strings, %zu of them used by code.\n", fileName.c_str(), stringIndex.GetStringCount(), referencedStrings);
+
+        /* Classes of the same file, from its RTTI; every class found must lead back to its vtable by name. */
+        RttiIndex rttiIndex;
+        results.push_back(BenchmarkUtilities::Measure(options, "scan", "RttiIndex::Build", fileName, file.GetSize(), [&]()
+        {
+            rttiIndex.Build(file);
+        }));
+
+        size_t vtableCount = 0;
+        for (const auto& entry : rttiIndex.GetClasses())
+        {
+            vtableCount += entry.second.vtables.size();
+            if (rttiIndex.FindClass(entry.second.decoratedName) != &entry.second)
+            {
+                std::printf("scan: class %s of %s isn't found by its decorated name.\n", entry.first.c_str(), fileName.c_str());
+                succeeded = false;
+            }
+        }
+        std::printf("scan: %s holds %zu polymorphic classes with %zu vtables.\n", fileName.c_str(), rttiIndex.GetClassCount(), vtableCount);
+    }
+
+    return succeeded;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtilities.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+class ScanBenchmarks
+{
+	// Description: Measures Internal::ScanForBytesPattern and Convertion::MemoryPattern_ToBytesPattern over synthetic images
+	//              (random bytes, x86-like code, zero-filled) from 1 MiB to 1 GiB and over real binaries, varying pattern length,
+	//              wildcard density, anchor rarity and thread count. Every scan is compared against a frozen copy of the original naive scanner.
+	//              Find-all scans are measured with their results on the default heap and in a MemoryArena.
+	//              Real binaries also get signatures generated for instructions spread over them, each checked to be unique,
+	//              and resolved again through a SignatureCache, cold and warm; all of them are then checked offline against every binary.
+	// Search Tags: #benchmark, #scan, #pattern, #signature, #cache, #offline, #throughput.
+public:
+	enum class E_ImageKind
+	{
+		Random,
+		Code,
+		Zero
+	};
+
+
+	/**
+	* @brief Settings of one scanned pattern.
+	* @param length - Pattern length in bytes.
+	* @param wildcardPercent - Share of the bytes after the anchor that are wildcards.
+	* @param rareAnchor - true to start the pattern with the least frequent byte of the image, false for the most frequent one.
+	*/
+	struct PatternShape
+	{
+		size_t length		   = 16;
+		int	   wildcardPercent = 25;
+		bool   rareAnchor	   = true;
+	};
+
+
+
+
+	/**
+	* @brief Runs every scan measurement and appends the results.
+	* @return false if a scanner returned a different match than the naive reference.
+	*/
+	static bool Run(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results);
+
+
+
+
+	/**
+	* @brief Fills an image of 'size' bytes. Output depends only on 'kind', 'size' and 'seed'.
+	*/
+	static std::vector<uint8_t> GenerateImage(E_ImageKind kind, size_t size, uint64_t seed);
+	static std::string ImageKindToString(E_ImageKind kind);
+
+	/**
+	* @brief Builds a pattern of the given shape whose concrete bytes come from 'image' distribution statistics and a seeded generator.
+	*/
+	static std::vector<std::optional<uint8_t>> MakePattern(const std::vector<uint8_t>& image, const PatternShape& shape, uint64_t seed);
+
+	/**
+	* @brief Splits 'size' bytes into one overlapping chunk per worker of 'pool' and scans them with Internal::ScanForBytesPattern in parallel.
+	* @return Address of the first match, or 0x0.
+	*/
+	static uintptr_t ParallelScan(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern, ThreadingUtilities::ThreadPool& pool);
+};
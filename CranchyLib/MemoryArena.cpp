@@ -0,0 +1,112 @@
+#include "MemoryArena.h"
+
+#include <algorithm>
+
+
+
+
+
+
+MemoryUtilities::MemoryArena::MemoryArena(size_t initialBlockSize, std::pmr::memory_resource* upstream)
+    : upstream(upstream != nullptr ? upstream : std::pmr::get_default_resource()), initialBlockSize(std::max<size_t>(initialBlockSize, 64))
+{
+}
+
+MemoryUtilities::MemoryArena::~MemoryArena()
+{
+    Release();
+}
+
+
+
+
+void MemoryUtilities::MemoryArena::Reset()
+{
+    currentBlock = 0;
+    currentOffset = 0;
+    bytesUsed = 0;
+}
+
+void MemoryUtilities::MemoryArena::Release()
+{
+    for (const Block& block : blocks)
+    {
+        upstream->deallocate(block.memory, block.size, alignof(std::max_align_t));
+    }
+
+    blocks.clear();
+    blocks.shrink_to_fit();
+    Reset();
+
+    peakBytesUsed = 0;
+    blockAllocations = 0;
+}
+
+MemoryUtilities::MemoryArena::Statistics MemoryUtilities::MemoryArena::GetStatistics() const
+{
+    Statistics statistics;
+    statistics.bytesUsed = bytesUsed;
+    statistics.peakBytesUsed = peakBytesUsed;
+    statistics.blockCount = blocks.size();
+    statistics.blockAllocations = blockAllocations;
+
+    for (const Block& block : blocks)
+    {
+        statistics.bytesReserved += block.size;
+    }
+
+    return statistics;
+}
+
+
+
+
+void* MemoryUtilities::MemoryArena::do_allocate(size_t bytes, size_t alignment)
+{
+    while (true)
+    {
+        /* Bump inside the current block; a block too small for the request is skipped until the next Reset(). */
+        for (; currentBlock < blocks.size(); ++currentBlock, currentOffset = 0)
+        {
+            const Block& block = blocks[currentBlock];
+            const uintptr_t blockAddress = reinterpret_cast<uintptr_t>(block.memory);
+            const size_t alignedOffset = static_cast<size_t>(((blockAddress + currentOffset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - blockAddress);
+
+            if (alignedOffset <= block.size && bytes <= block.size - alignedOffset)
+            {
+                bytesUsed += alignedOffset - currentOffset + bytes;
+                peakBytesUsed = std::max<size_t>(peakBytesUsed, bytesUsed);
+                currentOffset = alignedOffset + bytes;
+                return block.memory + alignedOffset;
+            }
+        }
+
+        /* Out of blocks: take a new one, twice the size of the previous one. */
+        size_t blockSize = initialBlockSize;
+        for (size_t i = 0; i < blocks.size() && blockSize < MaximumBlockSize; ++i)
+        {
+            blockSize *= 2;
+        }
+
+        blockSize = std::max<size_t>(std::min<size_t>(blockSize, std::max<size_t>(initialBlockSize, MaximumBlockSize)), bytes + alignment);
+
+        Block block;
+        block.memory = static_cast<uint8_t*>(upstream->allocate(blockSize, alignof(std::max_align_t)));
+        block.size = blockSize;
+        blocks.push_back(block);
+        ++blockAllocations;
+
+        currentBlock = blocks.size() - 1;
+        currentOffset = 0;
+    }
+}
+
+void MemoryUtilities::MemoryArena::do_deallocate(void* memoryPtr, size_t bytes, size_t alignment)
+{
+    /* Monotonic: memory only comes back through Reset() or Release(). */
+}
+
+bool MemoryUtilities::MemoryArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class MemoryArena : public std::pmr::memory_resource
+	{
+		// Description: Monotonic allocator for scan results and analysis temporaries. An allocation is a pointer bump inside the current
+		//              block and freeing one does nothing; Reset() rewinds to the first block in O(1) and keeps every block for the next
+		//              scan, so a warmed-up arena stops touching the heap. Being a std::pmr::memory_resource, it backs any std::pmr container.
+		//              Not thread-safe: use one arena per thread.
+		// Search Tags: #arena, #allocator, #monotonic, #bump, #pmr, #memoryresource, #results.
+	public:
+		static constexpr size_t DefaultBlockSize = 64 * 1024;
+		static constexpr size_t MaximumBlockSize = 64 * 1024 * 1024; // Blocks stop doubling here; larger requests still get a block of their own.
+
+
+		/**
+		* @brief Arena usage counters.
+		* @param bytesUsed - Bytes handed out since the last Reset(), alignment padding included.
+		* @param peakBytesUsed - Highest 'bytesUsed' seen since construction or the last Release().
+		* @param bytesReserved - Bytes held in blocks.
+		* @param blockCount - Number of blocks held.
+		* @param blockAllocations - Blocks taken from the upstream resource since construction or the last Release().
+		*/
+		struct Statistics
+		{
+			size_t bytesUsed		= 0;
+			size_t peakBytesUsed	= 0;
+			size_t bytesReserved	= 0;
+			size_t blockCount		= 0;
+			size_t blockAllocations = 0;
+		};
+
+
+
+
+		/**
+		* @param initialBlockSize - Size of the first block; every further block is twice as large, up to 'MaximumBlockSize'.
+		* @param upstream - Resource the blocks are taken from.
+		*/
+		explicit MemoryArena(size_t initialBlockSize = DefaultBlockSize, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		~MemoryArena() override;
+		MemoryArena(const MemoryArena&) = delete;
+		MemoryArena& operator=(const MemoryArena&) = delete;
+
+
+
+
+		/**
+		* @brief Invalidates everything allocated so far and starts over in the first block. Blocks are kept.
+		*        Containers using the arena must be destroyed or cleared before, since their memory gets reused.
+		*/
+		void Reset();
+		/**
+		* @brief Like Reset(), but also returns every block to the upstream resource.
+		*/
+		void Release();
+
+		Statistics GetStatistics() const;
+
+
+
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void  do_deallocate(void* memoryPtr, size_t bytes, size_t alignment) override;
+		bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+
+
+
+	private:
+		struct Block
+		{
+			uint8_t* memory = nullptr;
+			size_t	 size	= 0;
+		};
+
+
+		std::pmr::memory_resource* upstream;
+		size_t					   initialBlockSize;
+
+		std::vector<Block> blocks;
+		size_t			   currentBlock		= 0;
+		size_t			   currentOffset	= 0;
+
+		size_t			   bytesUsed		= 0;
+		size_t			   peakBytesUsed	= 0;
+		size_t			   blockAllocations = 0;
+	};
+}
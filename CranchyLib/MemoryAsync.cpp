@@ -0,0 +1,283 @@
+#include "MemoryAsync.h"
+
+#include <algorithm>
+
+
+
+
+
+
+namespace
+{
+    constexpr size_t kPageSize = 0x1000;
+}
+
+
+
+
+
+
+MemoryUtilities::AsyncMemory::AsyncMemory(size_t workerCount, size_t chunkSize) : chunkSize(std::max<size_t>(chunkSize, kPageSize))
+{
+    if (workerCount == 0)
+        workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(&AsyncMemory::WorkerLoop, this);
+    }
+}
+
+MemoryUtilities::AsyncMemory::~AsyncMemory()
+{
+    CancelPending();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+
+    queueCondition.notify_all();
+    for (std::thread& worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+
+
+
+std::future<MemoryUtilities::AsyncResult> MemoryUtilities::AsyncMemory::Read(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount)
+{
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->hProcess = hProcess;
+    request->memoryAddress = memoryAddress;
+    request->buffer = static_cast<uint8_t*>(buffer);
+    request->byteCount = byteCount;
+
+    std::future<AsyncResult> future = request->promise.get_future();
+    Submit(request);
+    return future;
+}
+
+void MemoryUtilities::AsyncMemory::Read(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount, Callback callback)
+{
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->hProcess = hProcess;
+    request->memoryAddress = memoryAddress;
+    request->buffer = static_cast<uint8_t*>(buffer);
+    request->byteCount = byteCount;
+    request->callback = std::move(callback);
+
+    Submit(request);
+}
+
+std::future<MemoryUtilities::AsyncResult> MemoryUtilities::AsyncMemory::Write(const HANDLE& hProcess, const uintptr_t& memoryAddress, const void* buffer, size_t byteCount)
+{
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->hProcess = hProcess;
+    request->memoryAddress = memoryAddress;
+    request->buffer = const_cast<uint8_t*>(static_cast<const uint8_t*>(buffer)); // Only read from for writes.
+    request->byteCount = byteCount;
+    request->isWrite = true;
+
+    std::future<AsyncResult> future = request->promise.get_future();
+    Submit(request);
+    return future;
+}
+
+void MemoryUtilities::AsyncMemory::Write(const HANDLE& hProcess, const uintptr_t& memoryAddress, const void* buffer, size_t byteCount, Callback callback)
+{
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->hProcess = hProcess;
+    request->memoryAddress = memoryAddress;
+    request->buffer = const_cast<uint8_t*>(static_cast<const uint8_t*>(buffer));
+    request->byteCount = byteCount;
+    request->isWrite = true;
+    request->callback = std::move(callback);
+
+    Submit(request);
+}
+
+
+
+
+void MemoryUtilities::AsyncMemory::CancelPending()
+{
+    std::deque<Chunk> cancelledChunks;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        cancelledChunks.swap(queue);
+    }
+
+    /* Completion runs outside the lock, callbacks may queue new requests. */
+    for (const Chunk& chunk : cancelledChunks)
+    {
+        chunk.request->cancelled = true;
+        FinishChunk(chunk.request);
+    }
+}
+
+void MemoryUtilities::AsyncMemory::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    idleCondition.wait(lock, [this]() { return activeRequestCount == 0; });
+}
+
+size_t MemoryUtilities::AsyncMemory::GetWorkerCount() const
+{
+    return workers.size();
+}
+
+size_t MemoryUtilities::AsyncMemory::GetPendingRequestCount() const
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return activeRequestCount;
+}
+
+
+
+
+void MemoryUtilities::AsyncMemory::Submit(const std::shared_ptr<Request>& request)
+{
+    /* Nothing to do for empty or obviously invalid requests, complete them right away. */
+    if (request->byteCount == 0 || request->buffer == nullptr || request->memoryAddress == 0x0 || External::IsValidProcessHandle(request->hProcess) == false)
+    {
+        request->remainingChunks = 1;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            activeRequestCount++;
+        }
+        FinishChunk(request);
+        return;
+    }
+
+    /* Writes are split on page boundaries, so no two chunks of a request lift and restore the protection of the same page. */
+    std::vector<Chunk> chunks;
+    const size_t writeChunkSize = chunkSize & ~(kPageSize - 1);
+    for (size_t offset = 0; offset < request->byteCount;)
+    {
+        size_t chunkEnd = offset + chunkSize;
+        if (request->isWrite)
+            chunkEnd = offset + writeChunkSize - static_cast<size_t>((request->memoryAddress + offset) % writeChunkSize);
+
+        Chunk chunk;
+        chunk.request = request;
+        chunk.offset = offset;
+        chunk.byteCount = std::min<size_t>(chunkEnd, request->byteCount) - offset;
+        offset += chunk.byteCount;
+        chunks.push_back(std::move(chunk));
+    }
+
+    const size_t chunkCount = chunks.size();
+    request->remainingChunks = chunkCount;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        activeRequestCount++;
+        for (Chunk& chunk : chunks)
+        {
+            queue.push_back(std::move(chunk));
+        }
+    }
+
+    if (chunkCount == 1)
+        queueCondition.notify_one();
+    else
+        queueCondition.notify_all();
+}
+
+void MemoryUtilities::AsyncMemory::WorkerLoop()
+{
+    for (;;)
+    {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || queue.empty() == false; });
+            if (queue.empty()) // Only reached when stopping.
+                return;
+
+            chunk = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        RunChunk(chunk);
+        FinishChunk(chunk.request);
+    }
+}
+
+void MemoryUtilities::AsyncMemory::RunChunk(const Chunk& chunk)
+{
+    Request& request = *chunk.request;
+    LPVOID target = reinterpret_cast<LPVOID>(request.memoryAddress + chunk.offset);
+    uint8_t* buffer = request.buffer + chunk.offset;
+    const External::Backend& backend = External::GetBackend();
+
+    SIZE_T bytesTransferred = 0;
+    BOOL ok;
+    DWORD errorCode = ERROR_SUCCESS;
+    if (request.isWrite)
+    {
+        /* Same protection dance as External::SetBytes, scoped to this chunk's pages. Chunks of other write requests may share
+           them, so one write at a time: none can restore a protection another one has lifted and is still writing through. */
+        std::lock_guard<std::mutex> lock(writeMutex);
+        DWORD oldProtect;
+        const BOOL unprotected = backend.ProtectMemory(request.hProcess, target, chunk.byteCount, PAGE_EXECUTE_READWRITE, &oldProtect);
+        ok = backend.WriteMemory(request.hProcess, target, buffer, chunk.byteCount, &bytesTransferred);
+        if (ok == FALSE)
+            errorCode = GetLastError(); // Before the restore below can overwrite it.
+
+        if (unprotected)
+        {
+            DWORD tmp;
+            backend.ProtectMemory(request.hProcess, target, chunk.byteCount, oldProtect, &tmp);
+        }
+    }
+    else
+    {
+        ok = backend.ReadMemory(request.hProcess, target, buffer, chunk.byteCount, &bytesTransferred);
+        if (ok == FALSE)
+            errorCode = GetLastError();
+    }
+
+    if (ok == FALSE || bytesTransferred != chunk.byteCount)
+    {
+        DWORD expected = ERROR_SUCCESS;
+        request.errorCode.compare_exchange_strong(expected, ok ? ERROR_PARTIAL_COPY : errorCode);
+    }
+
+    request.bytesTransferred += bytesTransferred;
+}
+
+void MemoryUtilities::AsyncMemory::FinishChunk(const std::shared_ptr<Request>& request)
+{
+    if (--request->remainingChunks != 0)
+        return;
+
+    /* Last chunk of the request, report the combined result. */
+    AsyncResult result;
+    result.bytesTransferred = request->bytesTransferred.load();
+    result.errorCode = request->errorCode.load();
+
+    if (request->cancelled.load())
+        result.status = E_AsyncStatus::Cancelled;
+    else if (request->byteCount != 0 && result.bytesTransferred == request->byteCount)
+        result.status = E_AsyncStatus::Completed;
+    else if (result.bytesTransferred != 0)
+        result.status = E_AsyncStatus::PartialCopy;
+    else
+        result.status = E_AsyncStatus::Failed;
+
+    if (request->callback)
+        request->callback(result);
+    else
+        request->promise.set_value(result);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        activeRequestCount--;
+    }
+    idleCondition.notify_all();
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	enum class E_AsyncStatus
+	{
+		Completed,	 /// Every byte was transferred.
+		PartialCopy, /// Only part of the range could be transferred, see 'bytesTransferred'.
+		Failed,		 /// Nothing was transferred.
+		Cancelled	 /// The request was still queued when the queue was cancelled or destroyed.
+	};
+
+	/**
+	* @brief Outcome of an asynchronous request.
+	* @param status - Overall result.
+	* @param bytesTransferred - Number of bytes read or written; chunks that failed don't count.
+	* @param errorCode - GetLastError() value of the first failed chunk, or ERROR_SUCCESS.
+	*/
+	struct AsyncResult
+	{
+		E_AsyncStatus status		   = E_AsyncStatus::Failed;
+		size_t		  bytesTransferred = 0;
+		DWORD		  errorCode		   = ERROR_SUCCESS;
+	};
+
+
+
+
+
+
+	class AsyncMemory
+	{
+		// Description: Queues reads and writes of a 3'rd party process onto a pool of worker threads, so the calling thread never blocks
+		//              on ReadProcessMemory / WriteProcessMemory. Large requests are split into chunks that run on several workers at once.
+		//              Completion is reported through a std::future or a callback that runs on the worker finishing the last chunk.
+		// Search Tags: #external, #async, #asynchronous, #future, #callback, #readprocessmemory, #writeprocessmemory.
+	public:
+		using Callback = std::function<void(const AsyncResult&)>;
+
+
+		/**
+		* @param workerCount - Number of worker threads; 0 picks the number of logical processors.
+		* @param chunkSize - Requests larger than this are split into chunks of this size that are processed in parallel.
+		*/
+		explicit AsyncMemory(size_t workerCount = 0, size_t chunkSize = 1024 * 1024);
+		/**
+		* @brief Cancels every queued request and waits for the ones in flight.
+		*/
+		~AsyncMemory();
+		AsyncMemory(const AsyncMemory&) = delete;
+		AsyncMemory& operator=(const AsyncMemory&) = delete;
+
+
+
+
+		/**
+		* @brief Queues a read of 'byteCount' bytes at 'memoryAddress' into 'buffer'.
+		*        'buffer' (and the process handle) must stay valid until the request completes.
+		*/
+		std::future<AsyncResult> Read(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount);
+		void Read(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount, Callback callback);
+
+		/**
+		* @brief Queues a write of 'byteCount' bytes from 'buffer' to 'memoryAddress'. Page protection is lifted and restored around the
+		*        write, as with External::SetBytes. Writes are split on page boundaries and run one at a time, so they never race over a
+		*        page's protection; reads still run in parallel. 'buffer' must stay valid until the request completes.
+		*/
+		std::future<AsyncResult> Write(const HANDLE& hProcess, const uintptr_t& memoryAddress, const void* buffer, size_t byteCount);
+		void Write(const HANDLE& hProcess, const uintptr_t& memoryAddress, const void* buffer, size_t byteCount, Callback callback);
+
+
+
+
+		/**
+		* @brief Completes every request that hasn't started yet with E_AsyncStatus::Cancelled.
+		*/
+		void CancelPending();
+		/**
+		* @brief Blocks until every queued and running request has completed.
+		*/
+		void WaitIdle();
+
+		size_t GetWorkerCount() const;
+		size_t GetPendingRequestCount() const;
+
+
+
+
+	private:
+		struct Request
+		{
+			HANDLE				hProcess	  = nullptr;
+			uintptr_t			memoryAddress = 0x0;
+			uint8_t*			buffer		  = nullptr;
+			size_t				byteCount	  = 0;
+			bool				isWrite		  = false;
+
+			std::atomic<size_t> remainingChunks{ 0 };
+			std::atomic<size_t> bytesTransferred{ 0 };
+			std::atomic<bool>	cancelled{ false };
+			std::atomic<DWORD>	errorCode{ ERROR_SUCCESS };
+
+			std::promise<AsyncResult> promise;
+			Callback				  callback;
+		};
+
+		struct Chunk
+		{
+			std::shared_ptr<Request> request;
+			size_t					 offset	   = 0;
+			size_t					 byteCount = 0;
+		};
+
+
+		void Submit(const std::shared_ptr<Request>& request);
+		void WorkerLoop();
+		void RunChunk(const Chunk& chunk);
+		void FinishChunk(const std::shared_ptr<Request>& request);
+
+
+		size_t					 chunkSize = 0;
+		std::vector<std::thread> workers;
+
+		std::mutex				 writeMutex; // Held around each write chunk's protection change, write and restore.
+		mutable std::mutex		 queueMutex;
+		std::condition_variable	 queueCondition;
+		std::condition_variable	 idleCondition;
+		std::deque<Chunk>		 queue;
+		size_t					 activeRequestCount = 0;
+		bool					 stopping = false;
+	};
+}
@@ -0,0 +1,325 @@
+#include "MemoryChannel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+
+
+
+
+
+namespace
+{
+    const uint32_t kChannelMagic   = 0x4E484353; // "SCHN"
+    const uint32_t kChannelVersion = 1;
+    const size_t   kCacheLineSize  = 64;
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "Shared atomics must be lock-free to work across processes.");
+}
+
+
+
+
+
+
+MemoryUtilities::SharedChannel::~SharedChannel()
+{
+    Close();
+}
+
+
+
+
+bool MemoryUtilities::SharedChannel::Create(const std::string& channelName, size_t stateSize, size_t messageSize, size_t messageCount)
+{
+    Close();
+    if (channelName.empty() || (stateSize == 0 && messageSize == 0) || (messageSize != 0 && messageCount == 0) || messageSize > 0xFFFFFFFF)
+        return false;
+
+    size_t roundedMessageCount = 0;
+    if (messageSize != 0)
+    {
+        roundedMessageCount = 2;
+        while (roundedMessageCount < messageCount)
+            roundedMessageCount <<= 1;
+    }
+
+    /* [header][state block][ring slots], every part on its own cache lines. Each slot is a uint32 length followed by the message. */
+    const size_t slotStride = AlignUp(sizeof(uint32_t) + messageSize, 8);
+    const size_t stateOffset = AlignUp(sizeof(ChannelHeader), kCacheLineSize);
+    const size_t slotsOffset = AlignUp(stateOffset + stateSize, kCacheLineSize);
+    mappingSize = slotsOffset + slotStride * roundedMessageCount;
+
+    hMapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,                                // Backed by the paging file.
+        nullptr,                                             // Security attributes.
+        PAGE_READWRITE,                                      // Protection.
+        static_cast<DWORD>(static_cast<uint64_t>(mappingSize) >> 32), // Maximum size, high.
+        static_cast<DWORD>(mappingSize & 0xFFFFFFFF),       // Maximum size, low.
+        channelName.c_str()                                  // Name.
+    );
+
+    if (hMapping == nullptr || GetLastError() == ERROR_ALREADY_EXISTS) // Never take over somebody else's channel.
+    {
+        Close();
+        return false;
+    }
+
+    if (MapChannel(true) == false)
+    {
+        Close();
+        return false;
+    }
+
+    /* A fresh mapping is zero filled; construct the header in place and publish the magic last, so Open() never sees a half made layout. */
+    header = new (header) ChannelHeader();
+    header->version = kChannelVersion;
+    header->stateSize = stateSize;
+    header->messageSize = messageSize;
+    header->messageCount = roundedMessageCount;
+    header->slotStride = slotStride;
+    header->stateSequence.store(0, std::memory_order_relaxed);
+    header->writeIndex.store(0, std::memory_order_relaxed);
+    header->droppedCount.store(0, std::memory_order_relaxed);
+    header->readIndex.store(0, std::memory_order_relaxed);
+
+    header->magic.store(kChannelMagic, std::memory_order_release);
+
+    return true;
+}
+
+bool MemoryUtilities::SharedChannel::Open(const std::string& channelName)
+{
+    Close();
+    if (channelName.empty())
+        return false;
+
+    hMapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, channelName.c_str());
+    if (hMapping == nullptr)
+        return false;
+
+    if (MapChannel(false) == false)
+    {
+        Close();
+        return false;
+    }
+
+    /* The acquire pairs with the release in Create(): once the magic is seen, the rest of the header is too. */
+    if (header->magic.load(std::memory_order_acquire) != kChannelMagic || header->version != kChannelVersion)
+    {
+        Close();
+        return false;
+    }
+
+    /* The header comes from another process; every size is bounded by the mapping before it's used in arithmetic, so none of
+       the checks below can overflow. GetSlot() masks with 'messageCount - 1', and Receive() copies 'messageSize' bytes out of a
+       slot, so both have to hold up too. */
+    const uint64_t messageCount = header->messageCount;
+    const uint64_t messageSize = header->messageSize;
+    const uint64_t slotStride = header->slotStride;
+    const uint64_t stateSize = header->stateSize;
+    bool isValidHeader = messageCount != 0 && (messageCount & (messageCount - 1)) == 0
+                         && messageSize <= mappingSize && stateSize <= mappingSize
+                         && slotStride >= AlignUp(sizeof(uint32_t) + static_cast<size_t>(messageSize), 8);
+
+    if (isValidHeader)
+    {
+        const size_t stateOffset = AlignUp(sizeof(ChannelHeader), kCacheLineSize);
+        const size_t slotsOffset = AlignUp(stateOffset + static_cast<size_t>(stateSize), kCacheLineSize);
+        isValidHeader = slotsOffset <= mappingSize && slotStride <= (mappingSize - slotsOffset) / messageCount;
+    }
+
+    if (isValidHeader == false)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MemoryUtilities::SharedChannel::Close()
+{
+    if (header != nullptr)
+        UnmapViewOfFile(header);
+
+    if (hMapping != nullptr)
+        CloseHandle(hMapping);
+
+    header = nullptr;
+    hMapping = nullptr;
+    mappingSize = 0;
+}
+
+bool MemoryUtilities::SharedChannel::IsOpen() const
+{
+    return header != nullptr;
+}
+
+size_t MemoryUtilities::SharedChannel::GetStateSize() const
+{
+    return header != nullptr ? static_cast<size_t>(header->stateSize) : 0;
+}
+
+size_t MemoryUtilities::SharedChannel::GetMessageSize() const
+{
+    return header != nullptr ? static_cast<size_t>(header->messageSize) : 0;
+}
+
+size_t MemoryUtilities::SharedChannel::GetMessageCount() const
+{
+    return header != nullptr ? static_cast<size_t>(header->messageCount) : 0;
+}
+
+
+
+
+bool MemoryUtilities::SharedChannel::PublishState(const void* data, size_t size)
+{
+    if (header == nullptr || data == nullptr || size > header->stateSize)
+        return false;
+
+    /* Odd sequence marks the write in progress; readers that saw it, or see it change, retry. */
+    const uint64_t sequence = header->stateSequence.load(std::memory_order_relaxed);
+    header->stateSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(GetStateBlock(), data, size);
+
+    header->stateSequence.store(sequence + 2, std::memory_order_release);
+    return true;
+}
+
+bool MemoryUtilities::SharedChannel::ReadState(void* outData, size_t size, size_t maxRetries) const
+{
+    if (header == nullptr || outData == nullptr || size > header->stateSize)
+        return false;
+
+    for (size_t attempt = 0; attempt <= maxRetries; ++attempt)
+    {
+        const uint64_t sequenceBefore = header->stateSequence.load(std::memory_order_acquire);
+        if (sequenceBefore & 1) // Writer is mid update.
+        {
+            YieldProcessor();
+            continue;
+        }
+
+        std::memcpy(outData, GetStateBlock(), size);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (header->stateSequence.load(std::memory_order_relaxed) == sequenceBefore)
+            return true;
+    }
+
+    return false;
+}
+
+uint64_t MemoryUtilities::SharedChannel::GetStateVersion() const
+{
+    return header != nullptr ? header->stateSequence.load(std::memory_order_acquire) / 2 : 0;
+}
+
+
+
+
+bool MemoryUtilities::SharedChannel::Send(const void* data, size_t size)
+{
+    if (header == nullptr || header->messageCount == 0 || (data == nullptr && size != 0) || size > header->messageSize)
+        return false;
+
+    const uint64_t writeIndex = header->writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - header->readIndex.load(std::memory_order_acquire) >= header->messageCount) // Consumer isn't keeping up.
+    {
+        header->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t* slot = GetSlot(writeIndex);
+    const uint32_t messageLength = static_cast<uint32_t>(size);
+    std::memcpy(slot, &messageLength, sizeof(messageLength));
+    if (size != 0)
+        std::memcpy(slot + sizeof(messageLength), data, size);
+
+    header->writeIndex.store(writeIndex + 1, std::memory_order_release);
+    return true;
+}
+
+bool MemoryUtilities::SharedChannel::Receive(void* outData, size_t capacity, size_t& outSize)
+{
+    outSize = 0;
+    if (header == nullptr || header->messageCount == 0)
+        return false;
+
+    const uint64_t readIndex = header->readIndex.load(std::memory_order_relaxed);
+    if (readIndex == header->writeIndex.load(std::memory_order_acquire)) // Empty.
+        return false;
+
+    const uint8_t* slot = GetSlot(readIndex);
+    uint32_t messageLength;
+    std::memcpy(&messageLength, slot, sizeof(messageLength));
+
+    outSize = std::min<size_t>(messageLength, static_cast<size_t>(header->messageSize));
+    if (outSize > capacity || (outData == nullptr && outSize != 0)) // Doesn't fit, leave it for a larger buffer.
+        return false;
+
+    if (outSize != 0)
+        std::memcpy(outData, slot + sizeof(messageLength), outSize);
+
+    header->readIndex.store(readIndex + 1, std::memory_order_release);
+    return true;
+}
+
+size_t MemoryUtilities::SharedChannel::GetPendingMessageCount() const
+{
+    if (header == nullptr)
+        return 0;
+
+    return static_cast<size_t>(header->writeIndex.load(std::memory_order_acquire) - header->readIndex.load(std::memory_order_acquire));
+}
+
+uint64_t MemoryUtilities::SharedChannel::GetDroppedMessageCount() const
+{
+    return header != nullptr ? header->droppedCount.load(std::memory_order_relaxed) : 0;
+}
+
+
+
+
+bool MemoryUtilities::SharedChannel::MapChannel(bool creating)
+{
+    void* view = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (view == nullptr)
+        return false;
+
+    header = static_cast<ChannelHeader*>(view);
+
+    /* The opening side doesn't know the size up front, the view spans the whole section. */
+    if (creating == false)
+    {
+        MEMORY_BASIC_INFORMATION mbi;
+        if (VirtualQuery(view, &mbi, sizeof(mbi)) == 0 || mbi.RegionSize < sizeof(ChannelHeader))
+            return false;
+
+        mappingSize = mbi.RegionSize;
+    }
+
+    return true;
+}
+
+uint8_t* MemoryUtilities::SharedChannel::GetStateBlock() const
+{
+    return reinterpret_cast<uint8_t*>(header) + AlignUp(sizeof(ChannelHeader), kCacheLineSize);
+}
+
+uint8_t* MemoryUtilities::SharedChannel::GetSlot(uint64_t index) const
+{
+    const size_t slotsOffset = AlignUp(AlignUp(sizeof(ChannelHeader), kCacheLineSize) + static_cast<size_t>(header->stateSize), kCacheLineSize);
+    const size_t slot = static_cast<size_t>(index & (header->messageCount - 1));
+    return reinterpret_cast<uint8_t*>(header) + slotsOffset + slot * static_cast<size_t>(header->slotStride);
+}
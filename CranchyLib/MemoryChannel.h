@@ -0,0 +1,152 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class SharedChannel
+	{
+		// Description: Lock-free transport between code injected into a process (usually built on MemoryUtilities::Internal) and an
+		//              external tool, over a named shared memory mapping. The external side reads with plain loads instead of going
+		//              through ReadProcessMemory. The mapping holds two independent parts:
+		//              - a "state" block protected by a sequence lock: one writer publishes a snapshot, readers retry on a torn read;
+		//              - a single producer / single consumer ring of fixed size message slots.
+		// Search Tags: #internal, #external, #shared, #memory, #mapping, #ipc, #seqlock, #ringbuffer.
+	public:
+		SharedChannel() = default;
+		~SharedChannel();
+		SharedChannel(const SharedChannel&) = delete;
+		SharedChannel& operator=(const SharedChannel&) = delete;
+
+
+
+
+		/**
+		* @brief Creates a new named channel. Usually called by the injected side.
+		* @param channelName - Mapping name, e.g. "Local\\MyChannel" (same session) or "Global\\MyChannel".
+		* @param stateSize - Size in bytes of the seqlock protected state block, may be 0.
+		* @param messageSize - Largest message the ring can carry, may be 0 if only the state block is used.
+		* @param messageCount - Number of ring slots, rounded up to a power of two.
+		* @return true if the channel was created; false if the name is already in use or the mapping couldn't be created.
+		*/
+		bool Create(const std::string& channelName, size_t stateSize, size_t messageSize = 0, size_t messageCount = 0);
+		/**
+		* @brief Opens a channel created by another process (or module) with Create().
+		* @return true if the channel exists and has a valid layout.
+		*/
+		bool Open(const std::string& channelName);
+		void Close();
+		bool IsOpen() const;
+
+		size_t GetStateSize() const;
+		size_t GetMessageSize() const;
+		size_t GetMessageCount() const;
+
+
+
+
+		/**
+		* @brief Publishes a new state snapshot. Must only be called from one thread (in one process) at a time.
+		* @param size - Number of bytes to publish, at most GetStateSize().
+		*/
+		bool PublishState(const void* data, size_t size);
+		/**
+		* @brief Takes a consistent copy of the state, retrying while the writer is in the middle of an update.
+		* @param maxRetries - Number of torn reads tolerated before giving up.
+		* @return true if a consistent copy was made.
+		*/
+		bool ReadState(void* outData, size_t size, size_t maxRetries = 1000) const;
+		/**
+		* @return Number of times the state was published; changes whenever the state does.
+		*/
+		uint64_t GetStateVersion() const;
+
+		template<typename T>
+		bool PublishState(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "State must be trivially copyable.");
+			return PublishState(&value, sizeof(T));
+		}
+
+		template<typename T>
+		bool ReadState(T& outValue, size_t maxRetries = 1000) const
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "State must be trivially copyable.");
+			return ReadState(&outValue, sizeof(T), maxRetries);
+		}
+
+
+
+
+		/**
+		* @brief Appends a message to the ring. Producer side, one thread only.
+		* @return true if the message was queued; false if it is too large or the ring is full (counted as dropped).
+		*/
+		bool Send(const void* data, size_t size);
+		/**
+		* @brief Takes the oldest message from the ring. Consumer side, one thread only.
+		* @param capacity - Size of 'outData'; a message that doesn't fit is left in the ring.
+		* @param outSize - Receives the size of the message.
+		* @return true if a message was copied out.
+		*/
+		bool Receive(void* outData, size_t capacity, size_t& outSize);
+
+		template<typename T>
+		bool Send(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Messages must be trivially copyable.");
+			return Send(&value, sizeof(T));
+		}
+
+		template<typename T>
+		bool Receive(T& outValue)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Messages must be trivially copyable.");
+			size_t size = 0;
+			return Receive(&outValue, sizeof(T), size) && size == sizeof(T);
+		}
+
+		/* Approximate when called concurrently with Send/Receive. */
+		size_t GetPendingMessageCount() const;
+		uint64_t GetDroppedMessageCount() const;
+
+
+
+
+	private:
+		/* Lives at the start of the mapping; both processes see the same object. */
+		struct ChannelHeader
+		{
+			std::atomic<uint32_t> magic{ 0 }; // Stored last by Create(), with release order; Open() reads nothing else before it.
+			uint32_t version	  = 0;
+			uint64_t stateSize	  = 0;
+			uint64_t messageSize  = 0;
+			uint64_t messageCount = 0;
+			uint64_t slotStride	  = 0;
+
+			alignas(64) std::atomic<uint64_t> stateSequence;  // Odd while the state is being written.
+			alignas(64) std::atomic<uint64_t> writeIndex;
+			std::atomic<uint64_t>			  droppedCount;
+			alignas(64) std::atomic<uint64_t> readIndex;
+		};
+
+
+		bool MapChannel(bool creating);
+		uint8_t* GetStateBlock() const;
+		uint8_t* GetSlot(uint64_t index) const;
+
+
+		HANDLE		   hMapping = nullptr;
+		ChannelHeader* header	= nullptr;
+		size_t		   mappingSize = 0;
+	};
+}
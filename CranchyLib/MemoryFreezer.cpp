@@ -0,0 +1,277 @@
+#include "MemoryFreezer.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+
+
+
+
+MemoryUtilities::Freezer::~Freezer()
+{
+    Stop();
+}
+
+
+
+
+bool MemoryUtilities::Freezer::Start(const HANDLE& hProcess, std::chrono::milliseconds interval)
+{
+    if (External::IsValidProcessHandle(hProcess) == false || interval.count() <= 0)
+        return false;
+
+    if (running.exchange(true)) // Already running.
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex);
+        this->hProcess = hProcess;
+        this->interval = interval;
+    }
+
+    workerThread = std::thread(&Freezer::WorkerLoop, this);
+    return true;
+}
+
+void MemoryUtilities::Freezer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex);
+        if (running.exchange(false) == false)
+            return;
+    }
+
+    wakeCondition.notify_all();
+    if (workerThread.joinable())
+        workerThread.join();
+}
+
+bool MemoryUtilities::Freezer::IsRunning() const
+{
+    return running.load();
+}
+
+void MemoryUtilities::Freezer::SetInterval(std::chrono::milliseconds interval)
+{
+    if (interval.count() <= 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    this->interval = interval;
+}
+
+
+
+
+MemoryUtilities::Freezer::FreezeId MemoryUtilities::Freezer::AddFreeze(const uintptr_t& memoryAddress, const std::vector<uint8_t>& bytes)
+{
+    if (memoryAddress == 0x0 || bytes.empty())
+        return InvalidFreeze;
+
+    Target target;
+    target.memoryAddress = memoryAddress;
+    target.bytes = bytes;
+
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    target.id = nextFreezeId++;
+    targets.push_back(std::move(target));
+
+    return targets.back().id;
+}
+
+bool MemoryUtilities::Freezer::UpdateFreeze(FreezeId freezeId, const std::vector<uint8_t>& bytes)
+{
+    if (bytes.empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    for (Target& target : targets)
+    {
+        if (target.id != freezeId)
+            continue;
+
+        target.bytes = bytes;
+        return true;
+    }
+
+    return false;
+}
+
+bool MemoryUtilities::Freezer::RemoveFreeze(FreezeId freezeId)
+{
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    auto it = std::find_if(targets.begin(), targets.end(), [freezeId](const Target& target) { return target.id == freezeId; });
+    if (it == targets.end())
+        return false;
+
+    targets.erase(it);
+    return true;
+}
+
+void MemoryUtilities::Freezer::ClearFreezes()
+{
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    targets.clear();
+}
+
+
+
+
+size_t MemoryUtilities::Freezer::Apply(const HANDLE& hProcess)
+{
+    if (External::IsValidProcessHandle(hProcess) == false)
+        return 0;
+
+    return ApplyPass(hProcess);
+}
+
+MemoryUtilities::Freezer::FreezeStatistics MemoryUtilities::Freezer::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    return statistics;
+}
+
+
+
+
+void MemoryUtilities::Freezer::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(targetsMutex);
+    auto nextTick = std::chrono::steady_clock::now();
+
+    while (running.load())
+    {
+        /* The pass does its I/O without 'targetsMutex', so a slow target never holds up AddFreeze(), Stop() and the like. */
+        const HANDLE hTarget = hProcess;
+        lock.unlock();
+        ApplyPass(hTarget);
+        lock.lock();
+
+        /* Keep a steady rate; if a pass overran the interval, start the next one right away instead of bursting. */
+        nextTick += interval;
+        const auto now = std::chrono::steady_clock::now();
+        if (nextTick < now)
+            nextTick = now;
+
+        wakeCondition.wait_until(lock, nextTick, [this]() { return running.load() == false; });
+    }
+}
+
+size_t MemoryUtilities::Freezer::ApplyPass(const HANDLE& hProcess)
+{
+    /* Passes are serialized by 'passMutex', which guards the scratch state; 'targetsMutex' is only held to copy the targets in
+       and the counters out. Targets changed meanwhile are picked up by the next pass. */
+    std::lock_guard<std::mutex> passLock(passMutex);
+    const uintptr_t kPageSize = 0x1000;
+    const External::Backend& backend = External::GetBackend();
+    FreezeStatistics passStatistics;
+    passStatistics.tickCount = 1;
+
+    {
+        std::lock_guard<std::mutex> lock(targetsMutex);
+        passTargets.resize(targets.size());
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            passTargets[i].id = targets[i].id;
+            passTargets[i].memoryAddress = targets[i].memoryAddress;
+            passTargets[i].bytes.assign(targets[i].bytes.begin(), targets[i].bytes.end()); // Reuses the scratch target's capacity.
+            passTargets[i].currentBytes.resize(targets[i].bytes.size());
+        }
+    }
+
+    /* Read every current value in one coalesced batch. */
+    batch.resize(passTargets.size());
+    for (size_t i = 0; i < passTargets.size(); ++i)
+    {
+        batch[i].memoryAddress = passTargets[i].memoryAddress;
+        batch[i].byteCount = passTargets[i].bytes.size();
+        batch[i].buffer = passTargets[i].currentBytes.data();
+    }
+    External::GetBytesBatch(hProcess, batch);
+
+    /* Only targets whose value drifted (or couldn't be read) are written. */
+    size_t heldCount = 0;
+    pendingWrites.clear();
+    for (size_t i = 0; i < passTargets.size(); ++i)
+    {
+        const Target& target = passTargets[i];
+        if (batch[i].succeeded && std::memcmp(target.currentBytes.data(), target.bytes.data(), target.bytes.size()) == 0)
+        {
+            passStatistics.skippedWriteCount++;
+            heldCount++;
+            continue;
+        }
+
+        pendingWrites.push_back(i);
+    }
+
+    std::sort(pendingWrites.begin(), pendingWrites.end(), [this](size_t a, size_t b) { return passTargets[a].memoryAddress < passTargets[b].memoryAddress; });
+
+    /* Walk the writes in groups of targets that touch the same pages. */
+    size_t first = 0;
+    while (first < pendingWrites.size())
+    {
+        const Target& firstTarget = passTargets[pendingWrites[first]];
+        const uintptr_t groupFirstPage = firstTarget.memoryAddress & ~(kPageSize - 1);
+        uintptr_t groupLastPage = (firstTarget.memoryAddress + firstTarget.bytes.size() - 1) & ~(kPageSize - 1);
+
+        size_t last = first + 1;
+        while (last < pendingWrites.size() && (passTargets[pendingWrites[last]].memoryAddress & ~(kPageSize - 1)) <= groupLastPage)
+        {
+            const Target& target = passTargets[pendingWrites[last]];
+            groupLastPage = std::max<uintptr_t>(groupLastPage, (target.memoryAddress + target.bytes.size() - 1) & ~(kPageSize - 1));
+            ++last;
+        }
+
+        /* Pages are unprotected one at a time, so each keeps (and gets back) its own original protection. */
+        const size_t pageCount = static_cast<size_t>((groupLastPage - groupFirstPage) / kPageSize) + 1;
+        pageProtections.resize(pageCount);
+
+        size_t unprotectedPages = 0;
+        for (; unprotectedPages < pageCount; ++unprotectedPages)
+        {
+            LPVOID page = reinterpret_cast<LPVOID>(groupFirstPage + unprotectedPages * kPageSize);
+            if (backend.ProtectMemory(hProcess, page, kPageSize, PAGE_EXECUTE_READWRITE, &pageProtections[unprotectedPages]) == FALSE)
+                break;
+        }
+        passStatistics.protectionChangeCount += unprotectedPages;
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const Target& target = passTargets[pendingWrites[i]];
+
+            SIZE_T bytesWritten = 0;
+            BOOL ok = unprotectedPages == pageCount
+                      && backend.WriteMemory(hProcess, reinterpret_cast<LPVOID>(target.memoryAddress),
+                                             target.bytes.data(), target.bytes.size(), &bytesWritten);
+
+            if (ok && bytesWritten == target.bytes.size())
+            {
+                passStatistics.writeCount++;
+                heldCount++;
+            }
+            else
+            {
+                passStatistics.failedWriteCount++;
+            }
+        }
+
+        /* Restore the original protection. */
+        for (size_t page = 0; page < unprotectedPages; ++page)
+        {
+            DWORD tmp;
+            backend.ProtectMemory(hProcess, reinterpret_cast<LPVOID>(groupFirstPage + page * kPageSize), kPageSize, pageProtections[page], &tmp);
+        }
+
+        first = last;
+    }
+
+    std::lock_guard<std::mutex> lock(targetsMutex);
+    statistics.tickCount += passStatistics.tickCount;
+    statistics.writeCount += passStatistics.writeCount;
+    statistics.skippedWriteCount += passStatistics.skippedWriteCount;
+    statistics.failedWriteCount += passStatistics.failedWriteCount;
+    statistics.protectionChangeCount += passStatistics.protectionChangeCount;
+    return heldCount;
+}
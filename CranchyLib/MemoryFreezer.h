@@ -0,0 +1,139 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class Freezer
+	{
+		// Description: Keeps ("freezes") values of a 3'rd party process at fixed contents by rewriting them from one background thread.
+		//              Current values are read in one batch and only mismatching targets are written; writes are grouped by page,
+		//              so every page has its protection changed at most once per tick.
+		// Search Tags: #external, #freeze, #lock, #writeprocessmemory, #virtualprotectex.
+	public:
+		using FreezeId = uint32_t;
+		static constexpr FreezeId InvalidFreeze = 0;
+
+
+		/**
+		* @brief Counters accumulated since the freezer was created.
+		* @param tickCount - Number of passes over the target set.
+		* @param writeCount - Targets that had to be rewritten.
+		* @param skippedWriteCount - Targets that already held the frozen value, so no write was issued.
+		* @param failedWriteCount - Targets that couldn't be read or written.
+		* @param protectionChangeCount - Pages whose protection was changed (and restored) to write targets.
+		*/
+		struct FreezeStatistics
+		{
+			uint64_t tickCount			   = 0;
+			uint64_t writeCount			   = 0;
+			uint64_t skippedWriteCount	   = 0;
+			uint64_t failedWriteCount	   = 0;
+			uint64_t protectionChangeCount = 0;
+		};
+
+
+
+
+		Freezer() = default;
+		~Freezer();
+		Freezer(const Freezer&) = delete;
+		Freezer& operator=(const Freezer&) = delete;
+
+
+
+
+		/**
+		* @brief Starts the background thread that rewrites every target once per 'interval'.
+		* @param hProcess - Process HANDLE with PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_VM_OPERATION access; must stay open until Stop().
+		* @param interval - Time between two passes.
+		* @return true if the thread was started; false if the handle is invalid or the freezer is already running.
+		*/
+		bool Start(const HANDLE& hProcess, std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+		void Stop();
+		bool IsRunning() const;
+
+		void SetInterval(std::chrono::milliseconds interval);
+
+
+
+
+		/**
+		* @brief Adds a target that will be kept at 'bytes'.
+		* @return Id of the new target, or 'InvalidFreeze' if the address is null or 'bytes' is empty.
+		*/
+		FreezeId AddFreeze(const uintptr_t& memoryAddress, const std::vector<uint8_t>& bytes);
+
+		template<typename T>
+		FreezeId AddFreeze(const uintptr_t& memoryAddress, const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Frozen values must be trivially copyable.");
+			const uint8_t* valueBytes = reinterpret_cast<const uint8_t*>(&value);
+			return AddFreeze(memoryAddress, std::vector<uint8_t>(valueBytes, valueBytes + sizeof(T)));
+		}
+
+		bool UpdateFreeze(FreezeId freezeId, const std::vector<uint8_t>& bytes);
+		bool RemoveFreeze(FreezeId freezeId);
+		void ClearFreezes();
+
+
+
+
+		/**
+		* @brief Runs one pass over every target on the calling thread. Works whether or not the background thread is running.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @return Number of targets that hold their frozen value after the pass.
+		*/
+		size_t Apply(const HANDLE& hProcess);
+
+		FreezeStatistics GetStatistics() const;
+
+
+
+
+	private:
+		struct Target
+		{
+			FreezeId			 id			   = InvalidFreeze;
+			uintptr_t			 memoryAddress = 0x0;
+			std::vector<uint8_t> bytes;
+			std::vector<uint8_t> currentBytes; // Scratch buffer for the batched read.
+		};
+
+
+		void WorkerLoop();
+		size_t ApplyPass(const HANDLE& hProcess);
+
+
+		HANDLE					 hProcess = nullptr;
+		std::thread				 workerThread;
+		std::atomic<bool>		 running{ false };
+		std::chrono::nanoseconds interval{ std::chrono::milliseconds(10) };
+
+		mutable std::mutex		 targetsMutex;
+		std::condition_variable	 wakeCondition;
+		std::vector<Target>		 targets;
+		FreezeId				 nextFreezeId = 1;
+		FreezeStatistics		 statistics;
+
+		/* Scratch state reused between passes, guarded by 'passMutex'. */
+		std::mutex						 passMutex;
+		std::vector<Target>				 passTargets; // Copy of 'targets' the pass works on, so I/O runs without 'targetsMutex'.
+		std::vector<External::BatchRead> batch;
+		std::vector<size_t>				 pendingWrites;
+		std::vector<DWORD>				 pageProtections;
+	};
+}
@@ -0,0 +1,745 @@
+#include "MemoryImages.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    constexpr size_t   kReadChunkSize = 64 * 1024;
+    constexpr size_t   kPageSize = 0x1000;
+
+    constexpr uint32_t kCodeViewSignature = 0x53445352; // "RSDS"
+    constexpr size_t   kCodeViewIdentitySize = 16 + sizeof(uint32_t); // PDB GUID and age.
+
+
+
+    /* ELF structures, as laid out in little endian files. Both classes name their fields alike, so one template parses either. */
+    constexpr uint8_t  kElfMagic[4] = { 0x7F, 'E', 'L', 'F' };
+    constexpr uint8_t  kElfClass32 = 1;
+    constexpr uint8_t  kElfClass64 = 2;
+    constexpr uint8_t  kElfLittleEndian = 1;
+    constexpr uint32_t kElfProgramLoad = 1;     // PT_LOAD
+    constexpr uint32_t kElfProgramNote = 4;     // PT_NOTE
+    constexpr uint32_t kElfSectionNoBits = 8;   // SHT_NOBITS
+    constexpr uint64_t kElfSectionWrite = 0x1;  // SHF_WRITE
+    constexpr uint64_t kElfSectionAlloc = 0x2;  // SHF_ALLOC
+    constexpr uint64_t kElfSectionExecute = 0x4; // SHF_EXECINSTR
+    constexpr uint32_t kElfNoteBuildId = 3;     // NT_GNU_BUILD_ID
+
+    struct ElfHeader32
+    {
+        uint8_t  e_ident[16];
+        uint16_t e_type, e_machine;
+        uint32_t e_version, e_entry, e_phoff, e_shoff, e_flags;
+        uint16_t e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx;
+    };
+
+    struct ElfHeader64
+    {
+        uint8_t  e_ident[16];
+        uint16_t e_type, e_machine;
+        uint32_t e_version;
+        uint64_t e_entry, e_phoff, e_shoff;
+        uint32_t e_flags;
+        uint16_t e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx;
+    };
+
+    struct ElfProgramHeader32
+    {
+        uint32_t p_type, p_offset, p_vaddr, p_paddr, p_filesz, p_memsz, p_flags, p_align;
+    };
+
+    struct ElfProgramHeader64
+    {
+        uint32_t p_type, p_flags;
+        uint64_t p_offset, p_vaddr, p_paddr, p_filesz, p_memsz, p_align;
+    };
+
+    struct ElfSectionHeader32
+    {
+        uint32_t sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link, sh_info, sh_addralign, sh_entsize;
+    };
+
+    struct ElfSectionHeader64
+    {
+        uint32_t sh_name, sh_type;
+        uint64_t sh_flags, sh_addr, sh_offset, sh_size;
+        uint32_t sh_link, sh_info;
+        uint64_t sh_addralign, sh_entsize;
+    };
+
+
+    /* What ModuleImage keeps of an ELF file; loadable segments use the ImageSection fields for their file and memory placement. */
+    struct ElfLayout
+    {
+        std::vector<MemoryUtilities::ImageSection> sections;
+        std::vector<MemoryUtilities::ImageSection> segments;
+        uint64_t                                   moduleBase  = 0;
+        uint32_t                                   sizeOfImage = 0;
+        uint64_t                                   buildHash   = 0;
+    };
+
+
+
+    /* Reads a 'T' at 'offset' of the image if it lies entirely inside it. */
+    template<typename T>
+    bool LoadImageValue(const uint8_t* image, size_t imageSize, size_t offset, T& outValue)
+    {
+        if (offset > imageSize || imageSize - offset < sizeof(T))
+            return false;
+
+        std::memcpy(&outValue, image + offset, sizeof(T));
+        return true;
+    }
+
+    uint64_t CombineHashes(uint64_t hash, uint64_t value)
+    {
+        return hash ^ (value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+    }
+
+    /* Build ID from the GNU note among the notes at [offset, offset + size). */
+    uint64_t HashElfBuildId(const uint8_t* image, size_t imageSize, uint64_t offset, uint64_t size)
+    {
+        /* Sizes come from the file: each one is checked against what is left before it is rounded up, and the sums are done in
+           64 bits, so none of them can wrap around in 32-bit builds. */
+        if (offset > imageSize)
+            return 0;
+
+        const uint64_t end = offset + std::min<uint64_t>(size, imageSize - offset);
+        while (end - offset >= 3 * sizeof(uint32_t))
+        {
+            uint32_t note[3]; // namesz, descsz, type
+            std::memcpy(note, image + static_cast<size_t>(offset), sizeof(note));
+
+            const uint64_t nameOffset = offset + sizeof(note);
+            if (note[0] > end - nameOffset)
+                break;
+
+            const uint64_t descriptionOffset = nameOffset + ((static_cast<uint64_t>(note[0]) + 3) & ~static_cast<uint64_t>(3));
+            if (descriptionOffset > end || note[1] > end - descriptionOffset)
+                break;
+
+            const uint64_t nextOffset = descriptionOffset + ((static_cast<uint64_t>(note[1]) + 3) & ~static_cast<uint64_t>(3));
+            if (note[2] == kElfNoteBuildId && note[0] == 4 && std::memcmp(image + static_cast<size_t>(nameOffset), "GNU", 4) == 0)
+                return MemoryUtilities::Convertion::Bytes_ToHash64(image + static_cast<size_t>(descriptionOffset), note[1]);
+
+            if (nextOffset >= end)
+                break;
+
+            offset = nextOffset;
+        }
+
+        return 0;
+    }
+
+    template<typename Header, typename ProgramHeader, typename SectionHeader>
+    bool ParseElf(const uint8_t* image, size_t imageSize, ElfLayout& layout)
+    {
+        Header header;
+        if (LoadImageValue(image, imageSize, 0, header) == false || header.e_phentsize < sizeof(ProgramHeader))
+            return false;
+
+        /* Loadable segments place the file in memory; the module base is the page of the lowest one. */
+        std::vector<ProgramHeader> loadSegments;
+        for (size_t i = 0; i < header.e_phnum; ++i)
+        {
+            ProgramHeader programHeader;
+            if (LoadImageValue(image, imageSize, static_cast<size_t>(header.e_phoff) + i * header.e_phentsize, programHeader) == false)
+                return false;
+
+            if (programHeader.p_type == kElfProgramLoad)
+                loadSegments.push_back(programHeader);
+            else if (programHeader.p_type == kElfProgramNote && layout.buildHash == 0)
+                layout.buildHash = HashElfBuildId(image, imageSize, programHeader.p_offset, programHeader.p_filesz);
+        }
+
+        if (loadSegments.empty())
+            return false;
+
+        uint64_t lowestAddress = UINT64_MAX;
+        uint64_t highestAddress = 0;
+        for (const ProgramHeader& segment : loadSegments)
+        {
+            lowestAddress = std::min<uint64_t>(lowestAddress, segment.p_vaddr);
+            highestAddress = std::max<uint64_t>(highestAddress, static_cast<uint64_t>(segment.p_vaddr) + segment.p_memsz);
+        }
+
+        const uint64_t moduleBase = lowestAddress & ~static_cast<uint64_t>(kPageSize - 1);
+        layout.moduleBase = moduleBase;
+        layout.sizeOfImage = static_cast<uint32_t>(highestAddress - moduleBase);
+        for (const ProgramHeader& segment : loadSegments)
+        {
+            MemoryUtilities::ImageSection mapping;
+            mapping.virtualAddress = static_cast<uint32_t>(segment.p_vaddr - moduleBase);
+            mapping.virtualSize = static_cast<uint32_t>(segment.p_memsz);
+            mapping.rawDataOffset = static_cast<uint32_t>(segment.p_offset);
+            mapping.rawDataSize = static_cast<uint32_t>(segment.p_filesz);
+            layout.segments.push_back(mapping);
+        }
+
+
+        /* Sections, for names and to tell code from data. Stripped files may have none, which is fine. */
+        SectionHeader nameTable;
+        const bool hasNameTable = header.e_shentsize >= sizeof(SectionHeader) &&
+            LoadImageValue(image, imageSize, static_cast<size_t>(header.e_shoff) + static_cast<size_t>(header.e_shstrndx) * header.e_shentsize, nameTable);
+
+        for (size_t i = 0; hasNameTable && i < header.e_shnum; ++i)
+        {
+            SectionHeader sectionHeader;
+            if (LoadImageValue(image, imageSize, static_cast<size_t>(header.e_shoff) + i * header.e_shentsize, sectionHeader) == false)
+                break;
+
+            if ((sectionHeader.sh_flags & kElfSectionAlloc) == 0 || sectionHeader.sh_addr < moduleBase)
+                continue;
+
+            MemoryUtilities::ImageSection section;
+            const size_t nameOffset = static_cast<size_t>(nameTable.sh_offset) + sectionHeader.sh_name;
+            if (nameOffset < imageSize && sectionHeader.sh_name < nameTable.sh_size)
+                section.name.assign(reinterpret_cast<const char*>(image + nameOffset), strnlen(reinterpret_cast<const char*>(image + nameOffset), imageSize - nameOffset));
+
+            section.virtualAddress = static_cast<uint32_t>(sectionHeader.sh_addr - moduleBase);
+            section.virtualSize = static_cast<uint32_t>(sectionHeader.sh_size);
+            section.rawDataOffset = static_cast<uint32_t>(sectionHeader.sh_offset);
+            section.rawDataSize = sectionHeader.sh_type != kElfSectionNoBits ? static_cast<uint32_t>(sectionHeader.sh_size) : 0;
+            section.isExecutable = (sectionHeader.sh_flags & kElfSectionExecute) != 0;
+            section.isWritable = (sectionHeader.sh_flags & kElfSectionWrite) != 0;
+            layout.sections.push_back(section);
+        }
+
+        return true;
+    }
+}
+
+
+
+
+
+
+MemoryUtilities::ModuleImage::~ModuleImage()
+{
+    Unload();
+}
+
+
+
+
+bool MemoryUtilities::ModuleImage::LoadInternal(HMODULE hModule)
+{
+    Unload();
+
+    MODULEINFO moduleInfo;
+    if (hModule == nullptr || GetModuleInformation(GetCurrentProcess(), hModule, &moduleInfo, sizeof(moduleInfo)) == FALSE)
+        return false;
+
+    image = reinterpret_cast<const uint8_t*>(moduleInfo.lpBaseOfDll);
+    imageSize = static_cast<size_t>(moduleInfo.SizeOfImage);
+    baseAddress = reinterpret_cast<uintptr_t>(moduleInfo.lpBaseOfDll);
+    layout = E_Layout::Memory;
+    ParseHeaders();
+    return true;
+}
+
+bool MemoryUtilities::ModuleImage::LoadExternal(const HANDLE& hProcess, HMODULE hModule)
+{
+    CRANCHYLIB_TRACE_SCOPE("image", "ModuleImage::LoadExternal", 0);
+
+    Unload();
+
+    MODULEINFO moduleInfo;
+    if (hModule == nullptr || GetModuleInformation(hProcess, hModule, &moduleInfo, sizeof(moduleInfo)) == FALSE)
+        return false;
+
+    const uintptr_t moduleBase = reinterpret_cast<uintptr_t>(moduleInfo.lpBaseOfDll);
+    const size_t moduleSize = static_cast<size_t>(moduleInfo.SizeOfImage);
+    std::vector<uint8_t> buffer(moduleSize, 0x00);
+
+    /* Read in large chunks; a chunk that fails is retried page by page, so one guard page doesn't lose its neighbours. */
+    size_t bytesCopied = 0;
+    for (size_t chunkStart = 0; chunkStart < moduleSize; chunkStart += kReadChunkSize)
+    {
+        const size_t chunkLength = std::min<size_t>(kReadChunkSize, moduleSize - chunkStart);
+
+        SIZE_T bytesRead = 0;
+        if (External::GetBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(moduleBase + chunkStart), buffer.data() + chunkStart, chunkLength, &bytesRead) && bytesRead == chunkLength)
+        {
+            bytesCopied += chunkLength;
+            continue;
+        }
+
+        for (size_t pageStart = chunkStart; pageStart < chunkStart + chunkLength; pageStart += kPageSize)
+        {
+            const size_t pageLength = std::min<size_t>(kPageSize, chunkStart + chunkLength - pageStart);
+            if (External::GetBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(moduleBase + pageStart), buffer.data() + pageStart, pageLength, &bytesRead) && bytesRead == pageLength)
+                bytesCopied += pageLength;
+            else
+                std::memset(buffer.data() + pageStart, 0x00, pageLength);
+        }
+    }
+
+    if (bytesCopied == 0)
+        return false;
+
+    imageCopy = std::move(buffer);
+    image = imageCopy.data();
+    imageSize = imageCopy.size();
+    baseAddress = moduleBase;
+    layout = E_Layout::Memory;
+    ParseHeaders();
+    return true;
+}
+
+bool MemoryUtilities::ModuleImage::LoadBuffer(const uint8_t* data, size_t size, uintptr_t baseAddress, E_Layout layout)
+{
+    Unload();
+
+    if (data == nullptr || size == 0)
+        return false;
+
+    image = data;
+    imageSize = size;
+    this->baseAddress = baseAddress;
+    this->layout = layout;
+    ParseHeaders();
+    return true;
+}
+
+bool MemoryUtilities::ModuleImage::LoadFile(const std::string& filePath, uintptr_t baseAddress)
+{
+    CRANCHYLIB_TRACE_SCOPE("image", "ModuleImage::LoadFile", 0);
+
+    Unload();
+
+    hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(hFile, &fileSize) == FALSE || fileSize.QuadPart <= 0)
+    {
+        Unload();
+        return false;
+    }
+
+    hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (hMapping == nullptr)
+    {
+        Unload();
+        return false;
+    }
+
+    image = static_cast<const uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (image == nullptr)
+    {
+        Unload();
+        return false;
+    }
+
+    imageSize = static_cast<size_t>(fileSize.QuadPart);
+    this->baseAddress = baseAddress;
+    layout = E_Layout::File;
+    ParseHeaders();
+    return true;
+}
+
+bool MemoryUtilities::ModuleImage::LoadFile(const std::wstring& filePath, uintptr_t baseAddress)
+{
+    return LoadFile(std::string(filePath.begin(), filePath.end()), baseAddress);
+}
+
+void MemoryUtilities::ModuleImage::Unload()
+{
+    if (hMapping != nullptr && image != nullptr)
+        UnmapViewOfFile(image);
+
+    if (hMapping != nullptr)
+        CloseHandle(hMapping);
+
+    if (hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(hFile);
+
+    hFile = INVALID_HANDLE_VALUE;
+    hMapping = nullptr;
+    imageCopy.clear();
+    imageCopy.shrink_to_fit();
+    image = nullptr;
+    imageSize = 0;
+    baseAddress = 0x0;
+    layout = E_Layout::Memory;
+    ParseHeaders();
+}
+
+
+
+
+bool MemoryUtilities::ModuleImage::IsLoaded() const
+{
+    return image != nullptr;
+}
+
+MemoryUtilities::ModuleImage::E_Layout MemoryUtilities::ModuleImage::GetLayout() const
+{
+    return layout;
+}
+
+const uint8_t* MemoryUtilities::ModuleImage::GetData() const
+{
+    return image;
+}
+
+size_t MemoryUtilities::ModuleImage::GetSize() const
+{
+    return imageSize;
+}
+
+uintptr_t MemoryUtilities::ModuleImage::GetBaseAddress() const
+{
+    return baseAddress;
+}
+
+
+
+
+bool MemoryUtilities::ModuleImage::HasHeaders() const
+{
+    return hasHeaders;
+}
+
+bool MemoryUtilities::ModuleImage::Is64Bit() const
+{
+    return is64Bit;
+}
+
+uint32_t MemoryUtilities::ModuleImage::GetTimeDateStamp() const
+{
+    return timeDateStamp;
+}
+
+uint32_t MemoryUtilities::ModuleImage::GetSizeOfImage() const
+{
+    return sizeOfImage;
+}
+
+uintptr_t MemoryUtilities::ModuleImage::GetPreferredBaseAddress() const
+{
+    return preferredBase;
+}
+
+const std::vector<MemoryUtilities::ImageSection>& MemoryUtilities::ModuleImage::GetSections() const
+{
+    return sections;
+}
+
+MemoryUtilities::ModuleIdentity MemoryUtilities::ModuleImage::GetIdentity(bool hashCode) const
+{
+    CRANCHYLIB_TRACE_SCOPE("image", "ModuleImage::GetIdentity", imageSize);
+
+    ModuleIdentity identity;
+    identity.timeDateStamp = timeDateStamp;
+    identity.imageSize = sizeOfImage;
+    identity.buildHash = buildHash;
+
+    if (hashCode == false || image == nullptr)
+        return identity;
+
+    /* Sections are hashed one by one and in order, so gaps between them (and whatever data sits there) don't count. Only the
+       bytes present in both the file and memory are hashed: file padding and zero-filled tails differ between the two. */
+    bool hashedSection = false;
+    for (const ImageSection& section : sections)
+    {
+        size_t offset = 0;
+        const size_t sectionSize = std::min<size_t>(section.virtualSize, section.rawDataSize);
+        if (section.isExecutable == false || sectionSize == 0 || RvaToOffset(section.virtualAddress, sectionSize, offset) == false)
+            continue;
+
+        identity.codeHash = CombineHashes(identity.codeHash, Convertion::Bytes_ToHash64(image + offset, sectionSize));
+        hashedSection = true;
+    }
+
+    if (hashedSection == false)
+        identity.codeHash = Convertion::Bytes_ToHash64(image, imageSize);
+
+    return identity;
+}
+
+
+
+
+uint32_t MemoryUtilities::ModuleImage::OffsetToRva(size_t offset) const
+{
+    for (const MappedRange& range : ranges)
+    {
+        if (offset >= range.offset && offset - range.offset < range.size)
+            return range.rva + static_cast<uint32_t>(offset - range.offset);
+    }
+
+    return InvalidRva;
+}
+
+bool MemoryUtilities::ModuleImage::RvaToOffset(uint32_t rva, size_t length, size_t& outOffset) const
+{
+    for (const MappedRange& range : ranges)
+    {
+        if (rva >= range.rva && rva - range.rva <= range.size && range.size - (rva - range.rva) >= length)
+        {
+            outOffset = range.offset + (rva - range.rva);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint32_t MemoryUtilities::ModuleImage::FindPattern(const MaskedPattern& pattern) const
+{
+    if (pattern.values.empty())
+        return InvalidRva;
+
+    /* Ranges are in RVA order, so the first one with a match holds the first match in memory. */
+    for (const MappedRange& range : ranges)
+    {
+        const uintptr_t match = Internal::ScanForMaskedPattern(image + range.offset, range.size, pattern);
+        if (match == 0x0)
+            continue;
+
+        const size_t rangeOffset = match - reinterpret_cast<uintptr_t>(image + range.offset);
+        return rangeOffset < InvalidRva - range.rva ? range.rva + static_cast<uint32_t>(rangeOffset) : InvalidRva;
+    }
+
+    return InvalidRva;
+}
+
+
+
+
+void MemoryUtilities::ModuleImage::ParseHeaders()
+{
+    hasHeaders = false;
+    is64Bit = sizeof(void*) == 8;
+    timeDateStamp = 0;
+    sizeOfImage = static_cast<uint32_t>(std::min<size_t>(imageSize, InvalidRva));
+    preferredBase = 0x0;
+    buildHash = 0;
+    sections.clear();
+    ranges.clear();
+
+    if (image == nullptr)
+        return;
+
+    /* In memory every offset is its own RVA; file layouts get their ranges from the headers. */
+    if (layout == E_Layout::Memory)
+        ranges.push_back({ 0, 0, imageSize });
+
+    ParsePortableExecutable();
+    if (hasHeaders == false && layout == E_Layout::File)
+        ParseExecutableAndLinkable();
+
+    /* Files of unknown formats are taken as they are. */
+    if (hasHeaders == false)
+    {
+        ranges.clear();
+        ranges.push_back({ 0, 0, imageSize });
+    }
+}
+
+void MemoryUtilities::ModuleImage::ParsePortableExecutable()
+{
+    IMAGE_DOS_HEADER dosHeader;
+    if (LoadImageValue(image, imageSize, 0, dosHeader) == false || dosHeader.e_magic != IMAGE_DOS_SIGNATURE || dosHeader.e_lfanew <= 0)
+        return;
+
+    /* Signature and file header are shared by both header formats; the optional header's magic tells them apart. */
+    const size_t ntOffset = static_cast<size_t>(dosHeader.e_lfanew);
+    IMAGE_NT_HEADERS32 ntHeaders32;
+    if (LoadImageValue(image, imageSize, ntOffset, ntHeaders32) == false || ntHeaders32.Signature != IMAGE_NT_SIGNATURE)
+        return;
+
+    IMAGE_DATA_DIRECTORY debugDirectory = {};
+    size_t sizeOfHeaders = 0;
+    if (ntHeaders32.OptionalHeader.Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC)
+    {
+        IMAGE_NT_HEADERS64 ntHeaders64;
+        if (LoadImageValue(image, imageSize, ntOffset, ntHeaders64) == false)
+            return;
+
+        is64Bit = true;
+        sizeOfImage = ntHeaders64.OptionalHeader.SizeOfImage;
+        preferredBase = static_cast<uintptr_t>(ntHeaders64.OptionalHeader.ImageBase);
+        sizeOfHeaders = ntHeaders64.OptionalHeader.SizeOfHeaders;
+        if (ntHeaders64.OptionalHeader.NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_DEBUG)
+            debugDirectory = ntHeaders64.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
+    }
+    else if (ntHeaders32.OptionalHeader.Magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC)
+    {
+        is64Bit = false;
+        sizeOfImage = ntHeaders32.OptionalHeader.SizeOfImage;
+        preferredBase = ntHeaders32.OptionalHeader.ImageBase;
+        sizeOfHeaders = ntHeaders32.OptionalHeader.SizeOfHeaders;
+        if (ntHeaders32.OptionalHeader.NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_DEBUG)
+            debugDirectory = ntHeaders32.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
+    }
+    else
+    {
+        return;
+    }
+
+    hasHeaders = true;
+    timeDateStamp = ntHeaders32.FileHeader.TimeDateStamp;
+
+
+    /* Section table, right after the optional header. On disk, the headers and each section's raw data are the mapped ranges. */
+    if (layout == E_Layout::File)
+        ranges.push_back({ 0, 0, std::min<size_t>(sizeOfHeaders, imageSize) });
+
+    const size_t sectionTableOffset = ntOffset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER) + ntHeaders32.FileHeader.SizeOfOptionalHeader;
+    for (WORD i = 0; i < ntHeaders32.FileHeader.NumberOfSections; ++i)
+    {
+        IMAGE_SECTION_HEADER sectionHeader;
+        if (LoadImageValue(image, imageSize, sectionTableOffset + i * sizeof(sectionHeader), sectionHeader) == false)
+            break;
+
+        ImageSection section;
+        section.name.assign(reinterpret_cast<const char*>(sectionHeader.Name), strnlen(reinterpret_cast<const char*>(sectionHeader.Name), IMAGE_SIZEOF_SHORT_NAME));
+        section.virtualAddress = sectionHeader.VirtualAddress;
+        section.virtualSize = sectionHeader.Misc.VirtualSize != 0 ? sectionHeader.Misc.VirtualSize : sectionHeader.SizeOfRawData;
+        section.rawDataOffset = sectionHeader.PointerToRawData;
+        section.rawDataSize = sectionHeader.SizeOfRawData;
+        section.isExecutable = (sectionHeader.Characteristics & (IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE)) != 0;
+        section.isWritable = (sectionHeader.Characteristics & IMAGE_SCN_MEM_WRITE) != 0;
+        sections.push_back(section);
+
+        const size_t mappedSize = std::min<size_t>(section.rawDataSize, section.virtualSize);
+        if (layout == E_Layout::File && mappedSize != 0 && section.rawDataOffset < imageSize)
+            ranges.push_back({ section.rawDataOffset, section.virtualAddress, std::min<size_t>(mappedSize, imageSize - section.rawDataOffset) });
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](const MappedRange& left, const MappedRange& right) { return left.rva < right.rva; });
+
+
+    /* Build ID: the CodeView record, which the linker fills with the GUID and age of the matching PDB. */
+    size_t debugOffset = 0;
+    const size_t debugEntryCount = debugDirectory.Size / sizeof(IMAGE_DEBUG_DIRECTORY);
+    if (debugDirectory.VirtualAddress == 0 || RvaToOffset(debugDirectory.VirtualAddress, debugEntryCount * sizeof(IMAGE_DEBUG_DIRECTORY), debugOffset) == false)
+        return;
+
+    for (size_t i = 0; i < debugEntryCount; ++i)
+    {
+        IMAGE_DEBUG_DIRECTORY debugEntry;
+        if (LoadImageValue(image, imageSize, debugOffset + i * sizeof(debugEntry), debugEntry) == false)
+            break;
+
+        size_t recordOffset = 0;
+        uint32_t signature = 0;
+        if (debugEntry.Type != IMAGE_DEBUG_TYPE_CODEVIEW || debugEntry.SizeOfData < sizeof(signature) + kCodeViewIdentitySize ||
+            RvaToOffset(debugEntry.AddressOfRawData, sizeof(signature) + kCodeViewIdentitySize, recordOffset) == false)
+            continue;
+
+        std::memcpy(&signature, image + recordOffset, sizeof(signature));
+        if (signature == kCodeViewSignature)
+            buildHash = Convertion::Bytes_ToHash64(image + recordOffset + sizeof(signature), kCodeViewIdentitySize);
+        break;
+    }
+}
+
+void MemoryUtilities::ModuleImage::ParseExecutableAndLinkable()
+{
+    uint8_t identification[6];
+    if (LoadImageValue(image, imageSize, 0, identification) == false || std::memcmp(identification, kElfMagic, sizeof(kElfMagic)) != 0 || identification[5] != kElfLittleEndian)
+        return;
+
+    ElfLayout elfLayout;
+    if (identification[4] == kElfClass64)
+    {
+        if (ParseElf<ElfHeader64, ElfProgramHeader64, ElfSectionHeader64>(image, imageSize, elfLayout) == false)
+            return;
+        is64Bit = true;
+    }
+    else if (identification[4] == kElfClass32)
+    {
+        if (ParseElf<ElfHeader32, ElfProgramHeader32, ElfSectionHeader32>(image, imageSize, elfLayout) == false)
+            return;
+        is64Bit = false;
+    }
+    else
+    {
+        return;
+    }
+
+    hasHeaders = true;
+    sizeOfImage = elfLayout.sizeOfImage;
+    preferredBase = static_cast<uintptr_t>(elfLayout.moduleBase);
+    buildHash = elfLayout.buildHash;
+    sections = std::move(elfLayout.sections);
+
+    for (const ImageSection& segment : elfLayout.segments)
+    {
+        const size_t mappedSize = std::min<size_t>(segment.rawDataSize, segment.virtualSize);
+        if (mappedSize != 0 && segment.rawDataOffset < imageSize)
+            ranges.push_back({ segment.rawDataOffset, segment.virtualAddress, std::min<size_t>(mappedSize, imageSize - segment.rawDataOffset) });
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](const MappedRange& left, const MappedRange& right) { return left.rva < right.rva; });
+}
+
+
+
+
+
+
+std::vector<MemoryUtilities::OfflineScanResult> MemoryUtilities::OfflineScanner::ScanFiles(const std::vector<std::string>& filePaths, const std::vector<std::string>& memoryPatterns)
+{
+    return ScanFiles(filePaths, memoryPatterns, ThreadingUtilities::GetSharedPool());
+}
+
+std::vector<MemoryUtilities::OfflineScanResult> MemoryUtilities::OfflineScanner::ScanFiles(const std::vector<std::string>& filePaths, const std::vector<std::string>& memoryPatterns, ThreadingUtilities::ThreadPool& pool)
+{
+    CRANCHYLIB_TRACE_SCOPE("image", "OfflineScanner::ScanFiles", filePaths.size());
+
+    std::vector<MaskedPattern> patterns;
+    patterns.reserve(memoryPatterns.size());
+    for (const std::string& memoryPattern : memoryPatterns)
+    {
+        patterns.push_back(Convertion::MemoryPattern_ToMaskedPattern(memoryPattern));
+    }
+
+    std::vector<OfflineScanResult> results(filePaths.size());
+    std::vector<std::unique_ptr<ModuleImage>> images(filePaths.size());
+    ThreadingUtilities::TaskGroup group(pool);
+
+    /* Mapping is cheap, hashing a file's code is not: one task per file. */
+    ThreadingUtilities::ParallelFor(group, 0, filePaths.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            results[i].filePath = filePaths[i];
+            images[i] = std::make_unique<ModuleImage>();
+            if (images[i]->LoadFile(filePaths[i]) == false)
+                continue;
+
+            results[i].loaded = true;
+            results[i].identity = images[i]->GetIdentity();
+            results[i].rvas.assign(patterns.size(), ModuleImage::InvalidRva);
+        }
+    });
+
+    /* Every (file, pattern) pair is a scan of its own. */
+    const size_t patternCount = patterns.size();
+    ThreadingUtilities::ParallelFor(group, 0, filePaths.size() * patternCount, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const size_t file = i / patternCount;
+            if (results[file].loaded)
+                results[file].rvas[i % patternCount] = images[file]->FindPattern(patterns[i % patternCount]);
+        }
+    });
+
+    return results;
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MemoryUtilities.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	/**
+	* @brief One section of a module image.
+	* @param name - Section name, e.g. ".text".
+	* @param virtualAddress / virtualSize - Where the section is mapped, relative to the module base (RVA).
+	* @param rawDataOffset / rawDataSize - Where the section's bytes sit in the file on disk.
+	* @param isExecutable - The section holds code.
+	* @param isWritable - The section is writable once loaded; read-only data and code aren't.
+	*/
+	struct ImageSection
+	{
+		std::string name;
+		uint32_t	virtualAddress = 0;
+		uint32_t	virtualSize	   = 0;
+		uint32_t	rawDataOffset  = 0;
+		uint32_t	rawDataSize	   = 0;
+		bool		isExecutable   = false;
+		bool		isWritable	   = false;
+	};
+
+
+	/**
+	* @brief Identifies one build of a module: equal identities mean the same code, so results found in one are valid in the other.
+	*        A module's identity is the same whether its image is taken from memory or from its file on disk.
+	* @param timeDateStamp - Link timestamp from the PE file header; 0 for ELF files and images without headers.
+	* @param imageSize - Size of the image in memory.
+	* @param buildHash - Hash of the build ID: the CodeView record (PDB GUID and age) of a PE, the GNU build ID note of an ELF file;
+	*                    0 if there is none.
+	* @param codeHash - Hash of the bytes of every executable section (of the whole image if it has no headers); 0 if not computed.
+	*/
+	struct ModuleIdentity
+	{
+		uint32_t timeDateStamp = 0;
+		uint32_t imageSize	   = 0;
+		uint64_t buildHash	   = 0;
+		uint64_t codeHash	   = 0;
+
+		bool operator==(const ModuleIdentity& other) const
+		{
+			return timeDateStamp == other.timeDateStamp && imageSize == other.imageSize && buildHash == other.buildHash && codeHash == other.codeHash;
+		}
+		bool operator!=(const ModuleIdentity& other) const
+		{
+			return (*this == other) == false;
+		}
+	};
+
+
+
+
+
+
+	class ModuleImage
+	{
+		// Description: Read-only view of a module's image: one of the current process (used in place), a copy of one loaded in
+		//              a target process, a buffer the caller provides, or an executable file mapped from disk. PE headers - and ELF
+		//              headers, for files - are parsed when present, giving the image's bitness, sections and identity; images
+		//              without headers are treated as one block of code. Files stay in their on-disk layout, and their offsets are
+		//              translated to RVAs through the section (PE) or segment (ELF) headers, so results match those from memory.
+		// Search Tags: #module, #image, #pe, #elf, #sections, #headers, #identity, #hash, #build, #file, #offline, #rva.
+	public:
+		enum class E_Layout
+		{
+			Memory, // As loaded: offsets are RVAs.
+			File	// As on disk: offsets are file offsets.
+		};
+
+
+		/**
+		* @brief RVA reported for file offsets that aren't mapped, and returned when a pattern isn't found.
+		*/
+		static constexpr uint32_t InvalidRva = 0xFFFFFFFF;
+
+
+		ModuleImage() = default;
+		~ModuleImage();
+		ModuleImage(const ModuleImage&) = delete;
+		ModuleImage& operator=(const ModuleImage&) = delete;
+
+
+
+
+		/**
+		* @brief Uses a module of the current process, in place.
+		* @return false if the module's image can't be located.
+		*/
+		bool LoadInternal(HMODULE hModule);
+		/**
+		* @brief Copies the image of a module loaded in a target process. Pages that can't be read are left zeroed.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @return false if the module's image can't be located or nothing of it can be read.
+		*/
+		bool LoadExternal(const HANDLE& hProcess, HMODULE hModule);
+		/**
+		* @brief Uses an image the caller keeps in memory. 'data' must outlive the ModuleImage.
+		* @param baseAddress - Address reported for data[0]; for E_Layout::File, the address the module would be loaded at.
+		* @param layout - Whether 'data' is laid out as in memory or as on disk.
+		*/
+		bool LoadBuffer(const uint8_t* data, size_t size, uintptr_t baseAddress, E_Layout layout = E_Layout::Memory);
+		/**
+		* @brief Maps a PE or ELF file read-only, without running or loading it.
+		* @param baseAddress - Address the module would be loaded at; only used to turn RVAs into addresses.
+		* @return false if the file can't be opened or mapped.
+		*/
+		bool LoadFile(const std::string& filePath, uintptr_t baseAddress = 0x0);
+		bool LoadFile(const std::wstring& filePath, uintptr_t baseAddress = 0x0);
+		void Unload();
+
+		bool		   IsLoaded() const;
+		E_Layout	   GetLayout() const;
+		const uint8_t* GetData() const;
+		size_t		   GetSize() const;
+		uintptr_t	   GetBaseAddress() const;
+
+
+
+
+		/**
+		* @return true if the image starts with valid PE or ELF headers.
+		*/
+		bool							 HasHeaders() const;
+		/**
+		* @return true for PE32+ and ELF64 images; for images without headers, whether the current process is 64-bit.
+		*/
+		bool							 Is64Bit() const;
+		uint32_t						 GetTimeDateStamp() const;
+		/**
+		* @return Size of the image once loaded (SizeOfImage, or the span of the ELF segments); the data size for images without headers.
+		*/
+		uint32_t						 GetSizeOfImage() const;
+		/**
+		* @return Address the module was linked for (PE ImageBase, lowest ELF segment page; 0x0 for position-independent ELF files
+		*         and images without headers). Absolute addresses in a file image, which isn't relocated, are relative to it.
+		*/
+		uintptr_t						 GetPreferredBaseAddress() const;
+		const std::vector<ImageSection>& GetSections() const;
+
+		/**
+		* @brief Computes the image's identity.
+		* @param hashCode - Hash the executable sections, which costs a pass over them (milliseconds for large modules) but tells
+		*                   apart images patched on disk or in memory. Without it 'codeHash' is 0. Code holding absolute addresses
+		*                   (mostly x86) hashes differently whenever the module is relocated to another base.
+		*/
+		ModuleIdentity					 GetIdentity(bool hashCode = true) const;
+
+
+
+
+		/**
+		* @brief Translates between RVAs and offsets into GetData().
+		* @return 'InvalidRva' / false if the location isn't part of a mapped range of the image (e.g. uninitialized data of a file image).
+		*/
+		uint32_t OffsetToRva(size_t offset) const;
+		bool	 RvaToOffset(uint32_t rva, size_t length, size_t& outOffset) const;
+
+		/**
+		* @brief Finds the first match of a pattern in the image, in RVA order.
+		* @return RVA of the match, which is what GetBaseAddress() + RVA would be in memory, or 'InvalidRva' if there is none.
+		*         File images are scanned range by range, so a match spanning two sections isn't found there.
+		*/
+		uint32_t FindPattern(const MaskedPattern& pattern) const;
+
+
+
+
+	private:
+		/* Bytes of the image at [offset, offset + size) are mapped at [rva, rva + size). */
+		struct MappedRange
+		{
+			size_t	 offset = 0;
+			uint32_t rva	= 0;
+			size_t	 size	= 0;
+		};
+
+
+		void ParseHeaders();
+		void ParsePortableExecutable();
+		void ParseExecutableAndLinkable();
+
+
+		std::vector<uint8_t>	  imageCopy; // Backs 'image' for LoadExternal().
+		HANDLE					  hFile			= INVALID_HANDLE_VALUE; // Back 'image' for LoadFile().
+		HANDLE					  hMapping		= nullptr;
+		const uint8_t*			  image			= nullptr;
+		size_t					  imageSize		= 0;
+		uintptr_t				  baseAddress	= 0x0;
+		E_Layout				  layout		= E_Layout::Memory;
+
+		bool					  hasHeaders	= false;
+		bool					  is64Bit		= sizeof(void*) == 8;
+		uint32_t				  timeDateStamp = 0;
+		uint32_t				  sizeOfImage	= 0;
+		uintptr_t				  preferredBase = 0x0;
+		uint64_t				  buildHash		= 0;
+		std::vector<ImageSection> sections;
+		std::vector<MappedRange>  ranges; // Sorted by RVA.
+	};
+
+
+
+
+
+
+	/**
+	* @brief Result of resolving a signature set against one file.
+	* @param filePath - File that was scanned.
+	* @param loaded - The file could be mapped; everything below is empty otherwise.
+	* @param identity - Identity of the module in the file, as ModuleImage::GetIdentity() computes it.
+	* @param rvas - One RVA per pattern, in the same order; ModuleImage::InvalidRva for patterns without a match.
+	*/
+	struct OfflineScanResult
+	{
+		std::string			  filePath;
+		bool				  loaded = false;
+		ModuleIdentity		  identity;
+		std::vector<uint32_t> rvas;
+	};
+
+
+
+	class OfflineScanner
+	{
+		// Description: Resolves a signature set against executable files on disk - archived builds of a target, say - without
+		//              running them. Files are mapped read-only and every (file, pattern) pair is scanned as its own task, so a
+		//              handful of large files and many small ones both keep the pool busy. Results are module-relative, as with
+		//              ModuleImage::FindPattern(), and can be compared against what the same signatures give in a running process.
+		// Search Tags: #offline, #file, #disk, #pe, #elf, #signature, #scan, #builds, #ci, #health.
+	public:
+		/**
+		* @param filePaths - PE or ELF files to scan.
+		* @param memoryPatterns - Patterns in the Convertion::MemoryPattern_ToMaskedPattern() format.
+		* @return One result per file, in the same order.
+		*/
+		static std::vector<OfflineScanResult> ScanFiles(const std::vector<std::string>& filePaths, const std::vector<std::string>& memoryPatterns);
+		static std::vector<OfflineScanResult> ScanFiles(const std::vector<std::string>& filePaths, const std::vector<std::string>& memoryPatterns, ThreadingUtilities::ThreadPool& pool);
+	};
+}
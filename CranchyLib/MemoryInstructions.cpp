@@ -0,0 +1,468 @@
+#include "MemoryInstructions.h"
+
+
+
+
+
+
+namespace
+{
+    /* Operand that follows the ModRM / SIB / displacement bytes. */
+    enum class E_Immediate
+    {
+        None,
+        Byte,             // ib
+        Word,             // iw
+        WordByte,         // iw ib (ENTER)
+        OperandSized,     // iz: 2 bytes with an operand size prefix, 4 otherwise
+        FullOperandSized, // iv: like iz, but 8 bytes with REX.W (MOV r64, imm64)
+        Relative8,        // rel8
+        RelativeSized,    // rel16 / rel32
+        MemoryOffset,     // moffs, sized by the address size
+        FarPointer,       // ptr16:16 / ptr16:32
+    };
+
+
+    struct Operands
+    {
+        bool        hasModRM = false;
+        E_Immediate immediate = E_Immediate::None;
+    };
+
+
+    bool IsLegacyPrefix(uint8_t value)
+    {
+        switch (value)
+        {
+        case 0xF0: case 0xF2: case 0xF3:
+        case 0x2E: case 0x36: case 0x3E: case 0x26: case 0x64: case 0x65:
+        case 0x66: case 0x67:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /* One-byte opcode map. F6 / F7 only get their immediate once the ModRM byte is known. */
+    bool GetOneByteOperands(uint8_t opcode, bool is64Bit, Operands& operands)
+    {
+        if (opcode < 0x40)
+        {
+            switch (opcode & 0x07)
+            {
+            case 0: case 1: case 2: case 3: // ALU r/m, r and r, r/m
+                operands.hasModRM = true;
+                return true;
+            case 4:
+                operands.immediate = E_Immediate::Byte;
+                return true;
+            case 5:
+                operands.immediate = E_Immediate::OperandSized;
+                return true;
+            default: // PUSH / POP of segment registers and the BCD adjustments, gone in x64.
+                return is64Bit == false;
+            }
+        }
+
+        if (opcode >= 0x40 && opcode <= 0x5F) // INC / DEC (x86 only, REX in x64), PUSH / POP
+            return true;
+        if (opcode >= 0x70 && opcode <= 0x7F) // Jcc rel8
+        {
+            operands.immediate = E_Immediate::Relative8;
+            return true;
+        }
+        if (opcode >= 0x84 && opcode <= 0x8F) // TEST, XCHG, MOV, LEA, POP r/m
+        {
+            operands.hasModRM = true;
+            return true;
+        }
+        if (opcode >= 0x90 && opcode <= 0x99)
+            return true;
+        if (opcode >= 0xB0 && opcode <= 0xB7)
+        {
+            operands.immediate = E_Immediate::Byte;
+            return true;
+        }
+        if (opcode >= 0xB8 && opcode <= 0xBF)
+        {
+            operands.immediate = E_Immediate::FullOperandSized;
+            return true;
+        }
+        if (opcode >= 0xD8 && opcode <= 0xDF) // x87
+        {
+            operands.hasModRM = true;
+            return true;
+        }
+
+        switch (opcode)
+        {
+        case 0x60: case 0x61: case 0x9A: case 0xCE: case 0xD4: case 0xD5: case 0xD6: case 0xEA: case 0x82:
+            if (is64Bit)
+                return false;
+
+            if (opcode == 0x9A || opcode == 0xEA)
+                operands.immediate = E_Immediate::FarPointer;
+            else if (opcode == 0xD4 || opcode == 0xD5)
+                operands.immediate = E_Immediate::Byte;
+            else if (opcode == 0x82)
+                operands = { true, E_Immediate::Byte };
+            return true;
+
+        case 0x62: case 0x63: case 0xC4: case 0xC5: // BOUND, ARPL / MOVSXD, LES, LDS (VEX / EVEX are handled before)
+        case 0xD0: case 0xD1: case 0xD2: case 0xD3:
+        case 0xF6: case 0xF7: case 0xFE: case 0xFF:
+            operands.hasModRM = true;
+            return true;
+
+        case 0x68: case 0xA9:
+            operands.immediate = E_Immediate::OperandSized;
+            return true;
+        case 0x6A: case 0xA8: case 0xCD: case 0xE4: case 0xE5: case 0xE6: case 0xE7:
+            operands.immediate = E_Immediate::Byte;
+            return true;
+        case 0x69: case 0x81: case 0xC7:
+            operands = { true, E_Immediate::OperandSized };
+            return true;
+        case 0x6B: case 0x80: case 0x83: case 0xC0: case 0xC1: case 0xC6:
+            operands = { true, E_Immediate::Byte };
+            return true;
+
+        case 0xA0: case 0xA1: case 0xA2: case 0xA3:
+            operands.immediate = E_Immediate::MemoryOffset;
+            return true;
+        case 0xC2: case 0xCA:
+            operands.immediate = E_Immediate::Word;
+            return true;
+        case 0xC8:
+            operands.immediate = E_Immediate::WordByte;
+            return true;
+        case 0xE0: case 0xE1: case 0xE2: case 0xE3: case 0xEB:
+            operands.immediate = E_Immediate::Relative8;
+            return true;
+        case 0xE8: case 0xE9:
+            operands.immediate = E_Immediate::RelativeSized;
+            return true;
+
+        case 0x6C: case 0x6D: case 0x6E: case 0x6F:
+        case 0x9B: case 0x9C: case 0x9D: case 0x9E: case 0x9F:
+        case 0xA4: case 0xA5: case 0xA6: case 0xA7: case 0xAA: case 0xAB: case 0xAC: case 0xAD: case 0xAE: case 0xAF:
+        case 0xC3: case 0xC9: case 0xCB: case 0xCC: case 0xCF: case 0xD7:
+        case 0xEC: case 0xED: case 0xEE: case 0xEF:
+        case 0xF1: case 0xF4: case 0xF5: case 0xF8: case 0xF9: case 0xFA: case 0xFB: case 0xFC: case 0xFD:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    /* Two-byte opcode map (0F xx). */
+    bool GetTwoByteOperands(uint8_t opcode, Operands& operands)
+    {
+        if (opcode >= 0x80 && opcode <= 0x8F) // Jcc rel32
+        {
+            operands.immediate = E_Immediate::RelativeSized;
+            return true;
+        }
+        if ((opcode >= 0x30 && opcode <= 0x37) || (opcode >= 0xC8 && opcode <= 0xCF)) // WRMSR..GETSEC, BSWAP
+            return true;
+
+        switch (opcode)
+        {
+        case 0x04: case 0x0A: case 0x0C: case 0x24: case 0x25: case 0x26: case 0x27: case 0x36:
+            return false;
+
+        case 0x05: case 0x06: case 0x07: case 0x08: case 0x09: case 0x0B: case 0x0E:
+        case 0x77: case 0xA0: case 0xA1: case 0xA2: case 0xA8: case 0xA9: case 0xAA:
+            return true;
+
+        case 0x0F: // 3DNow!, whose opcode comes as a trailing byte
+        case 0x70: case 0x71: case 0x72: case 0x73: case 0xA4: case 0xAC: case 0xBA:
+        case 0xC2: case 0xC4: case 0xC5: case 0xC6:
+            operands = { true, E_Immediate::Byte };
+            return true;
+
+        default:
+            operands.hasModRM = true;
+            return true;
+        }
+    }
+
+    /* Little endian operand of 'size' bytes (up to 8), sign-extended when 'isSigned'. */
+    uint64_t ReadOperand(const uint8_t* code, size_t size, bool isSigned)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            value |= static_cast<uint64_t>(code[i]) << (i * 8);
+        }
+
+        if (isSigned && size < sizeof(value) && (code[size - 1] & 0x80) != 0)
+            value |= ~0ULL << (size * 8);
+
+        return value;
+    }
+
+    /* Opcodes of VEX / EVEX map 1 taking an imm8, the same as their legacy 0F forms. */
+    bool HasVectorImmediate(uint8_t opcodeMap, uint8_t opcode)
+    {
+        if (opcodeMap == 3)
+            return true;
+
+        return opcodeMap == 1 && ((opcode >= 0x70 && opcode <= 0x73) || opcode == 0xC2 || (opcode >= 0xC4 && opcode <= 0xC6));
+    }
+}
+
+
+
+
+
+
+bool MemoryUtilities::InstructionDecoder::Decode(const uint8_t* code, size_t size, bool is64Bit, DecodedInstruction& instruction)
+{
+    instruction = DecodedInstruction();
+    size = size < MaximumInstructionLength ? size : MaximumInstructionLength;
+
+    size_t offset = 0;
+    bool operandSizeOverride = false;
+    bool addressSizeOverride = false;
+    bool rexW = false;
+
+    /* Legacy and REX prefixes; a REX that isn't right before the opcode is ignored by the CPU, so only the last one counts. */
+    while (offset < size)
+    {
+        if (is64Bit && (code[offset] & 0xF0) == 0x40)
+        {
+            rexW = (code[offset] & 0x08) != 0;
+        }
+        else if (IsLegacyPrefix(code[offset]))
+        {
+            operandSizeOverride |= code[offset] == 0x66;
+            addressSizeOverride |= code[offset] == 0x67;
+            rexW = false;
+        }
+        else
+        {
+            break;
+        }
+
+        ++offset;
+    }
+
+    if (offset >= size)
+        return false;
+
+    Operands operands;
+    uint8_t opcode = code[offset++];
+    uint8_t opcodeMap = 0;
+
+    /* C4 / C5 / 62 are LES / LDS / BOUND in x86 unless the next byte has ModRM.mod == 11, which those can't encode. */
+    const bool vectorPrefix = (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62) && offset < size && (is64Bit || (code[offset] & 0xC0) == 0xC0);
+    if (vectorPrefix)
+    {
+        const uint8_t prefix = opcode;
+        const size_t payloadSize = prefix == 0xC5 ? 1 : prefix == 0xC4 ? 2 : 3;
+        if (offset + payloadSize >= size)
+            return false;
+
+        if (prefix == 0xC5)
+            opcodeMap = 1;
+        else if (prefix == 0xC4)
+            opcodeMap = code[offset] & 0x1F;
+        else
+            opcodeMap = code[offset] & 0x07;
+
+        if (prefix != 0xC5 && (code[offset + 1] & 0x80) != 0) // VEX.W / EVEX.W
+            rexW = true;
+
+        offset += payloadSize;
+        opcode = code[offset++];
+
+        /* VEX selects maps 1 to 3; EVEX adds 5 and 6. */
+        if (opcodeMap == 0 || opcodeMap == 4 || opcodeMap > 6 || (prefix == 0xC4 && opcodeMap > 3))
+            return false;
+
+        operands.hasModRM = (opcodeMap == 1 && opcode == 0x77) == false; // VZEROUPPER / VZEROALL
+        operands.immediate = HasVectorImmediate(opcodeMap, opcode) ? E_Immediate::Byte : E_Immediate::None;
+    }
+    else if (opcode == 0x0F)
+    {
+        if (offset >= size)
+            return false;
+
+        opcode = code[offset++];
+        opcodeMap = 1;
+
+        if (opcode == 0x38 || opcode == 0x3A)
+        {
+            if (offset >= size)
+                return false;
+
+            opcodeMap = opcode == 0x38 ? 2 : 3;
+            opcode = code[offset++];
+            operands = { true, opcodeMap == 3 ? E_Immediate::Byte : E_Immediate::None };
+        }
+        else if (GetTwoByteOperands(opcode, operands) == false)
+        {
+            return false;
+        }
+    }
+    else if (GetOneByteOperands(opcode, is64Bit, operands) == false)
+    {
+        return false;
+    }
+
+    instruction.opcode = opcode;
+    instruction.opcodeMap = opcodeMap;
+
+    /* ModRM, SIB and displacement. */
+    if (operands.hasModRM)
+    {
+        if (offset >= size)
+            return false;
+
+        const uint8_t modRM = code[offset++];
+        const uint8_t mod = modRM >> 6;
+        const uint8_t reg = (modRM >> 3) & 0x07;
+        const uint8_t rm = modRM & 0x07;
+
+        instruction.hasModRM = true;
+        instruction.modRM = modRM;
+
+        /* TEST r/m, imm is the only group member of F6 / F7 with an immediate. */
+        if (opcodeMap == 0 && (opcode == 0xF6 || opcode == 0xF7) && reg <= 1)
+            operands.immediate = opcode == 0xF6 ? E_Immediate::Byte : E_Immediate::OperandSized;
+
+        /* MOV to / from control and debug registers always take the register form, whatever ModRM.mod says. */
+        const bool registerOnly = opcodeMap == 1 && opcode >= 0x20 && opcode <= 0x23;
+
+        size_t displacementSize = 0;
+        if (mod != 3 && registerOnly == false)
+        {
+            if (is64Bit == false && addressSizeOverride) // 16-bit addressing has no SIB
+            {
+                if (mod == 1)
+                    displacementSize = 1;
+                else if (mod == 2 || (mod == 0 && rm == 6))
+                    displacementSize = 2;
+
+                instruction.isAbsoluteAddress = mod == 0 && rm == 6;
+            }
+            else
+            {
+                if (rm == 4)
+                {
+                    if (offset >= size)
+                        return false;
+
+                    const uint8_t sib = code[offset++];
+                    if ((sib & 0x07) == 5 && mod == 0)
+                        displacementSize = 4;
+                }
+
+                if (mod == 1)
+                {
+                    displacementSize = 1;
+                }
+                else if (mod == 2)
+                {
+                    displacementSize = 4;
+                }
+                else if (rm == 5)
+                {
+                    displacementSize = 4;
+                    instruction.isRipRelative = is64Bit;
+                    instruction.isAbsoluteAddress = is64Bit == false;
+                }
+            }
+        }
+
+        if (displacementSize != 0)
+        {
+            instruction.displacementOffset = offset;
+            instruction.displacementSize = displacementSize;
+            offset += displacementSize;
+        }
+    }
+
+    /* Immediate. */
+    size_t immediateSize = 0;
+    switch (operands.immediate)
+    {
+    case E_Immediate::None:
+        break;
+    case E_Immediate::Byte:
+    case E_Immediate::Relative8:
+        immediateSize = 1;
+        break;
+    case E_Immediate::Word:
+        immediateSize = 2;
+        break;
+    case E_Immediate::WordByte:
+        immediateSize = 3;
+        break;
+    case E_Immediate::OperandSized:
+        immediateSize = operandSizeOverride ? 2 : 4;
+        break;
+    case E_Immediate::FullOperandSized:
+        immediateSize = rexW ? 8 : operandSizeOverride ? 2 : 4;
+        break;
+    case E_Immediate::RelativeSized: // x64 branches ignore the operand size prefix
+        immediateSize = operandSizeOverride && is64Bit == false ? 2 : 4;
+        break;
+    case E_Immediate::MemoryOffset:
+        immediateSize = is64Bit ? (addressSizeOverride ? 4 : 8) : (addressSizeOverride ? 2 : 4);
+        instruction.isAbsoluteAddress = true;
+        break;
+    case E_Immediate::FarPointer:
+        immediateSize = operandSizeOverride ? 4 : 6;
+        break;
+    }
+
+    if (immediateSize != 0)
+    {
+        instruction.immediateOffset = offset;
+        instruction.immediateSize = immediateSize;
+        instruction.isRelative = operands.immediate == E_Immediate::Relative8 || operands.immediate == E_Immediate::RelativeSized;
+        offset += immediateSize;
+    }
+
+    if (offset > size)
+        return false;
+
+    instruction.length = offset;
+    return true;
+}
+
+bool MemoryUtilities::InstructionDecoder::GetReferencedAddress(const uint8_t* code, const DecodedInstruction& instruction, uintptr_t instructionAddress, uintptr_t& outAddress)
+{
+    const uintptr_t nextAddress = instructionAddress + instruction.length;
+
+    if (instruction.isRipRelative && instruction.displacementSize != 0)
+    {
+        outAddress = nextAddress + static_cast<uintptr_t>(ReadOperand(code + instruction.displacementOffset, instruction.displacementSize, true));
+        return true;
+    }
+
+    /* Branches only take a relative immediate; far pointers and ENTER's pair of immediates never count as one. */
+    if (instruction.isRelative && instruction.immediateSize != 0)
+    {
+        outAddress = nextAddress + static_cast<uintptr_t>(ReadOperand(code + instruction.immediateOffset, instruction.immediateSize, true));
+        return true;
+    }
+
+    /* [disp32] (or [disp16]) comes with ModRM; moffs is the immediate of the A0 - A3 MOVs. */
+    if (instruction.isAbsoluteAddress)
+    {
+        if (instruction.displacementSize != 0)
+            outAddress = static_cast<uintptr_t>(ReadOperand(code + instruction.displacementOffset, instruction.displacementSize, false));
+        else if (instruction.immediateSize != 0)
+            outAddress = static_cast<uintptr_t>(ReadOperand(code + instruction.immediateOffset, instruction.immediateSize, false));
+        else
+            return false;
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	/**
+	* @brief Layout of one x86 / x64 instruction as found by InstructionDecoder::Decode(): where its parts sit, not what it does.
+	* @param length - Instruction length in bytes, prefixes included.
+	* @param opcode - Last opcode byte, after any prefixes and escape bytes.
+	* @param opcodeMap - 0 for the one-byte map, 1 for 0F, 2 for 0F 38, 3 for 0F 3A; VEX / EVEX encodings report the map they select.
+	* @param modRM - ModRM byte, when 'hasModRM'.
+	* @param displacementOffset / displacementSize - Memory operand displacement; size 0 if there is none.
+	* @param immediateOffset / immediateSize - Immediate operand, branch displacement or memory offset (moffs); size 0 if there is none.
+	* @param isRelative - The immediate is a branch displacement, relative to the end of the instruction.
+	* @param isRipRelative - The displacement is relative to the end of the instruction (x64 [rip + disp32]).
+	* @param isAbsoluteAddress - The displacement (x86 [disp32]) or immediate (moffs) is an absolute address.
+	*/
+	struct DecodedInstruction
+	{
+		size_t	length			   = 0;
+		uint8_t opcode			   = 0x00;
+		uint8_t opcodeMap		   = 0;
+		uint8_t modRM			   = 0x00;
+		bool	hasModRM		   = false;
+
+		size_t	displacementOffset = 0;
+		size_t	displacementSize   = 0;
+		size_t	immediateOffset	   = 0;
+		size_t	immediateSize	   = 0;
+
+		bool	isRelative		   = false;
+		bool	isRipRelative	   = false;
+		bool	isAbsoluteAddress  = false;
+	};
+
+
+
+
+
+
+	class InstructionDecoder
+	{
+		// Description: Length decoder for x86 and x64 machine code. Walks prefixes (legacy, REX, VEX, EVEX), the one-byte, 0F, 0F 38
+		//              and 0F 3A opcode maps, ModRM / SIB and operand sizes, which is enough to step through an instruction stream and
+		//              to tell which bytes are addresses or constants - without naming a single mnemonic.
+		// Search Tags: #x86, #x64, #amd64, #disassembler, #length, #decoder, #instruction, #opcode, #modrm, #operands.
+	public:
+		static constexpr size_t MaximumInstructionLength = 15;
+
+
+		/**
+		* @brief Decodes the instruction at the start of 'code'.
+		* @param code - Machine code to decode.
+		* @param size - Bytes available at 'code'; decoding never reads past them.
+		* @param is64Bit - Decode as x64 (REX prefixes, RIP-relative addressing) rather than x86.
+		* @param instruction - Receives the instruction layout.
+		* @return false if the bytes are not a valid instruction in the given mode, or are cut off by 'size'.
+		*/
+		static bool Decode(const uint8_t* code, size_t size, bool is64Bit, DecodedInstruction& instruction);
+		/**
+		* @brief Computes the address a decoded instruction refers to: the target of a relative branch, or the address of a
+		*        RIP-relative or absolute memory operand.
+		* @param code - Bytes of the instruction, as passed to Decode().
+		* @param instruction - Layout Decode() returned for them.
+		* @param instructionAddress - Where the instruction is (or would be) in memory; relative operands count from its end.
+		* @param outAddress - Receives the address.
+		* @return false if the instruction refers to no fixed address, e.g. its memory operand is based on a register.
+		*/
+		static bool GetReferencedAddress(const uint8_t* code, const DecodedInstruction& instruction, uintptr_t instructionAddress, uintptr_t& outAddress);
+	};
+}
@@ -0,0 +1,430 @@
+#include "MemoryInstrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+
+
+
+
+
+namespace
+{
+    const size_t kCounterCount	 = static_cast<size_t>(MemoryUtilities::E_InstrumentationCounter::Count);
+    const size_t kOperationCount = static_cast<size_t>(MemoryUtilities::E_InstrumentedOperation::Count);
+
+#if CRANCHYLIB_INSTRUMENTATION
+    /* Only the owning thread writes to a slot, so updates are a relaxed load and store instead of a locked read-modify-write. */
+    struct AtomicHistogram
+    {
+        std::array<std::atomic<uint64_t>, MemoryUtilities::LatencyHistogram::kBucketCount> buckets;
+        std::atomic<uint64_t>															  count;
+        std::atomic<uint64_t>															  totalNanoseconds;
+        std::atomic<uint64_t>															  minimum;
+        std::atomic<uint64_t>															  maximum;
+    };
+
+    struct ThreadSlot
+    {
+        std::array<std::atomic<uint64_t>, kCounterCount> counters;
+        std::array<AtomicHistogram, kOperationCount>	 histograms;
+    };
+
+    struct SlotRegistry
+    {
+        std::mutex							  registryMutex;
+        std::vector<ThreadSlot*>			  liveSlots;
+        MemoryUtilities::InstrumentationSnapshot retiredTotals; // Everything recorded by threads that already exited.
+    };
+
+
+    /* Never destroyed: threads may still exit (and retire their slots) while static destructors run. */
+    SlotRegistry& GetRegistry()
+    {
+        static SlotRegistry* registry = new SlotRegistry();
+        return *registry;
+    }
+
+
+    void Increase(std::atomic<uint64_t>& value, uint64_t amount)
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void AccumulateSlot(const ThreadSlot& slot, MemoryUtilities::InstrumentationSnapshot& snapshot)
+    {
+        for (size_t i = 0; i < kCounterCount; ++i)
+        {
+            snapshot.counters[i] += slot.counters[i].load(std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < kOperationCount; ++i)
+        {
+            const AtomicHistogram& source = slot.histograms[i];
+
+            MemoryUtilities::LatencyHistogram histogram;
+            histogram.count = source.count.load(std::memory_order_relaxed);
+            if (histogram.count == 0)
+                continue;
+
+            histogram.totalNanoseconds = source.totalNanoseconds.load(std::memory_order_relaxed);
+            histogram.minimum = source.minimum.load(std::memory_order_relaxed);
+            histogram.maximum = source.maximum.load(std::memory_order_relaxed);
+            for (size_t bucket = 0; bucket < histogram.buckets.size(); ++bucket)
+            {
+                histogram.buckets[bucket] = source.buckets[bucket].load(std::memory_order_relaxed);
+            }
+
+            snapshot.latencies[i].Merge(histogram);
+        }
+    }
+
+    void ClearSlot(ThreadSlot& slot)
+    {
+        for (std::atomic<uint64_t>& counter : slot.counters)
+        {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        for (AtomicHistogram& histogram : slot.histograms)
+        {
+            for (std::atomic<uint64_t>& bucket : histogram.buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.totalNanoseconds.store(0, std::memory_order_relaxed);
+            histogram.minimum.store(0, std::memory_order_relaxed);
+            histogram.maximum.store(0, std::memory_order_relaxed);
+        }
+    }
+
+
+    /* Registers the calling thread's slot on first use and retires it when the thread exits. */
+    class SlotOwner
+    {
+    public:
+        SlotOwner() : slot(new ThreadSlot())
+        {
+            ClearSlot(*slot);
+
+            SlotRegistry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.registryMutex);
+            registry.liveSlots.push_back(slot);
+        }
+
+        ~SlotOwner()
+        {
+            SlotRegistry& registry = GetRegistry();
+            {
+                std::lock_guard<std::mutex> lock(registry.registryMutex);
+                AccumulateSlot(*slot, registry.retiredTotals);
+                registry.liveSlots.erase(std::remove(registry.liveSlots.begin(), registry.liveSlots.end(), slot), registry.liveSlots.end());
+            }
+
+            delete slot;
+        }
+
+        ThreadSlot* slot;
+    };
+
+
+    ThreadSlot& GetThreadSlot()
+    {
+        thread_local SlotOwner owner;
+        return *owner.slot;
+    }
+#endif
+}
+
+
+
+
+
+
+size_t MemoryUtilities::LatencyHistogram::BucketIndex(uint64_t nanoseconds)
+{
+    if (nanoseconds < kSubBucketCount)
+        return static_cast<size_t>(nanoseconds);
+
+    /* Position of the highest set bit, by binary search so no compiler specific intrinsic is needed. */
+    size_t highestBit = 0;
+    for (size_t step = 32; step > 0; step >>= 1)
+    {
+        if ((nanoseconds >> (highestBit + step)) != 0)
+            highestBit += step;
+    }
+
+    const size_t shift = highestBit - kSubBucketBits;
+    const size_t subBucket = static_cast<size_t>(nanoseconds >> shift) & (kSubBucketCount - 1);
+    return (shift + 1) * kSubBucketCount + subBucket;
+}
+
+uint64_t MemoryUtilities::LatencyHistogram::BucketLowerBound(size_t index)
+{
+    if (index < kSubBucketCount)
+        return index;
+
+    const size_t shift = index / kSubBucketCount - 1;
+    return static_cast<uint64_t>(kSubBucketCount + index % kSubBucketCount) << shift;
+}
+
+uint64_t MemoryUtilities::LatencyHistogram::BucketUpperBound(size_t index)
+{
+    if (index < kSubBucketCount)
+        return index;
+
+    const size_t shift = index / kSubBucketCount - 1;
+    return BucketLowerBound(index) + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+
+
+
+uint64_t MemoryUtilities::LatencyHistogram::GetPercentile(double percentile) const
+{
+    if (count == 0)
+        return 0;
+
+    const double clampedPercentile = std::min<double>(100.0, std::max<double>(0.0, percentile));
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clampedPercentile / 100.0 * static_cast<double>(count) + 0.5));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::min<uint64_t>(BucketUpperBound(i), maximum);
+    }
+
+    return maximum;
+}
+
+double MemoryUtilities::LatencyHistogram::GetMean() const
+{
+    return count != 0 ? static_cast<double>(totalNanoseconds) / static_cast<double>(count) : 0.0;
+}
+
+void MemoryUtilities::LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    if (other.count == 0)
+        return;
+
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        buckets[i] += other.buckets[i];
+    }
+
+    minimum = count == 0 ? other.minimum : std::min<uint64_t>(minimum, other.minimum);
+    maximum = std::max<uint64_t>(maximum, other.maximum);
+    count += other.count;
+    totalNanoseconds += other.totalNanoseconds;
+}
+
+
+
+
+
+
+void MemoryUtilities::Instrumentation::Add(E_InstrumentationCounter counter, uint64_t value)
+{
+#if CRANCHYLIB_INSTRUMENTATION
+    Increase(GetThreadSlot().counters[static_cast<size_t>(counter)], value);
+#else
+    (void)counter;
+    (void)value;
+#endif
+}
+
+void MemoryUtilities::Instrumentation::RecordLatency(E_InstrumentedOperation operation, uint64_t nanoseconds)
+{
+#if CRANCHYLIB_INSTRUMENTATION
+    AtomicHistogram& histogram = GetThreadSlot().histograms[static_cast<size_t>(operation)];
+
+    const uint64_t count = histogram.count.load(std::memory_order_relaxed);
+    if (count == 0 || nanoseconds < histogram.minimum.load(std::memory_order_relaxed))
+        histogram.minimum.store(nanoseconds, std::memory_order_relaxed);
+
+    if (nanoseconds > histogram.maximum.load(std::memory_order_relaxed))
+        histogram.maximum.store(nanoseconds, std::memory_order_relaxed);
+
+    Increase(histogram.buckets[LatencyHistogram::BucketIndex(nanoseconds)], 1);
+    Increase(histogram.totalNanoseconds, nanoseconds);
+    histogram.count.store(count + 1, std::memory_order_relaxed);
+#else
+    (void)operation;
+    (void)nanoseconds;
+#endif
+}
+
+
+
+
+MemoryUtilities::InstrumentationSnapshot MemoryUtilities::Instrumentation::GetSnapshot()
+{
+    InstrumentationSnapshot snapshot;
+
+#if CRANCHYLIB_INSTRUMENTATION
+    SlotRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.registryMutex);
+
+    snapshot = registry.retiredTotals;
+    for (const ThreadSlot* slot : registry.liveSlots)
+    {
+        AccumulateSlot(*slot, snapshot);
+    }
+#endif
+
+    return snapshot;
+}
+
+void MemoryUtilities::Instrumentation::Reset()
+{
+#if CRANCHYLIB_INSTRUMENTATION
+    SlotRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.registryMutex);
+
+    registry.retiredTotals = InstrumentationSnapshot();
+    for (ThreadSlot* slot : registry.liveSlots)
+    {
+        ClearSlot(*slot);
+    }
+#endif
+}
+
+
+
+
+const char* MemoryUtilities::Instrumentation::CounterToString(E_InstrumentationCounter counter)
+{
+    switch (counter)
+    {
+    case E_InstrumentationCounter::ExternalReads:
+        return "external_reads";
+    case E_InstrumentationCounter::ExternalWrites:
+        return "external_writes";
+    case E_InstrumentationCounter::ExternalProtectionChanges:
+        return "external_protection_changes";
+    case E_InstrumentationCounter::ExternalQueries:
+        return "external_queries";
+    case E_InstrumentationCounter::InternalProtectionChanges:
+        return "internal_protection_changes";
+    case E_InstrumentationCounter::ValidationCalls:
+        return "validation_calls";
+    case E_InstrumentationCounter::Scans:
+        return "scans";
+    case E_InstrumentationCounter::BytesRead:
+        return "bytes_read";
+    case E_InstrumentationCounter::BytesWritten:
+        return "bytes_written";
+    case E_InstrumentationCounter::BytesScanned:
+        return "bytes_scanned";
+    case E_InstrumentationCounter::FailedCalls:
+        return "failed_calls";
+    default:
+        return "unknown";
+    }
+}
+
+const char* MemoryUtilities::Instrumentation::OperationToString(E_InstrumentedOperation operation)
+{
+    switch (operation)
+    {
+    case E_InstrumentedOperation::ExternalRead:
+        return "external_read";
+    case E_InstrumentedOperation::ExternalWrite:
+        return "external_write";
+    case E_InstrumentedOperation::ExternalProtect:
+        return "external_protect";
+    case E_InstrumentedOperation::ExternalQuery:
+        return "external_query";
+    case E_InstrumentedOperation::InternalProtect:
+        return "internal_protect";
+    case E_InstrumentedOperation::Validation:
+        return "validation";
+    case E_InstrumentedOperation::Scan:
+        return "scan";
+    default:
+        return "unknown";
+    }
+}
+
+
+
+
+std::string MemoryUtilities::Instrumentation::SnapshotToText(const InstrumentationSnapshot& snapshot)
+{
+    std::ostringstream text;
+
+    for (size_t i = 0; i < kCounterCount; ++i)
+    {
+        char line[96];
+        std::snprintf(line, sizeof(line), "%-28s %llu\n", CounterToString(static_cast<E_InstrumentationCounter>(i)),
+                      static_cast<unsigned long long>(snapshot.counters[i]));
+        text << line;
+    }
+
+    for (size_t i = 0; i < kOperationCount; ++i)
+    {
+        const LatencyHistogram& histogram = snapshot.latencies[i];
+        if (histogram.count == 0)
+            continue;
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-28s count %llu, mean %.1f ns, p50 %llu ns, p90 %llu ns, p99 %llu ns, max %llu ns\n",
+                      OperationToString(static_cast<E_InstrumentedOperation>(i)), static_cast<unsigned long long>(histogram.count), histogram.GetMean(),
+                      static_cast<unsigned long long>(histogram.GetPercentile(50.0)), static_cast<unsigned long long>(histogram.GetPercentile(90.0)),
+                      static_cast<unsigned long long>(histogram.GetPercentile(99.0)), static_cast<unsigned long long>(histogram.maximum));
+        text << line;
+    }
+
+    return text.str();
+}
+
+std::string MemoryUtilities::Instrumentation::SnapshotToJson(const InstrumentationSnapshot& snapshot)
+{
+    std::ostringstream json;
+    json << "{\n  \"enabled\": " << (IsEnabled() ? "true" : "false") << ",\n  \"counters\": {";
+
+    for (size_t i = 0; i < kCounterCount; ++i)
+    {
+        json << (i == 0 ? "\n" : ",\n") << "    \"" << CounterToString(static_cast<E_InstrumentationCounter>(i)) << "\": " << snapshot.counters[i];
+    }
+
+    json << "\n  },\n  \"latencies\": {";
+
+    for (size_t i = 0; i < kOperationCount; ++i)
+    {
+        const LatencyHistogram& histogram = snapshot.latencies[i];
+        json << (i == 0 ? "\n" : ",\n") << "    \"" << OperationToString(static_cast<E_InstrumentedOperation>(i)) << "\": { "
+             << "\"count\": " << histogram.count
+             << ", \"mean_ns\": " << histogram.GetMean()
+             << ", \"p50_ns\": " << histogram.GetPercentile(50.0)
+             << ", \"p90_ns\": " << histogram.GetPercentile(90.0)
+             << ", \"p99_ns\": " << histogram.GetPercentile(99.0)
+             << ", \"max_ns\": " << histogram.maximum
+             << ", \"buckets\": [";
+
+        /* Only non-empty buckets, as [lower bound in ns, count] pairs. */
+        bool firstBucket = true;
+        for (size_t bucket = 0; bucket < histogram.buckets.size(); ++bucket)
+        {
+            if (histogram.buckets[bucket] == 0)
+                continue;
+
+            json << (firstBucket ? "" : ", ") << "[" << LatencyHistogram::BucketLowerBound(bucket) << ", " << histogram.buckets[bucket] << "]";
+            firstBucket = false;
+        }
+
+        json << "] }";
+    }
+
+    json << "\n  }\n}\n";
+    return json.str();
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <windows.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+* Instrumentation is compiled in only when CRANCHYLIB_INSTRUMENTATION is defined to 1 in the preprocessor definitions of the library
+* and of every project that includes it. Otherwise the CRANCHYLIB_INSTRUMENT_* macros expand to nothing, the Instrumentation
+* functions are empty and snapshots stay zero.
+*/
+#ifndef CRANCHYLIB_INSTRUMENTATION
+#define CRANCHYLIB_INSTRUMENTATION 0
+#endif
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	enum class E_InstrumentationCounter
+	{
+		ExternalReads,			   /// External backend ReadMemory calls.
+		ExternalWrites,			   /// External backend WriteMemory calls.
+		ExternalProtectionChanges, /// External backend ProtectMemory calls.
+		ExternalQueries,		   /// External backend QueryMemory calls.
+		InternalProtectionChanges, /// VirtualProtect calls made by Internal.
+		ValidationCalls,		   /// Internal / External IsValidPtr and IsValidAddress calls.
+		Scans,					   /// Pattern scans.
+		BytesRead,				   /// Bytes External reads actually transferred.
+		BytesWritten,			   /// Bytes External writes actually transferred.
+		BytesScanned,			   /// Bytes pattern scans were given.
+		FailedCalls,			   /// Backend calls that returned failure.
+		Count
+	};
+
+	enum class E_InstrumentedOperation
+	{
+		ExternalRead,
+		ExternalWrite,
+		ExternalProtect,
+		ExternalQuery,
+		InternalProtect,
+		Validation,
+		Scan,
+		Count
+	};
+
+
+	/**
+	* @brief Log-linear latency histogram: values below 8 ns get a bucket each, every power of two above that is split into 8 buckets,
+	*        so any recorded value is reported within 12.5%.
+	*/
+	struct LatencyHistogram
+	{
+		static const size_t kSubBucketBits  = 3;
+		static const size_t kSubBucketCount = 1 << kSubBucketBits;
+		static const size_t kBucketCount	= (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+		std::array<uint64_t, kBucketCount> buckets = {};
+		uint64_t						   count			= 0;
+		uint64_t						   totalNanoseconds = 0;
+		uint64_t						   minimum			= 0;
+		uint64_t						   maximum			= 0;
+
+
+		static size_t BucketIndex(uint64_t nanoseconds);
+		static uint64_t BucketLowerBound(size_t index);
+		static uint64_t BucketUpperBound(size_t index);
+
+		/**
+		* @param percentile - 0.0 to 100.0.
+		* @return Upper bound of the bucket holding the requested percentile (never above 'maximum'), or 0 if the histogram is empty.
+		*/
+		uint64_t GetPercentile(double percentile) const;
+		double GetMean() const;
+		void Merge(const LatencyHistogram& other);
+	};
+
+
+	/**
+	* @brief Totals of every thread at the moment the snapshot was taken.
+	*/
+	struct InstrumentationSnapshot
+	{
+		std::array<uint64_t, static_cast<size_t>(E_InstrumentationCounter::Count)>		   counters = {};
+		std::array<LatencyHistogram, static_cast<size_t>(E_InstrumentedOperation::Count)> latencies;
+
+		uint64_t GetCounter(E_InstrumentationCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+		const LatencyHistogram& GetLatency(E_InstrumentedOperation operation) const { return latencies[static_cast<size_t>(operation)]; }
+	};
+
+
+
+
+
+
+	class Instrumentation
+	{
+		// Description: Low overhead counters and latency histograms for the memory APIs. Every thread records into its own slot
+		//              with plain relaxed stores; slots are summed only when a snapshot is requested. Slots of exited threads are
+		//              folded into a shared total, so nothing recorded is lost.
+		// Search Tags: #instrumentation, #metrics, #counters, #histogram, #latency, #profiling.
+	public:
+		static constexpr bool IsEnabled() { return CRANCHYLIB_INSTRUMENTATION != 0; }
+
+
+		static void Add(E_InstrumentationCounter counter, uint64_t value = 1);
+		static void RecordLatency(E_InstrumentedOperation operation, uint64_t nanoseconds);
+
+		/**
+		* @brief Sums the slots of every thread.
+		*/
+		static InstrumentationSnapshot GetSnapshot();
+		/**
+		* @brief Zeroes every counter and histogram. Values recorded by other threads while the reset runs may survive it.
+		*/
+		static void Reset();
+
+
+
+
+		static const char* CounterToString(E_InstrumentationCounter counter);
+		static const char* OperationToString(E_InstrumentedOperation operation);
+
+		/**
+		* @brief One "name value" line per counter, then one line per operation with its count, mean, p50, p90, p99 and max latency.
+		*/
+		static std::string SnapshotToText(const InstrumentationSnapshot& snapshot);
+		/**
+		* @brief { "counters": { name: value, ... }, "latencies": { name: { "count", "mean_ns", "p50_ns", "p90_ns", "p99_ns", "max_ns", "buckets": [[lower_ns, count], ...] }, ... } }
+		*/
+		static std::string SnapshotToJson(const InstrumentationSnapshot& snapshot);
+
+
+
+
+		/**
+		* @brief Records the lifetime of the object as one latency sample of 'operation'.
+		*/
+		class ScopedTimer
+		{
+		public:
+			explicit ScopedTimer(E_InstrumentedOperation operation)
+				: operation(operation), startTime(std::chrono::steady_clock::now()) {}
+
+			~ScopedTimer()
+			{
+				const auto elapsed = std::chrono::steady_clock::now() - startTime;
+				RecordLatency(operation, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+			}
+
+			ScopedTimer(const ScopedTimer&) = delete;
+			ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+		private:
+			E_InstrumentedOperation				  operation;
+			std::chrono::steady_clock::time_point startTime;
+		};
+	};
+}
+
+
+
+
+
+
+#if CRANCHYLIB_INSTRUMENTATION
+#define CRANCHYLIB_INSTRUMENT_CONCAT_INNER(a, b) a##b
+#define CRANCHYLIB_INSTRUMENT_CONCAT(a, b) CRANCHYLIB_INSTRUMENT_CONCAT_INNER(a, b)
+#define CRANCHYLIB_INSTRUMENT_COUNT(counter, value) ::MemoryUtilities::Instrumentation::Add((counter), (value))
+#define CRANCHYLIB_INSTRUMENT_SCOPE(operation) ::MemoryUtilities::Instrumentation::ScopedTimer CRANCHYLIB_INSTRUMENT_CONCAT(instrumentationTimer, __LINE__)(operation)
+#else
+#define CRANCHYLIB_INSTRUMENT_COUNT(counter, value) ((void)0)
+#define CRANCHYLIB_INSTRUMENT_SCOPE(operation) ((void)0)
+#endif
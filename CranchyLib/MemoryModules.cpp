@@ -0,0 +1,393 @@
+#include "MemoryModules.h"
+
+#include <algorithm>
+#include <cctype>
+#include <tlhelp32.h>
+
+#include "MemoryTracing.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace
+{
+    /* Toolhelp fails with ERROR_BAD_LENGTH while the target is loading or unloading a module; trying again is the documented fix. */
+    constexpr int kSnapshotAttempts = 4;
+
+
+
+    std::string ToLowerCase(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](char character)
+        {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+        });
+        return text;
+    }
+
+    bool IsSameModule(const MemoryUtilities::ModuleWatcher::ModuleInfo& left, const MemoryUtilities::ModuleWatcher::ModuleInfo& right)
+    {
+        return left.baseAddress == right.baseAddress && left.size == right.size && left.name == right.name;
+    }
+}
+
+
+
+
+
+
+MemoryUtilities::ModuleWatcher::~ModuleWatcher()
+{
+    Stop();
+}
+
+
+
+
+bool MemoryUtilities::ModuleWatcher::Start(const HANDLE& hProcess, std::chrono::milliseconds pollInterval)
+{
+    if (External::IsValidProcessHandle(hProcess) == false || pollInterval.count() <= 0)
+        return false;
+
+    /* A worker stopped from one of its own callbacks winds down by itself; it must be gone before another one starts. */
+    if (workerThread.joinable() && running.load() == false)
+    {
+        if (workerThread.get_id() == std::this_thread::get_id())
+            return false;
+
+        workerThread.join();
+    }
+
+    if (running.exchange(true)) // Already running.
+        return false;
+
+    this->hProcess = hProcess;
+    this->pollInterval = pollInterval;
+    isCurrentProcess = GetProcessId(hProcess) == GetCurrentProcessId();
+
+    Poll();
+    workerThread = std::thread(&ModuleWatcher::WorkerLoop, this);
+    return true;
+}
+
+void MemoryUtilities::ModuleWatcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        running = false;
+    }
+
+    /* From a callback the worker can't join itself; it leaves its loop once the callback returns, and is joined by the next
+       Start(), Stop() or the destructor. */
+    wakeCondition.notify_all();
+    if (workerThread.joinable() && workerThread.get_id() != std::this_thread::get_id())
+        workerThread.join();
+}
+
+bool MemoryUtilities::ModuleWatcher::IsRunning() const
+{
+    return running.load();
+}
+
+size_t MemoryUtilities::ModuleWatcher::Poll()
+{
+    CRANCHYLIB_TRACE_SCOPE("sweep", "ModuleWatcher::Poll", 0);
+
+    std::vector<ModuleEvent> moduleEvents;
+    std::vector<SignatureEvent> signatureEvents;
+    std::vector<std::function<void(const SignatureEvent&)>> signatureCallbacks;
+    std::function<void(const ModuleEvent&)> callback;
+
+    /* Events are gathered under pollMutex and delivered after it's released; a callback calling Stop() joins the worker, which
+       may itself be waiting on pollMutex. */
+    {
+        std::lock_guard<std::mutex> pollLock(pollMutex);
+        if (running.load() == false)
+            return 0;
+
+        /* Cleared before the list is taken: the worker waits on it, and would spin while the list can't be taken - once the target
+           exited, say. Signatures added from here on are resolved below, or by the poll their flag causes. */
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            signaturesChanged = false;
+        }
+
+        std::vector<ModuleInfo> currentModules;
+        if (TakeModuleList(currentModules) == false)
+            return 0;
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            callback = moduleCallback;
+
+            /* Both lists are sorted by base address; a module rebased or replaced by another file counts as unloaded and loaded. */
+            for (const ModuleInfo& module : modules)
+            {
+                const auto current = std::lower_bound(currentModules.begin(), currentModules.end(), module.baseAddress, [](const ModuleInfo& candidate, uintptr_t baseAddress)
+                {
+                    return candidate.baseAddress < baseAddress;
+                });
+                if (current != currentModules.end() && IsSameModule(*current, module))
+                    continue;
+
+                moduleEvents.push_back({ module, false });
+                for (Signature& signature : signatures)
+                {
+                    if (signature.moduleBase != module.baseAddress)
+                        continue;
+
+                    if (signature.address != 0x0)
+                    {
+                        signatureEvents.push_back({ signature.id, 0x0, false });
+                        signatureCallbacks.push_back(signature.callback);
+                    }
+
+                    signature.moduleBase = 0x0;
+                    signature.address = 0x0;
+                }
+            }
+
+            for (const ModuleInfo& module : currentModules)
+            {
+                const auto previous = std::lower_bound(modules.begin(), modules.end(), module.baseAddress, [](const ModuleInfo& candidate, uintptr_t baseAddress)
+                {
+                    return candidate.baseAddress < baseAddress;
+                });
+                if (previous == modules.end() || IsSameModule(*previous, module) == false)
+                    moduleEvents.push_back({ module, true });
+            }
+
+            modules = currentModules;
+        }
+
+        /* Pending signatures: those of new modules, and new signatures of modules loaded all along. */
+        for (const ModuleInfo& module : currentModules)
+        {
+            ResolveSignatures(module, signatureEvents, signatureCallbacks);
+        }
+    }
+
+    /* Callbacks run without any lock held, so they're free to add or remove signatures. */
+    if (callback)
+    {
+        for (const ModuleEvent& moduleEvent : moduleEvents)
+        {
+            callback(moduleEvent);
+        }
+    }
+
+    for (size_t i = 0; i < signatureEvents.size(); ++i)
+    {
+        if (signatureCallbacks[i])
+            signatureCallbacks[i](signatureEvents[i]);
+    }
+
+    return moduleEvents.size();
+}
+
+
+
+
+MemoryUtilities::ModuleWatcher::SignatureId MemoryUtilities::ModuleWatcher::AddSignature(const std::string& moduleName, const std::string& memoryPattern, std::function<void(const SignatureEvent&)> callback)
+{
+    Signature signature;
+    signature.moduleName = ToLowerCase(moduleName);
+    signature.pattern = Convertion::MemoryPattern_ToMaskedPattern(memoryPattern);
+    signature.callback = std::move(callback);
+    if (signature.moduleName.empty() || signature.pattern.values.empty())
+        return InvalidSignature;
+
+    SignatureId signatureId;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        signatureId = nextSignatureId++;
+        signature.id = signatureId;
+        signatures.push_back(std::move(signature));
+        signaturesChanged = true;
+    }
+
+    wakeCondition.notify_all();
+    return signatureId;
+}
+
+bool MemoryUtilities::ModuleWatcher::RemoveSignature(SignatureId signatureId)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    const auto signature = std::find_if(signatures.begin(), signatures.end(), [signatureId](const Signature& candidate)
+    {
+        return candidate.id == signatureId;
+    });
+
+    if (signature == signatures.end())
+        return false;
+
+    signatures.erase(signature);
+    return true;
+}
+
+void MemoryUtilities::ModuleWatcher::ClearSignatures()
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    signatures.clear();
+}
+
+uintptr_t MemoryUtilities::ModuleWatcher::GetAddress(SignatureId signatureId) const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    for (const Signature& signature : signatures)
+    {
+        if (signature.id == signatureId)
+            return signature.address;
+    }
+
+    return 0x0;
+}
+
+
+
+
+void MemoryUtilities::ModuleWatcher::SetModuleCallback(std::function<void(const ModuleEvent&)> callback)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    moduleCallback = std::move(callback);
+}
+
+std::vector<MemoryUtilities::ModuleWatcher::ModuleInfo> MemoryUtilities::ModuleWatcher::GetModules() const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return modules;
+}
+
+
+
+
+void MemoryUtilities::ModuleWatcher::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (running.load())
+    {
+        /* Wake up for the next tick, a new signature, or Stop(). */
+        wakeCondition.wait_for(lock, pollInterval, [this]() { return running.load() == false || signaturesChanged; });
+        if (running.load() == false)
+            break;
+
+        lock.unlock();
+        Poll();
+        lock.lock();
+    }
+}
+
+bool MemoryUtilities::ModuleWatcher::TakeModuleList(std::vector<ModuleInfo>& outModules) const
+{
+    HANDLE hSnapshot = INVALID_HANDLE_VALUE;
+    for (int attempt = 0; attempt < kSnapshotAttempts && hSnapshot == INVALID_HANDLE_VALUE; ++attempt)
+    {
+        hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, GetProcessId(hProcess));
+    }
+
+    if (hSnapshot == INVALID_HANDLE_VALUE)
+        return false;
+
+    MODULEENTRY32W moduleEntry{};
+    moduleEntry.dwSize = sizeof(moduleEntry);
+    for (BOOL hasEntry = Module32FirstW(hSnapshot, &moduleEntry); hasEntry; hasEntry = Module32NextW(hSnapshot, &moduleEntry))
+    {
+        const std::wstring moduleName(moduleEntry.szModule);
+
+        ModuleInfo module;
+        module.name = ToLowerCase(std::string(moduleName.begin(), moduleName.end()));
+        module.baseAddress = reinterpret_cast<uintptr_t>(moduleEntry.modBaseAddr);
+        module.size = static_cast<size_t>(moduleEntry.modBaseSize);
+        outModules.push_back(std::move(module));
+    }
+
+    CloseHandle(hSnapshot);
+    std::sort(outModules.begin(), outModules.end(), [](const ModuleInfo& left, const ModuleInfo& right) { return left.baseAddress < right.baseAddress; });
+    return true;
+}
+
+void MemoryUtilities::ModuleWatcher::ResolveSignatures(const ModuleInfo& module, std::vector<SignatureEvent>& events, std::vector<std::function<void(const SignatureEvent&)>>& callbacks)
+{
+    std::vector<SignatureId> pendingIds;
+    std::vector<MaskedPattern> patterns;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        for (const Signature& signature : signatures)
+        {
+            if (signature.moduleBase == 0x0 && signature.moduleName == module.name)
+            {
+                pendingIds.push_back(signature.id);
+                patterns.push_back(signature.pattern);
+            }
+        }
+    }
+
+    if (pendingIds.empty())
+        return;
+
+    CRANCHYLIB_TRACE_SCOPE("signature", "ModuleWatcher::ResolveSignatures", pendingIds.size());
+
+    /* The image is read once for all of the module's signatures; in our own process it is scanned in place, pinned so that
+       it can't be unloaded mid-scan. The list may be stale by now: whatever is pinned must still be the module at that base. */
+    const HMODULE hModule = reinterpret_cast<HMODULE>(module.baseAddress);
+    HMODULE hPinnedModule = nullptr;
+    if (isCurrentProcess)
+    {
+        if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(module.baseAddress), &hPinnedModule) == FALSE)
+            return;
+
+        if (hPinnedModule != hModule)
+        {
+            FreeLibrary(hPinnedModule);
+            return;
+        }
+    }
+
+    std::vector<uint32_t> rvas(patterns.size(), ModuleImage::InvalidRva);
+    bool loaded = false;
+    {
+        ModuleImage image;
+        loaded = isCurrentProcess ? image.LoadInternal(hModule) : image.LoadExternal(hProcess, hModule);
+        if (loaded)
+        {
+            ThreadingUtilities::TaskGroup group(ThreadingUtilities::GetSharedPool());
+            ThreadingUtilities::ParallelFor(group, 0, patterns.size(), 1, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    rvas[i] = image.FindPattern(patterns[i]);
+                }
+            });
+        }
+    }
+
+    if (hPinnedModule != nullptr)
+        FreeLibrary(hPinnedModule);
+
+    if (loaded == false)
+        return;
+
+    /* Signatures removed while the module was scanned are simply not found again. A pattern without a match stays with
+       its module anyway: scanning it again only makes sense once the module is reloaded. */
+    std::lock_guard<std::mutex> lock(stateMutex);
+    for (size_t i = 0; i < pendingIds.size(); ++i)
+    {
+        for (Signature& signature : signatures)
+        {
+            if (signature.id != pendingIds[i] || signature.moduleBase != 0x0)
+                continue;
+
+            signature.moduleBase = module.baseAddress;
+            signature.address = rvas[i] != ModuleImage::InvalidRva ? module.baseAddress + rvas[i] : 0x0;
+            if (signature.address != 0x0)
+            {
+                events.push_back({ signature.id, signature.address, true });
+                callbacks.push_back(signature.callback);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MemoryImages.h"
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class ModuleWatcher
+	{
+		// Description: Follows the modules of a process - the current one or a 3'rd party one - and keeps signatures registered
+		//              for them resolved. The module list is polled from a background thread (one Toolhelp snapshot per tick); a
+		//              module that appears gets only its own signatures resolved, all of them in one parallel pass over its image,
+		//              and a module that goes away invalidates them. A signature whose module isn't loaded yet stays pending, and its
+		//              callback fires once it resolves - for plugins loaded long after startup, say.
+		// Search Tags: #module, #dll, #plugin, #load, #unload, #watch, #signature, #deferred, #resolve, #toolhelp.
+	public:
+		using SignatureId = uint32_t;
+		static constexpr SignatureId InvalidSignature = 0;
+
+
+		/**
+		* @param name - Module file name, e.g. "engine.dll".
+		* @param baseAddress / size - Where the module's image is mapped.
+		*/
+		struct ModuleInfo
+		{
+			std::string name;
+			uintptr_t	baseAddress = 0x0;
+			size_t		size		= 0;
+		};
+
+		/**
+		* @param module - Module that was loaded or unloaded.
+		* @param loaded - true when the module appeared, false when it went away.
+		*/
+		struct ModuleEvent
+		{
+			ModuleInfo module;
+			bool	   loaded = false;
+		};
+
+		/**
+		* @param signatureId - Signature the event is about.
+		* @param address - Where the signature now resolves; 0x0 when it was invalidated by its module unloading.
+		* @param resolved - true when the signature resolved, false when it was invalidated.
+		*/
+		struct SignatureEvent
+		{
+			SignatureId signatureId = InvalidSignature;
+			uintptr_t	address		= 0x0;
+			bool		resolved	= false;
+		};
+
+
+
+
+		ModuleWatcher() = default;
+		~ModuleWatcher();
+		ModuleWatcher(const ModuleWatcher&) = delete;
+		ModuleWatcher& operator=(const ModuleWatcher&) = delete;
+
+
+
+
+		/**
+		* @brief Takes a first module list, resolving every signature whose module is already loaded, then starts polling.
+		* @param hProcess - Process HANDLE to follow, must stay open until Stop() is called. GetCurrentProcess() works too, and
+		*                   images are then scanned in place instead of copied.
+		* @param pollInterval - How often the module list is taken.
+		* @return true if polling was started; false if the handle is invalid or the watcher is already running.
+		*/
+		bool Start(const HANDLE& hProcess, std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250));
+		/**
+		* @brief Stops polling. May be called from a callback; the polling thread then finishes on its own once the callback returns.
+		*/
+		void Stop();
+		bool IsRunning() const;
+
+		/**
+		* @brief Takes the module list now instead of at the next tick, e.g. right after loading a library. Callbacks run on the
+		*        calling thread.
+		* @return Number of modules that were loaded or unloaded since the previous poll.
+		*/
+		size_t Poll();
+
+
+
+
+		/**
+		* @brief Registers a signature to keep resolved in a module. It is resolved at the next poll if its module is loaded.
+		* @param moduleName - File name of the module, matched without regard to case, e.g. "engine.dll".
+		* @param memoryPattern - Pattern in the Convertion::MemoryPattern_ToMaskedPattern() format.
+		* @param callback - Optional; called on the polling thread whenever the signature resolves or is invalidated. It may add
+		*                   or remove signatures.
+		* @return Id of the signature, or 'InvalidSignature' if the pattern is invalid.
+		*/
+		SignatureId AddSignature(const std::string& moduleName, const std::string& memoryPattern, std::function<void(const SignatureEvent&)> callback = nullptr);
+		bool		RemoveSignature(SignatureId signatureId);
+		void		ClearSignatures();
+
+		/**
+		* @return Where the signature resolves right now, or 0x0 if it is pending (module not loaded, or pattern not found in it).
+		*/
+		uintptr_t	GetAddress(SignatureId signatureId) const;
+
+
+
+
+		/**
+		* @brief Sets a function called on the polling thread for every module loaded or unloaded. Pass an empty function to remove it.
+		*/
+		void					SetModuleCallback(std::function<void(const ModuleEvent&)> callback);
+		std::vector<ModuleInfo> GetModules() const;
+
+
+
+
+	private:
+		struct Signature
+		{
+			SignatureId								  id = InvalidSignature;
+			std::string								  moduleName; // Lower case.
+			MaskedPattern							  pattern;
+			std::function<void(const SignatureEvent&)> callback;
+
+			uintptr_t								  moduleBase = 0x0; // Module the signature was scanned for in, found or not; 0x0 when pending.
+			uintptr_t								  address	 = 0x0;
+		};
+
+
+		void WorkerLoop();
+		bool TakeModuleList(std::vector<ModuleInfo>& outModules) const;
+		void ResolveSignatures(const ModuleInfo& module, std::vector<SignatureEvent>& events, std::vector<std::function<void(const SignatureEvent&)>>& callbacks);
+
+
+		HANDLE						hProcess	 = nullptr;
+		bool						isCurrentProcess = false;
+		std::chrono::milliseconds	pollInterval{ 250 };
+		std::thread					workerThread;
+		std::atomic<bool>			running{ false };
+		std::mutex					pollMutex;	// Serializes the diffing half of Poll() between the worker and callers; never held across callbacks.
+
+		mutable std::mutex			stateMutex;
+		std::condition_variable		wakeCondition;
+		bool						signaturesChanged = false;
+		std::vector<Signature>		signatures;
+		SignatureId					nextSignatureId = 1;
+		std::vector<ModuleInfo>		modules;	// Sorted by base address.
+		std::function<void(const ModuleEvent&)> moduleCallback;
+	};
+}
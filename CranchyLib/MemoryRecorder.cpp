@@ -0,0 +1,816 @@
+#include "MemoryRecorder.h"
+
+#include <algorithm>
+
+
+
+
+
+
+namespace
+{
+    /* File layout (little endian):
+       header: "CRRECORD", uint32 version, uint32 columnCount, uint32 rowsPerBlock,
+               then per column: uint8 valueType, uint8 valueSize, uint16 nameLength, name bytes.
+       block:  uint32 'CRBK', uint32 rowCount, uint32 streamsByteSize, uint32 streamSizes[columnCount + 1], streams.
+       Stream 0 holds the timestamps, stream N + 1 holds column N. */
+    const char     kFileMagic[8]    = { 'C', 'R', 'R', 'E', 'C', 'O', 'R', 'D' };
+    const uint32_t kFileVersion     = 1;
+    const uint32_t kBlockMagic      = 0x4B425243; // "CRBK"
+    const size_t   kBlockHeaderSize = 3 * sizeof(uint32_t);
+
+    const uint8_t  kStreamHasValidity = 0x01;
+
+
+
+    void AppendUInt32(std::vector<uint8_t>& bytes, uint32_t value)
+    {
+        uint8_t buffer[sizeof(uint32_t)];
+        std::memcpy(buffer, &value, sizeof(value));
+        bytes.insert(bytes.end(), buffer, buffer + sizeof(buffer));
+    }
+
+    uint32_t LoadUInt32(const uint8_t* data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    void AppendVarint(std::vector<uint8_t>& bytes, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool LoadVarint(const uint8_t*& data, const uint8_t* end, uint64_t& outValue)
+    {
+        outValue = 0;
+        for (int shift = 0; shift < 64 && data < end; shift += 7)
+        {
+            const uint8_t byte = *data++;
+            outValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    uint64_t ZigZagEncode(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t ZigZagDecode(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int64_t SignExtend(uint64_t bits, size_t valueSize)
+    {
+        const unsigned unusedBits = static_cast<unsigned>(64 - valueSize * 8);
+        return static_cast<int64_t>(bits << unusedBits) >> unusedBits;
+    }
+
+    uint64_t TruncateBits(uint64_t bits, size_t valueSize)
+    {
+        return valueSize >= sizeof(uint64_t) ? bits : bits & ((uint64_t(1) << (valueSize * 8)) - 1);
+    }
+
+    bool IsFloatingType(MemoryUtilities::E_ValueType valueType)
+    {
+        return valueType == MemoryUtilities::E_ValueType::Float || valueType == MemoryUtilities::E_ValueType::Double;
+    }
+
+
+
+    /* Integers: difference to the previous row, zigzag + varint, so slowly changing counters take a byte per row.
+       Floating point: XOR with the previous row; a control byte gives the number of zero bytes on each end and only
+       the bytes in between are stored, so repeated values take a single byte. */
+    void EncodeColumn(std::vector<uint8_t>& out, MemoryUtilities::E_ValueType valueType, size_t valueSize,
+                      const uint64_t* values, const uint8_t* validity, size_t rowCount)
+    {
+        const bool hasInvalid = std::find(validity, validity + rowCount, uint8_t(0)) != validity + rowCount;
+        out.push_back(hasInvalid ? kStreamHasValidity : 0);
+        if (hasInvalid)
+        {
+            const size_t bitmapOffset = out.size();
+            out.resize(out.size() + (rowCount + 7) / 8, 0);
+            for (size_t row = 0; row < rowCount; ++row)
+            {
+                if (validity[row])
+                    out[bitmapOffset + row / 8] |= static_cast<uint8_t>(1 << (row % 8));
+            }
+        }
+
+        uint64_t previous = 0;
+        for (size_t row = 0; row < rowCount; ++row)
+        {
+            if (IsFloatingType(valueType))
+            {
+                const uint64_t delta = values[row] ^ previous;
+                size_t leadingZeroBytes = 0;
+                size_t trailingZeroBytes = 0;
+                while (leadingZeroBytes < valueSize && ((delta >> ((valueSize - 1 - leadingZeroBytes) * 8)) & 0xFF) == 0)
+                    ++leadingZeroBytes;
+                while (trailingZeroBytes + leadingZeroBytes < valueSize && ((delta >> (trailingZeroBytes * 8)) & 0xFF) == 0)
+                    ++trailingZeroBytes;
+
+                out.push_back(static_cast<uint8_t>(leadingZeroBytes | (trailingZeroBytes << 4)));
+                for (size_t i = trailingZeroBytes; i < valueSize - leadingZeroBytes; ++i)
+                {
+                    out.push_back(static_cast<uint8_t>(delta >> (i * 8)));
+                }
+            }
+            else
+            {
+                /* Unsigned, so values far apart wrap around instead of overflowing; the decoder wraps back the same way. */
+                const uint64_t delta = static_cast<uint64_t>(SignExtend(values[row], valueSize)) - static_cast<uint64_t>(SignExtend(previous, valueSize));
+                AppendVarint(out, ZigZagEncode(static_cast<int64_t>(delta)));
+            }
+
+            previous = values[row];
+        }
+    }
+
+    bool DecodeColumn(const uint8_t* data, size_t size, MemoryUtilities::E_ValueType valueType, size_t valueSize, size_t rowCount,
+                      std::vector<uint64_t>& outBits, std::vector<bool>* outValid)
+    {
+        const uint8_t* end = data + size;
+        if (data >= end)
+            return false;
+
+        const uint8_t* bitmap = nullptr;
+        if (*data++ & kStreamHasValidity)
+        {
+            bitmap = data;
+            data += (rowCount + 7) / 8;
+            if (data > end)
+                return false;
+        }
+
+        uint64_t previous = 0;
+        for (size_t row = 0; row < rowCount; ++row)
+        {
+            if (IsFloatingType(valueType))
+            {
+                if (data >= end)
+                    return false;
+
+                const size_t leadingZeroBytes = *data & 0x0F;
+                const size_t trailingZeroBytes = *data >> 4;
+                ++data;
+                if (leadingZeroBytes + trailingZeroBytes > valueSize || static_cast<size_t>(end - data) < valueSize - leadingZeroBytes - trailingZeroBytes)
+                    return false;
+
+                uint64_t delta = 0;
+                for (size_t i = trailingZeroBytes; i < valueSize - leadingZeroBytes; ++i)
+                {
+                    delta |= static_cast<uint64_t>(*data++) << (i * 8);
+                }
+                previous ^= delta;
+            }
+            else
+            {
+                uint64_t encoded;
+                if (LoadVarint(data, end, encoded) == false)
+                    return false;
+
+                previous = TruncateBits(static_cast<uint64_t>(SignExtend(previous, valueSize)) + static_cast<uint64_t>(ZigZagDecode(encoded)), valueSize);
+            }
+
+            outBits.push_back(previous);
+            if (outValid != nullptr)
+                outValid->push_back(bitmap == nullptr || (bitmap[row / 8] >> (row % 8)) & 1);
+        }
+
+        return true;
+    }
+}
+
+
+
+
+
+
+MemoryUtilities::Recorder::~Recorder()
+{
+    Stop();
+}
+
+
+
+
+MemoryUtilities::Recorder::ColumnId MemoryUtilities::Recorder::AddColumn(const std::string& name, const uintptr_t& memoryAddress, E_ValueType valueType)
+{
+    return AddColumn(name, memoryAddress, {}, valueType);
+}
+
+MemoryUtilities::Recorder::ColumnId MemoryUtilities::Recorder::AddColumn(const std::string& name, const uintptr_t& memoryAddress, const std::vector<uintptr_t>& memoryOffsets, E_ValueType valueType)
+{
+    const size_t valueSize = GetValueTypeSize(valueType);
+    if (running.load() || memoryAddress == 0x0 || valueSize == 0 || name.size() > 0xFFFF)
+        return InvalidColumn;
+
+    Column column;
+    column.name = name;
+    column.memoryAddress = memoryAddress;
+    column.memoryOffsets = memoryOffsets;
+    column.valueType = valueType;
+    column.valueSize = valueSize;
+    columns.push_back(std::move(column));
+
+    return static_cast<ColumnId>(columns.size() - 1);
+}
+
+bool MemoryUtilities::Recorder::ClearColumns()
+{
+    if (running.load())
+        return false;
+
+    columns.clear();
+    return true;
+}
+
+size_t MemoryUtilities::Recorder::GetColumnCount() const
+{
+    return columns.size();
+}
+
+
+
+
+bool MemoryUtilities::Recorder::Start(const HANDLE& hProcess, const std::string& filePath, std::chrono::microseconds sampleInterval, size_t rowsPerBlock, size_t bufferedRows)
+{
+    if (External::IsValidProcessHandle(hProcess) == false || columns.empty() || sampleInterval.count() <= 0 || rowsPerBlock == 0 || bufferedRows == 0)
+        return false;
+
+    if (running.load() || samplingThread.joinable() || writingThread.joinable())
+        return false;
+
+    hFile = CreateFileA(filePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    this->hProcess = hProcess;
+    this->sampleInterval = sampleInterval;
+    this->rowsPerBlock = rowsPerBlock;
+
+    sampleCount = 0;
+    droppedSampleCount = 0;
+    failedReadCount = 0;
+    writtenBlockCount = 0;
+    writtenBytes = 0;
+    writeFailed = false;
+
+
+    /* File header. */
+    std::vector<uint8_t> header(kFileMagic, kFileMagic + sizeof(kFileMagic));
+    AppendUInt32(header, kFileVersion);
+    AppendUInt32(header, static_cast<uint32_t>(columns.size()));
+    AppendUInt32(header, static_cast<uint32_t>(rowsPerBlock));
+    for (const Column& column : columns)
+    {
+        header.push_back(static_cast<uint8_t>(column.valueType));
+        header.push_back(static_cast<uint8_t>(column.valueSize));
+        header.push_back(static_cast<uint8_t>(column.name.size()));
+        header.push_back(static_cast<uint8_t>(column.name.size() >> 8));
+        header.insert(header.end(), column.name.begin(), column.name.end());
+    }
+
+    if (WriteToFile(header) == false)
+    {
+        CloseHandle(hFile);
+        hFile = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+
+    /* Preallocate everything; the batch reads reuse 'batchScratch', so once it has grown on the first sample neither thread
+       allocates while recording. */
+    const size_t columnCount = columns.size();
+    rowTimestamps.assign(bufferedRows, 0);
+    rowValues.assign(bufferedRows * columnCount, 0);
+    rowValidity.assign(bufferedRows * columnCount, 0);
+    freeRows.reset(new SpscRingBuffer<uint32_t>(bufferedRows));
+    filledRows.reset(new SpscRingBuffer<uint32_t>(bufferedRows));
+    for (size_t row = 0; row < bufferedRows; ++row)
+    {
+        freeRows->Push(static_cast<uint32_t>(row));
+    }
+
+    chains.resize(columnCount);
+    for (size_t i = 0; i < columnCount; ++i)
+    {
+        chains[i].memoryAddress = columns[i].memoryAddress;
+        chains[i].memoryOffsets = &columns[i].memoryOffsets;
+    }
+    batch.reserve(columnCount);
+
+    blockTimestamps.assign(rowsPerBlock, 0);
+    blockValues.assign(rowsPerBlock * columnCount, 0);
+    blockValidity.assign(rowsPerBlock * columnCount, 0);
+    blockRowCount = 0;
+
+
+    startTime = std::chrono::steady_clock::now();
+    samplingStopped = false;
+    running = true;
+    samplingThread = std::thread(&Recorder::SamplingLoop, this);
+    writingThread = std::thread(&Recorder::WritingLoop, this);
+    return true;
+}
+
+bool MemoryUtilities::Recorder::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(samplingMutex);
+        if (running.exchange(false) == false)
+            return false;
+    }
+
+    samplingCondition.notify_all();
+    if (samplingThread.joinable())
+        samplingThread.join();
+
+    /* Let the writer drain whatever is still buffered, including the last partial block. */
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        samplingStopped = true;
+    }
+
+    writerCondition.notify_all();
+    if (writingThread.joinable())
+        writingThread.join();
+
+    CloseHandle(hFile);
+    hFile = INVALID_HANDLE_VALUE;
+
+    return writeFailed.load() == false && droppedSampleCount.load() == 0;
+}
+
+bool MemoryUtilities::Recorder::IsRunning() const
+{
+    return running.load();
+}
+
+MemoryUtilities::Recorder::RecorderStatistics MemoryUtilities::Recorder::GetStatistics() const
+{
+    RecorderStatistics statistics;
+    statistics.sampleCount = sampleCount.load();
+    statistics.droppedSampleCount = droppedSampleCount.load();
+    statistics.failedReadCount = failedReadCount.load();
+    statistics.writtenBlockCount = writtenBlockCount.load();
+    statistics.writtenBytes = writtenBytes.load();
+
+    return statistics;
+}
+
+
+
+
+void MemoryUtilities::Recorder::SamplingLoop()
+{
+    const size_t columnCount = columns.size();
+    auto nextSample = startTime;
+
+    std::unique_lock<std::mutex> lock(samplingMutex);
+    while (running.load())
+    {
+        lock.unlock();
+
+        uint32_t row;
+        if (freeRows->Pop(row) == false) // Writer is behind and every row slot is taken, drop this sample rather than wait.
+        {
+            droppedSampleCount++;
+        }
+        else
+        {
+            const auto sampledAt = std::chrono::steady_clock::now();
+            uint64_t* values = &rowValues[row * columnCount];
+            uint8_t* validity = &rowValidity[row * columnCount];
+            rowTimestamps[row] = std::chrono::duration_cast<std::chrono::nanoseconds>(sampledAt - startTime).count();
+
+            /* Resolve pointer paths, then read every value straight into its row slot. */
+            External::AddressFollowPointerChainBatch(hProcess, chains, batchScratch);
+
+            batch.clear();
+            for (size_t i = 0; i < columnCount; ++i)
+            {
+                values[i] = 0;
+                validity[i] = 0;
+                if (chains[i].succeeded == false)
+                    continue;
+
+                External::BatchRead read;
+                read.memoryAddress = chains[i].resolvedAddress;
+                read.byteCount = columns[i].valueSize;
+                read.buffer = &values[i];
+                batch.push_back(read);
+            }
+            External::GetBytesBatch(hProcess, batch, batchScratch);
+
+            size_t batchIndex = 0;
+            for (size_t i = 0; i < columnCount; ++i)
+            {
+                if (chains[i].succeeded && batch[batchIndex++].succeeded)
+                    validity[i] = 1;
+                else
+                    failedReadCount++;
+            }
+
+            filledRows->Push(row); // Can't fail, there are never more filled rows than row slots.
+            sampleCount++;
+
+            if (filledRows->Size() >= rowsPerBlock)
+                writerCondition.notify_one();
+        }
+
+        /* Keep a steady rate; if sampling overran the interval, skip ahead instead of bursting. */
+        nextSample += sampleInterval;
+        const auto now = std::chrono::steady_clock::now();
+        if (nextSample < now)
+            nextSample = now;
+
+        lock.lock();
+        samplingCondition.wait_until(lock, nextSample, [this]() { return running.load() == false; });
+    }
+}
+
+void MemoryUtilities::Recorder::WritingLoop()
+{
+    const size_t columnCount = columns.size();
+
+    for (;;)
+    {
+        /* Read the flag before draining, so rows pushed right before the sampler stopped are still picked up. */
+        const bool finishing = samplingStopped.load();
+
+        uint32_t row;
+        while (filledRows->Pop(row))
+        {
+            blockTimestamps[blockRowCount] = rowTimestamps[row];
+            for (size_t i = 0; i < columnCount; ++i)
+            {
+                /* Invalid rows repeat the previous value, so they cost nothing in the encoded stream. */
+                uint64_t& value = blockValues[i * rowsPerBlock + blockRowCount];
+                const uint8_t valid = rowValidity[row * columnCount + i];
+                blockValidity[i * rowsPerBlock + blockRowCount] = valid;
+                if (valid)
+                    value = rowValues[row * columnCount + i];
+                else
+                    value = blockRowCount > 0 ? blockValues[i * rowsPerBlock + blockRowCount - 1] : 0;
+            }
+
+            freeRows->Push(row);
+            if (++blockRowCount == rowsPerBlock)
+                WriteBlock();
+        }
+
+        if (finishing)
+            break;
+
+        std::unique_lock<std::mutex> lock(writerMutex);
+        writerCondition.wait_for(lock, std::chrono::milliseconds(20), [this]() { return samplingStopped.load(); });
+    }
+
+    if (blockRowCount > 0)
+        WriteBlock();
+}
+
+bool MemoryUtilities::Recorder::WriteBlock()
+{
+    const size_t columnCount = columns.size();
+
+    encodedBlock.clear();
+    AppendUInt32(encodedBlock, kBlockMagic);
+    AppendUInt32(encodedBlock, static_cast<uint32_t>(blockRowCount));
+    AppendUInt32(encodedBlock, 0); // Streams byte size, patched below.
+
+    const size_t tableOffset = encodedBlock.size();
+    encodedBlock.resize(encodedBlock.size() + (columnCount + 1) * sizeof(uint32_t), 0);
+
+
+    /* Timestamps, delta-of-delta: a steady sampling rate turns into a stream of zeros. */
+    size_t streamStart = encodedBlock.size();
+    uint64_t previousTimestamp = 0;
+    uint64_t previousDelta = 0;
+    for (size_t row = 0; row < blockRowCount; ++row)
+    {
+        const uint64_t delta = static_cast<uint64_t>(blockTimestamps[row]) - previousTimestamp;
+        AppendVarint(encodedBlock, ZigZagEncode(static_cast<int64_t>(delta - previousDelta)));
+        previousTimestamp = static_cast<uint64_t>(blockTimestamps[row]);
+        previousDelta = delta;
+    }
+
+    uint32_t streamSize = static_cast<uint32_t>(encodedBlock.size() - streamStart);
+    std::memcpy(&encodedBlock[tableOffset], &streamSize, sizeof(streamSize));
+
+    for (size_t i = 0; i < columnCount; ++i)
+    {
+        streamStart = encodedBlock.size();
+        EncodeColumn(encodedBlock, columns[i].valueType, columns[i].valueSize, &blockValues[i * rowsPerBlock], &blockValidity[i * rowsPerBlock], blockRowCount);
+
+        streamSize = static_cast<uint32_t>(encodedBlock.size() - streamStart);
+        std::memcpy(&encodedBlock[tableOffset + (i + 1) * sizeof(uint32_t)], &streamSize, sizeof(streamSize));
+    }
+
+    const uint32_t streamsByteSize = static_cast<uint32_t>(encodedBlock.size() - kBlockHeaderSize);
+    std::memcpy(&encodedBlock[2 * sizeof(uint32_t)], &streamsByteSize, sizeof(streamsByteSize));
+
+    blockRowCount = 0;
+    if (WriteToFile(encodedBlock) == false)
+        return false;
+
+    writtenBlockCount++;
+    return true;
+}
+
+bool MemoryUtilities::Recorder::WriteToFile(const std::vector<uint8_t>& bytes)
+{
+    size_t offset = 0;
+    while (offset < bytes.size())
+    {
+        const DWORD chunkSize = static_cast<DWORD>(std::min<size_t>(bytes.size() - offset, 0x40000000));
+        DWORD bytesWritten = 0;
+        if (WriteFile(hFile, bytes.data() + offset, chunkSize, &bytesWritten, nullptr) == FALSE || bytesWritten == 0)
+        {
+            writeFailed = true;
+            return false;
+        }
+
+        offset += bytesWritten;
+        writtenBytes += bytesWritten;
+    }
+
+    return true;
+}
+
+
+
+
+
+
+MemoryUtilities::RecordingReader::~RecordingReader()
+{
+    Close();
+}
+
+
+
+
+bool MemoryUtilities::RecordingReader::Open(const std::string& filePath)
+{
+    Close();
+
+    /* Sharing write access lets a recording be inspected while it is still being written. */
+    hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(hFile, &fileSize) == FALSE || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(kFileMagic) + 3 * sizeof(uint32_t)))
+    {
+        Close();
+        return false;
+    }
+
+    hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (hMapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    view = static_cast<const uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (view == nullptr)
+    {
+        Close();
+        return false;
+    }
+    viewSize = static_cast<size_t>(fileSize.QuadPart);
+
+
+    /* Header. */
+    const uint8_t* data = view;
+    const uint8_t* end = view + viewSize;
+    if (std::memcmp(data, kFileMagic, sizeof(kFileMagic)) != 0 || LoadUInt32(data + 8) != kFileVersion)
+    {
+        Close();
+        return false;
+    }
+
+    const uint32_t columnCount = LoadUInt32(data + 12);
+    data += sizeof(kFileMagic) + 3 * sizeof(uint32_t);
+
+    for (uint32_t i = 0; i < columnCount; ++i)
+    {
+        if (end - data < 4)
+        {
+            Close();
+            return false;
+        }
+
+        Column column;
+        column.valueType = static_cast<E_ValueType>(data[0]);
+        column.valueSize = data[1];
+        const size_t nameLength = data[2] | (static_cast<size_t>(data[3]) << 8);
+        data += 4;
+
+        if (column.valueSize == 0 || column.valueSize != GetValueTypeSize(column.valueType) || static_cast<size_t>(end - data) < nameLength)
+        {
+            Close();
+            return false;
+        }
+
+        column.name.assign(reinterpret_cast<const char*>(data), nameLength);
+        data += nameLength;
+        columns.push_back(std::move(column));
+    }
+
+
+    /* Locate blocks; stop at the first one that is incomplete. */
+    const size_t streamTableSize = (columns.size() + 1) * sizeof(uint32_t);
+    while (static_cast<size_t>(end - data) >= kBlockHeaderSize + streamTableSize)
+    {
+        const uint32_t streamsByteSize = LoadUInt32(data + 8);
+        if (LoadUInt32(data) != kBlockMagic || streamsByteSize < streamTableSize || static_cast<size_t>(end - data) - kBlockHeaderSize < streamsByteSize)
+            break;
+
+        Block block;
+        block.rowCount = LoadUInt32(data + 4);
+        block.streamTable = data + kBlockHeaderSize;
+        block.streamsEnd = block.streamTable + streamsByteSize;
+        blocks.push_back(block);
+        rowCount += block.rowCount;
+
+        data += kBlockHeaderSize + streamsByteSize;
+    }
+
+    return true;
+}
+
+void MemoryUtilities::RecordingReader::Close()
+{
+    if (view != nullptr)
+        UnmapViewOfFile(view);
+
+    if (hMapping != nullptr)
+        CloseHandle(hMapping);
+
+    if (hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(hFile);
+
+    hFile = INVALID_HANDLE_VALUE;
+    hMapping = nullptr;
+    view = nullptr;
+    viewSize = 0;
+    columns.clear();
+    blocks.clear();
+    rowCount = 0;
+}
+
+bool MemoryUtilities::RecordingReader::IsOpen() const
+{
+    return view != nullptr;
+}
+
+
+
+
+size_t MemoryUtilities::RecordingReader::GetColumnCount() const
+{
+    return columns.size();
+}
+
+std::string MemoryUtilities::RecordingReader::GetColumnName(size_t column) const
+{
+    if (column >= columns.size())
+        return std::string();
+
+    return columns[column].name;
+}
+
+MemoryUtilities::E_ValueType MemoryUtilities::RecordingReader::GetColumnType(size_t column) const
+{
+    if (column >= columns.size())
+        return E_ValueType::Bytes;
+
+    return columns[column].valueType;
+}
+
+size_t MemoryUtilities::RecordingReader::FindColumn(const std::string& name) const
+{
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        if (columns[i].name == name)
+            return i;
+    }
+
+    return InvalidColumn;
+}
+
+uint64_t MemoryUtilities::RecordingReader::GetRowCount() const
+{
+    return rowCount;
+}
+
+size_t MemoryUtilities::RecordingReader::GetBlockCount() const
+{
+    return blocks.size();
+}
+
+
+
+
+bool MemoryUtilities::RecordingReader::ReadTimestamps(std::vector<int64_t>& outTimestamps) const
+{
+    outTimestamps.clear();
+    if (IsOpen() == false)
+        return false;
+
+    outTimestamps.reserve(static_cast<size_t>(rowCount));
+    for (const Block& block : blocks)
+    {
+        const uint8_t* data;
+        size_t size;
+        if (GetStream(block, 0, data, size) == false)
+            return false;
+
+        const uint8_t* end = data + size;
+        uint64_t timestamp = 0;
+        uint64_t delta = 0;
+        for (uint32_t row = 0; row < block.rowCount; ++row)
+        {
+            uint64_t encoded;
+            if (LoadVarint(data, end, encoded) == false)
+                return false;
+
+            delta += static_cast<uint64_t>(ZigZagDecode(encoded));
+            timestamp += delta;
+            outTimestamps.push_back(static_cast<int64_t>(timestamp));
+        }
+    }
+
+    return true;
+}
+
+bool MemoryUtilities::RecordingReader::ReadColumnBits(size_t column, std::vector<uint64_t>& outBits, std::vector<bool>* outValid) const
+{
+    outBits.clear();
+    if (outValid != nullptr)
+        outValid->clear();
+
+    if (IsOpen() == false || column >= columns.size())
+        return false;
+
+    outBits.reserve(static_cast<size_t>(rowCount));
+    for (const Block& block : blocks)
+    {
+        const uint8_t* data;
+        size_t size;
+        if (GetStream(block, column + 1, data, size) == false)
+            return false;
+
+        if (DecodeColumn(data, size, columns[column].valueType, columns[column].valueSize, block.rowCount, outBits, outValid) == false)
+            return false;
+    }
+
+    return true;
+}
+
+
+
+
+bool MemoryUtilities::RecordingReader::GetStream(const Block& block, size_t stream, const uint8_t*& outData, size_t& outSize) const
+{
+    /* Streams follow the size table back to back; the block bounds were checked on Open(), the stream sizes weren't. Every
+       size is checked against what is left of the block, so a corrupted one can't reach into the next block or past the view. */
+    const size_t streamCount = columns.size() + 1;
+    const uint8_t* data = block.streamTable + streamCount * sizeof(uint32_t);
+    size_t remaining = static_cast<size_t>(block.streamsEnd - data);
+
+    for (size_t i = 0; i <= stream; ++i)
+    {
+        const size_t streamSize = LoadUInt32(block.streamTable + i * sizeof(uint32_t));
+        if (streamSize > remaining)
+            return false;
+
+        if (i == stream)
+        {
+            outData = data;
+            outSize = streamSize;
+            break;
+        }
+
+        data += streamSize;
+        remaining -= streamSize;
+    }
+
+    return true;
+}
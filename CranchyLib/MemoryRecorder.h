@@ -0,0 +1,275 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryUtilities.h"
+#include "MemoryWatcher.h"
+#include "RingBuffer.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class Recorder
+	{
+		// Description: Samples a fixed set of typed values of a 3'rd party process at a steady rate and appends them to a columnar,
+		//              block based binary file. Every sample is taken with batched reads; encoding and file I/O happen on a separate
+		//              writer thread that is fed through lock-free ring buffers, so a slow disk never delays sampling.
+		//              Each block holds up to 'rowsPerBlock' rows; timestamps are delta-of-delta encoded, integer columns are
+		//              delta + zigzag + varint encoded and floating point columns are XOR encoded against the previous value.
+		// Search Tags: #external, #record, #recorder, #timeseries, #columnar, #sampling, #compression.
+	public:
+		using ColumnId = uint32_t;
+		static constexpr ColumnId InvalidColumn = 0xFFFFFFFF;
+
+
+		/**
+		* @brief Counters of the current (or last) recording.
+		* @param sampleCount - Rows sampled.
+		* @param droppedSampleCount - Rows lost because the writer thread fell behind and the row buffer was full.
+		* @param failedReadCount - Individual values (or pointers along their path) that couldn't be read; stored as invalid.
+		* @param writtenBlockCount - Blocks written to the file.
+		* @param writtenBytes - Bytes written to the file, header included.
+		*/
+		struct RecorderStatistics
+		{
+			uint64_t sampleCount		= 0;
+			uint64_t droppedSampleCount = 0;
+			uint64_t failedReadCount	= 0;
+			uint64_t writtenBlockCount	= 0;
+			uint64_t writtenBytes		= 0;
+		};
+
+
+
+
+		Recorder() = default;
+		~Recorder();
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+
+
+
+
+		/**
+		* @brief Declares a value that lives directly at 'memoryAddress'. Columns can only be changed while the recorder is stopped.
+		* @param name - Column name stored in the file.
+		* @param valueType - Type of the value, E_ValueType::Bytes isn't supported.
+		* @return Id (index) of the new column, or 'InvalidColumn' if the parameters are invalid or the recorder is running.
+		*/
+		ColumnId AddColumn(const std::string& name, const uintptr_t& memoryAddress, E_ValueType valueType);
+		/**
+		* @brief Declares a value found by following a pointer path, with the same semantics as External::AddressFollowPointerChain.
+		*        The path is re-resolved for every sample.
+		* @return Id (index) of the new column, or 'InvalidColumn' if the parameters are invalid or the recorder is running.
+		*/
+		ColumnId AddColumn(const std::string& name, const uintptr_t& memoryAddress, const std::vector<uintptr_t>& memoryOffsets, E_ValueType valueType);
+
+		bool ClearColumns();
+		size_t GetColumnCount() const;
+
+
+
+
+		/**
+		* @brief Creates (or overwrites) 'filePath' and starts the sampling and writer threads.
+		* @param hProcess - Process HANDLE to sample, must stay open until Stop() is called.
+		* @param sampleInterval - Time between two rows.
+		* @param rowsPerBlock - Number of rows encoded together into one block.
+		* @param bufferedRows - Rows that can wait for the writer thread before new samples are dropped.
+		* @return true if recording was started; false if there are no columns, the file couldn't be created or the recorder is already running.
+		*/
+		bool Start(const HANDLE& hProcess, const std::string& filePath, std::chrono::microseconds sampleInterval, size_t rowsPerBlock = 1024, size_t bufferedRows = 8192);
+		/**
+		* @brief Stops sampling, writes every buffered row and closes the file.
+		* @return true if no rows were dropped and every write succeeded.
+		*/
+		bool Stop();
+		bool IsRunning() const;
+
+		RecorderStatistics GetStatistics() const;
+
+
+
+
+	private:
+		struct Column
+		{
+			std::string			   name;
+			uintptr_t			   memoryAddress = 0x0;
+			std::vector<uintptr_t> memoryOffsets;
+			E_ValueType			   valueType	 = E_ValueType::Int32;
+			size_t				   valueSize	 = 0;
+		};
+
+
+		void SamplingLoop();
+		void WritingLoop();
+		bool WriteBlock();
+		bool WriteToFile(const std::vector<uint8_t>& bytes);
+
+
+		HANDLE					  hProcess = nullptr;
+		HANDLE					  hFile	   = INVALID_HANDLE_VALUE;
+		std::vector<Column>		  columns;
+		std::chrono::nanoseconds  sampleInterval{ 0 };
+		size_t					  rowsPerBlock = 0;
+		std::chrono::steady_clock::time_point startTime;
+
+		std::thread				  samplingThread;
+		std::thread				  writingThread;
+		std::atomic<bool>		  running{ false };
+		std::atomic<bool>		  samplingStopped{ false };
+		std::atomic<bool>		  writeFailed{ false };
+		std::mutex				  samplingMutex;
+		std::condition_variable	  samplingCondition;
+		std::mutex				  writerMutex;
+		std::condition_variable	  writerCondition;
+
+		/* Row storage shared by both threads. A row slot is owned by whoever last popped its index from a ring. */
+		std::vector<int64_t>	  rowTimestamps;
+		std::vector<uint64_t>	  rowValues;   // 'columns.size()' values per row.
+		std::vector<uint8_t>	  rowValidity; // 'columns.size()' flags per row.
+		std::unique_ptr<SpscRingBuffer<uint32_t>> freeRows;   // Writer -> sampler.
+		std::unique_ptr<SpscRingBuffer<uint32_t>> filledRows; // Sampler -> writer.
+
+		/* Sampling thread scratch state. */
+		std::vector<External::BatchPointerChain> chains;
+		std::vector<External::BatchRead>		 batch;
+		External::BatchScratch					 batchScratch;
+
+		/* Writer thread block staging, column major. */
+		std::vector<int64_t>	  blockTimestamps;
+		std::vector<uint64_t>	  blockValues;
+		std::vector<uint8_t>	  blockValidity;
+		size_t					  blockRowCount = 0;
+		std::vector<uint8_t>	  encodedBlock;
+
+		std::atomic<uint64_t>	  sampleCount{ 0 };
+		std::atomic<uint64_t>	  droppedSampleCount{ 0 };
+		std::atomic<uint64_t>	  failedReadCount{ 0 };
+		std::atomic<uint64_t>	  writtenBlockCount{ 0 };
+		std::atomic<uint64_t>	  writtenBytes{ 0 };
+	};
+
+
+
+
+
+
+	class RecordingReader
+	{
+		// Description: Reads files produced by Recorder through a read-only memory mapping. Blocks are located once on Open() and
+		//              decoded on demand; a truncated last block (e.g. the recording process crashed) is ignored.
+		// Search Tags: #record, #recorder, #timeseries, #columnar, #reader, #mapping.
+	public:
+		static constexpr size_t InvalidColumn = static_cast<size_t>(-1);
+
+
+		RecordingReader() = default;
+		~RecordingReader();
+		RecordingReader(const RecordingReader&) = delete;
+		RecordingReader& operator=(const RecordingReader&) = delete;
+
+
+
+
+		bool Open(const std::string& filePath);
+		void Close();
+		bool IsOpen() const;
+
+
+
+
+		size_t		GetColumnCount() const;
+		std::string GetColumnName(size_t column) const;
+		E_ValueType GetColumnType(size_t column) const;
+		/**
+		* @return Index of the first column called 'name', or 'InvalidColumn' if there is none.
+		*/
+		size_t		FindColumn(const std::string& name) const;
+
+		uint64_t	GetRowCount() const;
+		size_t		GetBlockCount() const;
+
+
+
+
+		/**
+		* @brief Decodes the timestamp of every row, in nanoseconds since the recording was started.
+		*/
+		bool ReadTimestamps(std::vector<int64_t>& outTimestamps) const;
+
+		/**
+		* @brief Decodes a column as raw value bits (the value's bytes, zero extended to 64 bits).
+		* @param outValid - Optional; receives false for rows whose value couldn't be read while recording.
+		*/
+		bool ReadColumnBits(size_t column, std::vector<uint64_t>& outBits, std::vector<bool>* outValid = nullptr) const;
+
+		/**
+		* @brief Decodes a column as values of type 'T', which must have the size of the column's type.
+		*/
+		template<typename T>
+		bool ReadColumn(size_t column, std::vector<T>& outValues, std::vector<bool>* outValid = nullptr) const
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Column values must be trivially copyable.");
+			if (column >= columns.size() || sizeof(T) != columns[column].valueSize)
+				return false;
+
+			std::vector<uint64_t> bits;
+			if (ReadColumnBits(column, bits, outValid) == false)
+				return false;
+
+			outValues.resize(bits.size());
+			for (size_t i = 0; i < bits.size(); ++i)
+			{
+				std::memcpy(&outValues[i], &bits[i], sizeof(T));
+			}
+
+			return true;
+		}
+
+
+
+
+	private:
+		struct Column
+		{
+			std::string name;
+			E_ValueType valueType = E_ValueType::Int32;
+			size_t		valueSize = 0;
+		};
+
+		struct Block
+		{
+			const uint8_t* streamTable = nullptr; // 'columns.size() + 1' stream sizes (timestamps first), followed by the streams.
+			const uint8_t* streamsEnd  = nullptr; // End of the block's last stream.
+			uint32_t	   rowCount	   = 0;
+		};
+
+
+		bool GetStream(const Block& block, size_t stream, const uint8_t*& outData, size_t& outSize) const;
+
+
+		HANDLE				hFile	 = INVALID_HANDLE_VALUE;
+		HANDLE				hMapping = nullptr;
+		const uint8_t*		view	 = nullptr;
+		size_t				viewSize = 0;
+
+		std::vector<Column> columns;
+		std::vector<Block>	blocks;
+		uint64_t			rowCount = 0;
+	};
+}
@@ -0,0 +1,241 @@
+#include "MemoryReferences.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "MemoryInstructions.h"
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    constexpr size_t kChunkSize = 64 * 1024;
+    /* Bytes decoded before a chunk's start so that its sweep falls in step with the instructions of the previous chunk;
+       x86 code resynchronizes within a few instructions. */
+    constexpr size_t kLeadInSize = 256;
+
+
+
+    /* Part of an executable section, decoded as one task. Offsets are into the image data. */
+    struct CodeChunk
+    {
+        size_t   sectionOffset = 0; // Where the section starts; the lead-in never goes before it.
+        size_t   sectionEnd    = 0; // Where it ends; the last instruction may run past the chunk, not past this.
+        size_t   offset        = 0;
+        size_t   size          = 0;
+        uint32_t rva           = 0;
+    };
+
+
+    bool CompareReferences(const MemoryUtilities::CodeReference& left, const MemoryUtilities::CodeReference& right)
+    {
+        if (left.targetRva != right.targetRva)
+            return left.targetRva < right.targetRva;
+        if (left.sourceRva != right.sourceRva)
+            return left.sourceRva < right.sourceRva;
+        return left.type < right.type;
+    }
+
+
+    /* Executable parts of the image, split into chunks. Images without headers are taken as code from end to end. */
+    std::vector<CodeChunk> SplitCode(const MemoryUtilities::ModuleImage& module)
+    {
+        std::vector<CodeChunk> chunks;
+        auto addSection = [&chunks](size_t sectionOffset, uint32_t sectionRva, size_t sectionSize)
+        {
+            for (size_t position = 0; position < sectionSize; position += kChunkSize)
+            {
+                CodeChunk chunk;
+                chunk.sectionOffset = sectionOffset;
+                chunk.sectionEnd = sectionOffset + sectionSize;
+                chunk.offset = sectionOffset + position;
+                chunk.size = std::min<size_t>(kChunkSize, sectionSize - position);
+                chunk.rva = sectionRva + static_cast<uint32_t>(position);
+                chunks.push_back(chunk);
+            }
+        };
+
+        if (module.HasHeaders() == false)
+        {
+            addSection(0, 0, module.GetSize());
+            return chunks;
+        }
+
+        const bool isFile = module.GetLayout() == MemoryUtilities::ModuleImage::E_Layout::File;
+        for (const MemoryUtilities::ImageSection& section : module.GetSections())
+        {
+            size_t offset = 0;
+            const size_t sectionSize = isFile ? std::min<size_t>(section.virtualSize, section.rawDataSize) : section.virtualSize;
+            if (section.isExecutable && sectionSize != 0 && module.RvaToOffset(section.virtualAddress, sectionSize, offset))
+                addSection(offset, section.virtualAddress, sectionSize);
+        }
+
+        return chunks;
+    }
+
+
+    void IndexChunk(const uint8_t* image, const CodeChunk& chunk, bool is64Bit, uintptr_t absoluteBase, uint32_t sizeOfImage, std::vector<MemoryUtilities::CodeReference>& outReferences)
+    {
+        const size_t immediatePointerSize = is64Bit ? 8 : 4;
+        const size_t chunkEnd = chunk.offset + chunk.size;
+
+        size_t position = chunk.offset - std::min<size_t>(kLeadInSize, chunk.offset - chunk.sectionOffset);
+        while (position < chunkEnd)
+        {
+            MemoryUtilities::DecodedInstruction instruction;
+            if (MemoryUtilities::InstructionDecoder::Decode(image + position, chunk.sectionEnd - position, is64Bit, instruction) == false)
+            {
+                ++position; // Data or padding; step over it a byte at a time.
+                continue;
+            }
+
+            if (position >= chunk.offset)
+            {
+                const uint8_t* code = image + position;
+                const uint32_t sourceRva = chunk.rva + static_cast<uint32_t>(position - chunk.offset);
+                const uintptr_t sourceAddress = absoluteBase + sourceRva;
+
+                /* Targets are computed at the module's absolute base, so absolute operands and relative ones come out alike. */
+                uintptr_t targetAddress = 0x0;
+                if (MemoryUtilities::InstructionDecoder::GetReferencedAddress(code, instruction, sourceAddress, targetAddress) && targetAddress - absoluteBase < sizeOfImage)
+                {
+                    MemoryUtilities::E_ReferenceType type = MemoryUtilities::E_ReferenceType::Memory;
+                    if (instruction.isRelative)
+                        type = instruction.opcodeMap == 0 && instruction.opcode == 0xE8 ? MemoryUtilities::E_ReferenceType::Call : MemoryUtilities::E_ReferenceType::Jump;
+
+                    outReferences.push_back({ sourceRva, static_cast<uint32_t>(targetAddress - absoluteBase), type });
+                }
+
+                /* Pointer-sized immediates, unless they're the moffs already taken above. A module without a base would make every small constant an address. */
+                if (absoluteBase != 0x0 && instruction.immediateSize == immediatePointerSize && instruction.isRelative == false && (instruction.isAbsoluteAddress && instruction.displacementSize == 0) == false)
+                {
+                    uint64_t value = 0;
+                    std::memcpy(&value, code + instruction.immediateOffset, immediatePointerSize);
+                    const uintptr_t immediateAddress = static_cast<uintptr_t>(value);
+                    if (immediateAddress - absoluteBase < sizeOfImage)
+                        outReferences.push_back({ sourceRva, static_cast<uint32_t>(immediateAddress - absoluteBase), MemoryUtilities::E_ReferenceType::Immediate });
+                }
+            }
+
+            position += instruction.length;
+        }
+    }
+}
+
+
+
+
+
+
+bool MemoryUtilities::ReferenceIndex::Build(const ModuleImage& module)
+{
+    return Build(module, ThreadingUtilities::GetSharedPool());
+}
+
+bool MemoryUtilities::ReferenceIndex::Build(const ModuleImage& module, ThreadingUtilities::ThreadPool& pool)
+{
+    Clear();
+    if (module.IsLoaded() == false)
+        return false;
+
+    CRANCHYLIB_TRACE_SCOPE("image", "ReferenceIndex::Build", module.GetSize());
+    baseAddress = module.GetBaseAddress();
+
+    /* A file isn't relocated: its absolute operands hold addresses at the base it was linked for. */
+    const uintptr_t absoluteBase = module.GetLayout() == ModuleImage::E_Layout::File ? module.GetPreferredBaseAddress() : module.GetBaseAddress();
+    const uint32_t sizeOfImage = std::max<uint32_t>(module.GetSizeOfImage(), static_cast<uint32_t>(std::min<size_t>(module.GetSize(), ModuleImage::InvalidRva)));
+
+    const std::vector<CodeChunk> chunks = SplitCode(module);
+    std::vector<std::vector<CodeReference>> chunkReferences(chunks.size());
+    ThreadingUtilities::TaskGroup group(pool);
+    ThreadingUtilities::ParallelFor(group, 0, chunks.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            IndexChunk(module.GetData(), chunks[i], module.Is64Bit(), absoluteBase, sizeOfImage, chunkReferences[i]);
+        }
+    });
+
+    size_t referenceCount = 0;
+    for (const std::vector<CodeReference>& chunk : chunkReferences)
+    {
+        referenceCount += chunk.size();
+    }
+
+    references.reserve(referenceCount);
+    for (const std::vector<CodeReference>& chunk : chunkReferences)
+    {
+        references.insert(references.end(), chunk.begin(), chunk.end());
+    }
+
+    std::sort(references.begin(), references.end(), CompareReferences);
+    return true;
+}
+
+void MemoryUtilities::ReferenceIndex::Clear()
+{
+    references.clear();
+    references.shrink_to_fit();
+    baseAddress = 0x0;
+}
+
+
+
+
+size_t MemoryUtilities::ReferenceIndex::GetReferenceCount() const
+{
+    return references.size();
+}
+
+const std::vector<MemoryUtilities::CodeReference>& MemoryUtilities::ReferenceIndex::GetReferences() const
+{
+    return references;
+}
+
+uintptr_t MemoryUtilities::ReferenceIndex::GetBaseAddress() const
+{
+    return baseAddress;
+}
+
+
+
+
+std::vector<MemoryUtilities::CodeReference> MemoryUtilities::ReferenceIndex::FindReferencesTo(uint32_t targetRva) const
+{
+    return FindReferencesToRange(targetRva, targetRva + 1);
+}
+
+std::vector<MemoryUtilities::CodeReference> MemoryUtilities::ReferenceIndex::FindReferencesToRange(uint32_t beginRva, uint32_t endRva) const
+{
+    if (beginRva >= endRva)
+        return {};
+
+    const auto first = std::lower_bound(references.begin(), references.end(), beginRva, [](const CodeReference& reference, uint32_t rva)
+    {
+        return reference.targetRva < rva;
+    });
+    const auto last = std::lower_bound(first, references.end(), endRva, [](const CodeReference& reference, uint32_t rva)
+    {
+        return reference.targetRva < rva;
+    });
+
+    return std::vector<CodeReference>(first, last);
+}
+
+std::vector<uintptr_t> MemoryUtilities::ReferenceIndex::FindReferencingAddresses(uintptr_t address) const
+{
+    std::vector<uintptr_t> addresses;
+    if (address < baseAddress || address - baseAddress >= ModuleImage::InvalidRva)
+        return addresses;
+
+    for (const CodeReference& reference : FindReferencesTo(static_cast<uint32_t>(address - baseAddress)))
+    {
+        addresses.push_back(baseAddress + reference.sourceRva);
+    }
+
+    return addresses;
+}
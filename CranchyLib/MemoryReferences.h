@@ -0,0 +1,98 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <vector>
+
+#include "MemoryImages.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	enum class E_ReferenceType : uint8_t
+	{
+		Call,	  // CALL rel32.
+		Jump,	  // JMP, Jcc, LOOP and JECXZ with a relative target.
+		Memory,	  // Memory operand at a fixed address: [rip + disp32] on x64, [disp32] and moffs on x86.
+		Immediate // Pointer-sized immediate holding an address of the module, e.g. PUSH offset on x86 or MOV r64, imm64.
+	};
+
+
+	/**
+	* @brief One instruction referring to a location of its module.
+	* @param sourceRva - RVA of the instruction.
+	* @param targetRva - RVA it refers to.
+	* @param type - How it refers to it.
+	*/
+	struct CodeReference
+	{
+		uint32_t		sourceRva = 0;
+		uint32_t		targetRva = 0;
+		E_ReferenceType type	  = E_ReferenceType::Call;
+	};
+
+
+
+
+
+
+	class ReferenceIndex
+	{
+		// Description: Answers "who calls this function" and "who uses this global" for a whole module at once, instead of with a
+		//              scan per target. The executable sections are walked instruction by instruction (InstructionDecoder) in
+		//              parallel chunks, and every relative call / jump, fixed memory operand and pointer-sized immediate landing
+		//              inside the module is kept, 12 bytes per reference, sorted by target: a lookup is then a binary search.
+		//              Works on any ModuleImage - a module of the current process, one copied from a target process, or a file.
+		//              Instructions are found by linear sweep, so data embedded in code may now and then yield a stray reference.
+		// Search Tags: #xref, #references, #callers, #calls, #jumps, #rip, #disassembly, #index, #analysis, #usages.
+	public:
+		/**
+		* @brief Indexes the references of a module's code, replacing any previous index. The module isn't needed afterwards.
+		* @return false if the module isn't loaded.
+		*/
+		bool Build(const ModuleImage& module);
+		bool Build(const ModuleImage& module, ThreadingUtilities::ThreadPool& pool);
+		void Clear();
+
+		size_t									 GetReferenceCount() const;
+		/**
+		* @return Every reference, sorted by target RVA and then by source RVA.
+		*/
+		const std::vector<CodeReference>&		 GetReferences() const;
+		/**
+		* @return Base address of the indexed module, for turning RVAs into addresses.
+		*/
+		uintptr_t								 GetBaseAddress() const;
+
+
+
+
+		/**
+		* @brief Finds the instructions referring to a location of the module.
+		* @param targetRva - RVA of the location, e.g. of a function's first instruction or a global variable.
+		* @return References to it, ordered by source RVA; empty if there are none.
+		*/
+		std::vector<CodeReference>				 FindReferencesTo(uint32_t targetRva) const;
+		/**
+		* @brief Finds the instructions referring to anywhere in [beginRva, endRva), e.g. to any field of a global structure.
+		* @return References ordered by target RVA, then by source RVA.
+		*/
+		std::vector<CodeReference>				 FindReferencesToRange(uint32_t beginRva, uint32_t endRva) const;
+		/**
+		* @brief Same as FindReferencesTo(), with addresses in the module's address space instead of RVAs.
+		* @return Addresses of the instructions referring to 'address'.
+		*/
+		std::vector<uintptr_t>					 FindReferencingAddresses(uintptr_t address) const;
+
+
+
+
+	private:
+		std::vector<CodeReference> references; // Sorted by target, then source.
+		uintptr_t				   baseAddress = 0x0;
+	};
+}
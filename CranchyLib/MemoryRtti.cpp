@@ -0,0 +1,889 @@
+#include "MemoryRtti.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    constexpr size_t   kChunkSize = 64 * 1024;
+    constexpr size_t   kMaximumNameLength = 1024;
+    constexpr uint32_t kMaximumBaseClasses = 1024;
+    constexpr int64_t  kMaximumObjectSize = 0x1000000; // Larger offsets to top are taken for other data.
+    constexpr uint32_t kMaximumEmptySlots = 2;          // Null slots allowed before the first virtual function of an ELF vtable.
+
+
+
+    /* MSVC RTTI. x64 modules (locator signature 1) link the structures by RVA, x86 ones (signature 0) by address. */
+    constexpr uint32_t kLocatorSignature32 = 0;
+    constexpr uint32_t kLocatorSignature64 = 1;
+
+    struct CompleteObjectLocator
+    {
+        uint32_t signature;
+        uint32_t offset;            // Of the subobject whose vtable the locator sits before.
+        uint32_t constructorOffset;
+        uint32_t typeDescriptor;
+        uint32_t classDescriptor;
+        uint32_t self;              // x64 only: RVA of the locator itself.
+    };
+
+    struct ClassHierarchyDescriptor
+    {
+        uint32_t signature;
+        uint32_t attributes;
+        uint32_t baseClassCount;    // The class itself included.
+        uint32_t baseClassArray;
+    };
+
+    struct BaseClassDescriptor
+    {
+        uint32_t typeDescriptor;
+        uint32_t containedBaseCount; // Bases of this base, listed right after it.
+        int32_t  memberOffset;
+        int32_t  vbtableOffset;
+        int32_t  vbtableDisplacement;
+        uint32_t attributes;
+    };
+
+
+
+    /* Itanium C++ ABI: a vtable starts with the offset to top and the class's type_info, whose own vtable tells its kind. */
+    enum class E_TypeInfoKind
+    {
+        None,
+        Class,                     // No bases.
+        SingleInheritance,         // One public, non-virtual base at offset 0.
+        VirtualMultipleInheritance // Anything else: a count of bases and their offsets.
+    };
+
+    constexpr char kClassTypeInfoVtable[] = "_ZTVN10__cxxabiv117__class_type_infoE";
+    constexpr char kSingleInheritanceTypeInfoVtable[] = "_ZTVN10__cxxabiv120__si_class_type_infoE";
+    constexpr char kVirtualMultipleInheritanceTypeInfoVtable[] = "_ZTVN10__cxxabiv121__vmi_class_type_infoE";
+    constexpr char kTypeInfoPrefix[] = "_ZTI";
+
+    /* ELF dynamic symbols and relocations; shared objects leave their pointers to the dynamic linker. Type numbers are those of x64 and x86 alike. */
+    constexpr uint32_t kElfRelocationAbsolute = 1;   // R_X86_64_64 / R_386_32
+    constexpr uint32_t kElfRelocationGlobalData = 6; // R_X86_64_GLOB_DAT / R_386_GLOB_DAT
+    constexpr uint32_t kElfRelocationRelative = 8;   // R_X86_64_RELATIVE / R_386_RELATIVE
+
+    struct ElfSymbol32
+    {
+        uint32_t st_name, st_value, st_size;
+        uint8_t  st_info, st_other;
+        uint16_t st_shndx;
+    };
+
+    struct ElfSymbol64
+    {
+        uint32_t st_name;
+        uint8_t  st_info, st_other;
+        uint16_t st_shndx;
+        uint64_t st_value, st_size;
+    };
+
+    struct ElfRelocation32
+    {
+        uint32_t r_offset, r_info;
+    };
+
+    struct ElfRelocation64
+    {
+        uint64_t r_offset, r_info;
+        int64_t  r_addend;
+    };
+
+
+
+    /* Pointer read from the module: a location inside it, and / or the symbol the dynamic linker resolves it to. */
+    struct ModulePointer
+    {
+        uint32_t           rva    = MemoryUtilities::ModuleImage::InvalidRva;
+        const std::string* symbol = nullptr;
+    };
+
+
+    /* Reads the module by RVA, with pointers as they'd be once loaded. */
+    class ModuleReader
+    {
+    public:
+        explicit ModuleReader(const MemoryUtilities::ModuleImage& module) : module(module)
+        {
+            const bool isFile = module.GetLayout() == MemoryUtilities::ModuleImage::E_Layout::File;
+            absoluteBase = isFile ? module.GetPreferredBaseAddress() : module.GetBaseAddress();
+            sizeOfImage = std::max<uint32_t>(module.GetSizeOfImage(), static_cast<uint32_t>(std::min<size_t>(module.GetSize(), MemoryUtilities::ModuleImage::InvalidRva)));
+            pointerSize = module.Is64Bit() ? 8 : 4;
+            isElf = module.HasHeaders() && module.GetSize() >= 4 && std::memcmp(module.GetData(), "\x7F" "ELF", 4) == 0;
+
+            if (isElf && module.Is64Bit())
+                LoadElfRelocations<ElfSymbol64, ElfRelocation64>(".rela.dyn");
+            else if (isElf)
+                LoadElfRelocations<ElfSymbol32, ElfRelocation32>(".rel.dyn");
+        }
+
+
+        bool   IsElf() const { return isElf; }
+        size_t GetPointerSize() const { return pointerSize; }
+
+        bool ReadBytes(uint32_t rva, void* outBuffer, size_t size) const
+        {
+            size_t offset = 0;
+            if (module.RvaToOffset(rva, size, offset) == false)
+                return false;
+
+            std::memcpy(outBuffer, module.GetData() + offset, size);
+            return true;
+        }
+
+        template<typename T>
+        bool Read(uint32_t rva, T& outValue) const
+        {
+            return ReadBytes(rva, &outValue, sizeof(T));
+        }
+
+        /* Pointer-sized value as stored, without relocations. */
+        bool ReadRaw(uint32_t rva, uint64_t& outValue) const
+        {
+            outValue = 0;
+            return ReadBytes(rva, &outValue, pointerSize);
+        }
+
+        bool ReadString(uint32_t rva, std::string& outText) const
+        {
+            outText.clear();
+            for (size_t i = 0; i < kMaximumNameLength; ++i)
+            {
+                char character = 0;
+                if (Read(rva + static_cast<uint32_t>(i), character) == false)
+                    return false;
+                if (character == 0)
+                    return outText.empty() == false;
+
+                outText.push_back(character);
+            }
+
+            return false;
+        }
+
+        /* Absolute address, as the module holds it, to RVA. */
+        uint32_t ToRva(uint64_t address) const
+        {
+            if (address == 0 || address - absoluteBase >= sizeOfImage)
+                return MemoryUtilities::ModuleImage::InvalidRva;
+
+            return static_cast<uint32_t>(address - absoluteBase);
+        }
+
+        bool HasRelocation(uint32_t rva) const
+        {
+            return relocations.find(rva) != relocations.end();
+        }
+
+        bool ReadPointer(uint32_t rva, ModulePointer& outPointer) const
+        {
+            outPointer = ModulePointer();
+            const auto relocation = relocations.find(rva);
+            if (relocation != relocations.end())
+            {
+                outPointer.rva = relocation->second.targetRva;
+                outPointer.symbol = relocation->second.symbolIndex != 0 ? &symbolNames[relocation->second.symbolIndex] : nullptr;
+                return outPointer.rva != MemoryUtilities::ModuleImage::InvalidRva || outPointer.symbol != nullptr;
+            }
+
+            uint64_t value = 0;
+            if (ReadRaw(rva, value) == false)
+                return false;
+
+            outPointer.rva = ToRva(value);
+            return outPointer.rva != MemoryUtilities::ModuleImage::InvalidRva;
+        }
+
+        bool IsExecutable(uint32_t rva) const
+        {
+            if (module.HasHeaders() == false)
+                return rva < sizeOfImage;
+
+            for (const MemoryUtilities::ImageSection& section : module.GetSections())
+            {
+                if (section.isExecutable && rva >= section.virtualAddress && rva - section.virtualAddress < section.virtualSize)
+                    return true;
+            }
+
+            return false;
+        }
+
+        E_TypeInfoKind GetTypeInfoKind(const ModulePointer& vtable) const
+        {
+            if (vtable.symbol != nullptr)
+            {
+                if (*vtable.symbol == kClassTypeInfoVtable)
+                    return E_TypeInfoKind::Class;
+                if (*vtable.symbol == kSingleInheritanceTypeInfoVtable)
+                    return E_TypeInfoKind::SingleInheritance;
+                if (*vtable.symbol == kVirtualMultipleInheritanceTypeInfoVtable)
+                    return E_TypeInfoKind::VirtualMultipleInheritance;
+            }
+
+            const auto kind = typeInfoVtables.find(vtable.rva);
+            return kind != typeInfoVtables.end() ? kind->second : E_TypeInfoKind::None;
+        }
+
+        /* Symbol of a type_info the module exports - or holds a copy of, as executables do of the type_info they use from
+           shared libraries, whose content is only filled in at load time. */
+        const std::string* FindTypeInfoSymbol(uint32_t rva) const
+        {
+            const auto symbol = typeInfoSymbols.find(rva);
+            return symbol != typeInfoSymbols.end() ? &symbolNames[symbol->second] : nullptr;
+        }
+
+
+    private:
+        struct Relocation
+        {
+            uint32_t targetRva   = MemoryUtilities::ModuleImage::InvalidRva;
+            uint32_t symbolIndex = 0; // Into 'symbolNames'; 0 for none.
+        };
+
+
+        const MemoryUtilities::ImageSection* FindSection(const char* name) const
+        {
+            for (const MemoryUtilities::ImageSection& section : module.GetSections())
+            {
+                if (section.name == name)
+                    return &section;
+            }
+
+            return nullptr;
+        }
+
+        /* Dynamic relocations of pointer slots; their symbols name what a slot points to outside the module. Files only: loaded
+           modules have their pointers filled in already. */
+        template<typename Symbol, typename ElfRelocation>
+        void LoadElfRelocations(const char* relocationSectionName)
+        {
+            const MemoryUtilities::ImageSection* symbolSection = FindSection(".dynsym");
+            const MemoryUtilities::ImageSection* nameSection = FindSection(".dynstr");
+            const MemoryUtilities::ImageSection* relocationSection = FindSection(relocationSectionName);
+            if (symbolSection == nullptr || nameSection == nullptr)
+                return;
+
+            std::vector<uint32_t> symbolTargets;
+            const size_t symbolCount = symbolSection->virtualSize / sizeof(Symbol);
+            symbolNames.resize(symbolCount);
+            symbolTargets.resize(symbolCount, MemoryUtilities::ModuleImage::InvalidRva);
+            for (size_t i = 1; i < symbolCount; ++i)
+            {
+                Symbol symbol;
+                if (Read(symbolSection->virtualAddress + static_cast<uint32_t>(i * sizeof(Symbol)), symbol) == false)
+                    break;
+
+                ReadString(nameSection->virtualAddress + symbol.st_name, symbolNames[i]);
+                if (symbol.st_shndx == 0) // Undefined: lives in another module.
+                    continue;
+
+                symbolTargets[i] = ToRva(symbol.st_value);
+                if (symbolNames[i].compare(0, 4, kTypeInfoPrefix) == 0 && symbolTargets[i] != MemoryUtilities::ModuleImage::InvalidRva)
+                    typeInfoSymbols[symbolTargets[i]] = i;
+
+                const E_TypeInfoKind kind = GetTypeInfoKind({ MemoryUtilities::ModuleImage::InvalidRva, &symbolNames[i] });
+                if (kind != E_TypeInfoKind::None && symbolTargets[i] != MemoryUtilities::ModuleImage::InvalidRva)
+                    typeInfoVtables[symbolTargets[i] + static_cast<uint32_t>(2 * pointerSize)] = kind; // type_info objects point past the offset to top and type_info of their vtable.
+            }
+
+            if (relocationSection == nullptr)
+                return;
+
+            const bool hasAddend = sizeof(ElfRelocation) == sizeof(ElfRelocation64);
+            const size_t relocationCount = relocationSection->virtualSize / sizeof(ElfRelocation);
+            for (size_t i = 0; i < relocationCount; ++i)
+            {
+                ElfRelocation elfRelocation;
+                if (Read(relocationSection->virtualAddress + static_cast<uint32_t>(i * sizeof(ElfRelocation)), elfRelocation) == false)
+                    break;
+
+                const uint64_t info = elfRelocation.r_info;
+                const uint32_t type = hasAddend ? static_cast<uint32_t>(info & 0xFFFFFFFF) : static_cast<uint32_t>(info & 0xFF);
+                const size_t symbolIndex = hasAddend ? static_cast<size_t>(info >> 32) : static_cast<size_t>(info >> 8);
+                const uint32_t slotRva = ToRva(elfRelocation.r_offset);
+                if (slotRva == MemoryUtilities::ModuleImage::InvalidRva || symbolIndex >= symbolCount)
+                    continue;
+
+                /* REL relocations keep their addend in the slot. */
+                uint64_t addend = 0;
+                if (hasAddend)
+                    addend = static_cast<uint64_t>(GetAddend(elfRelocation));
+                else if (ReadRaw(slotRva, addend) == false)
+                    continue;
+
+                Relocation relocation;
+                if (type == kElfRelocationRelative)
+                {
+                    relocation.targetRva = ToRva(addend); // Address the slot would hold if loaded at the preferred base.
+                }
+                else if (type == kElfRelocationAbsolute || type == kElfRelocationGlobalData)
+                {
+                    relocation.symbolIndex = static_cast<uint32_t>(symbolIndex);
+                    if (symbolTargets[symbolIndex] != MemoryUtilities::ModuleImage::InvalidRva)
+                        relocation.targetRva = ToRva(absoluteBase + symbolTargets[symbolIndex] + (type == kElfRelocationAbsolute ? addend : 0)); // S + A; GOT entries take S alone.
+                }
+                else
+                {
+                    continue;
+                }
+
+                relocations[slotRva] = relocation;
+            }
+        }
+
+        static int64_t GetAddend(const ElfRelocation64& relocation) { return relocation.r_addend; }
+        static int64_t GetAddend(const ElfRelocation32&) { return 0; }
+
+
+        const MemoryUtilities::ModuleImage&          module;
+        uintptr_t                                    absoluteBase = 0x0;
+        uint32_t                                     sizeOfImage  = 0;
+        size_t                                       pointerSize  = sizeof(void*);
+        bool                                         isElf        = false;
+
+        std::vector<std::string>                     symbolNames;
+        std::unordered_map<uint32_t, Relocation>     relocations;     // By slot RVA.
+        std::unordered_map<uint32_t, E_TypeInfoKind> typeInfoVtables; // type_info vtables defined in the module, by address point.
+        std::unordered_map<uint32_t, size_t>         typeInfoSymbols; // Exported type_info objects, by RVA.
+    };
+
+
+
+    /* ".?AVPlayer@game@@" -> "game::Player". Templates and anonymous namespaces are left to the caller's fallback. */
+    bool UndecorateMsvcTypeName(const std::string& decoratedName, std::string& outName)
+    {
+        if ((decoratedName.compare(0, 4, ".?AV") != 0 && decoratedName.compare(0, 4, ".?AU") != 0) || decoratedName.size() < 7 ||
+            decoratedName.compare(decoratedName.size() - 2, 2, "@@") != 0)
+            return false;
+
+        std::vector<std::string> scopes;
+        const std::string body = decoratedName.substr(4, decoratedName.size() - 6);
+        for (size_t begin = 0; begin <= body.size();)
+        {
+            const size_t end = std::min<size_t>(body.find('@', begin), body.size());
+            const std::string scope = body.substr(begin, end - begin);
+            if (scope.empty() || scope[0] == '?' || (scope[0] >= '0' && scope[0] <= '9'))
+                return false;
+
+            scopes.push_back(scope);
+            begin = end + 1;
+        }
+
+        outName.clear();
+        for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope)
+        {
+            outName += outName.empty() ? *scope : "::" + *scope;
+        }
+        return true;
+    }
+
+    /* "N4game6PlayerE" -> "game::Player", "St9exception" -> "std::exception". Only plain nested names are demangled. */
+    bool DemangleItaniumTypeName(const std::string& mangledName, std::string& outName)
+    {
+        size_t position = 0;
+        std::vector<std::string> scopes;
+        auto readSourceName = [&]()
+        {
+            size_t length = 0;
+            const size_t digitsBegin = position;
+            while (position < mangledName.size() && mangledName[position] >= '0' && mangledName[position] <= '9' && position - digitsBegin < 6)
+            {
+                length = length * 10 + (mangledName[position++] - '0');
+            }
+
+            if (position == digitsBegin || length == 0 || mangledName.size() - position < length)
+                return false;
+
+            const std::string scope = mangledName.substr(position, length);
+            scopes.push_back(scope.compare(0, 10, "_GLOBAL__N") == 0 ? "(anonymous namespace)" : scope);
+            position += length;
+            return true;
+        };
+
+        const bool isNested = mangledName.compare(0, 1, "N") == 0;
+        position = isNested ? 1 : 0;
+        if (mangledName.compare(position, 2, "St") == 0)
+        {
+            scopes.push_back("std");
+            position += 2;
+        }
+
+        do
+        {
+            if (readSourceName() == false)
+                return false;
+        } while (isNested && position < mangledName.size() && mangledName[position] != 'E');
+
+        if (isNested && (position >= mangledName.size() || mangledName[position++] != 'E'))
+            return false;
+        if (position != mangledName.size())
+            return false;
+
+        outName.clear();
+        for (const std::string& scope : scopes)
+        {
+            outName += outName.empty() ? scope : "::" + scope;
+        }
+        return true;
+    }
+
+
+
+    /* A vtable found by the sweep, and the RTTI record it was found through. */
+    struct FoundVtable
+    {
+        uint32_t    recordRva = 0;    // Complete Object Locator (MSVC) or type_info (Itanium); InvalidRva for an imported type_info.
+        std::string importedType;     // Mangled name of an imported type_info.
+        uint32_t    vtableRva = 0;
+        uint32_t    offset    = 0;
+    };
+
+    /* Part of the module's data, swept as one task. */
+    struct DataChunk
+    {
+        uint32_t rva  = 0;
+        size_t   size = 0;
+    };
+
+
+    std::vector<DataChunk> SplitData(const MemoryUtilities::ModuleImage& module, size_t pointerSize, bool includeCode)
+    {
+        std::vector<DataChunk> chunks;
+        auto addRange = [&chunks](uint32_t rva, size_t size)
+        {
+            for (size_t position = 0; position < size; position += kChunkSize)
+            {
+                chunks.push_back({ rva + static_cast<uint32_t>(position), std::min<size_t>(kChunkSize, size - position) });
+            }
+        };
+
+        if (module.HasHeaders() == false)
+        {
+            addRange(0, module.GetSize());
+            return chunks;
+        }
+
+        /* Vtables sit in read-only data, yet ELF keeps those needing relocation in a writable section (.data.rel.ro), and PE
+           modules linked with /MERGE:.rdata=.text keep them in code. */
+        const bool isFile = module.GetLayout() == MemoryUtilities::ModuleImage::E_Layout::File;
+        for (const MemoryUtilities::ImageSection& section : module.GetSections())
+        {
+            const size_t sectionSize = std::min<size_t>(section.virtualSize, isFile ? section.rawDataSize : section.virtualSize);
+            if ((section.isExecutable == false || includeCode) && sectionSize != 0 && section.virtualAddress % pointerSize == 0)
+                addRange(section.virtualAddress, sectionSize);
+        }
+
+        return chunks;
+    }
+
+
+    /* Reads a Complete Object Locator, normalized to RVAs, if there is a valid one at 'rva'. */
+    bool ReadLocator(const ModuleReader& reader, uint32_t rva, CompleteObjectLocator& outLocator)
+    {
+        /* x86 locators end before 'self'. */
+        const bool is64Bit = reader.GetPointerSize() == 8;
+        if (reader.ReadBytes(rva, &outLocator, is64Bit ? sizeof(outLocator) : sizeof(outLocator) - sizeof(outLocator.self)) == false)
+            return false;
+
+        if (is64Bit ? (outLocator.signature != kLocatorSignature64 || outLocator.self != rva) : outLocator.signature != kLocatorSignature32)
+            return false;
+
+        if (is64Bit == false)
+        {
+            outLocator.typeDescriptor = reader.ToRva(outLocator.typeDescriptor);
+            outLocator.classDescriptor = reader.ToRva(outLocator.classDescriptor);
+            outLocator.self = rva;
+        }
+
+        std::string typeName;
+        return reader.ReadString(outLocator.typeDescriptor + static_cast<uint32_t>(2 * reader.GetPointerSize()), typeName) && typeName.compare(0, 3, ".?A") == 0;
+    }
+
+    /* Reads the decorated name of an Itanium type_info of a class. */
+    bool ReadTypeInfoName(const ModuleReader& reader, uint32_t typeInfoRva, std::string& outName)
+    {
+        ModulePointer vtable;
+        ModulePointer name;
+        if (reader.ReadPointer(typeInfoRva, vtable) == false || reader.GetTypeInfoKind(vtable) == E_TypeInfoKind::None ||
+            reader.ReadPointer(typeInfoRva + static_cast<uint32_t>(reader.GetPointerSize()), name) == false || reader.ReadString(name.rva, outName) == false)
+            return false;
+
+        /* GCC marks the names of types with internal linkage with a '*', so that they're compared by address. */
+        if (outName[0] == '*')
+            outName.erase(0, 1);
+        return outName.empty() == false;
+    }
+
+
+    /* Whether a vtable starts with a virtual function - pure virtual ones point to an imported handler. GCC leaves the
+       destructor slots of some abstract classes empty, so up to 'emptySlots' null slots may come first. */
+    bool HasFunction(const ModuleReader& reader, uint32_t vtableRva, uint32_t emptySlots)
+    {
+        const uint32_t pointerSize = static_cast<uint32_t>(reader.GetPointerSize());
+        for (uint32_t i = 0; i <= emptySlots; ++i)
+        {
+            const uint32_t slotRva = vtableRva + i * pointerSize;
+            uint64_t value = 0;
+            if (reader.HasRelocation(slotRva) == false && reader.ReadRaw(slotRva, value) && value == 0)
+                continue;
+
+            ModulePointer function;
+            return reader.ReadPointer(slotRva, function) && (function.symbol != nullptr || reader.IsExecutable(function.rva));
+        }
+
+        return false;
+    }
+
+
+    void SweepChunk(const ModuleReader& reader, const DataChunk& chunk, std::vector<FoundVtable>& outVtables)
+    {
+        const uint32_t pointerSize = static_cast<uint32_t>(reader.GetPointerSize());
+        for (uint32_t slotRva = chunk.rva; slotRva - chunk.rva + pointerSize <= chunk.size; slotRva += pointerSize)
+        {
+            ModulePointer record;
+            if (reader.ReadPointer(slotRva, record) == false)
+                continue;
+
+            const uint32_t vtableRva = slotRva + pointerSize;
+            const bool hasFunction = HasFunction(reader, vtableRva, reader.IsElf() ? kMaximumEmptySlots : 0);
+
+            FoundVtable found;
+            found.recordRva = record.rva;
+            found.vtableRva = vtableRva;
+            if (reader.IsElf() == false)
+            {
+                /* MSVC: the slot before the vtable points to its Complete Object Locator. */
+                CompleteObjectLocator locator;
+                if (hasFunction == false || record.rva == MemoryUtilities::ModuleImage::InvalidRva || ReadLocator(reader, record.rva, locator) == false)
+                    continue;
+
+                found.offset = locator.offset;
+            }
+            else
+            {
+                /* Itanium: the slot holds the type_info, the one before it the offset to top - which no relocation fills in. */
+                uint64_t offsetToTop = 0;
+                if (reader.HasRelocation(slotRva - pointerSize) || reader.ReadRaw(slotRva - pointerSize, offsetToTop) == false)
+                    continue;
+
+                const int64_t offset = pointerSize == 8 ? static_cast<int64_t>(offsetToTop) : static_cast<int64_t>(static_cast<int32_t>(offsetToTop));
+                if (offset > 0 || offset <= -kMaximumObjectSize)
+                    continue;
+
+                /* A secondary vtable may hold no function at all (a base reached only through virtual inheritance); a type_info
+                   of the module's own is proof enough there. */
+                std::string typeName;
+                if (record.rva != MemoryUtilities::ModuleImage::InvalidRva)
+                {
+                    if (ReadTypeInfoName(reader, record.rva, typeName) == false || (hasFunction == false && offset == 0))
+                        continue;
+                }
+                else if (hasFunction && record.symbol != nullptr && record.symbol->compare(0, 4, kTypeInfoPrefix) == 0)
+                {
+                    found.importedType = record.symbol->substr(4);
+                }
+                else
+                {
+                    continue;
+                }
+
+                found.offset = static_cast<uint32_t>(-offset);
+            }
+
+            outVtables.push_back(std::move(found));
+        }
+    }
+
+
+    std::string GetClassName(const std::string& decoratedName, bool isElf)
+    {
+        std::string name;
+        if ((isElf ? DemangleItaniumTypeName(decoratedName, name) : UndecorateMsvcTypeName(decoratedName, name)) == false)
+            return decoratedName;
+
+        return name;
+    }
+
+    /* Direct bases, from the flattened list of a class hierarchy descriptor: each base is followed by its own bases. */
+    void ReadMsvcBaseClasses(const ModuleReader& reader, uint32_t classDescriptorRva, std::vector<std::string>& outBaseClasses)
+    {
+        ClassHierarchyDescriptor hierarchy;
+        if (reader.Read(classDescriptorRva, hierarchy) == false || hierarchy.baseClassCount > kMaximumBaseClasses)
+            return;
+
+        const bool is64Bit = reader.GetPointerSize() == 8;
+        const uint32_t arrayRva = is64Bit ? hierarchy.baseClassArray : reader.ToRva(hierarchy.baseClassArray);
+        for (uint32_t i = 1; i < hierarchy.baseClassCount;)
+        {
+            uint32_t descriptorRva = 0;
+            BaseClassDescriptor descriptor;
+            std::string decoratedName;
+            if (reader.Read(arrayRva + i * static_cast<uint32_t>(sizeof(uint32_t)), descriptorRva) == false ||
+                reader.Read(is64Bit ? descriptorRva : reader.ToRva(descriptorRva), descriptor) == false)
+                return;
+
+            const uint32_t typeDescriptorRva = is64Bit ? descriptor.typeDescriptor : reader.ToRva(descriptor.typeDescriptor);
+            if (reader.ReadString(typeDescriptorRva + static_cast<uint32_t>(2 * reader.GetPointerSize()), decoratedName) == false)
+                return;
+
+            outBaseClasses.push_back(GetClassName(decoratedName, false));
+            i += descriptor.containedBaseCount + 1;
+        }
+    }
+
+    std::string GetBaseTypeName(const ModuleReader& reader, const ModulePointer& typeInfo)
+    {
+        std::string decoratedName;
+        if (typeInfo.rva != MemoryUtilities::ModuleImage::InvalidRva && ReadTypeInfoName(reader, typeInfo.rva, decoratedName))
+            return GetClassName(decoratedName, true);
+        const std::string* symbol = typeInfo.symbol != nullptr ? typeInfo.symbol : reader.FindTypeInfoSymbol(typeInfo.rva);
+        if (symbol != nullptr && symbol->compare(0, 4, kTypeInfoPrefix) == 0)
+            return GetClassName(symbol->substr(4), true);
+
+        return std::string();
+    }
+
+    void ReadItaniumBaseClasses(const ModuleReader& reader, uint32_t typeInfoRva, std::vector<std::string>& outBaseClasses)
+    {
+        const uint32_t pointerSize = static_cast<uint32_t>(reader.GetPointerSize());
+        ModulePointer vtable;
+        if (reader.ReadPointer(typeInfoRva, vtable) == false)
+            return;
+
+        /* __si_class_type_info: name, then the base's type_info. __vmi_class_type_info: name, flags, count, then (type_info, offset and flags) pairs. */
+        const E_TypeInfoKind kind = reader.GetTypeInfoKind(vtable);
+        if (kind == E_TypeInfoKind::SingleInheritance)
+        {
+            ModulePointer baseTypeInfo;
+            if (reader.ReadPointer(typeInfoRva + 2 * pointerSize, baseTypeInfo))
+                outBaseClasses.push_back(GetBaseTypeName(reader, baseTypeInfo));
+        }
+        else if (kind == E_TypeInfoKind::VirtualMultipleInheritance)
+        {
+            uint32_t baseCount = 0;
+            if (reader.Read(typeInfoRva + 2 * pointerSize + sizeof(uint32_t), baseCount) == false || baseCount > kMaximumBaseClasses)
+                return;
+
+            for (uint32_t i = 0; i < baseCount; ++i)
+            {
+                ModulePointer baseTypeInfo;
+                if (reader.ReadPointer(typeInfoRva + 2 * pointerSize + 2 * sizeof(uint32_t) + i * 2 * pointerSize, baseTypeInfo))
+                    outBaseClasses.push_back(GetBaseTypeName(reader, baseTypeInfo));
+            }
+        }
+
+        outBaseClasses.erase(std::remove(outBaseClasses.begin(), outBaseClasses.end(), std::string()), outBaseClasses.end());
+    }
+}
+
+
+
+
+
+
+bool MemoryUtilities::RttiIndex::Build(const ModuleImage& module)
+{
+    return Build(module, ThreadingUtilities::GetSharedPool());
+}
+
+bool MemoryUtilities::RttiIndex::Build(const ModuleImage& module, ThreadingUtilities::ThreadPool& pool)
+{
+    Clear();
+    if (module.IsLoaded() == false)
+        return false;
+
+    CRANCHYLIB_TRACE_SCOPE("image", "RttiIndex::Build", module.GetSize());
+    baseAddress = module.GetBaseAddress();
+
+    const ModuleReader reader(module);
+    const std::vector<DataChunk> chunks = SplitData(module, reader.GetPointerSize(), reader.IsElf() == false);
+    std::vector<std::vector<FoundVtable>> chunkVtables(chunks.size());
+    ThreadingUtilities::TaskGroup group(pool);
+    ThreadingUtilities::ParallelFor(group, 0, chunks.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            SweepChunk(reader, chunks[i], chunkVtables[i]);
+        }
+    });
+
+
+    /* Classes are described once per RTTI record; every vtable found through a record joins its class. */
+    std::unordered_map<uint32_t, std::string> recordClasses; // Record RVA -> class name.
+    for (const std::vector<FoundVtable>& found : chunkVtables)
+    {
+        for (const FoundVtable& vtable : found)
+        {
+            std::string className;
+            const auto recordClass = recordClasses.find(vtable.recordRva);
+            if (vtable.importedType.empty() == false)
+            {
+                className = GetClassName(vtable.importedType, true);
+                if (classes.find(className) == classes.end())
+                {
+                    RttiClass& importedClass = classes[className];
+                    importedClass.name = className;
+                    importedClass.decoratedName = vtable.importedType;
+                    importedClass.typeInfoRva = ModuleImage::InvalidRva;
+                }
+            }
+            else if (recordClass != recordClasses.end())
+            {
+                className = recordClass->second;
+            }
+            else
+            {
+                RttiClass rttiClass;
+                if (reader.IsElf())
+                {
+                    rttiClass.typeInfoRva = vtable.recordRva;
+                    ReadTypeInfoName(reader, vtable.recordRva, rttiClass.decoratedName);
+                    ReadItaniumBaseClasses(reader, vtable.recordRva, rttiClass.baseClasses);
+                }
+                else
+                {
+                    CompleteObjectLocator locator;
+                    ReadLocator(reader, vtable.recordRva, locator);
+                    rttiClass.typeInfoRva = locator.typeDescriptor;
+                    reader.ReadString(locator.typeDescriptor + static_cast<uint32_t>(2 * reader.GetPointerSize()), rttiClass.decoratedName);
+                    ReadMsvcBaseClasses(reader, locator.classDescriptor, rttiClass.baseClasses);
+                }
+
+                rttiClass.name = GetClassName(rttiClass.decoratedName, reader.IsElf());
+                className = rttiClass.name;
+                recordClasses[vtable.recordRva] = className;
+
+                /* Several records can describe one class: an MSVC locator per subobject, say. The first one gives the bases. */
+                RttiClass& knownClass = classes[className];
+                if (knownClass.name.empty())
+                    knownClass = std::move(rttiClass);
+            }
+
+            classes[className].vtables.push_back({ vtable.vtableRva, vtable.offset });
+        }
+    }
+
+    for (auto& entry : classes)
+    {
+        std::vector<RttiVtable>& vtables = entry.second.vtables;
+        std::sort(vtables.begin(), vtables.end(), [](const RttiVtable& left, const RttiVtable& right)
+        {
+            return left.offset != right.offset ? left.offset < right.offset : left.rva < right.rva;
+        });
+        vtables.erase(std::unique(vtables.begin(), vtables.end(), [](const RttiVtable& left, const RttiVtable& right)
+        {
+            return left.offset == right.offset && left.rva == right.rva;
+        }), vtables.end());
+
+        decoratedNames[entry.second.decoratedName] = entry.first;
+    }
+
+    return true;
+}
+
+void MemoryUtilities::RttiIndex::Clear()
+{
+    classes.clear();
+    decoratedNames.clear();
+    baseAddress = 0x0;
+}
+
+
+
+
+size_t MemoryUtilities::RttiIndex::GetClassCount() const
+{
+    return classes.size();
+}
+
+const std::unordered_map<std::string, MemoryUtilities::RttiClass>& MemoryUtilities::RttiIndex::GetClasses() const
+{
+    return classes;
+}
+
+uintptr_t MemoryUtilities::RttiIndex::GetBaseAddress() const
+{
+    return baseAddress;
+}
+
+
+
+
+const MemoryUtilities::RttiClass* MemoryUtilities::RttiIndex::FindClass(const std::string& className) const
+{
+    auto rttiClass = classes.find(className);
+    if (rttiClass == classes.end())
+    {
+        const auto decoratedName = decoratedNames.find(className);
+        if (decoratedName == decoratedNames.end())
+            return nullptr;
+
+        rttiClass = classes.find(decoratedName->second);
+    }
+
+    return rttiClass != classes.end() ? &rttiClass->second : nullptr;
+}
+
+uintptr_t MemoryUtilities::RttiIndex::GetVtableAddress(const std::string& className) const
+{
+    const RttiClass* rttiClass = FindClass(className);
+    if (rttiClass == nullptr || rttiClass->vtables.empty() || rttiClass->vtables.front().offset != 0)
+        return 0x0;
+
+    return baseAddress + rttiClass->vtables.front().rva;
+}
+
+std::vector<std::string> MemoryUtilities::RttiIndex::GetAllBaseClasses(const std::string& className) const
+{
+    std::vector<std::string> baseClasses;
+    const RttiClass* rttiClass = FindClass(className);
+    if (rttiClass == nullptr)
+        return baseClasses;
+
+    /* Breadth first, so direct bases come first; a base reached twice (diamonds) is listed once. */
+    std::unordered_set<std::string> visited;
+    baseClasses = rttiClass->baseClasses;
+    visited.insert(baseClasses.begin(), baseClasses.end());
+    for (size_t i = 0; i < baseClasses.size(); ++i)
+    {
+        const auto baseClass = classes.find(baseClasses[i]);
+        if (baseClass == classes.end())
+            continue;
+
+        for (const std::string& name : baseClass->second.baseClasses)
+        {
+            if (visited.insert(name).second)
+                baseClasses.push_back(name);
+        }
+    }
+
+    return baseClasses;
+}
+
+std::vector<std::string> MemoryUtilities::RttiIndex::FindDerivedClasses(const std::string& className) const
+{
+    std::vector<std::string> derivedClasses;
+    const RttiClass* rttiClass = FindClass(className);
+    const std::string& name = rttiClass != nullptr ? rttiClass->name : className;
+
+    for (const auto& entry : classes)
+    {
+        const std::vector<std::string> baseClasses = GetAllBaseClasses(entry.first);
+        if (std::find(baseClasses.begin(), baseClasses.end(), name) != baseClasses.end())
+            derivedClasses.push_back(entry.first);
+    }
+
+    std::sort(derivedClasses.begin(), derivedClasses.end());
+    return derivedClasses;
+}
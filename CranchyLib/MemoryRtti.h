@@ -0,0 +1,111 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryImages.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	/**
+	* @brief One virtual function table of a class.
+	* @param rva - RVA of the table's first function pointer, which is what an object's vfptr holds.
+	* @param offset - Offset of the subobject using the table within the complete object: 0 for the primary table, the offset of
+	*                 the base class for the extra tables of multiple inheritance.
+	*/
+	struct RttiVtable
+	{
+		uint32_t rva	= 0;
+		uint32_t offset = 0;
+	};
+
+
+	/**
+	* @brief A polymorphic class, as described by the RTTI of a module.
+	* @param name - Class name with its scopes, e.g. "game::Player"; the decorated name when it can't be undecorated (templates).
+	* @param decoratedName - Name as the compiler stored it: ".?AVPlayer@game@@" (MSVC), "N4game6PlayerE" (Itanium).
+	* @param typeInfoRva - RVA of the class's TypeDescriptor (MSVC) or std::type_info object (Itanium); ModuleImage::InvalidRva
+	*                      when the type_info lives in another module.
+	* @param vtables - The class's virtual function tables, ordered by offset. Itanium construction vtables, used while a class with
+	*                  virtual bases is being built, are listed under the base class they're built for.
+	* @param baseClasses - Names of its direct base classes, in declaration order; empty when its type_info lives in another module.
+	*/
+	struct RttiClass
+	{
+		std::string				 name;
+		std::string				 decoratedName;
+		uint32_t				 typeInfoRva = 0;
+		std::vector<RttiVtable>	 vtables;
+		std::vector<std::string> baseClasses;
+	};
+
+
+
+
+
+
+	class RttiIndex
+	{
+		// Description: Finds the vtables of a module by class name, from the RTTI the compiler emits for every polymorphic class,
+		//              so they don't need a hand-written signature each. The module's data is swept once, in parallel chunks, for
+		//              pointer slots that sit right before a vtable: MSVC Complete Object Locators in PE modules (x86 and x64),
+		//              Itanium type_info pointers in ELF files (x86 and x64, dynamic relocations applied). Class hierarchies come
+		//              from the same structures. Modules built without RTTI (/GR-, -fno-rtti) have nothing to find.
+		// Search Tags: #rtti, #vtable, #vftable, #typeinfo, #class, #inheritance, #msvc, #itanium, #col, #polymorphic.
+	public:
+		/**
+		* @brief Indexes the classes of a module, replacing any previous index. The module isn't needed afterwards.
+		* @return false if the module isn't loaded.
+		*/
+		bool Build(const ModuleImage& module);
+		bool Build(const ModuleImage& module, ThreadingUtilities::ThreadPool& pool);
+		void Clear();
+
+		size_t												GetClassCount() const;
+		/**
+		* @return Every class, by name.
+		*/
+		const std::unordered_map<std::string, RttiClass>&	GetClasses() const;
+		uintptr_t											GetBaseAddress() const;
+
+
+
+
+		/**
+		* @brief Looks up a class.
+		* @param className - Undecorated ("game::Player") or decorated (".?AVPlayer@game@@", "N4game6PlayerE") name.
+		* @return The class, or nullptr if the module has no vtable for it.
+		*/
+		const RttiClass*		 FindClass(const std::string& className) const;
+		/**
+		* @brief Finds a class's primary vtable, the one an object's first pointer refers to.
+		* @return Address of the vtable in the module's address space, or 0x0 if the class isn't known.
+		*/
+		uintptr_t				 GetVtableAddress(const std::string& className) const;
+
+		/**
+		* @return Names of every base class of a class, direct ones first; bases of classes from other modules aren't known.
+		*/
+		std::vector<std::string> GetAllBaseClasses(const std::string& className) const;
+		/**
+		* @return Names of the classes deriving from a class, directly or not.
+		*/
+		std::vector<std::string> FindDerivedClasses(const std::string& className) const;
+
+
+
+
+	private:
+		std::unordered_map<std::string, RttiClass>	 classes;
+		std::unordered_map<std::string, std::string> decoratedNames; // Decorated name -> name.
+		uintptr_t									 baseAddress = 0x0;
+	};
+}
@@ -0,0 +1,1022 @@
+#include "MemoryRules.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+
+#include "MemoryInstrumentation.h"
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    const size_t kMaximumNestingDepth = 64;
+
+
+    int HexDigitValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+
+        return -1;
+    }
+}
+
+
+
+
+
+
+class MemoryUtilities::RuleSet::RuleParser
+{
+public:
+    explicit RuleParser(const std::string& text) : text(text) {}
+
+
+    bool Parse(RuleNode& root)
+    {
+        if (ParseAlternation(root, 0) == false)
+            return false;
+
+        SkipWhitespace();
+        if (position != text.size())
+            return Fail(std::string("unexpected '") + text[position] + "'");
+
+        return true;
+    }
+
+    const std::string& GetError() const
+    {
+        return error;
+    }
+
+
+    /* Shortest and longest byte count 'node' can match. */
+    static void MeasureLengths(const RuleNode& node, size_t& minimumLength, size_t& maximumLength)
+    {
+        switch (node.kind)
+        {
+        case RuleNode::E_Kind::Bytes:
+            minimumLength = maximumLength = 1;
+            return;
+
+        case RuleNode::E_Kind::Sequence:
+            minimumLength = maximumLength = 0;
+            for (const RuleNode& child : node.children)
+            {
+                size_t childMinimum = 0;
+                size_t childMaximum = 0;
+                MeasureLengths(child, childMinimum, childMaximum);
+                minimumLength += childMinimum;
+                maximumLength += childMaximum;
+            }
+            return;
+
+        case RuleNode::E_Kind::Alternation:
+            minimumLength = SIZE_MAX;
+            maximumLength = 0;
+            for (const RuleNode& child : node.children)
+            {
+                size_t childMinimum = 0;
+                size_t childMaximum = 0;
+                MeasureLengths(child, childMinimum, childMaximum);
+                minimumLength = std::min<size_t>(minimumLength, childMinimum);
+                maximumLength = std::max<size_t>(maximumLength, childMaximum);
+            }
+            return;
+        }
+    }
+
+
+
+
+private:
+    bool ParseAlternation(RuleNode& node, size_t depth)
+    {
+        if (depth > kMaximumNestingDepth)
+            return Fail("alternatives nested too deeply");
+
+        RuleNode alternative;
+        if (ParseSequence(alternative, depth) == false)
+            return false;
+
+        SkipWhitespace();
+        if (position >= text.size() || text[position] != '|')
+        {
+            node = std::move(alternative);
+            return true;
+        }
+
+        node = RuleNode();
+        node.kind = RuleNode::E_Kind::Alternation;
+        node.children.push_back(std::move(alternative));
+
+        while (position < text.size() && text[position] == '|')
+        {
+            ++position;
+            if (ParseSequence(alternative, depth) == false)
+                return false;
+
+            node.children.push_back(std::move(alternative));
+            SkipWhitespace();
+        }
+
+        return true;
+    }
+
+    bool ParseSequence(RuleNode& node, size_t depth)
+    {
+        node = RuleNode();
+        node.kind = RuleNode::E_Kind::Sequence;
+
+        while (true)
+        {
+            SkipWhitespace();
+            if (position >= text.size() || text[position] == '|' || text[position] == ')')
+                return true;
+
+            RuleNode term;
+            switch (text[position])
+            {
+            case '(':
+                ++position;
+                if (ParseAlternation(term, depth + 1) == false)
+                    return false;
+
+                SkipWhitespace();
+                if (position >= text.size() || text[position] != ')')
+                    return Fail("missing ')'");
+
+                ++position;
+                node.children.push_back(std::move(term));
+                break;
+
+            case '[':
+                if (ParseJump(node) == false)
+                    return false;
+                break;
+
+            case '{':
+                if (ParseByteSet(term) == false)
+                    return false;
+
+                node.children.push_back(std::move(term));
+                break;
+
+            default:
+                if (ParseByte(term) == false)
+                    return false;
+
+                node.children.push_back(std::move(term));
+                break;
+            }
+        }
+    }
+
+
+    /* "[n]" or "[n-m]": appended to 'sequence' as n any-bytes followed by m - n optional ones. */
+    bool ParseJump(RuleNode& sequence)
+    {
+        ++position;
+
+        size_t minimumLength = 0;
+        if (ParseNumber(minimumLength) == false)
+            return false;
+
+        size_t maximumLength = minimumLength;
+        SkipWhitespace();
+        if (position < text.size() && text[position] == '-')
+        {
+            ++position;
+            if (ParseNumber(maximumLength) == false)
+                return false;
+
+            SkipWhitespace();
+        }
+
+        if (position >= text.size() || text[position] != ']')
+            return Fail("missing ']'");
+
+        ++position;
+        if (maximumLength < minimumLength || maximumLength == 0 || maximumLength > MaximumJumpLength)
+            return Fail("invalid jump length");
+
+        RuleNode anyByte;
+        anyByte.kind = RuleNode::E_Kind::Bytes;
+        anyByte.bytes.set();
+
+        /* Independent '(?? | )' terms accept the same lengths as nested ones and keep the tree flat. */
+        RuleNode optionalByte;
+        optionalByte.kind = RuleNode::E_Kind::Alternation;
+        optionalByte.children.push_back(anyByte);
+        optionalByte.children.push_back(RuleNode());
+
+        sequence.children.insert(sequence.children.end(), minimumLength, anyByte);
+        sequence.children.insert(sequence.children.end(), maximumLength - minimumLength, optionalByte);
+        return true;
+    }
+
+    /* "{30-39,5F}": any byte of the listed ranges and values. */
+    bool ParseByteSet(RuleNode& node)
+    {
+        ++position;
+        node.kind = RuleNode::E_Kind::Bytes;
+
+        while (true)
+        {
+            SkipWhitespace();
+
+            uint8_t first = 0;
+            if (ParseHexByte(first) == false)
+                return false;
+
+            uint8_t last = first;
+            SkipWhitespace();
+            if (position < text.size() && text[position] == '-')
+            {
+                ++position;
+                SkipWhitespace();
+                if (ParseHexByte(last) == false)
+                    return false;
+
+                if (last < first)
+                    return Fail("invalid byte range");
+
+                SkipWhitespace();
+            }
+
+            for (size_t value = first; value <= last; ++value)
+            {
+                node.bytes.set(value);
+            }
+
+            if (position < text.size() && text[position] == ',')
+            {
+                ++position;
+                continue;
+            }
+
+            if (position >= text.size() || text[position] != '}')
+                return Fail("missing '}'");
+
+            ++position;
+            return true;
+        }
+    }
+
+    /* "48", "??", "4?", "?B" or "48/F0". */
+    bool ParseByte(RuleNode& node)
+    {
+        if (position + 2 > text.size())
+            return Fail("incomplete byte");
+
+        const char high = text[position];
+        const char low = text[position + 1];
+        const int highValue = HexDigitValue(high);
+        const int lowValue = HexDigitValue(low);
+        if ((highValue < 0 && high != '?') || (lowValue < 0 && low != '?'))
+            return Fail(std::string("unexpected '") + high + "'");
+
+        position += 2;
+        node.kind = RuleNode::E_Kind::Bytes;
+
+        uint8_t mask = static_cast<uint8_t>((highValue >= 0 ? 0xF0 : 0x00) | (lowValue >= 0 ? 0x0F : 0x00));
+        const uint8_t value = static_cast<uint8_t>(((highValue >= 0 ? highValue : 0) << 4) | (lowValue >= 0 ? lowValue : 0));
+
+        if (position < text.size() && text[position] == '/')
+        {
+            if (mask != 0xFF)
+                return Fail("a masked byte can't have wildcards");
+
+            ++position;
+            if (ParseHexByte(mask) == false)
+                return false;
+        }
+
+        for (size_t candidate = 0; candidate < 256; ++candidate)
+        {
+            if ((candidate & mask) == (value & mask))
+                node.bytes.set(candidate);
+        }
+
+        return true;
+    }
+
+
+    bool ParseHexByte(uint8_t& value)
+    {
+        if (position + 2 > text.size() || HexDigitValue(text[position]) < 0 || HexDigitValue(text[position + 1]) < 0)
+            return Fail("expected a hex byte");
+
+        value = static_cast<uint8_t>((HexDigitValue(text[position]) << 4) | HexDigitValue(text[position + 1]));
+        position += 2;
+        return true;
+    }
+
+    bool ParseNumber(size_t& value)
+    {
+        SkipWhitespace();
+
+        const size_t begin = position;
+        value = 0;
+        for (; position < text.size() && text[position] >= '0' && text[position] <= '9'; ++position)
+        {
+            value = std::min<size_t>(value * 10 + (text[position] - '0'), MaximumJumpLength + 1); // Saturate, the caller rejects it.
+        }
+
+        if (position == begin)
+            return Fail("expected a number");
+
+        return true;
+    }
+
+
+    void SkipWhitespace()
+    {
+        while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\r' || text[position] == '\n'))
+        {
+            ++position;
+        }
+    }
+
+    bool Fail(const std::string& message)
+    {
+        error = message + " at position " + std::to_string(position);
+        return false;
+    }
+
+
+
+
+    const std::string& text;
+    size_t			   position = 0;
+    std::string		   error;
+};
+
+
+
+
+
+
+class MemoryUtilities::RuleSet::AutomatonBuilder
+{
+public:
+    /* Builds a DFA for 'roots'. Unanchored automata look for matches starting anywhere, anchored ones only at the first byte fed;
+       reversed ones match the rules back to front. */
+    bool Build(const std::vector<const RuleNode*>& roots, bool anchored, bool reversed, Automaton& automaton, std::string& error)
+    {
+        states.clear();
+
+        const uint32_t start = AddState();
+        for (size_t i = 0; i < roots.size(); ++i)
+        {
+            const uint32_t ruleEntry = AddState();
+            states[start].epsilons.push_back(ruleEntry);
+
+            const uint32_t ruleExit = Emit(*roots[i], ruleEntry, reversed);
+            states[ruleExit].acceptedRule = i;
+        }
+
+        ComputeByteClasses(automaton);
+
+        /* Subset construction over byte classes; every DFA state is the epsilon closure of a set of NFA states. */
+        std::map<std::vector<uint32_t>, uint32_t> stateIds;
+        std::vector<std::vector<uint32_t>> stateSets;
+        std::vector<uint32_t> targets;
+
+        auto internState = [&](std::vector<uint32_t>&& stateSet)
+        {
+            auto inserted = stateIds.emplace(stateSet, static_cast<uint32_t>(stateSets.size()));
+            if (inserted.second)
+                stateSets.push_back(std::move(stateSet));
+
+            return inserted.first->second;
+        };
+
+        internState(Closure({ start }));
+
+        std::vector<uint32_t> seeds;
+        for (size_t current = 0; current < stateSets.size(); ++current)
+        {
+            const std::vector<uint32_t> currentSet = stateSets[current]; // The vector may grow below.
+            for (size_t byteClass = 0; byteClass < automaton.classCount; ++byteClass)
+            {
+                const uint8_t byte = classRepresentatives[byteClass];
+
+                seeds.clear();
+                for (uint32_t nfaState : currentSet)
+                {
+                    if (states[nfaState].next != NoState && states[nfaState].bytes[byte])
+                        seeds.push_back(states[nfaState].next);
+                }
+
+                if (anchored == false) // A new match may start at every byte.
+                    seeds.push_back(start);
+
+                targets.push_back(internState(Closure(seeds)));
+                if (stateSets.size() > MaximumStateCount)
+                {
+                    error = "the automaton exceeds " + std::to_string(MaximumStateCount) + " states, use shorter jumps or fewer alternatives";
+                    return false;
+                }
+            }
+        }
+
+        /* Renumber the states so the accepting ones come last, then a single compare tells whether a row accepts. */
+        std::vector<std::vector<size_t>> acceptedRules(stateSets.size());
+        for (size_t i = 0; i < stateSets.size(); ++i)
+        {
+            for (uint32_t nfaState : stateSets[i])
+            {
+                if (states[nfaState].acceptedRule != NoRule)
+                    acceptedRules[i].push_back(states[nfaState].acceptedRule);
+            }
+
+            std::sort(acceptedRules[i].begin(), acceptedRules[i].end());
+            acceptedRules[i].erase(std::unique(acceptedRules[i].begin(), acceptedRules[i].end()), acceptedRules[i].end());
+        }
+
+        std::vector<uint32_t> renumbered(stateSets.size());
+        uint32_t stateCount = 0;
+        for (bool accepting : { false, true })
+        {
+            for (size_t i = 0; i < stateSets.size(); ++i)
+            {
+                if (acceptedRules[i].empty() != accepting)
+                    renumbered[i] = stateCount++;
+            }
+        }
+
+        const uint32_t acceptingCount = static_cast<uint32_t>(std::count_if(acceptedRules.begin(), acceptedRules.end(), [](const std::vector<size_t>& rules)
+        {
+            return rules.empty() == false;
+        }));
+
+        const size_t classCount = automaton.classCount;
+        automaton.transitions.resize(targets.size());
+        automaton.acceptedRules.assign(reversed ? 0 : acceptingCount, std::vector<size_t>());
+        for (size_t i = 0; i < stateSets.size(); ++i)
+        {
+            const size_t row = renumbered[i] * classCount;
+            for (size_t byteClass = 0; byteClass < classCount; ++byteClass)
+            {
+                automaton.transitions[row + byteClass] = static_cast<uint32_t>(renumbered[targets[i * classCount + byteClass]] * classCount);
+            }
+
+            if (reversed == false && renumbered[i] >= stateCount - acceptingCount)
+                automaton.acceptedRules[renumbered[i] - (stateCount - acceptingCount)] = std::move(acceptedRules[i]);
+        }
+
+        automaton.startRow = static_cast<uint32_t>(renumbered[0] * classCount);
+        automaton.firstAcceptingRow = static_cast<uint32_t>((stateCount - acceptingCount) * classCount);
+
+        auto deadState = stateIds.find(std::vector<uint32_t>());
+        automaton.deadRow = deadState != stateIds.end() ? static_cast<uint32_t>(renumbered[deadState->second] * classCount) : UINT32_MAX;
+        return true;
+    }
+
+
+
+
+private:
+    static constexpr uint32_t NoState = UINT32_MAX;
+    static constexpr size_t	  NoRule  = SIZE_MAX;
+
+
+    /* Thompson NFA state: a byte transition to 'next' and/or epsilon transitions. */
+    struct NfaState
+    {
+        std::bitset<256>	  bytes;
+        uint32_t			  next = NoState;
+        std::vector<uint32_t> epsilons;
+        size_t				  acceptedRule = NoRule;
+    };
+
+
+    uint32_t AddState()
+    {
+        states.emplace_back();
+        return static_cast<uint32_t>(states.size() - 1);
+    }
+
+    /* Links 'node' from the fresh state 'entry' and returns the fresh state reached after it. */
+    uint32_t Emit(const RuleNode& node, uint32_t entry, bool reversed)
+    {
+        switch (node.kind)
+        {
+        case RuleNode::E_Kind::Bytes:
+        {
+            const uint32_t exit = AddState();
+            states[entry].bytes = node.bytes;
+            states[entry].next = exit;
+            return exit;
+        }
+
+        case RuleNode::E_Kind::Sequence:
+        {
+            uint32_t cursor = entry;
+            if (reversed)
+            {
+                for (auto child = node.children.rbegin(); child != node.children.rend(); ++child)
+                {
+                    cursor = Emit(*child, cursor, reversed);
+                }
+            }
+            else
+            {
+                for (const RuleNode& child : node.children)
+                {
+                    cursor = Emit(child, cursor, reversed);
+                }
+            }
+
+            return cursor;
+        }
+
+        case RuleNode::E_Kind::Alternation:
+        default:
+        {
+            const uint32_t exit = AddState();
+            for (const RuleNode& child : node.children)
+            {
+                const uint32_t childEntry = AddState();
+                states[entry].epsilons.push_back(childEntry);
+
+                const uint32_t childExit = Emit(child, childEntry, reversed);
+                states[childExit].epsilons.push_back(exit);
+            }
+
+            return exit;
+        }
+        }
+    }
+
+
+    /* Splits the 256 byte values into classes no NFA transition tells apart, so the DFA needs one column per class. */
+    void ComputeByteClasses(Automaton& automaton)
+    {
+        std::unordered_set<std::bitset<256>> byteSets;
+        for (const NfaState& state : states)
+        {
+            if (state.next != NoState)
+                byteSets.insert(state.bytes);
+        }
+
+        std::vector<size_t> byteClasses(256, 0);
+        size_t classCount = 1;
+        for (const std::bitset<256>& byteSet : byteSets)
+        {
+            std::map<std::pair<size_t, bool>, size_t> refinedClasses;
+            for (size_t byte = 0; byte < 256; ++byte)
+            {
+                byteClasses[byte] = refinedClasses.emplace(std::make_pair(byteClasses[byte], byteSet[byte]), refinedClasses.size()).first->second;
+            }
+
+            classCount = refinedClasses.size();
+        }
+
+        automaton.classCount = classCount;
+        classRepresentatives.assign(classCount, 0);
+        for (size_t byte = 256; byte-- > 0;)
+        {
+            automaton.byteClasses[byte] = static_cast<uint8_t>(byteClasses[byte]);
+            classRepresentatives[byteClasses[byte]] = static_cast<uint8_t>(byte);
+        }
+    }
+
+    std::vector<uint32_t> Closure(const std::vector<uint32_t>& seeds)
+    {
+        closureMarks.resize(states.size(), 0);
+        ++closureGeneration;
+
+        std::vector<uint32_t> closure;
+        std::vector<uint32_t> pending(seeds);
+        while (pending.empty() == false)
+        {
+            const uint32_t nfaState = pending.back();
+            pending.pop_back();
+
+            if (closureMarks[nfaState] == closureGeneration)
+                continue;
+
+            closureMarks[nfaState] = closureGeneration;
+            closure.push_back(nfaState);
+            pending.insert(pending.end(), states[nfaState].epsilons.begin(), states[nfaState].epsilons.end());
+        }
+
+        std::sort(closure.begin(), closure.end());
+        return closure;
+    }
+
+
+
+
+    std::vector<NfaState> states;
+    std::vector<uint8_t>  classRepresentatives;
+    std::vector<uint64_t> closureMarks;
+    uint64_t			  closureGeneration = 0;
+};
+
+
+
+
+
+
+size_t MemoryUtilities::RuleSet::AddRule(const std::string& rule)
+{
+    RuleNode root;
+    RuleParser parser(rule);
+    if (parser.Parse(root) == false)
+    {
+        compileError = parser.GetError();
+        return InvalidRule;
+    }
+
+    size_t minimumLength = 0;
+    size_t maximumLength = 0;
+    RuleParser::MeasureLengths(root, minimumLength, maximumLength);
+    if (minimumLength == 0)
+    {
+        compileError = "the rule can match zero bytes";
+        return InvalidRule;
+    }
+
+    rules.push_back(std::move(root));
+    minimumLengths.push_back(minimumLength);
+    maximumLengths.push_back(maximumLength);
+    compiled = false;
+
+    return rules.size() - 1;
+}
+
+bool MemoryUtilities::RuleSet::Compile()
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "RuleSet::Compile", rules.size());
+
+    compiled = false;
+    compileError.clear();
+    if (rules.empty())
+    {
+        compileError = "no rules to compile";
+        return false;
+    }
+
+    std::vector<const RuleNode*> roots;
+    for (const RuleNode& rule : rules)
+    {
+        roots.push_back(&rule);
+    }
+
+    AutomatonBuilder builder;
+    if (builder.Build(roots, false, false, forward, compileError) == false)
+        return false;
+
+    reverse.assign(rules.size(), Automaton());
+    for (size_t i = 0; i < rules.size(); ++i)
+    {
+        if (builder.Build({ &rules[i] }, true, true, reverse[i], compileError) == false)
+            return false;
+    }
+
+    maximumMatchLength = *std::max_element(maximumLengths.begin(), maximumLengths.end());
+    compiled = true;
+    return true;
+}
+
+void MemoryUtilities::RuleSet::Clear()
+{
+    rules.clear();
+    minimumLengths.clear();
+    maximumLengths.clear();
+    compileError.clear();
+
+    compiled = false;
+    forward = Automaton();
+    reverse.clear();
+    maximumMatchLength = 0;
+}
+
+
+
+
+bool MemoryUtilities::RuleSet::IsCompiled() const
+{
+    return compiled;
+}
+
+size_t MemoryUtilities::RuleSet::GetRuleCount() const
+{
+    return rules.size();
+}
+
+size_t MemoryUtilities::RuleSet::GetStateCount() const
+{
+    return forward.classCount != 0 ? forward.transitions.size() / forward.classCount : 0;
+}
+
+size_t MemoryUtilities::RuleSet::GetMaximumMatchLength() const
+{
+    return maximumMatchLength;
+}
+
+std::string MemoryUtilities::RuleSet::GetCompileError() const
+{
+    return compileError;
+}
+
+
+
+
+size_t MemoryUtilities::RuleSet::ScanBuffer(const uint8_t* data, size_t size, uintptr_t baseAddress, std::vector<RuleMatch>& matches) const
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "RuleSet::ScanBuffer", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    if (compiled == false)
+        return 0;
+
+    StreamState stream;
+    BeginStream(stream);
+
+    return FeedStream(stream, data, size, baseAddress, matches);
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::RuleSet::ScanInternal(const uint8_t* startingAddress, size_t size, std::vector<RuleMatch>& matches, const ScanOptions& options) const
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "RuleSet::ScanInternal", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    E_ScanStatus status = E_ScanStatus::Completed;
+    if (compiled == false)
+        return status;
+
+    StreamState stream;
+    BeginStream(stream);
+
+    ScanProgress progress;
+    progress.bytesTotal = size;
+    progress.regionsTotal = 1;
+
+    const size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+    for (size_t chunkStart = 0; chunkStart < size; chunkStart += chunkSize)
+    {
+        progress.bytesProcessed = chunkStart;
+        if (options.Continue(progress, status) == false)
+            return status;
+
+        const uint8_t* chunk = startingAddress + chunkStart;
+        FeedStream(stream, chunk, std::min<size_t>(chunkSize, size - chunkStart), reinterpret_cast<uintptr_t>(chunk), matches);
+    }
+
+    progress.bytesProcessed = size;
+    progress.regionsDone = 1;
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return E_ScanStatus::Completed;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::RuleSet::ScanExternal(const HANDLE& hProcess, const std::vector<SnapshotStore::Region>& regions, std::vector<RuleMatch>& matches,
+                                                                     const ScanOptions& options) const
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "RuleSet::ScanExternal", regions.size());
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+
+    E_ScanStatus status = E_ScanStatus::Completed;
+    if (compiled == false || External::IsValidProcessHandle(hProcess) == false)
+        return status;
+
+    StreamState stream;
+    BeginStream(stream);
+
+    ScanProgress progress;
+    progress.regionsTotal = regions.size();
+    for (const SnapshotStore::Region& region : regions)
+    {
+        progress.bytesTotal += region.size;
+    }
+
+    const size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+    std::vector<uint8_t> chunkBuffer(chunkSize);
+
+    for (const SnapshotStore::Region& region : regions)
+    {
+        const uintptr_t regionEnd = region.baseAddress + region.size;
+        for (uintptr_t cursor = region.baseAddress; cursor < regionEnd;)
+        {
+            if (options.Continue(progress, status) == false)
+                return status;
+
+            const size_t chunkLength = std::min<size_t>(chunkSize, regionEnd - cursor);
+
+            /* An unreadable chunk leaves a gap in the stream, which FeedStream() won't match across. */
+            SIZE_T bytesRead = 0;
+            if (External::GetBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(cursor), chunkBuffer.data(), chunkLength, &bytesRead) && bytesRead != 0)
+            {
+                CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, bytesRead);
+                FeedStream(stream, chunkBuffer.data(), static_cast<size_t>(bytesRead), cursor, matches);
+            }
+
+            cursor += chunkLength;
+            progress.bytesProcessed += chunkLength;
+        }
+
+        ++progress.regionsDone;
+    }
+
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return E_ScanStatus::Completed;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::RuleSet::ScanFile(const std::string& filePath, std::vector<RuleMatch>& matches, const ScanOptions& options) const
+{
+    HANDLE hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) // A file that can't be opened has no matches.
+        return E_ScanStatus::Completed;
+
+    const E_ScanStatus status = ScanFileHandle(hFile, matches, options);
+    CloseHandle(hFile);
+
+    return status;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::RuleSet::ScanFile(const std::wstring& filePath, std::vector<RuleMatch>& matches, const ScanOptions& options) const
+{
+    HANDLE hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) // A file that can't be opened has no matches.
+        return E_ScanStatus::Completed;
+
+    const E_ScanStatus status = ScanFileHandle(hFile, matches, options);
+    CloseHandle(hFile);
+
+    return status;
+}
+
+
+
+
+void MemoryUtilities::RuleSet::BeginStream(StreamState& stream) const
+{
+    stream.row = forward.startRow;
+    stream.history.clear();
+    stream.historyEnd = 0x0;
+    stream.recentStarts.assign(rules.size(), std::vector<uintptr_t>());
+}
+
+size_t MemoryUtilities::RuleSet::FeedStream(StreamState& stream, const uint8_t* data, size_t size, uintptr_t baseAddress, std::vector<RuleMatch>& matches) const
+{
+    /* A gap since the previous chunk: no match can span it. */
+    if (baseAddress != stream.historyEnd)
+    {
+        stream.row = forward.startRow;
+        stream.history.clear();
+        for (std::vector<uintptr_t>& recentStarts : stream.recentStarts)
+        {
+            recentStarts.clear();
+        }
+    }
+
+    const uint32_t* transitions = forward.transitions.data();
+    const uint8_t* byteClasses = forward.byteClasses;
+    const uint32_t firstAcceptingRow = forward.firstAcceptingRow;
+    uint32_t row = stream.row;
+    size_t matchCount = 0;
+
+    /* One table lookup per byte, whatever the number of rules. */
+    for (size_t offset = 0; offset < size; ++offset)
+    {
+        row = transitions[row + byteClasses[data[offset]]];
+        if (row < firstAcceptingRow)
+            continue;
+
+        for (size_t ruleIndex : forward.acceptedRules[(row - firstAcceptingRow) / forward.classCount])
+        {
+            matchCount += ReportMatches(ruleIndex, stream, data, offset, baseAddress, matches);
+        }
+    }
+
+    stream.row = row;
+
+    /* Keep the bytes a match ending in the next chunk may start in. */
+    const size_t historyLength = maximumMatchLength - 1;
+    if (size >= historyLength)
+    {
+        stream.history.assign(data + size - historyLength, data + size);
+    }
+    else
+    {
+        stream.history.insert(stream.history.end(), data, data + size);
+        if (stream.history.size() > historyLength)
+            stream.history.erase(stream.history.begin(), stream.history.begin() + (stream.history.size() - historyLength));
+    }
+
+    stream.historyEnd = baseAddress + size;
+    return matchCount;
+}
+
+size_t MemoryUtilities::RuleSet::ReportMatches(size_t ruleIndex, StreamState& stream, const uint8_t* data, size_t endOffset, uintptr_t baseAddress, std::vector<RuleMatch>& matches) const
+{
+    const Automaton& automaton = reverse[ruleIndex];
+    const uintptr_t endAddress = baseAddress + endOffset;
+    const size_t maximumLength = maximumLengths[ruleIndex];
+    const bool fixedLength = minimumLengths[ruleIndex] == maximumLength;
+
+    /* A variable-length rule may match the same start again at a later end; only the first (shortest) match is reported. */
+    std::vector<uintptr_t>& recentStarts = stream.recentStarts[ruleIndex];
+    if (fixedLength == false)
+    {
+        recentStarts.erase(std::remove_if(recentStarts.begin(), recentStarts.end(), [&](uintptr_t startAddress)
+        {
+            return endAddress - startAddress >= maximumLength;
+        }), recentStarts.end());
+    }
+
+    /* The forward automaton only knows where matches end: walk back with the rule's reversed automaton to find their starts. */
+    const size_t reachableLength = std::min<size_t>(endOffset + 1 + stream.history.size(), maximumLength);
+    uint32_t row = automaton.startRow;
+    size_t matchCount = 0;
+
+    for (size_t length = 1; length <= reachableLength; ++length)
+    {
+        const uint8_t byte = length <= endOffset + 1 ? data[endOffset + 1 - length] : stream.history[stream.history.size() - (length - endOffset - 1)];
+        row = automaton.transitions[row + automaton.byteClasses[byte]];
+        if (row == automaton.deadRow)
+            break;
+
+        if (row < automaton.firstAcceptingRow)
+            continue;
+
+        const uintptr_t startAddress = endAddress + 1 - length;
+        if (fixedLength == false)
+        {
+            if (std::find(recentStarts.begin(), recentStarts.end(), startAddress) != recentStarts.end())
+                continue;
+
+            recentStarts.push_back(startAddress);
+        }
+
+        matches.push_back({ startAddress, length, ruleIndex });
+        ++matchCount;
+    }
+
+    return matchCount;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::RuleSet::ScanFileHandle(HANDLE hFile, std::vector<RuleMatch>& matches, const ScanOptions& options) const
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "RuleSet::ScanFile", 0);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+
+    E_ScanStatus status = E_ScanStatus::Completed;
+    if (compiled == false)
+        return status;
+
+    StreamState stream;
+    BeginStream(stream);
+
+    ScanProgress progress;
+    progress.regionsTotal = 1;
+
+    LARGE_INTEGER fileSize{};
+    if (GetFileSizeEx(hFile, &fileSize))
+        progress.bytesTotal = static_cast<uint64_t>(fileSize.QuadPart);
+
+    const size_t chunkSize = std::min<size_t>(std::max<size_t>(options.chunkSize, 1), MAXDWORD);
+    std::vector<uint8_t> chunkBuffer(chunkSize);
+
+    while (true)
+    {
+        if (options.Continue(progress, status) == false)
+            return status;
+
+        DWORD bytesRead = 0;
+        if (!ReadFile(hFile, chunkBuffer.data(), static_cast<DWORD>(chunkSize), &bytesRead, nullptr) || bytesRead == 0)
+            break;
+
+        CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, bytesRead);
+        FeedStream(stream, chunkBuffer.data(), bytesRead, static_cast<uintptr_t>(progress.bytesProcessed), matches);
+        progress.bytesProcessed += bytesRead;
+    }
+
+    progress.regionsDone = 1;
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return E_ScanStatus::Completed;
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <windows.h>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MemorySnapshots.h"
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	/**
+	* @brief Match reported by a RuleSet scan.
+	* @param address - Where the match starts: a memory address, or a file offset for ScanFile().
+	* @param length - Length of the match in bytes; for rules with variable-length parts, the shortest match starting at 'address'.
+	* @param ruleIndex - Index returned by RuleSet::AddRule() for the rule that matched.
+	*/
+	struct RuleMatch
+	{
+		uintptr_t address	= 0x0;
+		size_t	  length	= 0;
+		size_t	  ruleIndex = 0;
+	};
+
+
+
+
+
+
+	class RuleSet
+	{
+		// Description: Byte-level pattern rules compiled together into a single DFA, so a buffer is scanned in one linear pass whatever
+		//              the number of rules. Rules are space separated terms:
+		//                  48        exact byte              ??       any byte
+		//                  4? / ?B   nibble wildcards        48/F0    byte under a mask ((b & F0) == 40)
+		//                  {30-39,5F} byte ranges and sets   [4-8]    jump over 4 to 8 bytes; [4] over exactly 4
+		//                  ( 74 | 0F 84 ?? ?? ?? ?? )         alternatives, which may nest
+		//              e.g. "48 8B [4-8] E8" or "( E8 | E9 ) ?? ?? ?? ?? {C3,CC}". A match is reported once per (rule, start address).
+		//              Scanning is const and thread-safe once compiled.
+		// Search Tags: #rules, #regex, #dfa, #automaton, #pattern, #signature, #alternatives, #jumps, #yara.
+	public:
+		static constexpr size_t InvalidRule		   = static_cast<size_t>(-1);
+		static constexpr size_t MaximumJumpLength  = 1024;		 // Upper bound of a single [n-m] jump.
+		static constexpr size_t MaximumStateCount  = 64 * 1024;	 // Compile() fails if the combined DFA would grow past this.
+
+
+
+
+		/**
+		* @brief Parses a rule and adds it to the set. The set has to be compiled again before the next scan.
+		* @param rule - Rule text, see the class description.
+		* @return Index of the rule, reported in RuleMatch::ruleIndex; 'InvalidRule' if it can't be parsed (see GetCompileError()).
+		*/
+		size_t AddRule(const std::string& rule);
+		/**
+		* @brief Builds the automaton for every rule added so far.
+		* @return false if there are no rules or the automaton would exceed 'MaximumStateCount' states (see GetCompileError()).
+		*/
+		bool Compile();
+		void Clear();
+
+
+		bool		IsCompiled() const;
+		size_t		GetRuleCount() const;
+		size_t		GetStateCount() const;
+		/**
+		* @brief Longest match any rule can produce, the overlap needed when scanning a range in pieces.
+		*/
+		size_t		GetMaximumMatchLength() const;
+		/**
+		* @brief Describes why the last AddRule() or Compile() call failed.
+		*/
+		std::string GetCompileError() const;
+
+
+
+
+		/**
+		* @brief Scans a buffer already in memory, e.g. a file read or mapped by the caller.
+		* @param baseAddress - Address reported for data[0].
+		* @param matches - Receives the matches, ordered by their end.
+		* @return Number of matches appended to 'matches'.
+		*/
+		size_t		 ScanBuffer(const uint8_t* data, size_t size, uintptr_t baseAddress, std::vector<RuleMatch>& matches) const;
+		/**
+		* @brief Scans a range of the current process. Cancellable, bounded by a deadline and reporting progress (see ScanOptions).
+		*/
+		E_ScanStatus ScanInternal(const uint8_t* startingAddress, size_t size, std::vector<RuleMatch>& matches, const ScanOptions& options = ScanOptions()) const;
+		/**
+		* @brief Scans regions of a target process in one pass, reading them in chunks of ScanOptions::chunkSize bytes.
+		*        Chunks that can't be read are skipped, and matches never span them.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		*/
+		E_ScanStatus ScanExternal(const HANDLE& hProcess, const std::vector<SnapshotStore::Region>& regions, std::vector<RuleMatch>& matches,
+								  const ScanOptions& options = ScanOptions()) const;
+		/**
+		* @brief Scans a file from disk in chunks of ScanOptions::chunkSize bytes. RuleMatch::address holds file offsets.
+		*/
+		E_ScanStatus ScanFile(const std::string& filePath, std::vector<RuleMatch>& matches, const ScanOptions& options = ScanOptions()) const;
+		E_ScanStatus ScanFile(const std::wstring& filePath, std::vector<RuleMatch>& matches, const ScanOptions& options = ScanOptions()) const;
+
+
+
+
+	private:
+		/* Rule syntax tree, kept so the set can be recompiled when rules are added. */
+		struct RuleNode
+		{
+			enum class E_Kind
+			{
+				Bytes,		 // One byte out of 'bytes'.
+				Sequence,	 // 'children' one after the other.
+				Alternation, // One of 'children'; an empty Sequence child makes the whole node optional.
+			};
+
+			E_Kind				  kind = E_Kind::Sequence;
+			std::bitset<256>	  bytes;
+			std::vector<RuleNode> children;
+		};
+
+
+		/* Byte-classed transition table. A transition holds the target's row offset (state * classCount), which spares a multiply
+		   per byte; accepting states are numbered last, so a row accepts when it's at least 'firstAcceptingRow'. */
+		struct Automaton
+		{
+			uint8_t							 byteClasses[256]  = {};
+			size_t							 classCount		   = 0;
+			std::vector<uint32_t>			 transitions;
+			std::vector<std::vector<size_t>> acceptedRules;	   // Per accepting state; only filled for the forward automaton.
+			uint32_t						 startRow		   = 0;
+			uint32_t						 firstAcceptingRow = 0;
+			uint32_t						 deadRow		   = UINT32_MAX; // Only anchored automata have one.
+		};
+
+
+		/* Forward automaton state carried from one chunk to the next, plus the bytes needed to find where matches started. */
+		struct StreamState
+		{
+			uint32_t							row		   = 0;
+			std::vector<uint8_t>				history;	  // Up to GetMaximumMatchLength() - 1 bytes preceding the next chunk.
+			uintptr_t							historyEnd = 0x0;
+			std::vector<std::vector<uintptr_t>> recentStarts; // Per rule, starts already reported that a later end may match again.
+		};
+
+
+		class RuleParser;		// Text to RuleNode tree.
+		class AutomatonBuilder; // RuleNode trees to Thompson NFA to DFA.
+
+
+		void		 BeginStream(StreamState& stream) const;
+		size_t		 FeedStream(StreamState& stream, const uint8_t* data, size_t size, uintptr_t baseAddress, std::vector<RuleMatch>& matches) const;
+		size_t		 ReportMatches(size_t ruleIndex, StreamState& stream, const uint8_t* data, size_t endOffset, uintptr_t baseAddress, std::vector<RuleMatch>& matches) const;
+		E_ScanStatus ScanFileHandle(HANDLE hFile, std::vector<RuleMatch>& matches, const ScanOptions& options) const;
+
+
+		std::vector<RuleNode> rules;
+		std::vector<size_t>	  minimumLengths;
+		std::vector<size_t>	  maximumLengths;
+		std::string			  compileError;
+
+		bool				   compiled = false;
+		Automaton			   forward;
+		std::vector<Automaton> reverse; // One anchored automaton per rule, run backwards from a match end to find its start.
+		size_t				   maximumMatchLength = 0;
+	};
+}
@@ -0,0 +1,324 @@
+#include "MemorySignatureCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FileUtilities.h"
+#include "MemoryTracing.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace
+{
+    /* File layout (little endian):
+       header: "CRSIGCAC", uint32 version, uint32 moduleCount.
+       module: uint32 timeDateStamp, uint32 imageSize, uint64 buildHash, uint64 codeHash, uint32 entryCount,
+               then per entry: uint64 patternKey, uint32 rva (ModuleImage::InvalidRva for patterns without a match). */
+    const char     kFileMagic[8]     = { 'C', 'R', 'S', 'I', 'G', 'C', 'A', 'C' };
+    const uint32_t kFileVersion      = 1;
+    const size_t   kFileHeaderSize   = sizeof(kFileMagic) + 2 * sizeof(uint32_t);
+    const size_t   kModuleHeaderSize = 3 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    const size_t   kEntrySize        = sizeof(uint64_t) + sizeof(uint32_t);
+
+
+
+    template<typename T>
+    void AppendValue(std::string& bytes, T value)
+    {
+        char buffer[sizeof(T)];
+        std::memcpy(buffer, &value, sizeof(value));
+        bytes.append(buffer, sizeof(buffer));
+    }
+
+    template<typename T>
+    T LoadValue(const char*& data)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(value));
+        data += sizeof(value);
+        return value;
+    }
+
+    /* Key of a pattern: its masked bytes and masks, so spelling ("4?" / "40/F0", spacing, case) doesn't matter. */
+    uint64_t GetPatternKey(const MemoryUtilities::MaskedPattern& pattern)
+    {
+        thread_local std::vector<uint8_t> keyBytes;
+        keyBytes.resize(pattern.values.size() * 2);
+        for (size_t i = 0; i < pattern.values.size(); ++i)
+        {
+            keyBytes[i * 2] = pattern.values[i] & pattern.masks[i];
+            keyBytes[i * 2 + 1] = pattern.masks[i];
+        }
+
+        return MemoryUtilities::Convertion::Bytes_ToHash64(keyBytes.data(), keyBytes.size());
+    }
+
+    bool PatternMatchesAt(const uint8_t* data, const MemoryUtilities::MaskedPattern& pattern)
+    {
+        for (size_t i = 0; i < pattern.values.size(); ++i)
+        {
+            if ((data[i] & pattern.masks[i]) != (pattern.values[i] & pattern.masks[i]))
+                return false;
+        }
+
+        return true;
+    }
+}
+
+
+
+
+
+
+bool MemoryUtilities::SignatureCache::Load(const std::string& filePath)
+{
+    Clear();
+
+    const std::string contents = FileUtilities::ReadFileContents(filePath);
+    if (contents.size() < kFileHeaderSize || std::memcmp(contents.data(), kFileMagic, sizeof(kFileMagic)) != 0)
+        return false;
+
+    const char* data = contents.data() + sizeof(kFileMagic);
+    const char* end = contents.data() + contents.size();
+    if (LoadValue<uint32_t>(data) != kFileVersion)
+        return false;
+
+    const uint32_t moduleCount = LoadValue<uint32_t>(data);
+    std::vector<ModuleRecord> loadedModules;
+    for (uint32_t i = 0; i < moduleCount; ++i)
+    {
+        if (static_cast<size_t>(end - data) < kModuleHeaderSize)
+            return false;
+
+        ModuleRecord record;
+        record.identity.timeDateStamp = LoadValue<uint32_t>(data);
+        record.identity.imageSize = LoadValue<uint32_t>(data);
+        record.identity.buildHash = LoadValue<uint64_t>(data);
+        record.identity.codeHash = LoadValue<uint64_t>(data);
+
+        const uint32_t entryCount = LoadValue<uint32_t>(data);
+        if (static_cast<size_t>(end - data) / kEntrySize < entryCount)
+            return false;
+
+        record.rvas.reserve(entryCount);
+        for (uint32_t j = 0; j < entryCount; ++j)
+        {
+            const uint64_t patternKey = LoadValue<uint64_t>(data);
+            record.rvas[patternKey] = LoadValue<uint32_t>(data);
+        }
+
+        loadedModules.push_back(std::move(record));
+    }
+
+    modules = std::move(loadedModules);
+    return true;
+}
+
+bool MemoryUtilities::SignatureCache::Load(const std::wstring& filePath)
+{
+    return Load(std::string(filePath.begin(), filePath.end()));
+}
+
+bool MemoryUtilities::SignatureCache::Save(const std::string& filePath) const
+{
+    const size_t moduleCount = std::min<size_t>(modules.size(), MaximumModules);
+
+    std::string contents(kFileMagic, sizeof(kFileMagic));
+    AppendValue<uint32_t>(contents, kFileVersion);
+    AppendValue<uint32_t>(contents, static_cast<uint32_t>(moduleCount));
+
+    for (size_t i = 0; i < moduleCount; ++i)
+    {
+        const ModuleRecord& record = modules[i];
+        AppendValue<uint32_t>(contents, record.identity.timeDateStamp);
+        AppendValue<uint32_t>(contents, record.identity.imageSize);
+        AppendValue<uint64_t>(contents, record.identity.buildHash);
+        AppendValue<uint64_t>(contents, record.identity.codeHash);
+        AppendValue<uint32_t>(contents, static_cast<uint32_t>(record.rvas.size()));
+
+        for (const auto& entry : record.rvas)
+        {
+            AppendValue<uint64_t>(contents, entry.first);
+            AppendValue<uint32_t>(contents, entry.second);
+        }
+    }
+
+    if (FileUtilities::WriteFileContents(filePath, contents) == false)
+        return false;
+
+    modified = false;
+    return true;
+}
+
+bool MemoryUtilities::SignatureCache::Save(const std::wstring& filePath) const
+{
+    return Save(std::string(filePath.begin(), filePath.end()));
+}
+
+void MemoryUtilities::SignatureCache::Clear()
+{
+    modules.clear();
+    module = nullptr;
+    statistics = Statistics();
+    modified = false;
+}
+
+bool MemoryUtilities::SignatureCache::IsModified() const
+{
+    return modified;
+}
+
+
+
+
+bool MemoryUtilities::SignatureCache::Attach(const ModuleImage& module, bool hashCode)
+{
+    if (module.IsLoaded() == false)
+        return false;
+
+    const ModuleIdentity identity = module.GetIdentity(hashCode);
+    auto record = std::find_if(modules.begin(), modules.end(), [&](const ModuleRecord& candidate)
+    {
+        return candidate.identity == identity;
+    });
+
+    /* The attached module's record goes first, which also keeps the most recently used ones when the file is trimmed. */
+    if (record != modules.end())
+    {
+        std::rotate(modules.begin(), record, record + 1);
+    }
+    else
+    {
+        ModuleRecord newRecord;
+        newRecord.identity = identity;
+        modules.insert(modules.begin(), std::move(newRecord));
+    }
+
+    this->module = &module;
+    return true;
+}
+
+MemoryUtilities::ModuleIdentity MemoryUtilities::SignatureCache::GetIdentity() const
+{
+    return module != nullptr ? modules.front().identity : ModuleIdentity();
+}
+
+
+
+
+uintptr_t MemoryUtilities::SignatureCache::Resolve(const std::string& memoryPattern)
+{
+    return Resolve(Convertion::MemoryPattern_ToMaskedPattern(memoryPattern));
+}
+
+uintptr_t MemoryUtilities::SignatureCache::Resolve(const MaskedPattern& pattern)
+{
+    if (module == nullptr || pattern.values.empty())
+        return 0x0;
+
+    const uint64_t patternKey = GetPatternKey(pattern);
+    uintptr_t address = 0x0;
+    if (LookUp(pattern, patternKey, address))
+        return address;
+
+    CRANCHYLIB_TRACE_SCOPE("signature", "SignatureCache::Resolve", pattern.values.size());
+    const uint32_t rva = module->FindPattern(pattern);
+    Store(patternKey, rva);
+    return rva != ModuleImage::InvalidRva ? module->GetBaseAddress() + rva : 0x0;
+}
+
+std::vector<uintptr_t> MemoryUtilities::SignatureCache::Resolve(const std::vector<std::string>& memoryPatterns)
+{
+    std::vector<uintptr_t> addresses(memoryPatterns.size(), 0x0);
+    if (module == nullptr)
+        return addresses;
+
+    /* Cached results first; only what's left is scanned for. */
+    std::vector<MaskedPattern> patterns(memoryPatterns.size());
+    std::vector<uint64_t> patternKeys(memoryPatterns.size(), 0);
+    std::vector<size_t> scanned;
+    for (size_t i = 0; i < memoryPatterns.size(); ++i)
+    {
+        patterns[i] = Convertion::MemoryPattern_ToMaskedPattern(memoryPatterns[i]);
+        if (patterns[i].values.empty())
+            continue;
+
+        patternKeys[i] = GetPatternKey(patterns[i]);
+        if (LookUp(patterns[i], patternKeys[i], addresses[i]) == false)
+            scanned.push_back(i);
+    }
+
+    if (scanned.empty())
+        return addresses;
+
+    CRANCHYLIB_TRACE_SCOPE("signature", "SignatureCache::Resolve", scanned.size());
+
+    /* Every miss is a scan of the whole module, so each one is a task of its own. */
+    std::vector<uint32_t> rvas(scanned.size(), ModuleImage::InvalidRva);
+    ThreadingUtilities::TaskGroup group(ThreadingUtilities::GetSharedPool());
+    ThreadingUtilities::ParallelFor(group, 0, scanned.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            rvas[i] = module->FindPattern(patterns[scanned[i]]);
+        }
+    });
+
+    for (size_t i = 0; i < scanned.size(); ++i)
+    {
+        Store(patternKeys[scanned[i]], rvas[i]);
+        if (rvas[i] != ModuleImage::InvalidRva)
+            addresses[scanned[i]] = module->GetBaseAddress() + rvas[i];
+    }
+
+    return addresses;
+}
+
+MemoryUtilities::SignatureCache::Statistics MemoryUtilities::SignatureCache::GetStatistics() const
+{
+    return statistics;
+}
+
+
+
+
+bool MemoryUtilities::SignatureCache::LookUp(const MaskedPattern& pattern, uint64_t patternKey, uintptr_t& outAddress)
+{
+    const std::unordered_map<uint64_t, uint32_t>& rvas = modules.front().rvas;
+    const auto entry = rvas.find(patternKey);
+    if (entry == rvas.end())
+    {
+        statistics.misses++;
+        return false;
+    }
+
+    /* A pattern without a match stays without one as long as the identity holds; nothing to compare against. */
+    const uint32_t rva = entry->second;
+    if (rva == ModuleImage::InvalidRva)
+    {
+        statistics.hits++;
+        outAddress = 0x0;
+        return true;
+    }
+
+    size_t offset = 0;
+    if (module->RvaToOffset(rva, pattern.values.size(), offset) == false || PatternMatchesAt(module->GetData() + offset, pattern) == false)
+    {
+        statistics.invalidated++;
+        return false;
+    }
+
+    statistics.hits++;
+    outAddress = module->GetBaseAddress() + rva;
+    return true;
+}
+
+void MemoryUtilities::SignatureCache::Store(uint64_t patternKey, uint32_t rva)
+{
+    modules.front().rvas[patternKey] = rva;
+    modified = true;
+}
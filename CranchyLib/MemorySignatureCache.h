@@ -0,0 +1,111 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryImages.h"
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class SignatureCache
+	{
+		// Description: Remembers where signatures were found in a module, so the next launch doesn't scan for them again. Results
+		//              are stored relative to the module base, per module identity (ModuleImage::GetIdentity()), and saved to a small
+		//              binary file. A cached result is trusted only after one compare of the pattern at the remembered offset; a
+		//              pattern that isn't cached or no longer matches there is scanned for and the cache updated. Resolving a few
+		//              hundred signatures from a warm cache takes well under a millisecond, against one module scan per signature.
+		//              Works on file images too, so a cache can be filled offline from the target's executable.
+		//              Not thread-safe: use one cache per thread, or guard it.
+		// Search Tags: #signature, #cache, #pattern, #aob, #resolve, #startup, #persistent, #offsets.
+	public:
+		/**
+		* @param hits - Results taken from the cache.
+		* @param misses - Patterns that weren't cached and were scanned for.
+		* @param invalidated - Cached offsets the pattern no longer matched at, scanned for again.
+		*/
+		struct Statistics
+		{
+			size_t hits		   = 0;
+			size_t misses	   = 0;
+			size_t invalidated = 0;
+		};
+
+
+		/**
+		* @brief Modules kept in the file; the least recently attached ones are dropped past this, e.g. old builds of an updated target.
+		*/
+		static constexpr size_t MaximumModules = 16;
+
+
+
+
+		/**
+		* @brief Replaces the cache's contents with a file written by Save().
+		* @return false if the file can't be read or isn't a valid cache file; the cache is left empty then.
+		*/
+		bool Load(const std::string& filePath);
+		bool Load(const std::wstring& filePath);
+		bool Save(const std::string& filePath) const;
+		bool Save(const std::wstring& filePath) const;
+		void Clear();
+
+		/**
+		* @return true if results were added or changed since the last Load() or Save().
+		*/
+		bool IsModified() const;
+
+
+
+
+		/**
+		* @brief Selects the module that Resolve() works on, and its cached results. The module must outlive its use by the cache.
+		* @param hashCode - Identify the module by the hash of its code as well as by its headers (see ModuleImage::GetIdentity()).
+		* @return false if the module isn't loaded.
+		*/
+		bool		   Attach(const ModuleImage& module, bool hashCode = true);
+		ModuleIdentity GetIdentity() const;
+
+		/**
+		* @brief Finds the first match of a pattern in the attached module, from the cache when possible.
+		* @param memoryPattern - Pattern in the Convertion::MemoryPattern_ToMaskedPattern() format, e.g. "48 8B ?? 4?".
+		* @return Address of the match in the module's address space, or 0x0 if the pattern doesn't match (which is cached too).
+		*/
+		uintptr_t			   Resolve(const std::string& memoryPattern);
+		uintptr_t			   Resolve(const MaskedPattern& pattern);
+		/**
+		* @brief Resolves many patterns at once; the ones missing from the cache are scanned for in parallel on the shared thread pool.
+		* @return One address per pattern, in the same order.
+		*/
+		std::vector<uintptr_t> Resolve(const std::vector<std::string>& memoryPatterns);
+
+		Statistics			   GetStatistics() const;
+
+
+
+
+	private:
+		struct ModuleRecord
+		{
+			ModuleIdentity						   identity;
+			std::unordered_map<uint64_t, uint32_t> rvas; // Pattern key -> RVA of the first match.
+		};
+
+
+		bool LookUp(const MaskedPattern& pattern, uint64_t patternKey, uintptr_t& outAddress);
+		void Store(uint64_t patternKey, uint32_t rva);
+
+
+		std::vector<ModuleRecord> modules; // Most recently attached first.
+		const ModuleImage*		  module   = nullptr;
+		Statistics				  statistics;
+		mutable bool			  modified = false;
+	};
+}
@@ -0,0 +1,221 @@
+#include "MemorySignatures.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    /* Prefix scanned for the first candidates: short enough to be cheap to find, long enough not to match everywhere. */
+    constexpr size_t kInitialConcreteBytes = 4;
+}
+
+
+
+
+
+
+bool MemoryUtilities::SignatureGenerator::LoadInternal(HMODULE hModule)
+{
+    if (module.LoadInternal(hModule) == false)
+        return false;
+
+    image = module.GetData();
+    imageSize = module.GetSize();
+    baseAddress = module.GetBaseAddress();
+    is64Bit = module.Is64Bit();
+    return true;
+}
+
+bool MemoryUtilities::SignatureGenerator::LoadExternal(const HANDLE& hProcess, HMODULE hModule)
+{
+    if (module.LoadExternal(hProcess, hModule) == false)
+        return false;
+
+    image = module.GetData();
+    imageSize = module.GetSize();
+    baseAddress = module.GetBaseAddress();
+    is64Bit = module.Is64Bit();
+    return true;
+}
+
+bool MemoryUtilities::SignatureGenerator::LoadBuffer(const uint8_t* data, size_t size, uintptr_t baseAddress, bool is64Bit)
+{
+    if (module.LoadBuffer(data, size, baseAddress) == false)
+        return false;
+
+    image = data;
+    imageSize = size;
+    this->baseAddress = baseAddress;
+    this->is64Bit = is64Bit;
+    return true;
+}
+
+
+
+
+bool MemoryUtilities::SignatureGenerator::IsLoaded() const
+{
+    return image != nullptr;
+}
+
+uintptr_t MemoryUtilities::SignatureGenerator::GetBaseAddress() const
+{
+    return baseAddress;
+}
+
+size_t MemoryUtilities::SignatureGenerator::GetImageSize() const
+{
+    return imageSize;
+}
+
+bool MemoryUtilities::SignatureGenerator::Is64Bit() const
+{
+    return is64Bit;
+}
+
+
+
+
+MemoryUtilities::MaskedPattern MemoryUtilities::SignatureGenerator::GeneratePattern(uintptr_t address, const SignatureOptions& options) const
+{
+    CRANCHYLIB_TRACE_SCOPE("signature", "SignatureGenerator::GeneratePattern", address);
+
+    if (image == nullptr || address < baseAddress || address - baseAddress >= imageSize || options.maximumLength == 0)
+        return MaskedPattern();
+
+    const size_t targetOffset = address - baseAddress;
+
+    /* Lay out the instruction stream as a pattern of up to 'maximumLength' bytes, with the unstable operands wildcarded. */
+    MaskedPattern pattern;
+    for (size_t offset = targetOffset; pattern.values.size() < options.maximumLength && offset < imageSize;)
+    {
+        DecodedInstruction instruction;
+        if (InstructionDecoder::Decode(image + offset, imageSize - offset, is64Bit, instruction) == false)
+            break;
+
+        uint8_t masks[InstructionDecoder::MaximumInstructionLength];
+        std::memset(masks, 0xFF, sizeof(masks));
+
+        /* moffs forms have no displacement, their absolute address is the immediate. */
+        const bool addressDisplacement = instruction.isRipRelative || (instruction.isAbsoluteAddress && instruction.displacementSize != 0);
+        const bool addressImmediate = instruction.isAbsoluteAddress && instruction.displacementSize == 0;
+
+        if (instruction.displacementSize != 0 && (addressDisplacement || options.wildcardDisplacements))
+            std::memset(masks + instruction.displacementOffset, 0x00, instruction.displacementSize);
+
+        /* Short branches stay: they only change when the code around them does. */
+        const bool wideImmediate = instruction.immediateSize >= 4;
+        if (instruction.immediateSize != 0 && (addressImmediate || (wideImmediate && (instruction.isRelative || options.wildcardImmediates))))
+            std::memset(masks + instruction.immediateOffset, 0x00, instruction.immediateSize);
+
+        for (size_t i = 0; i < instruction.length && pattern.values.size() < options.maximumLength; ++i)
+        {
+            pattern.masks.push_back(masks[i]);
+            pattern.values.push_back(image[offset + i] & masks[i]);
+        }
+
+        offset += instruction.length;
+    }
+
+    if (pattern.values.empty())
+        return MaskedPattern();
+
+    /* First candidates: every match of the shortest prefix with 'kInitialConcreteBytes' concrete bytes. */
+    size_t prefixLength = 0;
+    for (size_t concreteBytes = 0; prefixLength < pattern.values.size() && concreteBytes < kInitialConcreteBytes; ++prefixLength)
+    {
+        concreteBytes += pattern.masks[prefixLength] != 0x00 ? 1 : 0;
+    }
+
+    MaskedPattern prefix;
+    prefix.values.assign(pattern.values.begin(), pattern.values.begin() + prefixLength);
+    prefix.masks.assign(pattern.masks.begin(), pattern.masks.begin() + prefixLength);
+
+    std::pmr::vector<uintptr_t> candidates;
+    Internal::ScanForAllMaskedPattern(image, imageSize, prefix, candidates);
+
+    if (candidates.size() <= 1)
+    {
+        /* Unique already: shorter prefixes may be too. Each check stops at the first other match, which short prefixes find fast. */
+        while (prefixLength > 1 && IsUniquePrefix(pattern, prefixLength - 1, targetOffset))
+        {
+            --prefixLength;
+        }
+    }
+    else
+    {
+        /* Grow one byte at a time, keeping the candidates that still match; no further scan is needed. */
+        const uintptr_t imageAddress = reinterpret_cast<uintptr_t>(image);
+        while (candidates.size() > 1 && prefixLength < pattern.values.size())
+        {
+            const uint8_t mask = pattern.masks[prefixLength];
+            const uint8_t value = pattern.values[prefixLength];
+
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uintptr_t candidate)
+            {
+                const size_t byteOffset = candidate - imageAddress + prefixLength;
+                return byteOffset >= imageSize || (image[byteOffset] & mask) != value;
+            }), candidates.end());
+
+            ++prefixLength;
+        }
+
+        if (candidates.size() != 1)
+            return MaskedPattern();
+    }
+
+    pattern.values.resize(prefixLength);
+    pattern.masks.resize(prefixLength);
+    return pattern;
+}
+
+std::string MemoryUtilities::SignatureGenerator::Generate(uintptr_t address, const SignatureOptions& options) const
+{
+    return Convertion::MaskedPattern_ToMemoryPattern(GeneratePattern(address, options));
+}
+
+std::vector<std::string> MemoryUtilities::SignatureGenerator::Generate(const std::vector<uintptr_t>& addresses, const SignatureOptions& options) const
+{
+    return Generate(addresses, ThreadingUtilities::GetSharedPool(), options);
+}
+
+std::vector<std::string> MemoryUtilities::SignatureGenerator::Generate(const std::vector<uintptr_t>& addresses, ThreadingUtilities::ThreadPool& pool, const SignatureOptions& options) const
+{
+    CRANCHYLIB_TRACE_SCOPE("signature", "SignatureGenerator::Generate", addresses.size());
+
+    /* Every address costs about one scan of the module, so even single addresses are worth a task of their own. */
+    std::vector<std::string> signatures(addresses.size());
+    ThreadingUtilities::TaskGroup group(pool);
+    ThreadingUtilities::ParallelFor(group, 0, addresses.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            signatures[i] = Generate(addresses[i], options);
+        }
+    });
+
+    return signatures;
+}
+
+
+
+
+bool MemoryUtilities::SignatureGenerator::IsUniquePrefix(const MaskedPattern& pattern, size_t prefixLength, size_t targetOffset) const
+{
+    MaskedPattern prefix;
+    prefix.values.assign(pattern.values.begin(), pattern.values.begin() + prefixLength);
+    prefix.masks.assign(pattern.masks.begin(), pattern.masks.begin() + prefixLength);
+
+    /* The target is the first match, and nothing matches after it. */
+    if (Internal::ScanForMaskedPattern(image, imageSize, prefix) != reinterpret_cast<uintptr_t>(image + targetOffset))
+        return false;
+
+    return Internal::ScanForMaskedPattern(image + targetOffset + 1, imageSize - targetOffset - 1, prefix) == 0x0;
+}
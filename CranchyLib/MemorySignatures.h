@@ -0,0 +1,104 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MemoryImages.h"
+#include "MemoryInstructions.h"
+#include "MemoryUtilities.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	/**
+	* @brief What SignatureGenerator wildcards, and how long a signature may grow.
+	* @param maximumLength - Longest signature tried, in bytes; an address that needs more gets none.
+	* @param wildcardImmediates - Wildcard 4 and 8-byte immediates, which are often addresses or constants that change between builds.
+	* @param wildcardDisplacements - Also wildcard plain memory displacements (structure offsets). Branch targets, RIP-relative and
+	*                                absolute addresses are wildcarded regardless.
+	*/
+	struct SignatureOptions
+	{
+		size_t maximumLength		 = 64;
+		bool   wildcardImmediates	 = true;
+		bool   wildcardDisplacements = false;
+	};
+
+
+
+
+
+
+	class SignatureGenerator
+	{
+		// Description: Makes signatures for addresses in a module. The instruction stream at the address is decoded (InstructionDecoder),
+		//              operands that change when the module is rebuilt or relocated are wildcarded, and the pattern grows byte by
+		//              byte until it matches nowhere else in the module: one scan finds the candidates for a short prefix, and every
+		//              further byte only filters them. Generation is const and thread-safe once a module is loaded, and batches of
+		//              addresses are spread over the shared thread pool. Signatures come out in the usual "48 8B ?? ..." format.
+		// Search Tags: #signature, #sigmaker, #pattern, #aob, #unique, #wildcard, #generator, #update.
+	public:
+		/**
+		* @brief Uses a module of the current process, scanned in place.
+		* @return false if the module's image can't be located.
+		*/
+		bool LoadInternal(HMODULE hModule);
+		/**
+		* @brief Copies the image of a module loaded in a target process. Pages that can't be read are left zeroed.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @return false if the module's image can't be located or nothing of it can be read.
+		*/
+		bool LoadExternal(const HANDLE& hProcess, HMODULE hModule);
+		/**
+		* @brief Uses an image the caller keeps in memory, e.g. a module read or mapped from disk. 'data' must outlive the generator.
+		* @param baseAddress - Address reported for data[0]; the addresses passed to Generate() are in the same space.
+		* @param is64Bit - Decode the code as x64 rather than x86.
+		*/
+		bool LoadBuffer(const uint8_t* data, size_t size, uintptr_t baseAddress, bool is64Bit);
+
+		bool	  IsLoaded() const;
+		uintptr_t GetBaseAddress() const;
+		size_t	  GetImageSize() const;
+		bool	  Is64Bit() const;
+
+
+
+
+		/**
+		* @brief Generates the shortest signature starting at 'address' that matches only there within the module.
+		* @param address - Address of an instruction in the module.
+		* @return The signature; an empty pattern if the address is outside the module, the code can't be decoded, or no pattern
+		*         of up to 'options.maximumLength' bytes is unique.
+		*/
+		MaskedPattern			 GeneratePattern(uintptr_t address, const SignatureOptions& options = SignatureOptions()) const;
+		/**
+		* @brief Same as above, formatted as "48 8B ?? ..."; an empty string if there is no signature.
+		*/
+		std::string				 Generate(uintptr_t address, const SignatureOptions& options = SignatureOptions()) const;
+		/**
+		* @brief Generates signatures for many addresses in parallel.
+		* @return One signature per address, in the same order; empty strings for addresses without one.
+		*/
+		std::vector<std::string> Generate(const std::vector<uintptr_t>& addresses, const SignatureOptions& options = SignatureOptions()) const;
+		std::vector<std::string> Generate(const std::vector<uintptr_t>& addresses, ThreadingUtilities::ThreadPool& pool, const SignatureOptions& options = SignatureOptions()) const;
+
+
+
+
+	private:
+		bool IsUniquePrefix(const MaskedPattern& pattern, size_t prefixLength, size_t targetOffset) const;
+
+
+		ModuleImage	   module;
+		const uint8_t* image	   = nullptr;
+		size_t		   imageSize   = 0;
+		uintptr_t	   baseAddress = 0x0;
+		bool		   is64Bit	   = sizeof(void*) == 8;
+	};
+}
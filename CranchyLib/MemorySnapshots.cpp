@@ -0,0 +1,405 @@
+#include "MemorySnapshots.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    /* Appends pages whose contents differ between the two page tables, or that only one of them has, in ascending order. */
+    template <typename PageTable, typename Container>
+    void CollectChangedPages(const PageTable& fromTable, const PageTable& toTable, Container& changedPages)
+    {
+        const size_t pagesBefore = changedPages.size();
+
+        /* Pages are content-addressed, so equal pool indices mean equal contents - no byte comparison needed. */
+        for (const auto& [pageAddress, pageIndex] : toTable)
+        {
+            auto it = fromTable.find(pageAddress);
+            if (it == fromTable.end() || it->second != pageIndex)
+                changedPages.push_back(pageAddress);
+        }
+        for (const auto& [pageAddress, pageIndex] : fromTable)
+        {
+            if (toTable.find(pageAddress) == toTable.end())
+                changedPages.push_back(pageAddress);
+        }
+
+        std::sort(changedPages.begin() + pagesBefore, changedPages.end());
+    }
+
+
+    /* Bytes a capture of 'regions' walks, counted in whole pages - the total reported through ScanProgress. */
+    uint64_t GetSweepSize(const std::vector<MemoryUtilities::SnapshotStore::Region>& regions)
+    {
+        const uintptr_t pageMask = MemoryUtilities::SnapshotStore::PageSize - 1;
+
+        uint64_t sweepSize = 0;
+        for (const MemoryUtilities::SnapshotStore::Region& region : regions)
+        {
+            const uintptr_t regionEnd = region.baseAddress + region.size;
+            sweepSize += ((regionEnd + pageMask) & ~pageMask) - (region.baseAddress & ~pageMask);
+        }
+
+        return sweepSize;
+    }
+}
+
+
+
+
+
+
+std::vector<MemoryUtilities::SnapshotStore::Region> MemoryUtilities::SnapshotStore::GetReadableRegions(const HANDLE& hProcess)
+{
+    CRANCHYLIB_TRACE_SCOPE("sweep", "SnapshotStore::GetReadableRegions", 0);
+
+    std::vector<Region> regions;
+    if (External::IsValidProcessHandle(hProcess) == false)
+        return regions;
+
+    SYSTEM_INFO systemInfo{};
+    GetSystemInfo(&systemInfo);
+
+    uintptr_t cursor = reinterpret_cast<uintptr_t>(systemInfo.lpMinimumApplicationAddress);
+    const uintptr_t maximumAddress = reinterpret_cast<uintptr_t>(systemInfo.lpMaximumApplicationAddress);
+
+    MEMORY_BASIC_INFORMATION mbi{};
+    while (cursor < maximumAddress && External::GetBackend().QueryMemory(hProcess, reinterpret_cast<LPCVOID>(cursor), &mbi, sizeof(mbi)) == sizeof(mbi))
+    {
+        const uintptr_t regionBase = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+        const uintptr_t regionEnd = regionBase + mbi.RegionSize;
+
+        /* Committed and readable, guard pages are left alone so the capture never trips them. */
+        DWORD protectionFlags = mbi.Protect & ~(PAGE_NOCACHE | PAGE_WRITECOMBINE);
+        bool isReadable = (protectionFlags & (PAGE_READONLY | PAGE_READWRITE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE)) != 0;
+        if (mbi.State == MEM_COMMIT && isReadable && (protectionFlags & PAGE_GUARD) == 0)
+        {
+            /* Merge with the previous region when they touch, fewer regions means fewer reads. */
+            if (regions.empty() == false && regions.back().baseAddress + regions.back().size == regionBase)
+                regions.back().size += mbi.RegionSize;
+            else
+                regions.push_back({ regionBase, static_cast<size_t>(mbi.RegionSize) });
+        }
+
+        if (regionEnd <= cursor) // Never loop on a zero sized region.
+            break;
+        cursor = regionEnd;
+    }
+
+    return regions;
+}
+
+
+
+
+size_t MemoryUtilities::SnapshotStore::CaptureInternal(const std::vector<Region>& regions)
+{
+    E_ScanStatus status;
+    return CaptureInternal(regions, ScanOptions(), status);
+}
+
+size_t MemoryUtilities::SnapshotStore::CaptureInternal(const std::vector<Region>& regions, const ScanOptions& options, E_ScanStatus& status)
+{
+    CRANCHYLIB_TRACE_SCOPE("sweep", "SnapshotStore::CaptureInternal", regions.size());
+
+    status = E_ScanStatus::Completed;
+    Snapshot snapshot;
+    std::vector<uint8_t> pageBuffer(PageSize);
+
+    ScanProgress progress;
+    progress.bytesTotal = GetSweepSize(regions);
+    progress.regionsTotal = regions.size();
+    const size_t chunkBytes = std::max<size_t>(options.chunkSize / PageSize, 1) * PageSize;
+
+    for (const Region& region : regions)
+    {
+        uintptr_t cursor = region.baseAddress & ~(PageSize - 1);
+        const uintptr_t regionEnd = region.baseAddress + region.size;
+
+        while (cursor < regionEnd)
+        {
+            /* Check between chunks; whatever was captured so far is still committed below. */
+            if (options.Continue(progress, status) == false)
+                return CommitSnapshot(std::move(snapshot));
+
+            /* Query once per memory region rather than once per page. */
+            MEMORY_BASIC_INFORMATION mbi{};
+            if (VirtualQuery(reinterpret_cast<LPCVOID>(cursor), &mbi, sizeof(mbi)) != sizeof(mbi))
+                break;
+
+            const uintptr_t queriedEnd = std::min<uintptr_t>(reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize, regionEnd);
+            if (queriedEnd <= cursor)
+                break;
+
+            /* Large regions are taken one chunk at a time, so the limits are checked often enough. */
+            const uintptr_t chunkEnd = queriedEnd - cursor > chunkBytes ? cursor + chunkBytes : queriedEnd;
+            const uintptr_t nextCursor = (chunkEnd + PageSize - 1) & ~(PageSize - 1);
+            progress.bytesProcessed += nextCursor - cursor;
+
+            /* Decide from the region just queried, guard pages must never be touched in-process. */
+            DWORD protectionFlags = mbi.Protect & ~(PAGE_NOCACHE | PAGE_WRITECOMBINE);
+            bool isReadable = (protectionFlags & (PAGE_READONLY | PAGE_READWRITE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE)) != 0;
+            if (mbi.State != MEM_COMMIT || isReadable == false || (protectionFlags & (PAGE_GUARD | PAGE_NOACCESS)) != 0) // Skip the unreadable part.
+            {
+                cursor = nextCursor;
+                continue;
+            }
+
+            std::unique_lock<std::shared_mutex> lock(storeMutex);
+            for (; cursor < chunkEnd; cursor += PageSize)
+            {
+                /* Copy first, so the hash and stored contents always describe the same bytes. */
+                std::memcpy(pageBuffer.data(), reinterpret_cast<const void*>(cursor), PageSize);
+                snapshot.pageTable[cursor] = InternPage(pageBuffer.data());
+            }
+        }
+
+        ++progress.regionsDone;
+    }
+
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return CommitSnapshot(std::move(snapshot));
+}
+
+size_t MemoryUtilities::SnapshotStore::CaptureExternal(const HANDLE& hProcess, const std::vector<Region>& regions)
+{
+    E_ScanStatus status;
+    return CaptureExternal(hProcess, regions, ScanOptions(), status);
+}
+
+size_t MemoryUtilities::SnapshotStore::CaptureExternal(const HANDLE& hProcess, const std::vector<Region>& regions, const ScanOptions& options, E_ScanStatus& status)
+{
+    CRANCHYLIB_TRACE_SCOPE("sweep", "SnapshotStore::CaptureExternal", regions.size());
+
+    status = E_ScanStatus::Completed;
+    if (External::IsValidProcessHandle(hProcess) == false)
+        return InvalidSnapshot;
+
+    const size_t kChunkPages = 64; // Read up to 256 KiB per ReadProcessMemory call.
+    Snapshot snapshot;
+    std::vector<uint8_t> chunkBuffer(kChunkPages * PageSize);
+    std::vector<bool> pageRead(kChunkPages);
+
+    ScanProgress progress;
+    progress.bytesTotal = GetSweepSize(regions);
+    progress.regionsTotal = regions.size();
+    size_t bytesSinceCheck = options.chunkSize; // Check before the first read too.
+
+    for (const Region& region : regions)
+    {
+        uintptr_t cursor = region.baseAddress & ~(PageSize - 1);
+        const uintptr_t regionEnd = region.baseAddress + region.size;
+
+        while (cursor < regionEnd)
+        {
+            /* Check once every 'chunkSize' bytes; whatever was captured so far is still committed below. */
+            if (bytesSinceCheck >= options.chunkSize)
+            {
+                bytesSinceCheck = 0;
+                if (options.Continue(progress, status) == false)
+                    return CommitSnapshot(std::move(snapshot));
+            }
+
+            const size_t pagesLeft = static_cast<size_t>((regionEnd - cursor + PageSize - 1) / PageSize);
+            const size_t chunkPages = std::min<size_t>(pagesLeft, kChunkPages);
+
+            SIZE_T bytesRead = 0;
+            bool chunkRead = External::GetBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(cursor),
+                                                               chunkBuffer.data(), chunkPages * PageSize, &bytesRead)
+                             && bytesRead == chunkPages * PageSize;
+
+            /* The chunk crossed an unreadable page, retry page by page and skip the ones that fail. All remote reads are done
+               before the store is locked, so readers of earlier snapshots never wait on the other process. */
+            std::fill(pageRead.begin(), pageRead.begin() + chunkPages, chunkRead);
+            for (size_t i = 0; i < chunkPages && chunkRead == false; ++i)
+            {
+                bytesRead = 0;
+                pageRead[i] = External::GetBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(cursor + i * PageSize),
+                                                                chunkBuffer.data() + i * PageSize, PageSize, &bytesRead)
+                              && bytesRead == PageSize;
+            }
+
+            std::unique_lock<std::shared_mutex> lock(storeMutex);
+            for (size_t i = 0; i < chunkPages; ++i)
+            {
+                if (pageRead[i])
+                    snapshot.pageTable[cursor + i * PageSize] = InternPage(chunkBuffer.data() + i * PageSize);
+            }
+
+            cursor += chunkPages * PageSize;
+            progress.bytesProcessed += chunkPages * PageSize;
+            bytesSinceCheck += chunkPages * PageSize;
+        }
+
+        ++progress.regionsDone;
+    }
+
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return CommitSnapshot(std::move(snapshot));
+}
+
+size_t MemoryUtilities::SnapshotStore::CaptureExternal(const HANDLE& hProcess)
+{
+    return CaptureExternal(hProcess, GetReadableRegions(hProcess));
+}
+
+
+
+
+const uint8_t* MemoryUtilities::SnapshotStore::GetPage(size_t snapshotIndex, const uintptr_t& memoryAddress) const
+{
+    std::shared_lock<std::shared_mutex> lock(storeMutex);
+    if (snapshotIndex >= snapshots.size())
+        return nullptr;
+
+    const auto& pageTable = snapshots[snapshotIndex].pageTable;
+    auto it = pageTable.find(memoryAddress & ~(PageSize - 1));
+    if (it == pageTable.end())
+        return nullptr;
+
+    return GetPoolPage(it->second);
+}
+
+bool MemoryUtilities::SnapshotStore::GetBytes(size_t snapshotIndex, const uintptr_t& memoryAddress, void* buffer, size_t byteCount) const
+{
+    uint8_t* destination = static_cast<uint8_t*>(buffer);
+    uintptr_t cursor = memoryAddress;
+    size_t remaining = byteCount;
+
+    while (remaining > 0)
+    {
+        const uint8_t* page = GetPage(snapshotIndex, cursor);
+        if (page == nullptr)
+            return false;
+
+        const size_t pageOffset = static_cast<size_t>(cursor & (PageSize - 1));
+        const size_t toCopy = std::min<size_t>(remaining, PageSize - pageOffset);
+        std::memcpy(destination, page + pageOffset, toCopy);
+
+        destination += toCopy;
+        cursor += toCopy;
+        remaining -= toCopy;
+    }
+
+    return true;
+}
+
+std::vector<uint8_t> MemoryUtilities::SnapshotStore::GetBytes(size_t snapshotIndex, const uintptr_t& memoryAddress, size_t byteCount) const
+{
+    std::vector<uint8_t> buffer(byteCount);
+    if (byteCount == 0 || GetBytes(snapshotIndex, memoryAddress, buffer.data(), byteCount) == false)
+        return {};
+
+    return buffer;
+}
+
+std::vector<uintptr_t> MemoryUtilities::SnapshotStore::GetChangedPages(size_t fromSnapshotIndex, size_t toSnapshotIndex) const
+{
+    std::vector<uintptr_t> changedPages;
+
+    std::shared_lock<std::shared_mutex> lock(storeMutex);
+    if (fromSnapshotIndex < snapshots.size() && toSnapshotIndex < snapshots.size())
+        CollectChangedPages(snapshots[fromSnapshotIndex].pageTable, snapshots[toSnapshotIndex].pageTable, changedPages);
+
+    return changedPages;
+}
+
+size_t MemoryUtilities::SnapshotStore::GetChangedPages(size_t fromSnapshotIndex, size_t toSnapshotIndex, std::pmr::vector<uintptr_t>& changedPages) const
+{
+    std::shared_lock<std::shared_mutex> lock(storeMutex);
+    if (fromSnapshotIndex >= snapshots.size() || toSnapshotIndex >= snapshots.size())
+        return 0;
+
+    const size_t pagesBefore = changedPages.size();
+    CollectChangedPages(snapshots[fromSnapshotIndex].pageTable, snapshots[toSnapshotIndex].pageTable, changedPages);
+    return changedPages.size() - pagesBefore;
+}
+
+
+
+
+size_t MemoryUtilities::SnapshotStore::GetSnapshotCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(storeMutex);
+    return snapshots.size();
+}
+
+MemoryUtilities::SnapshotStore::Statistics MemoryUtilities::SnapshotStore::GetStatistics() const
+{
+    std::shared_lock<std::shared_mutex> lock(storeMutex);
+
+    Statistics statistics;
+    statistics.snapshotCount = snapshots.size();
+    statistics.uniquePageCount = pageCount;
+    statistics.storedBytes = pageCount * PageSize;
+    for (const Snapshot& snapshot : snapshots)
+    {
+        statistics.referencedPageCount += snapshot.pageTable.size();
+    }
+    statistics.logicalBytes = statistics.referencedPageCount * PageSize;
+
+    return statistics;
+}
+
+void MemoryUtilities::SnapshotStore::Clear()
+{
+    std::unique_lock<std::shared_mutex> lock(storeMutex);
+    snapshots.clear();
+    pagesByHash.clear();
+    pageBlocks.clear();
+    pageCount = 0;
+}
+
+
+
+
+uint32_t MemoryUtilities::SnapshotStore::InternPage(const uint8_t* pageBytes)
+{
+    /* Caller must hold 'storeMutex' exclusively. */
+    const uint64_t pageHash = Convertion::Bytes_ToHash64(pageBytes, PageSize);
+
+    /* Hash equality is only a hint, confirm with a full compare so collisions can never corrupt a snapshot. */
+    std::vector<uint32_t>& candidates = pagesByHash[pageHash];
+    for (uint32_t candidate : candidates)
+    {
+        if (std::memcmp(GetPoolPage(candidate), pageBytes, PageSize) == 0)
+            return candidate;
+    }
+
+    /* New contents - append to the pool, allocating a fresh block when the current one is full. */
+    if (pageCount % PagesPerBlock == 0)
+        pageBlocks.emplace_back(new uint8_t[PagesPerBlock * PageSize]);
+
+    const uint32_t pageIndex = static_cast<uint32_t>(pageCount++);
+    std::memcpy(const_cast<uint8_t*>(GetPoolPage(pageIndex)), pageBytes, PageSize);
+    candidates.push_back(pageIndex);
+
+    return pageIndex;
+}
+
+const uint8_t* MemoryUtilities::SnapshotStore::GetPoolPage(uint32_t pageIndex) const
+{
+    return pageBlocks[pageIndex / PagesPerBlock].get() + (pageIndex % PagesPerBlock) * PageSize;
+}
+
+size_t MemoryUtilities::SnapshotStore::CommitSnapshot(Snapshot&& snapshot)
+{
+    if (snapshot.pageTable.empty())
+        return InvalidSnapshot;
+
+    std::unique_lock<std::shared_mutex> lock(storeMutex);
+    snapshots.push_back(std::move(snapshot));
+    return snapshots.size() - 1;
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "MemoryUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	class SnapshotStore
+	{
+		// Description: Stores a series of memory snapshots where every distinct 4 KiB page is kept only once.
+		//              N snapshots cost roughly one full copy plus the pages that actually changed in between.
+		// Search Tags: #snapshot, #replay, #dedup, #pages, #hash, #readprocessmemory.
+	public:
+		static constexpr size_t PageSize = 0x1000;
+		static constexpr size_t InvalidSnapshot = static_cast<size_t>(-1);
+
+
+		/**
+		* @brief Continuous range of memory to capture.
+		* @param baseAddress - First byte of the range (rounded down to a page boundary on capture).
+		* @param size - Size of the range in bytes (rounded up to a page boundary on capture).
+		*/
+		struct Region
+		{
+			uintptr_t baseAddress = 0x0;
+			size_t    size		  = 0;
+		};
+
+
+		/**
+		* @brief Storage figures for the whole series.
+		* @param snapshotCount - Number of captured snapshots.
+		* @param uniquePageCount - Number of distinct pages physically stored.
+		* @param referencedPageCount - Sum of pages referenced by every snapshot page table.
+		* @param storedBytes - Bytes used by the deduplicated page pool.
+		* @param logicalBytes - Bytes the series would take if every snapshot was stored in full.
+		*/
+		struct Statistics
+		{
+			size_t snapshotCount	   = 0;
+			size_t uniquePageCount	   = 0;
+			size_t referencedPageCount = 0;
+			size_t storedBytes		   = 0;
+			size_t logicalBytes		   = 0;
+		};
+
+
+
+
+		SnapshotStore() = default;
+		SnapshotStore(const SnapshotStore&) = delete;
+		SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+
+
+
+		/**
+		* @brief Collects every committed, readable region of a target process (VirtualQueryEx sweep).
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @return Regions in ascending address order; empty vector if the handle is invalid.
+		*/
+		static std::vector<Region> GetReadableRegions(const HANDLE& hProcess);
+
+
+		/**
+		* @brief Captures the given regions of the current process as a new snapshot. Unreadable pages are skipped.
+		* @param regions - Regions to capture.
+		* @return Index of the new snapshot, or 'InvalidSnapshot' if nothing could be captured.
+		*/
+		size_t CaptureInternal(const std::vector<Region>& regions);
+		/**
+		* @brief Same as above, but cancellable, bounded by a deadline and reporting progress (see ScanOptions).
+		*        A sweep that is stopped still commits the pages captured so far as a partial snapshot.
+		* @param status - Receives whether the sweep completed, was cancelled or ran out of time.
+		*/
+		size_t CaptureInternal(const std::vector<Region>& regions, const ScanOptions& options, E_ScanStatus& status);
+		/**
+		* @brief Captures the given regions of a target process as a new snapshot. Unreadable pages are skipped.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @param regions - Regions to capture.
+		* @return Index of the new snapshot, or 'InvalidSnapshot' if nothing could be captured.
+		*/
+		size_t CaptureExternal(const HANDLE& hProcess, const std::vector<Region>& regions);
+		/**
+		* @brief Same as above, but cancellable, bounded by a deadline and reporting progress (see ScanOptions).
+		*        A sweep that is stopped still commits the pages captured so far as a partial snapshot.
+		* @param status - Receives whether the sweep completed, was cancelled or ran out of time.
+		*/
+		size_t CaptureExternal(const HANDLE& hProcess, const std::vector<Region>& regions, const ScanOptions& options, E_ScanStatus& status);
+		/**
+		* @brief Captures every committed, readable region of a target process as a new snapshot.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @return Index of the new snapshot, or 'InvalidSnapshot' if nothing could be captured.
+		*/
+		size_t CaptureExternal(const HANDLE& hProcess);
+
+
+
+
+		/**
+		* @brief Looks up the stored page that contains a given address (single hash lookup).
+		* @param snapshotIndex - Index of the snapshot returned by one of the Capture functions.
+		* @param memoryAddress - Any address inside the page of interest.
+		* @return Pointer to 'PageSize' bytes of page contents, valid until Clear() is called; 'nullptr' if the page wasn't captured.
+		*/
+		const uint8_t* GetPage(size_t snapshotIndex, const uintptr_t& memoryAddress) const;
+
+		/**
+		* @brief Copies bytes out of a snapshot, crossing page boundaries where needed.
+		* @param snapshotIndex - Index of the snapshot returned by one of the Capture functions.
+		* @param memoryAddress - Address of the first byte to copy.
+		* @param buffer - Destination buffer, at least 'byteCount' bytes long.
+		* @param byteCount - Number of bytes to copy.
+		* @return true if every requested byte was present in the snapshot; false otherwise.
+		*/
+		bool GetBytes(size_t snapshotIndex, const uintptr_t& memoryAddress, void* buffer, size_t byteCount) const;
+		std::vector<uint8_t> GetBytes(size_t snapshotIndex, const uintptr_t& memoryAddress, size_t byteCount) const;
+
+		/**
+		* @brief Lists pages whose contents differ between two snapshots (including pages present in only one of them).
+		* @return Page base addresses in ascending order.
+		*/
+		std::vector<uintptr_t> GetChangedPages(size_t fromSnapshotIndex, size_t toSnapshotIndex) const;
+		/**
+		* @brief Same, but appends into 'changedPages', which can live in a MemoryArena when diffing many snapshot pairs.
+		* @return Number of page addresses appended.
+		*/
+		size_t GetChangedPages(size_t fromSnapshotIndex, size_t toSnapshotIndex, std::pmr::vector<uintptr_t>& changedPages) const;
+
+
+
+
+		size_t GetSnapshotCount() const;
+		Statistics GetStatistics() const;
+
+		void Clear();
+
+
+
+
+	private:
+		static constexpr size_t PagesPerBlock = 256; // 1 MiB page pool blocks; pages never move once stored.
+
+		struct Snapshot
+		{
+			std::unordered_map<uintptr_t, uint32_t> pageTable; // Page base address -> index in the page pool.
+		};
+
+
+		uint32_t InternPage(const uint8_t* pageBytes);
+		const uint8_t* GetPoolPage(uint32_t pageIndex) const;
+		size_t CommitSnapshot(Snapshot&& snapshot);
+
+
+		std::vector<std::unique_ptr<uint8_t[]>>			 pageBlocks;
+		size_t											 pageCount = 0;
+		std::unordered_map<uint64_t, std::vector<uint32_t>> pagesByHash;
+		std::vector<Snapshot>							 snapshots;
+		mutable std::shared_mutex						 storeMutex;
+	};
+}
@@ -0,0 +1,340 @@
+#include "MemoryStrings.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "MemoryTracing.h"
+
+
+
+
+
+
+namespace
+{
+    constexpr size_t   kBlockSize = 16;
+    constexpr unsigned kByteLanes = 0xFFFF; // Every byte of a block.
+    constexpr unsigned kWideLanes = 0x5555; // The low byte of every UTF-16 code unit of a block.
+
+
+
+    /* String found by a sweep: 'length' characters at 'offset' into the image data. */
+    struct FoundString
+    {
+        size_t                            offset   = 0;
+        size_t                            length   = 0;
+        uint32_t                          rva      = 0;
+        MemoryUtilities::E_StringEncoding encoding = MemoryUtilities::E_StringEncoding::Ascii;
+    };
+
+    /* Part of the image swept for one encoding, as one task. UTF-16 code units are taken at even offsets from its start,
+       where compilers place wchar_t literals. */
+    struct StringRange
+    {
+        size_t                            offset   = 0;
+        size_t                            size     = 0;
+        uint32_t                          rva      = 0;
+        MemoryUtilities::E_StringEncoding encoding = MemoryUtilities::E_StringEncoding::Ascii;
+    };
+
+
+    unsigned CountTrailingZeros(unsigned value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+    }
+
+    bool IsPrintable(uint8_t value)
+    {
+        return (value >= 0x20 && value <= 0x7E) || value == '\t';
+    }
+
+    /* Bit i is set for every printable byte of the 16 at 'block'. */
+    unsigned GetPrintableBytes(const uint8_t* block)
+    {
+#if defined(_M_X64) || defined(_M_IX86)
+        /* Signed compares: bytes from 0x80 up are negative, so "greater than 0x1F" already leaves them out. */
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+        const __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(0x1F)), _mm_cmplt_epi8(bytes, _mm_set1_epi8(0x7F)));
+        const __m128i printable = _mm_or_si128(inRange, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+        return static_cast<unsigned>(_mm_movemask_epi8(printable));
+#else
+        unsigned mask = 0;
+        for (size_t i = 0; i < kBlockSize; ++i)
+        {
+            mask |= IsPrintable(block[i]) ? 1u << i : 0u;
+        }
+        return mask;
+#endif
+    }
+
+    /* Bit 2i is set for every printable UTF-16 code unit (printable low byte, zero high byte) of the 8 at 'block'. */
+    unsigned GetPrintableUnits(const uint8_t* block)
+    {
+#if defined(_M_X64) || defined(_M_IX86)
+        const unsigned zeroBytes = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), _mm_setzero_si128())));
+#else
+        unsigned zeroBytes = 0;
+        for (size_t i = 0; i < kBlockSize; ++i)
+        {
+            zeroBytes |= block[i] == 0 ? 1u << i : 0u;
+        }
+#endif
+        return GetPrintableBytes(block) & (zeroBytes >> 1) & kWideLanes;
+    }
+
+    bool IsPrintableCharacter(const uint8_t* data, MemoryUtilities::E_StringEncoding encoding)
+    {
+        return encoding == MemoryUtilities::E_StringEncoding::Ascii ? IsPrintable(data[0]) : IsPrintable(data[0]) && data[1] == 0;
+    }
+
+    /* Offset of the first character at or after 'position' that is (or isn't, by 'printable') printable; 'end' if none is.
+       'end - position' must be a whole number of characters. */
+    size_t FindCharacter(const uint8_t* data, size_t position, size_t end, MemoryUtilities::E_StringEncoding encoding, bool printable)
+    {
+        const bool isWide = encoding == MemoryUtilities::E_StringEncoding::Utf16;
+        const unsigned lanes = isWide ? kWideLanes : kByteLanes;
+        for (; end - position >= kBlockSize; position += kBlockSize)
+        {
+            unsigned mask = isWide ? GetPrintableUnits(data + position) : GetPrintableBytes(data + position);
+            if (printable == false)
+                mask = ~mask & lanes;
+
+            if (mask != 0)
+                return position + CountTrailingZeros(mask);
+        }
+
+        const size_t characterSize = isWide ? 2 : 1;
+        for (; position < end; position += characterSize)
+        {
+            if (IsPrintableCharacter(data + position, encoding) == printable)
+                return position;
+        }
+
+        return end;
+    }
+
+    /* Every NUL-terminated run of at least 'minimumLength' printable characters in the range. */
+    void SweepRange(const uint8_t* data, const StringRange& range, size_t minimumLength, std::vector<FoundString>& outStrings)
+    {
+        const size_t characterSize = range.encoding == MemoryUtilities::E_StringEncoding::Utf16 ? 2 : 1;
+        const size_t end = range.offset + (range.size / characterSize) * characterSize;
+
+        size_t position = range.offset;
+        while (position < end)
+        {
+            position = FindCharacter(data, position, end, range.encoding, true);
+            if (position >= end)
+                break;
+
+            const size_t runEnd = FindCharacter(data, position, end, range.encoding, false);
+            const size_t length = (runEnd - position) / characterSize;
+            const bool terminated = runEnd < end && data[runEnd] == 0 && (characterSize == 1 || data[runEnd + 1] == 0);
+            if (terminated && length >= minimumLength)
+                outStrings.push_back({ position, length, range.rva + static_cast<uint32_t>(position - range.offset), range.encoding });
+
+            position = runEnd + characterSize;
+        }
+    }
+
+
+    /* Read-only data, swept once per encoding. Images without headers are swept from end to end. */
+    std::vector<StringRange> GetStringRanges(const MemoryUtilities::ModuleImage& module)
+    {
+        std::vector<StringRange> ranges;
+        auto addRange = [&ranges](size_t offset, uint32_t rva, size_t size)
+        {
+            ranges.push_back({ offset, size, rva, MemoryUtilities::E_StringEncoding::Ascii });
+            ranges.push_back({ offset, size, rva, MemoryUtilities::E_StringEncoding::Utf16 });
+        };
+
+        if (module.HasHeaders() == false)
+        {
+            addRange(0, 0, module.GetSize());
+            return ranges;
+        }
+
+        const bool isFile = module.GetLayout() == MemoryUtilities::ModuleImage::E_Layout::File;
+        for (const MemoryUtilities::ImageSection& section : module.GetSections())
+        {
+            size_t offset = 0;
+            const size_t sectionSize = std::min<size_t>(section.virtualSize, isFile ? section.rawDataSize : section.virtualSize);
+            if (section.isExecutable == false && section.isWritable == false && sectionSize != 0 && module.RvaToOffset(section.virtualAddress, sectionSize, offset))
+                addRange(offset, section.virtualAddress, sectionSize);
+        }
+
+        return ranges;
+    }
+
+
+    std::vector<MemoryUtilities::CodeReference> FindLiteralReferences(const std::vector<MemoryUtilities::StringLiteral>& literals, const MemoryUtilities::ReferenceIndex& references)
+    {
+        std::vector<MemoryUtilities::CodeReference> literalReferences;
+        for (const MemoryUtilities::StringLiteral& literal : literals)
+        {
+            const std::vector<MemoryUtilities::CodeReference> found = references.FindReferencesTo(literal.rva);
+            literalReferences.insert(literalReferences.end(), found.begin(), found.end());
+        }
+
+        std::sort(literalReferences.begin(), literalReferences.end(), [](const MemoryUtilities::CodeReference& left, const MemoryUtilities::CodeReference& right)
+        {
+            return left.sourceRva < right.sourceRva;
+        });
+        return literalReferences;
+    }
+
+    /* Wide text as the ASCII content it is indexed under; false if it holds anything else. */
+    bool NarrowText(const std::wstring& text, std::string& outText)
+    {
+        outText.clear();
+        outText.reserve(text.size());
+        for (wchar_t character : text)
+        {
+            if (character < 0 || character > 0x7F)
+                return false;
+
+            outText.push_back(static_cast<char>(character));
+        }
+
+        return true;
+    }
+}
+
+
+
+
+
+
+bool MemoryUtilities::StringIndex::Build(const ModuleImage& module, size_t minimumLength)
+{
+    return Build(module, minimumLength, ThreadingUtilities::GetSharedPool());
+}
+
+bool MemoryUtilities::StringIndex::Build(const ModuleImage& module, size_t minimumLength, ThreadingUtilities::ThreadPool& pool)
+{
+    Clear();
+    if (module.IsLoaded() == false)
+        return false;
+
+    CRANCHYLIB_TRACE_SCOPE("image", "StringIndex::Build", module.GetSize());
+    baseAddress = module.GetBaseAddress();
+    minimumLength = std::max<size_t>(minimumLength, 1);
+
+    const uint8_t* data = module.GetData();
+    const std::vector<StringRange> ranges = GetStringRanges(module);
+    std::vector<std::vector<FoundString>> rangeStrings(ranges.size());
+    ThreadingUtilities::TaskGroup group(pool);
+    ThreadingUtilities::ParallelFor(group, 0, ranges.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            SweepRange(data, ranges[i], minimumLength, rangeStrings[i]);
+        }
+    });
+
+    /* Ranges are in section order, ASCII before UTF-16, so each content's occurrences come out mostly sorted already. */
+    std::string content;
+    for (const std::vector<FoundString>& found : rangeStrings)
+    {
+        for (const FoundString& string : found)
+        {
+            if (string.encoding == E_StringEncoding::Ascii)
+            {
+                content.assign(reinterpret_cast<const char*>(data + string.offset), string.length);
+            }
+            else
+            {
+                content.resize(string.length);
+                for (size_t i = 0; i < string.length; ++i)
+                {
+                    content[i] = static_cast<char>(data[string.offset + i * 2]);
+                }
+            }
+
+            strings[content].push_back({ string.rva, string.encoding });
+        }
+    }
+
+    for (auto& entry : strings)
+    {
+        std::sort(entry.second.begin(), entry.second.end(), [](const StringLiteral& left, const StringLiteral& right) { return left.rva < right.rva; });
+    }
+
+    return true;
+}
+
+void MemoryUtilities::StringIndex::Clear()
+{
+    strings.clear();
+    baseAddress = 0x0;
+}
+
+
+
+
+size_t MemoryUtilities::StringIndex::GetStringCount() const
+{
+    return strings.size();
+}
+
+const std::unordered_map<std::string, std::vector<MemoryUtilities::StringLiteral>>& MemoryUtilities::StringIndex::GetStrings() const
+{
+    return strings;
+}
+
+uintptr_t MemoryUtilities::StringIndex::GetBaseAddress() const
+{
+    return baseAddress;
+}
+
+
+
+
+std::vector<MemoryUtilities::StringLiteral> MemoryUtilities::StringIndex::Find(const std::string& text) const
+{
+    const auto entry = strings.find(text);
+    return entry != strings.end() ? entry->second : std::vector<StringLiteral>();
+}
+
+std::vector<MemoryUtilities::StringLiteral> MemoryUtilities::StringIndex::Find(const std::wstring& text) const
+{
+    std::string narrowText;
+    if (NarrowText(text, narrowText) == false)
+        return {};
+
+    return Find(narrowText);
+}
+
+std::vector<std::string> MemoryUtilities::StringIndex::FindContaining(const std::string& fragment) const
+{
+    std::vector<std::string> contents;
+    for (const auto& entry : strings)
+    {
+        if (entry.first.find(fragment) != std::string::npos)
+            contents.push_back(entry.first);
+    }
+
+    std::sort(contents.begin(), contents.end());
+    return contents;
+}
+
+std::vector<MemoryUtilities::CodeReference> MemoryUtilities::StringIndex::FindReferencesTo(const std::string& text, const ReferenceIndex& references) const
+{
+    return FindLiteralReferences(Find(text), references);
+}
+
+std::vector<MemoryUtilities::CodeReference> MemoryUtilities::StringIndex::FindReferencesTo(const std::wstring& text, const ReferenceIndex& references) const
+{
+    return FindLiteralReferences(Find(text), references);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryImages.h"
+#include "MemoryReferences.h"
+#include "ThreadingUtilities.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	enum class E_StringEncoding : uint8_t
+	{
+		Ascii, // One byte per character.
+		Utf16  // UTF-16LE, two bytes per character, as wchar_t literals of Windows modules.
+	};
+
+
+	/**
+	* @brief Where one string literal sits in its module.
+	* @param rva - RVA of the literal's first character.
+	* @param encoding - How it is stored; its content is the key it is indexed under.
+	*/
+	struct StringLiteral
+	{
+		uint32_t		 rva	  = 0;
+		E_StringEncoding encoding = E_StringEncoding::Ascii;
+	};
+
+
+
+
+
+
+	class StringIndex
+	{
+		// Description: Finds code by the string literals it uses - error messages, config keys, class names - without a pattern
+		//              scan per string. The module's read-only data is swept once, 16 bytes per SSE2 compare, for NUL-terminated
+		//              runs of printable characters, stored either as bytes or as UTF-16 code units, and every run is kept in a hash
+		//              map from its content to where it sits. Together with a ReferenceIndex of the same module it tells which
+		//              instructions use a string. Only printable ASCII is recognized, in both encodings.
+		// Search Tags: #strings, #literals, #text, #ascii, #utf16, #unicode, #rdata, #rodata, #xref, #index, #sse2.
+	public:
+		static constexpr size_t DefaultMinimumLength = 5;
+
+
+		/**
+		* @brief Indexes the string literals of a module's read-only sections (of the whole image if it has no headers),
+		*        replacing any previous index. The module isn't needed afterwards.
+		* @param minimumLength - Shortest string kept, in characters; shorter runs are mostly bytes of other data.
+		* @return false if the module isn't loaded.
+		*/
+		bool Build(const ModuleImage& module, size_t minimumLength = DefaultMinimumLength);
+		bool Build(const ModuleImage& module, size_t minimumLength, ThreadingUtilities::ThreadPool& pool);
+		void Clear();
+
+		size_t																GetStringCount() const;
+		/**
+		* @return Every distinct string content, with where it occurs.
+		*/
+		const std::unordered_map<std::string, std::vector<StringLiteral>>&	GetStrings() const;
+		uintptr_t															GetBaseAddress() const;
+
+
+
+
+		/**
+		* @brief Looks up a string by its exact content, in both encodings.
+		* @return Where it occurs, ordered by RVA; empty if it isn't in the module.
+		*/
+		std::vector<StringLiteral> Find(const std::string& text) const;
+		std::vector<StringLiteral> Find(const std::wstring& text) const;
+		/**
+		* @brief Finds the strings containing a fragment, e.g. part of an error message that is formatted at runtime. Goes
+		*        through every string, which is still far quicker than scanning the module.
+		* @return Contents of the strings containing 'fragment'.
+		*/
+		std::vector<std::string>   FindContaining(const std::string& fragment) const;
+
+		/**
+		* @brief Finds the instructions using a string, through the code references of the same module.
+		* @param text - Exact content of the string.
+		* @param references - Index built from the same module.
+		* @return References to any occurrence of the string, ordered by source RVA.
+		*/
+		std::vector<CodeReference> FindReferencesTo(const std::string& text, const ReferenceIndex& references) const;
+		std::vector<CodeReference> FindReferencesTo(const std::wstring& text, const ReferenceIndex& references) const;
+
+
+
+
+	private:
+		std::unordered_map<std::string, std::vector<StringLiteral>> strings;
+		uintptr_t													baseAddress = 0x0;
+	};
+}
@@ -0,0 +1,249 @@
+#include "MemoryTracing.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+
+
+
+
+
+namespace
+{
+    const size_t kChunkEventCount = 4096;
+    const size_t kMaximumChunks	  = 256; // 1M events per thread.
+
+
+    /* Written only by its owner thread. Chunks are allocated on demand and never move, so a published event stays readable. */
+    struct ThreadBuffer
+    {
+        DWORD									   threadId = 0;
+        std::array<std::atomic<MemoryUtilities::TraceEvent*>, kMaximumChunks> chunks;
+        std::atomic<uint64_t>					   publishedCount{ 0 };
+        std::atomic<uint64_t>					   droppedCount{ 0 };
+        std::atomic<bool>						   retired{ false }; // Owner thread exited; Clear() may free the buffer.
+
+        ThreadBuffer()
+        {
+            for (std::atomic<MemoryUtilities::TraceEvent*>& chunk : chunks)
+            {
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~ThreadBuffer()
+        {
+            for (std::atomic<MemoryUtilities::TraceEvent*>& chunk : chunks)
+            {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct BufferRegistry
+    {
+        std::mutex				   registryMutex;
+        std::vector<ThreadBuffer*> buffers; // Kept after their thread exits, so its events can still be exported.
+    };
+
+
+    /* Never destroyed: threads may still record while static destructors run. */
+    BufferRegistry& GetRegistry()
+    {
+        static BufferRegistry* registry = new BufferRegistry();
+        return *registry;
+    }
+
+
+    class BufferOwner
+    {
+    public:
+        BufferOwner() : buffer(new ThreadBuffer())
+        {
+            buffer->threadId = GetCurrentThreadId();
+
+            BufferRegistry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.registryMutex);
+            registry.buffers.push_back(buffer);
+        }
+
+        ~BufferOwner()
+        {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+
+        ThreadBuffer* buffer;
+    };
+
+
+    ThreadBuffer& GetThreadBuffer()
+    {
+        thread_local BufferOwner owner;
+        return *owner.buffer;
+    }
+
+
+    void AppendJsonString(std::ostringstream& json, const char* text)
+    {
+        json << '"';
+        for (const char* c = text != nullptr ? text : ""; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                json << '\\';
+
+            json << *c;
+        }
+        json << '"';
+    }
+}
+
+
+
+
+
+
+std::atomic<bool> MemoryUtilities::Tracer::enabled{ false };
+
+
+
+
+void MemoryUtilities::Tracer::Enable()
+{
+    GetTimestamp(); // Pin the epoch before the first event.
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void MemoryUtilities::Tracer::Disable()
+{
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+
+
+
+void MemoryUtilities::Tracer::Record(const TraceEvent& traceEvent)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+
+    const uint64_t index = buffer.publishedCount.load(std::memory_order_relaxed);
+    const size_t chunkIndex = static_cast<size_t>(index / kChunkEventCount);
+    if (chunkIndex >= kMaximumChunks)
+    {
+        buffer.droppedCount.store(buffer.droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceEvent* chunk = buffer.chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+        chunk = new TraceEvent[kChunkEventCount];
+        buffer.chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    chunk[index % kChunkEventCount] = traceEvent;
+    buffer.publishedCount.store(index + 1, std::memory_order_release); // Makes the event visible to ExportChromeTrace().
+}
+
+uint64_t MemoryUtilities::Tracer::GetTimestamp()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+
+
+
+std::string MemoryUtilities::Tracer::ExportChromeTrace()
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.registryMutex);
+
+    const DWORD processId = GetCurrentProcessId();
+    std::ostringstream json;
+    json << "{\"traceEvents\":[";
+
+    bool firstEvent = true;
+    for (const ThreadBuffer* buffer : registry.buffers)
+    {
+        const uint64_t eventCount = buffer->publishedCount.load(std::memory_order_acquire);
+        for (uint64_t i = 0; i < eventCount; ++i)
+        {
+            const TraceEvent* chunk = buffer->chunks[static_cast<size_t>(i / kChunkEventCount)].load(std::memory_order_acquire);
+            const TraceEvent& traceEvent = chunk[i % kChunkEventCount];
+
+            /* Chrome expects microseconds; keep the nanoseconds as decimals. */
+            char timing[96];
+            std::snprintf(timing, sizeof(timing), "\"ts\":%llu.%03llu,\"dur\":%llu.%03llu",
+                          static_cast<unsigned long long>(traceEvent.startNanoseconds / 1000), static_cast<unsigned long long>(traceEvent.startNanoseconds % 1000),
+                          static_cast<unsigned long long>(traceEvent.durationNanoseconds / 1000), static_cast<unsigned long long>(traceEvent.durationNanoseconds % 1000));
+
+            json << (firstEvent ? "\n" : ",\n") << "{\"name\":";
+            AppendJsonString(json, traceEvent.name);
+            json << ",\"cat\":";
+            AppendJsonString(json, traceEvent.category);
+            json << ",\"ph\":\"X\"," << timing
+                 << ",\"pid\":" << processId
+                 << ",\"tid\":" << buffer->threadId
+                 << ",\"args\":{\"value\":" << traceEvent.value << "}}";
+            firstEvent = false;
+        }
+    }
+
+    json << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return json.str();
+}
+
+void MemoryUtilities::Tracer::Clear()
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.registryMutex);
+
+    std::vector<ThreadBuffer*> liveBuffers;
+    for (ThreadBuffer* buffer : registry.buffers)
+    {
+        if (buffer->retired.load(std::memory_order_acquire))
+        {
+            delete buffer;
+            continue;
+        }
+
+        /* Chunks stay allocated for the thread's next events. */
+        buffer->publishedCount.store(0, std::memory_order_relaxed);
+        buffer->droppedCount.store(0, std::memory_order_relaxed);
+        liveBuffers.push_back(buffer);
+    }
+
+    registry.buffers.swap(liveBuffers);
+}
+
+uint64_t MemoryUtilities::Tracer::GetEventCount()
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.registryMutex);
+
+    uint64_t eventCount = 0;
+    for (const ThreadBuffer* buffer : registry.buffers)
+    {
+        eventCount += buffer->publishedCount.load(std::memory_order_acquire);
+    }
+
+    return eventCount;
+}
+
+uint64_t MemoryUtilities::Tracer::GetDroppedEventCount()
+{
+    BufferRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.registryMutex);
+
+    uint64_t droppedCount = 0;
+    for (const ThreadBuffer* buffer : registry.buffers)
+    {
+        droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+    }
+
+    return droppedCount;
+}
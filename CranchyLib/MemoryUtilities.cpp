@@ -1,4 +1,15 @@
 #include "MemoryUtilities.h"
+#include "MemoryInstrumentation.h"
+#include "MemoryTracing.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 
@@ -78,6 +89,259 @@ std::vector<std::optional<uint8_t>> MemoryUtilities::Convertion::MemoryPattern_T
     return outBytes;
 }
 
+MemoryUtilities::MaskedPattern MemoryUtilities::Convertion::MemoryPattern_ToMaskedPattern(const std::string& memoryPattern)
+{
+    MaskedPattern maskedPattern;
+
+    size_t i = 0;
+    const size_t patternSize = memoryPattern.size();
+    while (i < patternSize)
+    {
+        /* Skip whitespace between tokens. */
+        if (std::isspace(static_cast<unsigned char>(memoryPattern[i])))
+        {
+            i++;
+            continue;
+        }
+
+        /* "/F0" narrows the mask of the byte before it. */
+        if (memoryPattern[i] == '/')
+        {
+            if (maskedPattern.masks.empty() || i + 2 >= patternSize)
+                return MaskedPattern();
+
+            int16_t highPart = Convertion::HEXChar_ToInt16(memoryPattern[i + 1]);
+            int16_t lowPart = Convertion::HEXChar_ToInt16(memoryPattern[i + 2]);
+            if (highPart < 0 || lowPart < 0)
+                return MaskedPattern();
+
+            maskedPattern.masks.back() &= static_cast<uint8_t>((highPart << 4) | lowPart);
+            maskedPattern.values.back() &= maskedPattern.masks.back();
+            i += 3;
+            continue;
+        }
+
+        if (i + 1 >= patternSize) // A single trailing character is not enough for a byte or wildcard.
+            return MaskedPattern();
+
+        /* Each nibble is either a HEX digit or a '?' wildcard. */
+        uint8_t value = 0;
+        uint8_t mask = 0;
+        for (size_t n = 0; n < 2; ++n)
+        {
+            value = static_cast<uint8_t>(value << 4);
+            mask = static_cast<uint8_t>(mask << 4);
+
+            const char nibble = memoryPattern[i + n];
+            if (nibble == '?')
+                continue;
+
+            int16_t part = Convertion::HEXChar_ToInt16(nibble);
+            if (part < 0)
+                return MaskedPattern();
+
+            value |= static_cast<uint8_t>(part);
+            mask |= 0x0F;
+        }
+
+        maskedPattern.values.push_back(value);
+        maskedPattern.masks.push_back(mask);
+        i += 2;
+    }
+
+    return maskedPattern;
+}
+
+MemoryUtilities::MaskedPattern MemoryUtilities::Convertion::BytesPattern_ToMaskedPattern(const std::vector<std::optional<uint8_t>>& bytesPattern)
+{
+    MaskedPattern maskedPattern;
+    maskedPattern.values.reserve(bytesPattern.size());
+    maskedPattern.masks.reserve(bytesPattern.size());
+
+    for (const std::optional<uint8_t>& patternByte : bytesPattern)
+    {
+        maskedPattern.values.push_back(patternByte.value_or(0x00));
+        maskedPattern.masks.push_back(patternByte.has_value() ? 0xFF : 0x00);
+    }
+
+    return maskedPattern;
+}
+
+
+
+std::string MemoryUtilities::Convertion::MaskedPattern_ToMemoryPattern(const MaskedPattern& maskedPattern)
+{
+    std::string memoryPattern;
+
+    const size_t patternLength = std::min<size_t>(maskedPattern.values.size(), maskedPattern.masks.size());
+    for (size_t i = 0; i < patternLength; ++i)
+    {
+        if (i != 0)
+            memoryPattern += ' ';
+
+        const uint8_t mask = maskedPattern.masks[i];
+        const uint8_t value = maskedPattern.values[i] & mask;
+
+        /* Nibbles that are fully in or out of the mask become a digit or '?'; any other mask is written out after the byte. */
+        const uint8_t highMask = mask >> 4;
+        const uint8_t lowMask = mask & 0x0F;
+        const bool nibbleMask = (highMask == 0x0 || highMask == 0xF) && (lowMask == 0x0 || lowMask == 0xF);
+
+        memoryPattern += nibbleMask && highMask == 0x0 ? '?' : Int16_ToHEXChar(value >> 4);
+        memoryPattern += nibbleMask && lowMask == 0x0 ? '?' : Int16_ToHEXChar(value & 0x0F);
+
+        if (nibbleMask == false)
+        {
+            memoryPattern += '/';
+            memoryPattern += Int16_ToHEXChar(mask >> 4);
+            memoryPattern += Int16_ToHEXChar(mask & 0x0F);
+        }
+    }
+
+    return memoryPattern;
+}
+
+
+/* Per-lane keys mixed into every 64 byte stripe, and keys applied when scrambling the accumulators after each 1 KiB block. */
+static constexpr size_t kHashStripeSize = 64;
+static constexpr size_t kHashStripesPerBlock = 16;
+static constexpr uint64_t kHashPrime32 = 0x9E3779B1ULL;
+static constexpr uint64_t kHashPrime64 = 0x9E3779B185EBCA87ULL;
+alignas(16) static constexpr uint64_t kHashStripeKeys[8] =
+{
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL,
+    0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL, 0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL
+};
+alignas(16) static constexpr uint64_t kHashScrambleKeys[8] =
+{
+    0xCB00C391BB52283CULL, 0xA32E531B8B65D088ULL, 0x4EF90DA297486471ULL, 0xD8ACDEA946EF1938ULL,
+    0x3F349CE33F76FAA8ULL, 0x1D4F0BC7C7BBDCF9ULL, 0x3159B4CD4BE0518AULL, 0x647378D9C97E9FC8ULL
+};
+
+static void HashAccumulateStripe(uint64_t* accumulators, const uint8_t* stripe)
+{
+#if defined(_M_X64) || defined(_M_IX86)
+    __m128i* lanes = reinterpret_cast<__m128i*>(accumulators);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe) + i);
+        __m128i key = _mm_xor_si128(data, _mm_load_si128(reinterpret_cast<const __m128i*>(kHashStripeKeys) + i));
+
+        /* lo32(key) * hi32(key) for both 64-bit lanes, plus the neighbouring lane's raw data. */
+        __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+    }
+#else
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t data;
+        std::memcpy(&data, stripe + i * sizeof(uint64_t), sizeof(data));
+        uint64_t key = data ^ kHashStripeKeys[i];
+
+        accumulators[i ^ 1] += data;
+        accumulators[i] += (key & 0xFFFFFFFFULL) * (key >> 32);
+    }
+#endif
+}
+
+static void HashScrambleAccumulators(uint64_t* accumulators)
+{
+#if defined(_M_X64) || defined(_M_IX86)
+    __m128i* lanes = reinterpret_cast<__m128i*>(accumulators);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(kHashPrime32));
+    for (size_t i = 0; i < 4; ++i)
+    {
+        __m128i value = _mm_xor_si128(lanes[i], _mm_srli_epi64(lanes[i], 47));
+        value = _mm_xor_si128(value, _mm_load_si128(reinterpret_cast<const __m128i*>(kHashScrambleKeys) + i));
+
+        /* 64 x 32 bit multiply built out of two 32 x 32 -> 64 bit multiplies. */
+        __m128i productLow = _mm_mul_epu32(value, prime);
+        __m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)), prime);
+        lanes[i] = _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32));
+    }
+#else
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t value = accumulators[i] ^ (accumulators[i] >> 47) ^ kHashScrambleKeys[i];
+        accumulators[i] = value * kHashPrime32;
+    }
+#endif
+}
+
+static uint64_t HashMix(uint64_t a, uint64_t b)
+{
+    uint64_t product = (a ^ (a >> 31)) * kHashPrime64;
+    product ^= b + (product >> 29);
+    return product * 0xC2B2AE3D27D4EB4FULL;
+}
+
+uint64_t MemoryUtilities::Convertion::Bytes_ToHash64(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    alignas(16) uint64_t accumulators[8] =
+    {
+        kHashPrime32, kHashPrime64, 0x165667B19E3779F9ULL, 0x85EBCA77C2B2AE63ULL,
+        0x27D4EB2F165667C5ULL, 0xC2B2AE3D27D4EB4FULL, 0x9E3779B97F4A7C15ULL, kHashPrime32 ^ kHashPrime64
+    };
+
+    /* Consume whole 64 byte stripes, scrambling the accumulators once per block. */
+    const size_t stripeCount = size / kHashStripeSize;
+    for (size_t stripe = 0; stripe < stripeCount; ++stripe)
+    {
+        HashAccumulateStripe(accumulators, bytes + stripe * kHashStripeSize);
+        if ((stripe + 1) % kHashStripesPerBlock == 0)
+            HashScrambleAccumulators(accumulators);
+    }
+
+    /* The trailing partial stripe is zero-padded so every code path sees the same input. */
+    const size_t tailSize = size % kHashStripeSize;
+    if (tailSize != 0)
+    {
+        alignas(16) uint8_t lastStripe[kHashStripeSize] = { 0 };
+        std::memcpy(lastStripe, bytes + stripeCount * kHashStripeSize, tailSize);
+        HashAccumulateStripe(accumulators, lastStripe);
+    }
+
+    /* Fold the accumulators together and avalanche the result. */
+    uint64_t hash = static_cast<uint64_t>(size) * kHashPrime64;
+    for (size_t i = 0; i < 8; i += 2)
+    {
+        hash += HashMix(accumulators[i] ^ kHashScrambleKeys[i], accumulators[i + 1] ^ kHashStripeKeys[i + 1]);
+    }
+
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9ULL;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+
+
+
+
+
+bool MemoryUtilities::ScanOptions::Continue(const ScanProgress& progress, E_ScanStatus& status) const
+{
+    if (progressCallback)
+        progressCallback(progress);
+
+    if (cancellationToken != nullptr && cancellationToken->IsCancellationRequested())
+    {
+        status = E_ScanStatus::Cancelled;
+        return false;
+    }
+
+    if (deadline != (std::chrono::steady_clock::time_point::max)() && std::chrono::steady_clock::now() >= deadline)
+    {
+        status = E_ScanStatus::DeadlineExceeded;
+        return false;
+    }
+
+    return true;
+}
+
 
 
 
@@ -86,8 +350,20 @@ std::vector<std::optional<uint8_t>> MemoryUtilities::Convertion::MemoryPattern_T
 // ========================================================
 // |                      #INTERNAL                       |
 // ========================================================
+/* Every in-process protection change goes through here, so instrumentation sees all of them. */
+static BOOL ProtectLocalMemory(LPVOID address, SIZE_T size, DWORD newProtect, PDWORD oldProtect)
+{
+    CRANCHYLIB_INSTRUMENT_SCOPE(MemoryUtilities::E_InstrumentedOperation::InternalProtect);
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::InternalProtectionChanges, 1);
+
+    return VirtualProtect(address, size, newProtect, oldProtect);
+}
+
 bool MemoryUtilities::Internal::IsValidPtr(const void* memoryPtr)
 {
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Validation);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::ValidationCalls, 1);
+
     MEMORY_BASIC_INFORMATION mbi;
 
     if (VirtualQuery(memoryPtr, &mbi, sizeof(mbi)) != sizeof(mbi)) // Try to request (query) information about the given memory region, return False if attempt fails.
@@ -171,6 +447,8 @@ void* MemoryUtilities::Internal::PtrFollowPointerChain(const void* memoryPtr, co
 
 uintptr_t MemoryUtilities::Internal::AddressFollowPointerChain(const uintptr_t& memoryAddress, const std::vector<uintptr_t>& memoryOffsets)
 {
+    CRANCHYLIB_TRACE_SCOPE("pointer", "Internal::AddressFollowPointerChain", memoryOffsets.size());
+
     uintptr_t newMemoryAddress = memoryAddress;
     size_t offsetsCount = memoryOffsets.size();
 
@@ -194,85 +472,564 @@ uintptr_t MemoryUtilities::Internal::AddressFollowPointerChain(const uintptr_t&
 
 
 
-uintptr_t MemoryUtilities::Internal::ScanForBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern)
+/* Pattern bytes and masks as flat arrays, the form every scan loop works on. */
+struct PatternView
+{
+    const uint8_t* values = nullptr;
+    const uint8_t* masks = nullptr;
+    size_t length = 0;
+};
+
+/* Backing memory of a PatternView, owned by the scan's own frame; a progress callback may then start another scan on the same
+   thread without clobbering the pattern of the one it was called from. Patterns of up to 128 bytes don't allocate. */
+struct PatternStorage
+{
+    uint8_t inlineBuffer[128 * 2];
+    std::vector<uint8_t> heapBuffer;
+
+    uint8_t* Reserve(size_t byteCount)
+    {
+        if (byteCount <= sizeof(inlineBuffer))
+            return inlineBuffer;
+
+        heapBuffer.resize(byteCount);
+        return heapBuffer.data();
+    }
+};
+
+/* Copies a pattern into 'storage' as masked values and masks. The view is valid as long as 'storage' is. */
+static PatternView GetPatternView(const std::vector<std::optional<uint8_t>>& bytesPattern, PatternStorage& storage)
 {
     const size_t patternLength = bytesPattern.size();
-    if (patternLength == 0 || size < patternLength) // If there's nothing to search for, or the region is too small, give up.
+    uint8_t* values = storage.Reserve(patternLength * 2);
+    uint8_t* masks = values + patternLength;
+    for (size_t i = 0; i < patternLength; ++i)
+    {
+        values[i] = bytesPattern[i].value_or(0x00);
+        masks[i] = bytesPattern[i].has_value() ? 0xFF : 0x00;
+    }
+
+    return { values, masks, patternLength };
+}
+
+static PatternView GetPatternView(const MemoryUtilities::MaskedPattern& maskedPattern, PatternStorage& storage)
+{
+    /* Values are re-masked here, so a pattern built by hand with stray bits still matches. */
+    const size_t patternLength = std::min<size_t>(maskedPattern.values.size(), maskedPattern.masks.size());
+    uint8_t* values = storage.Reserve(patternLength * 2);
+    uint8_t* masks = values + patternLength;
+    for (size_t i = 0; i < patternLength; ++i)
+    {
+        masks[i] = maskedPattern.masks[i];
+        values[i] = maskedPattern.values[i] & masks[i];
+    }
+
+    return { values, masks, patternLength };
+}
+
+
+static unsigned CountTrailingZeros(unsigned value)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+/* Whether 'pattern' matches at 'data', comparing 16 masked bytes at a time. */
+static bool MaskedPatternMatches(const uint8_t* data, const PatternView& pattern)
+{
+    size_t i = 0;
+#if defined(_M_X64) || defined(_M_IX86)
+    for (; i + 16 <= pattern.length; i += 16)
+    {
+        const __m128i bytes = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.masks + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.values + i)))) != 0xFFFF)
+            return false;
+    }
+#endif
+
+    for (; i < pattern.length; ++i)
+    {
+        if ((data[i] & pattern.masks[i]) != pattern.values[i])
+            return false;
+    }
+
+    return true;
+}
+
+/* Pattern position candidates are keyed on: the one keeping the most mask bits, and among exact bytes preferably not one of
+   the bytes most frequent in x86 code, which would let through a candidate every few bytes. */
+static size_t GetAnchorIndex(const PatternView& pattern)
+{
+    static constexpr uint8_t kFrequentCodeBytes[] = { 0x00, 0xFF, 0xCC, 0x90, 0x48, 0x89, 0x8B, 0x0F, 0xE8, 0x4C, 0x24, 0x83 };
+
+    size_t anchorIndex = 0;
+    int bestScore = -1;
+    for (size_t i = 0; i < pattern.length; ++i)
+    {
+        int score = 0;
+        for (uint8_t bits = pattern.masks[i]; bits != 0; bits &= bits - 1)
+        {
+            score += 2;
+        }
+
+        if (pattern.masks[i] == 0xFF && std::find(std::begin(kFrequentCodeBytes), std::end(kFrequentCodeBytes), pattern.values[i]) == std::end(kFrequentCodeBytes))
+            score += 1;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            anchorIndex = i;
+        }
+    }
+
+    return anchorIndex;
+}
+
+/* First offset in [firstOffset, lastOffset) where 'pattern' matches, or 'lastOffset'. The caller guarantees that
+   'lastOffset - 1 + pattern.length' bytes are readable. */
+static size_t FindMaskedPattern(const uint8_t* startingAddress, size_t firstOffset, size_t lastOffset, const PatternView& pattern)
+{
+    const size_t anchorIndex = GetAnchorIndex(pattern);
+    const uint8_t anchorMask = pattern.masks[anchorIndex];
+    const uint8_t anchorValue = pattern.values[anchorIndex];
+
+    size_t offset = firstOffset;
+#if defined(_M_X64) || defined(_M_IX86)
+    /* Test the anchor at 16 offsets per compare; only the offsets it lets through are verified in full. */
+    const __m128i anchorMasks = _mm_set1_epi8(static_cast<char>(anchorMask));
+    const __m128i anchorValues = _mm_set1_epi8(static_cast<char>(anchorValue));
+    for (; offset + 16 <= lastOffset; offset += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(startingAddress + offset + anchorIndex));
+        unsigned candidates = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, anchorMasks), anchorValues)));
+        while (candidates != 0)
+        {
+            const size_t candidate = offset + CountTrailingZeros(candidates);
+            if (MaskedPatternMatches(startingAddress + candidate, pattern))
+                return candidate;
+
+            candidates &= candidates - 1;
+        }
+    }
+#endif
+
+    for (; offset < lastOffset; ++offset)
+    {
+        if ((startingAddress[offset + anchorIndex] & anchorMask) == anchorValue && MaskedPatternMatches(startingAddress + offset, pattern))
+            return offset;
+    }
+
+    return lastOffset;
+}
+
+/* Chunked first-match scan shared by the pattern flavours; checks 'options' before every chunk, the first one included,
+   so an already cancelled token scans nothing. */
+static MemoryUtilities::E_ScanStatus FindFirstMatch(const uint8_t* startingAddress, size_t size, const PatternView& pattern,
+                                                    const MemoryUtilities::ScanOptions& options, uintptr_t& match)
+{
+    match = 0x0;
+    MemoryUtilities::E_ScanStatus status = MemoryUtilities::E_ScanStatus::Completed;
+
+    MemoryUtilities::ScanProgress progress;
+    progress.bytesTotal = size;
+    progress.regionsTotal = 1;
+
+    const size_t offsetCount = pattern.length != 0 && size >= pattern.length ? size - pattern.length + 1 : 0;
+    const size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+
+    for (size_t chunkStart = 0; chunkStart < offsetCount; chunkStart += chunkSize)
+    {
+        progress.bytesProcessed = chunkStart;
+        if (options.Continue(progress, status) == false)
+            return status;
+
+        const size_t chunkEnd = chunkStart + std::min<size_t>(chunkSize, offsetCount - chunkStart);
+        const size_t offset = FindMaskedPattern(startingAddress, chunkStart, chunkEnd, pattern);
+        if (offset != chunkEnd)
+        {
+            match = reinterpret_cast<uintptr_t>(startingAddress + offset);
+            return MemoryUtilities::E_ScanStatus::Completed;
+        }
+    }
+
+    progress.bytesProcessed = size;
+    progress.regionsDone = 1;
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return MemoryUtilities::E_ScanStatus::Completed;
+}
+
+/* Same as FindFirstMatch, but keeps going after a match. */
+static MemoryUtilities::E_ScanStatus FindAllMatches(const uint8_t* startingAddress, size_t size, const PatternView& pattern,
+                                                    std::pmr::vector<uintptr_t>& matches, const MemoryUtilities::ScanOptions& options)
+{
+    MemoryUtilities::E_ScanStatus status = MemoryUtilities::E_ScanStatus::Completed;
+
+    MemoryUtilities::ScanProgress progress;
+    progress.bytesTotal = size;
+    progress.regionsTotal = 1;
+
+    const size_t offsetCount = pattern.length != 0 && size >= pattern.length ? size - pattern.length + 1 : 0;
+    const size_t chunkSize = std::max<size_t>(options.chunkSize, 1);
+
+    for (size_t chunkStart = 0; chunkStart < offsetCount; chunkStart += chunkSize)
+    {
+        progress.bytesProcessed = chunkStart;
+        if (options.Continue(progress, status) == false)
+            return status;
+
+        const size_t chunkEnd = chunkStart + std::min<size_t>(chunkSize, offsetCount - chunkStart);
+        for (size_t offset = FindMaskedPattern(startingAddress, chunkStart, chunkEnd, pattern); offset != chunkEnd;
+             offset = FindMaskedPattern(startingAddress, offset + 1, chunkEnd, pattern))
+        {
+            matches.push_back(reinterpret_cast<uintptr_t>(startingAddress + offset));
+        }
+    }
+
+    progress.bytesProcessed = size;
+    progress.regionsDone = 1;
+    if (options.progressCallback)
+        options.progressCallback(progress);
+
+    return MemoryUtilities::E_ScanStatus::Completed;
+}
+
+uintptr_t MemoryUtilities::Internal::ScanForBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern)
+{
+    uintptr_t match = 0x0;
+    ScanForBytesPattern(startingAddress, size, bytesPattern, ScanOptions(), match);
+
+    return match;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::Internal::ScanForBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+                                                                             const ScanOptions& options, uintptr_t& match)
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "Internal::ScanForBytesPattern", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    PatternStorage patternStorage;
+    return FindFirstMatch(startingAddress, size, GetPatternView(bytesPattern, patternStorage), options, match);
+}
+
+uintptr_t MemoryUtilities::Internal::ScanForMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern)
+{
+    /* Parse the mask string into a masked pattern. */
+    auto maskedPattern = Convertion::MemoryPattern_ToMaskedPattern(memoryPattern);
+    if (maskedPattern.values.empty())
     {
         return 0x0;
     }
 
-    /* Slide a window of patternLength across the region. */
-    for (size_t offset = 0; offset <= size - patternLength; ++offset) 
+    return ScanForMaskedPattern(startingAddress, size, maskedPattern);
+}
+
+uintptr_t MemoryUtilities::Internal::ScanForMaskedPattern(const uint8_t* startingAddress, size_t size, const MaskedPattern& maskedPattern)
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "Internal::ScanForMaskedPattern", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    uintptr_t match = 0x0;
+    PatternStorage patternStorage;
+    FindFirstMatch(startingAddress, size, GetPatternView(maskedPattern, patternStorage), ScanOptions(), match);
+
+    return match;
+}
+
+size_t MemoryUtilities::Internal::ScanForAllBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern, std::pmr::vector<uintptr_t>& matches)
+{
+    const size_t matchesBefore = matches.size();
+    ScanForAllBytesPattern(startingAddress, size, bytesPattern, matches, ScanOptions());
+
+    return matches.size() - matchesBefore;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::Internal::ScanForAllBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+                                                                                std::pmr::vector<uintptr_t>& matches, const ScanOptions& options)
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "Internal::ScanForAllBytesPattern", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    PatternStorage patternStorage;
+    return FindAllMatches(startingAddress, size, GetPatternView(bytesPattern, patternStorage), matches, options);
+}
+
+size_t MemoryUtilities::Internal::ScanForAllMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern, std::pmr::vector<uintptr_t>& matches)
+{
+    /* Parse the mask string into a masked pattern. */
+    auto maskedPattern = Convertion::MemoryPattern_ToMaskedPattern(memoryPattern);
+    if (maskedPattern.values.empty())
+        return 0;
+
+    return ScanForAllMaskedPattern(startingAddress, size, maskedPattern, matches);
+}
+
+size_t MemoryUtilities::Internal::ScanForAllMaskedPattern(const uint8_t* startingAddress, size_t size, const MaskedPattern& maskedPattern, std::pmr::vector<uintptr_t>& matches)
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "Internal::ScanForAllMaskedPattern", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    const size_t matchesBefore = matches.size();
+    PatternStorage patternStorage;
+    FindAllMatches(startingAddress, size, GetPatternView(maskedPattern, patternStorage), matches, ScanOptions());
+
+    return matches.size() - matchesBefore;
+}
+
+
+/* Mismatched bytes of 'pattern' against 'data', ignoring the bits outside each mask; stops counting once 'limit' is exceeded. */
+static size_t CountPatternMismatches(const uint8_t* data, const PatternView& pattern, size_t limit)
+{
+    size_t mismatches = 0;
+    for (size_t i = 0; i < pattern.length && mismatches <= limit; ++i)
+    {
+        if ((data[i] & pattern.masks[i]) != pattern.values[i])
+            ++mismatches;
+    }
+
+    return mismatches;
+}
+
+/* Best matches first, then cut down to 'maxResults' (0 keeps them all). */
+static void SortFuzzyMatches(std::vector<MemoryUtilities::FuzzyMatch>& matches, size_t maxResults)
+{
+    std::sort(matches.begin(), matches.end(), [](const MemoryUtilities::FuzzyMatch& a, const MemoryUtilities::FuzzyMatch& b)
     {
-        bool match = true;
-        for (size_t j = 0; j < patternLength; ++j) 
+        return a.mismatches != b.mismatches ? a.mismatches < b.mismatches : a.address < b.address;
+    });
+
+    if (maxResults != 0 && matches.size() > maxResults)
+        matches.resize(maxResults);
+}
+
+std::vector<MemoryUtilities::FuzzyMatch> MemoryUtilities::Internal::FuzzyScanForBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+                                                                                             size_t maxMismatches, size_t maxResults)
+{
+    return FuzzyScanForMaskedPattern(startingAddress, size, Convertion::BytesPattern_ToMaskedPattern(bytesPattern), maxMismatches, maxResults);
+}
+
+std::vector<MemoryUtilities::FuzzyMatch> MemoryUtilities::Internal::FuzzyScanForMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern,
+                                                                                              size_t maxMismatches, size_t maxResults)
+{
+    /* Parse the mask string into a masked pattern. */
+    auto maskedPattern = Convertion::MemoryPattern_ToMaskedPattern(memoryPattern);
+    if (maskedPattern.values.empty())
+        return std::vector<FuzzyMatch>();
+
+    return FuzzyScanForMaskedPattern(startingAddress, size, maskedPattern, maxMismatches, maxResults);
+}
+
+std::vector<MemoryUtilities::FuzzyMatch> MemoryUtilities::Internal::FuzzyScanForMaskedPattern(const uint8_t* startingAddress, size_t size, const MaskedPattern& maskedPattern,
+                                                                                              size_t maxMismatches, size_t maxResults)
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "Internal::FuzzyScanForMaskedPattern", size);
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Scan);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::Scans, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::BytesScanned, size);
+
+    std::vector<FuzzyMatch> matches;
+    PatternStorage patternStorage;
+    const PatternView pattern = GetPatternView(maskedPattern, patternStorage);
+    const size_t patternLength = pattern.length;
+    if (patternLength == 0 || size < patternLength)
+        return matches;
+
+    /* Every alignment matches once each byte may mismatch; no need to filter, and a limit that large would leave no room in the
+       state word for even one field. */
+    maxMismatches = std::min<size_t>(maxMismatches, patternLength);
+    if (maxMismatches == patternLength)
+    {
+        for (size_t offset = 0; offset + patternLength <= size; ++offset)
         {
-            /* If this pattern position has a concrete byte, it must match exactly. */
-            /* If it's std::nullopt, it's a wildcard - accept any byte. */
-            if (bytesPattern[j].has_value() && startingAddress[offset + j] != bytesPattern[j].value())
-            {
-                match = false;
-                break;
-            }
+            matches.push_back({ reinterpret_cast<uintptr_t>(startingAddress + offset), CountPatternMismatches(startingAddress + offset, pattern, patternLength) });
+        }
+
+        SortFuzzyMatches(matches, maxResults);
+        return matches;
+    }
+
+    /*
+        Shift-Add: the state holds one mismatch counter per pattern position, packed into 'fieldBits'-wide fields of a 64-bit word.
+        Every byte shifts the state by one field and adds the byte's mismatch mask, so field i counts the mismatches of the alignment
+        whose pattern byte i is the current one. A field's top bit catches counters that went past 'maxMismatches'; it is moved into
+        'overflow', which shifts along with the state, and cleared so it never carries into the next field.
+    */
+    size_t counterBits = 1;
+    while (counterBits < 63 && (static_cast<uint64_t>(1) << counterBits) <= maxMismatches)
+    {
+        ++counterBits;
+    }
+
+    const size_t fieldBits = counterBits + 1;
+    const size_t windowLength = std::min<size_t>(patternLength, 64 / fieldBits);
+
+    /* Patterns longer than a word are filtered on their most concrete window, then verified in full - mismatches in the whole
+       pattern are at least those in any window, so no match is lost. */
+    size_t windowStart = 0;
+    size_t bestConcreteCount = 0;
+    for (size_t start = 0; start + windowLength <= patternLength; ++start)
+    {
+        size_t concreteCount = 0;
+        for (size_t i = start; i < start + windowLength; ++i)
+        {
+            concreteCount += pattern.masks[i] != 0x00 ? 1 : 0;
+        }
+
+        if (concreteCount > bestConcreteCount)
+        {
+            bestConcreteCount = concreteCount;
+            windowStart = start;
         }
-        if (match) 
+    }
+
+    uint64_t mismatchMasks[256] = {};
+    uint64_t overflowBits = 0;
+    for (size_t i = 0; i < windowLength; ++i)
+    {
+        overflowBits |= static_cast<uint64_t>(1) << (i * fieldBits + counterBits);
+
+        /* A byte mismatches when it differs in the bits its mask keeps; full wildcards never do. */
+        const uint8_t patternMask = pattern.masks[windowStart + i];
+        const uint8_t patternValue = pattern.values[windowStart + i];
+        for (size_t value = 0; value < 256; ++value)
         {
-            return reinterpret_cast<uintptr_t>(startingAddress + offset);
+            if ((value & patternMask) != patternValue)
+                mismatchMasks[value] |= static_cast<uint64_t>(1) << (i * fieldBits);
         }
     }
 
-    return 0x0;
-}
+    const size_t lastFieldShift = (windowLength - 1) * fieldBits;
+    const uint64_t counterMask = (static_cast<uint64_t>(1) << counterBits) - 1;
 
-uintptr_t MemoryUtilities::Internal::ScanForMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern)
-{
-    /* Parse the mask string into a byte-pattern vector. */
-    auto bytesPattern = Convertion::MemoryPattern_ToBytesPattern(memoryPattern);
-    if (bytesPattern.empty())
+    /* Alignments that began before the region count as overflowed. */
+    uint64_t state = 0;
+    uint64_t overflow = overflowBits;
+
+    /* The window ends at 'offset'; the whole pattern must still fit in the region after it. */
+    const size_t lastOffset = size - (patternLength - windowStart - windowLength);
+    for (size_t offset = 0; offset < lastOffset; ++offset)
     {
-        return 0x0;
+        state = (state << fieldBits) + mismatchMasks[startingAddress[offset]];
+        overflow = (overflow << fieldBits) | (state & overflowBits);
+        state &= ~overflowBits;
+
+        if (((overflow >> lastFieldShift) >> counterBits) & 1)
+            continue;
+        if (((state >> lastFieldShift) & counterMask) > maxMismatches)
+            continue;
+
+        /* The window matched well enough; the pattern around it must start inside the region. */
+        const size_t windowOffset = offset + 1 - windowLength;
+        if (windowOffset < windowStart)
+            continue;
+
+        const uint8_t* candidate = startingAddress + windowOffset - windowStart;
+        const size_t mismatches = windowLength == patternLength ? static_cast<size_t>((state >> lastFieldShift) & counterMask)
+                                                                : CountPatternMismatches(candidate, pattern, maxMismatches);
+        if (mismatches <= maxMismatches)
+            matches.push_back({ reinterpret_cast<uintptr_t>(candidate), mismatches });
     }
 
-    return ScanForBytesPattern(startingAddress, size, bytesPattern);
+    SortFuzzyMatches(matches, maxResults);
+    return matches;
 }
 
 
 
 
-uintptr_t MemoryUtilities::Internal::SearchForBytesPattern(const std::vector<std::optional<uint8_t>>& bytesPattern)
+/* Base address and size of the main module's image, which the Search functions scan. */
+static bool GetMainModuleImage(const uint8_t*& baseAddress, size_t& imageSize)
 {
     /* Obtain the module handle for the current executable or DLL. */
     HMODULE hModule = GetModuleHandleW(nullptr);
     if (!hModule)
     {
-        return 0x0;
+        return false;
     }
 
     /* Retrieve information about the module: base address and image size. */
     MODULEINFO modInfo;
     if (!GetModuleInformation(GetCurrentProcess(), hModule, &modInfo, sizeof(modInfo)))
     {
-        return 0x0;
+        return false;
     }
 
-    const uint8_t* baseAddress = reinterpret_cast<const uint8_t*>(modInfo.lpBaseOfDll);
-    const size_t imageSize = static_cast<size_t>(modInfo.SizeOfImage);
+    baseAddress = reinterpret_cast<const uint8_t*>(modInfo.lpBaseOfDll);
+    imageSize = static_cast<size_t>(modInfo.SizeOfImage);
+    return true;
+}
+
+uintptr_t MemoryUtilities::Internal::SearchForBytesPattern(const std::vector<std::optional<uint8_t>>& bytesPattern)
+{
+    uintptr_t match = 0x0;
+    SearchForBytesPattern(bytesPattern, ScanOptions(), match);
+
+    return match;
+}
+
+MemoryUtilities::E_ScanStatus MemoryUtilities::Internal::SearchForBytesPattern(const std::vector<std::optional<uint8_t>>& bytesPattern, const ScanOptions& options, uintptr_t& match)
+{
+    CRANCHYLIB_TRACE_SCOPE("scan", "Internal::SearchForBytesPattern", bytesPattern.size());
+    match = 0x0;
+
+    const uint8_t* baseAddress = nullptr;
+    size_t imageSize = 0;
+    if (GetMainModuleImage(baseAddress, imageSize) == false)
+        return E_ScanStatus::Completed;
 
     /* Scan the entire module image for the pattern. */
-    return ScanForBytesPattern(baseAddress, imageSize, bytesPattern);
+    return ScanForBytesPattern(baseAddress, imageSize, bytesPattern, options, match);
 }
 
 uintptr_t MemoryUtilities::Internal::SearchForMemoryPattern(const std::string& memoryPattern)
 {
-    /* Parse the mask string into a byte-pattern vector. */
-    auto bytesPattern = Convertion::MemoryPattern_ToBytesPattern(memoryPattern);
-    if (bytesPattern.empty())
+    /* Parse the mask string into a masked pattern. */
+    auto maskedPattern = Convertion::MemoryPattern_ToMaskedPattern(memoryPattern);
+    if (maskedPattern.values.empty())
     {
         return 0x0;
     }
 
-    return SearchForBytesPattern(bytesPattern);
+    const uint8_t* baseAddress = nullptr;
+    size_t imageSize = 0;
+    if (GetMainModuleImage(baseAddress, imageSize) == false)
+        return 0x0;
+
+    return ScanForMaskedPattern(baseAddress, imageSize, maskedPattern);
+}
+
+std::vector<MemoryUtilities::FuzzyMatch> MemoryUtilities::Internal::FuzzySearchForBytesPattern(const std::vector<std::optional<uint8_t>>& bytesPattern, size_t maxMismatches, size_t maxResults)
+{
+    const uint8_t* baseAddress = nullptr;
+    size_t imageSize = 0;
+    if (GetMainModuleImage(baseAddress, imageSize) == false)
+        return std::vector<FuzzyMatch>();
+
+    return FuzzyScanForBytesPattern(baseAddress, imageSize, bytesPattern, maxMismatches, maxResults);
+}
+
+std::vector<MemoryUtilities::FuzzyMatch> MemoryUtilities::Internal::FuzzySearchForMemoryPattern(const std::string& memoryPattern, size_t maxMismatches, size_t maxResults)
+{
+    const uint8_t* baseAddress = nullptr;
+    size_t imageSize = 0;
+    if (GetMainModuleImage(baseAddress, imageSize) == false)
+        return std::vector<FuzzyMatch>();
+
+    return FuzzyScanForMemoryPattern(baseAddress, imageSize, memoryPattern, maxMismatches, maxResults);
 }
 
 
@@ -312,7 +1069,7 @@ bool MemoryUtilities::Internal::SetBool(const uintptr_t& memoryAddress, bool new
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value. */
@@ -320,7 +1077,7 @@ bool MemoryUtilities::Internal::SetBool(const uintptr_t& memoryAddress, bool new
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetBool, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetBool, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -345,7 +1102,7 @@ bool MemoryUtilities::Internal::PatchBool(const uintptr_t& memoryAddress, bool f
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value */
@@ -353,7 +1110,7 @@ bool MemoryUtilities::Internal::PatchBool(const uintptr_t& memoryAddress, bool f
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetBool, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetBool, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -402,7 +1159,7 @@ bool MemoryUtilities::Internal::IndirectSetBool(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value. */
@@ -410,7 +1167,7 @@ bool MemoryUtilities::Internal::IndirectSetBool(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetBool, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetBool, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -440,7 +1197,7 @@ bool MemoryUtilities::Internal::IndirectPatchBool(const uintptr_t& memoryAddress
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value */
@@ -448,7 +1205,7 @@ bool MemoryUtilities::Internal::IndirectPatchBool(const uintptr_t& memoryAddress
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetBool, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetBool, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -490,7 +1247,7 @@ bool MemoryUtilities::Internal::SetInt8(const uintptr_t& memoryAddress, int8_t n
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -498,7 +1255,7 @@ bool MemoryUtilities::Internal::SetInt8(const uintptr_t& memoryAddress, int8_t n
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -523,7 +1280,7 @@ bool MemoryUtilities::Internal::PatchInt8(const uintptr_t& memoryAddress, int8_t
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -531,7 +1288,7 @@ bool MemoryUtilities::Internal::PatchInt8(const uintptr_t& memoryAddress, int8_t
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -580,7 +1337,7 @@ bool MemoryUtilities::Internal::IndirectSetInt8(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -588,7 +1345,7 @@ bool MemoryUtilities::Internal::IndirectSetInt8(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -618,7 +1375,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt8(const uintptr_t& memoryAddress
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -626,7 +1383,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt8(const uintptr_t& memoryAddress
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -669,7 +1426,7 @@ bool MemoryUtilities::Internal::SetInt16(const uintptr_t& memoryAddress, int16_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -677,7 +1434,7 @@ bool MemoryUtilities::Internal::SetInt16(const uintptr_t& memoryAddress, int16_t
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -702,7 +1459,7 @@ bool MemoryUtilities::Internal::PatchInt16(const uintptr_t& memoryAddress, int16
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -710,7 +1467,7 @@ bool MemoryUtilities::Internal::PatchInt16(const uintptr_t& memoryAddress, int16
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -759,7 +1516,7 @@ bool MemoryUtilities::Internal::IndirectSetInt16(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -767,7 +1524,7 @@ bool MemoryUtilities::Internal::IndirectSetInt16(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -797,7 +1554,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt16(const uintptr_t& memoryAddres
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -805,7 +1562,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt16(const uintptr_t& memoryAddres
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -849,7 +1606,7 @@ bool MemoryUtilities::Internal::SetInt32(const uintptr_t& memoryAddress, int32_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -857,7 +1614,7 @@ bool MemoryUtilities::Internal::SetInt32(const uintptr_t& memoryAddress, int32_t
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -882,7 +1639,7 @@ bool MemoryUtilities::Internal::PatchInt32(const uintptr_t& memoryAddress, int32
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -890,7 +1647,7 @@ bool MemoryUtilities::Internal::PatchInt32(const uintptr_t& memoryAddress, int32
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -942,7 +1699,7 @@ bool MemoryUtilities::Internal::IndirectSetInt32(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -950,7 +1707,7 @@ bool MemoryUtilities::Internal::IndirectSetInt32(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -980,7 +1737,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt32(const uintptr_t& memoryAddres
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -988,7 +1745,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt32(const uintptr_t& memoryAddres
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1030,7 +1787,7 @@ bool MemoryUtilities::Internal::SetInt64(const uintptr_t& memoryAddress, int64_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -1038,7 +1795,7 @@ bool MemoryUtilities::Internal::SetInt64(const uintptr_t& memoryAddress, int64_t
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1063,7 +1820,7 @@ bool MemoryUtilities::Internal::PatchInt64(const uintptr_t& memoryAddress, int64
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -1071,7 +1828,7 @@ bool MemoryUtilities::Internal::PatchInt64(const uintptr_t& memoryAddress, int64
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1120,7 +1877,7 @@ bool MemoryUtilities::Internal::IndirectSetInt64(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
@@ -1128,7 +1885,7 @@ bool MemoryUtilities::Internal::IndirectSetInt64(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1158,7 +1915,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt64(const uintptr_t& memoryAddres
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
@@ -1166,7 +1923,7 @@ bool MemoryUtilities::Internal::IndirectPatchInt64(const uintptr_t& memoryAddres
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetInt, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetInt, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1208,7 +1965,7 @@ bool MemoryUtilities::Internal::SetFloat(const uintptr_t& memoryAddress, float n
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new float value. */
@@ -1216,7 +1973,7 @@ bool MemoryUtilities::Internal::SetFloat(const uintptr_t& memoryAddress, float n
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetFloat, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetFloat, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1241,7 +1998,7 @@ bool MemoryUtilities::Internal::PatchFloat(const uintptr_t& memoryAddress, float
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new float value */
@@ -1249,7 +2006,7 @@ bool MemoryUtilities::Internal::PatchFloat(const uintptr_t& memoryAddress, float
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetFloat, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetFloat, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1298,7 +2055,7 @@ bool MemoryUtilities::Internal::IndirectSetFloat(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new float value. */
@@ -1306,7 +2063,7 @@ bool MemoryUtilities::Internal::IndirectSetFloat(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetFloat, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetFloat, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1336,7 +2093,7 @@ bool MemoryUtilities::Internal::IndirectPatchFloat(const uintptr_t& memoryAddres
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new float value */
@@ -1344,7 +2101,7 @@ bool MemoryUtilities::Internal::IndirectPatchFloat(const uintptr_t& memoryAddres
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetFloat, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetFloat, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1386,7 +2143,7 @@ bool MemoryUtilities::Internal::SetDouble(const uintptr_t& memoryAddress, double
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new double value. */
@@ -1394,7 +2151,7 @@ bool MemoryUtilities::Internal::SetDouble(const uintptr_t& memoryAddress, double
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetDouble, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetDouble, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1419,7 +2176,7 @@ bool MemoryUtilities::Internal::PatchDouble(const uintptr_t& memoryAddress, doub
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new double value */
@@ -1427,7 +2184,7 @@ bool MemoryUtilities::Internal::PatchDouble(const uintptr_t& memoryAddress, doub
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetDouble, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetDouble, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1476,7 +2233,7 @@ bool MemoryUtilities::Internal::IndirectSetDouble(const uintptr_t& memoryAddress
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new double value. */
@@ -1484,7 +2241,7 @@ bool MemoryUtilities::Internal::IndirectSetDouble(const uintptr_t& memoryAddress
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetDouble, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetDouble, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1514,7 +2271,7 @@ bool MemoryUtilities::Internal::IndirectPatchDouble(const uintptr_t& memoryAddre
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new double value */
@@ -1522,7 +2279,7 @@ bool MemoryUtilities::Internal::IndirectPatchDouble(const uintptr_t& memoryAddre
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(targetDouble, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetDouble, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1564,6 +2321,45 @@ std::string MemoryUtilities::Internal::GetString(const uintptr_t& memoryAddress,
     return std::string(strPtr, strnlen_s(strPtr, maxLength));
 }
 
+bool MemoryUtilities::Internal::GetString(const void* memoryPtr, std::string& output)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return GetString(memoryAddress, output);
+}
+
+bool MemoryUtilities::Internal::GetString(const void* memoryPtr, std::string& output, size_t maxLength)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return GetString(memoryAddress, output, maxLength);
+}
+
+bool MemoryUtilities::Internal::GetString(const uintptr_t& memoryAddress, std::string& output)
+{
+    output.clear();
+
+    /* Verify that the address is valid. */
+    if (IsValidAddress(memoryAddress) == false)
+        return false;
+
+    /* Copy the string into 'output', reusing its capacity. */
+    output.assign(reinterpret_cast<const char*>(memoryAddress));
+    return true;
+}
+
+bool MemoryUtilities::Internal::GetString(const uintptr_t& memoryAddress, std::string& output, size_t maxLength)
+{
+    output.clear();
+
+    /* Verify that the address is valid. */
+    if (IsValidAddress(memoryAddress) == false)
+        return false;
+
+    /* Copy the string into 'output', reusing its capacity. */
+    const char* strPtr = reinterpret_cast<const char*>(memoryAddress);
+    output.assign(strPtr, strnlen_s(strPtr, maxLength));
+    return true;
+}
+
 bool MemoryUtilities::Internal::SetString(const void* memoryPtr, const std::string& newValue)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -1582,7 +2378,7 @@ bool MemoryUtilities::Internal::SetString(const uintptr_t& memoryAddress, const
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value. */
@@ -1590,7 +2386,7 @@ bool MemoryUtilities::Internal::SetString(const uintptr_t& memoryAddress, const
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetStr, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetStr, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1616,7 +2412,7 @@ bool MemoryUtilities::Internal::PatchString(const uintptr_t& memoryAddress, cons
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(reinterpret_cast<void*>(memoryAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(reinterpret_cast<void*>(memoryAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value */
@@ -1624,7 +2420,7 @@ bool MemoryUtilities::Internal::PatchString(const uintptr_t& memoryAddress, cons
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(reinterpret_cast<void*>(memoryAddress), byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(reinterpret_cast<void*>(memoryAddress), byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1699,7 +2495,7 @@ bool MemoryUtilities::Internal::IndirectSetString(const uintptr_t& memoryAddress
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value. */
@@ -1707,7 +2503,7 @@ bool MemoryUtilities::Internal::IndirectSetString(const uintptr_t& memoryAddress
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetStr, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetStr, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1738,7 +2534,7 @@ bool MemoryUtilities::Internal::IndirectPatchString(const uintptr_t& memoryAddre
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(reinterpret_cast<void*>(dataAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(reinterpret_cast<void*>(dataAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value */
@@ -1746,7 +2542,7 @@ bool MemoryUtilities::Internal::IndirectPatchString(const uintptr_t& memoryAddre
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(reinterpret_cast<void*>(dataAddress), byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(reinterpret_cast<void*>(dataAddress), byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1806,7 +2602,7 @@ bool MemoryUtilities::Internal::SetWString(const uintptr_t& memoryAddress, const
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value. */
@@ -1814,7 +2610,7 @@ bool MemoryUtilities::Internal::SetWString(const uintptr_t& memoryAddress, const
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetStr, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetStr, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1840,7 +2636,7 @@ bool MemoryUtilities::Internal::PatchWString(const uintptr_t& memoryAddress, con
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(reinterpret_cast<void*>(memoryAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(reinterpret_cast<void*>(memoryAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value */
@@ -1848,7 +2644,7 @@ bool MemoryUtilities::Internal::PatchWString(const uintptr_t& memoryAddress, con
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(reinterpret_cast<void*>(memoryAddress), byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(reinterpret_cast<void*>(memoryAddress), byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1920,7 +2716,7 @@ bool MemoryUtilities::Internal::IndirectSetWString(const uintptr_t& memoryAddres
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value. */
@@ -1928,7 +2724,7 @@ bool MemoryUtilities::Internal::IndirectSetWString(const uintptr_t& memoryAddres
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(targetStr, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(targetStr, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1959,7 +2755,7 @@ bool MemoryUtilities::Internal::IndirectPatchWString(const uintptr_t& memoryAddr
 
     /* Make the memory region writable */
     DWORD oldProtect;
-    if (VirtualProtect(reinterpret_cast<void*>(dataAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (ProtectLocalMemory(reinterpret_cast<void*>(dataAddress), byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new string value */
@@ -1967,7 +2763,7 @@ bool MemoryUtilities::Internal::IndirectPatchWString(const uintptr_t& memoryAddr
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtect(reinterpret_cast<void*>(dataAddress), byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(reinterpret_cast<void*>(dataAddress), byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -1993,6 +2789,23 @@ std::vector<uint8_t> MemoryUtilities::Internal::GetBytes(const uintptr_t& memory
     return buffer;
 }
 
+bool MemoryUtilities::Internal::GetBytes(const void* memoryPtr, void* buffer, size_t byteCount)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return GetBytes(memoryAddress, buffer, byteCount);
+}
+
+bool MemoryUtilities::Internal::GetBytes(const uintptr_t& memoryAddress, void* buffer, size_t byteCount)
+{
+    /* Verify that the address is valid. */
+    if (IsValidAddress(memoryAddress) == false || buffer == nullptr)
+        return false;
+
+    /* Read the bytes from the target address. */
+    memcpy(buffer, reinterpret_cast<void*>(memoryAddress), byteCount);
+    return true;
+}
+
 bool MemoryUtilities::Internal::SetBytes(const void* memoryPtr, const std::vector<uint8_t>& newBytes)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -2010,7 +2823,7 @@ bool MemoryUtilities::Internal::SetBytes(const uintptr_t& memoryAddress, const s
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (ProtectLocalMemory(target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes. */
@@ -2018,7 +2831,7 @@ bool MemoryUtilities::Internal::SetBytes(const uintptr_t& memoryAddress, const s
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(target, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(target, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -2051,7 +2864,7 @@ bool MemoryUtilities::Internal::PatchBytes(const uintptr_t& memoryAddress, const
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(target, toBytes.size(), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (ProtectLocalMemory(target, toBytes.size(), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes. */
@@ -2059,7 +2872,7 @@ bool MemoryUtilities::Internal::PatchBytes(const uintptr_t& memoryAddress, const
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(target, toBytes.size(), oldProtect, &tmp);
+    ProtectLocalMemory(target, toBytes.size(), oldProtect, &tmp);
 
     return true;
 }
@@ -2087,6 +2900,28 @@ std::vector<uint8_t> MemoryUtilities::Internal::IndirectGetBytes(const uintptr_t
     return buffer;
 }
 
+bool MemoryUtilities::Internal::IndirectGetBytes(const void* memoryPtr, void* buffer, size_t byteCount)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return IndirectGetBytes(memoryAddress, buffer, byteCount);
+}
+
+bool MemoryUtilities::Internal::IndirectGetBytes(const uintptr_t& memoryAddress, void* buffer, size_t byteCount)
+{
+    /* Verify that the address is valid. */
+    if (IsValidAddress(memoryAddress) == false || buffer == nullptr)
+        return false;
+
+    /* Read the data pointer from memoryAddress */
+    uintptr_t dataAddress = *reinterpret_cast<uintptr_t*>(memoryAddress);
+    if (IsValidAddress(dataAddress) == false)
+        return false;
+
+    /* Read the bytes from the target address. */
+    memcpy(buffer, reinterpret_cast<void*>(dataAddress), byteCount);
+    return true;
+}
+
 bool MemoryUtilities::Internal::IndirectSetBytes(const void* memoryPtr, const std::vector<uint8_t>& newBytes)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -2113,7 +2948,7 @@ bool MemoryUtilities::Internal::IndirectSetBytes(const uintptr_t& memoryAddress,
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (ProtectLocalMemory(target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes. */
@@ -2121,7 +2956,7 @@ bool MemoryUtilities::Internal::IndirectSetBytes(const uintptr_t& memoryAddress,
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(target, byteSize, oldProtect, &tmp);
+    ProtectLocalMemory(target, byteSize, oldProtect, &tmp);
 
     return true;
 }
@@ -2159,7 +2994,7 @@ bool MemoryUtilities::Internal::IndirectPatchBytes(const uintptr_t& memoryAddres
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtect(target, toBytes.size(), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (ProtectLocalMemory(target, toBytes.size(), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes. */
@@ -2167,7 +3002,7 @@ bool MemoryUtilities::Internal::IndirectPatchBytes(const uintptr_t& memoryAddres
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtect(target, toBytes.size(), oldProtect, &tmp);
+    ProtectLocalMemory(target, toBytes.size(), oldProtect, &tmp);
 
     return true;
 }
@@ -2180,41 +3015,163 @@ bool MemoryUtilities::Internal::IndirectPatchBytes(const uintptr_t& memoryAddres
 // ========================================================
 // |                      #EXTERNAL                       |
 // ========================================================
+#if CRANCHYLIB_INSTRUMENTATION
+/* Default backend functions with instrumentation. Custom backends are measured too as long as they forward to the default one. */
+static BOOL WINAPI InstrumentedReadProcessMemory(HANDLE hProcess, LPCVOID baseAddress, LPVOID buffer, SIZE_T size, SIZE_T* bytesRead)
+{
+    CRANCHYLIB_INSTRUMENT_SCOPE(MemoryUtilities::E_InstrumentedOperation::ExternalRead);
+    SIZE_T transferred = 0;
+    BOOL result = ReadProcessMemory(hProcess, baseAddress, buffer, size, &transferred);
+
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::ExternalReads, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::BytesRead, transferred);
+    if (result == FALSE)
+        CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::FailedCalls, 1);
+
+    if (bytesRead != nullptr)
+        *bytesRead = transferred;
+
+    return result;
+}
+
+static BOOL WINAPI InstrumentedWriteProcessMemory(HANDLE hProcess, LPVOID baseAddress, LPCVOID buffer, SIZE_T size, SIZE_T* bytesWritten)
+{
+    CRANCHYLIB_INSTRUMENT_SCOPE(MemoryUtilities::E_InstrumentedOperation::ExternalWrite);
+    SIZE_T transferred = 0;
+    BOOL result = WriteProcessMemory(hProcess, baseAddress, buffer, size, &transferred);
+
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::ExternalWrites, 1);
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::BytesWritten, transferred);
+    if (result == FALSE)
+        CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::FailedCalls, 1);
+
+    if (bytesWritten != nullptr)
+        *bytesWritten = transferred;
+
+    return result;
+}
+
+static BOOL WINAPI InstrumentedVirtualProtectEx(HANDLE hProcess, LPVOID address, SIZE_T size, DWORD newProtect, PDWORD oldProtect)
+{
+    CRANCHYLIB_INSTRUMENT_SCOPE(MemoryUtilities::E_InstrumentedOperation::ExternalProtect);
+    BOOL result = VirtualProtectEx(hProcess, address, size, newProtect, oldProtect);
+
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::ExternalProtectionChanges, 1);
+    if (result == FALSE)
+        CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::FailedCalls, 1);
+
+    return result;
+}
+
+static SIZE_T WINAPI InstrumentedVirtualQueryEx(HANDLE hProcess, LPCVOID address, PMEMORY_BASIC_INFORMATION buffer, SIZE_T length)
+{
+    CRANCHYLIB_INSTRUMENT_SCOPE(MemoryUtilities::E_InstrumentedOperation::ExternalQuery);
+    SIZE_T result = VirtualQueryEx(hProcess, address, buffer, length);
+
+    CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::ExternalQueries, 1);
+    if (result == 0)
+        CRANCHYLIB_INSTRUMENT_COUNT(MemoryUtilities::E_InstrumentationCounter::FailedCalls, 1);
+
+    return result;
+}
+#endif
+
+/* A function-local static rather than a global, so code running during another file's static initialization never sees the
+   table zeroed. The Win32 functions are dllimports, whose addresses aren't constant expressions. */
+static MemoryUtilities::External::Backend& GetActiveBackend()
+{
+    static MemoryUtilities::External::Backend activeBackend = MemoryUtilities::External::GetDefaultBackend();
+    return activeBackend;
+}
+
+/* Per-thread scratch memory for temporaries, like the current value a Patch* function compares against.
+   It only ever grows, so once warmed up those calls don't touch the heap. */
+static uint8_t* GetScratchBuffer(size_t byteCount)
+{
+    thread_local std::vector<uint8_t> scratch;
+    if (scratch.size() < byteCount)
+        scratch.resize(byteCount);
+
+    return scratch.data();
+}
+
+MemoryUtilities::External::Backend MemoryUtilities::External::GetDefaultBackend()
+{
+    Backend backend;
+#if CRANCHYLIB_INSTRUMENTATION
+    backend.ReadMemory = InstrumentedReadProcessMemory;
+    backend.WriteMemory = InstrumentedWriteProcessMemory;
+    backend.ProtectMemory = InstrumentedVirtualProtectEx;
+    backend.QueryMemory = InstrumentedVirtualQueryEx;
+#else
+    backend.ReadMemory = ReadProcessMemory;
+    backend.WriteMemory = WriteProcessMemory;
+    backend.ProtectMemory = VirtualProtectEx;
+    backend.QueryMemory = VirtualQueryEx;
+#endif
+
+    return backend;
+}
+
+const MemoryUtilities::External::Backend& MemoryUtilities::External::GetBackend()
+{
+    return GetActiveBackend();
+}
+
+bool MemoryUtilities::External::SetBackend(const Backend& backend)
+{
+    if (backend.ReadMemory == nullptr || backend.WriteMemory == nullptr || backend.ProtectMemory == nullptr || backend.QueryMemory == nullptr)
+        return false;
+
+    GetActiveBackend() = backend;
+    return true;
+}
+
 std::string MemoryUtilities::External::ReadRemoteString(const HANDLE& hProcess, const uintptr_t memoryAddress, size_t maxLength)
 {
+    std::string result;
+    result.reserve(std::min<size_t>(maxLength, 256));
+
+    ReadRemoteString(hProcess, memoryAddress, result, maxLength);
+    return result;
+}
+
+bool MemoryUtilities::External::ReadRemoteString(const HANDLE& hProcess, const uintptr_t memoryAddress, std::string& output, size_t maxLength)
+{
+    /* Keep the capacity, so a reused 'output' doesn't reallocate. */
+    output.clear();
+
     /* Verify that the address is valid. */
     if (IsValidAddress(hProcess, memoryAddress) == false || maxLength == 0)
-        return std::string();
+        return false;
 
     const size_t kChunk = 256; // number of char_t per chunk.
-    std::string result;
-    result.reserve(std::min<size_t>(maxLength, kChunk));
+    char buf[kChunk];
 
     uintptr_t cursor = memoryAddress;
     size_t remaining = maxLength;
-    std::vector<char> buf(kChunk);
 
     while (remaining > 0)
     {
         size_t toRead = std::min<size_t>(remaining, kChunk);
         SIZE_T bytesRead = 0;
 
-        if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(cursor),
-                               buf.data(), toRead, &bytesRead)
+        if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(cursor),
+                                           buf, toRead, &bytesRead)
             || bytesRead == 0)
             break; // Could not read further; return what we have.
 
         // Look for '\0' in the portion we actually read.
-        void* nulPos = std::memchr(buf.data(), '\0', bytesRead);
+        void* nulPos = std::memchr(buf, '\0', bytesRead);
         if (nulPos)
         {
-            const size_t chunkLen = static_cast<char*>(nulPos) - buf.data();
-            result.append(buf.data(), chunkLen);
-            return result;
+            const size_t chunkLen = static_cast<char*>(nulPos) - buf;
+            output.append(buf, chunkLen);
+            return true;
         }
 
         // No NUL; append all bytes read and continue until we hit maxLength.
-        result.append(buf.data(), static_cast<size_t>(bytesRead));
+        output.append(buf, static_cast<size_t>(bytesRead));
 
         cursor += bytesRead;
         remaining -= static_cast<size_t>(bytesRead);
@@ -2223,7 +3180,7 @@ std::string MemoryUtilities::External::ReadRemoteString(const HANDLE& hProcess,
             break; // Likely hit an unreadable boundary.
     }
 
-    return result; // May be exactly maxLength or shorter if we hit a boundary.
+    return cursor != memoryAddress; // May be exactly maxLength or shorter if we hit a boundary.
 }
 
 std::wstring MemoryUtilities::External::ReadRemoteWString(const HANDLE& hProcess, const uintptr_t memoryAddress, size_t maxLength /*= 256*/)
@@ -2238,7 +3195,7 @@ std::wstring MemoryUtilities::External::ReadRemoteWString(const HANDLE& hProcess
 
     uintptr_t cursor = memoryAddress;
     size_t remaining = maxLength;
-    std::vector<wchar_t> buf(kChunk);
+    wchar_t buf[kChunk];
 
     while (remaining > 0)
     {
@@ -2246,8 +3203,8 @@ std::wstring MemoryUtilities::External::ReadRemoteWString(const HANDLE& hProcess
         size_t toReadBytes = toReadChars * static_cast<size_t>(sizeof(wchar_t));
         SIZE_T bytesRead = 0;
 
-        if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(cursor),
-                               buf.data(), toReadBytes, &bytesRead)
+        if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(cursor),
+                                           buf, toReadBytes, &bytesRead)
             || bytesRead == 0)
             break; // Could not read further; return what we have.
 
@@ -2257,18 +3214,18 @@ std::wstring MemoryUtilities::External::ReadRemoteWString(const HANDLE& hProcess
             break; // Partial wchar_t or unreadable; stop.
 
         // Look for L'\0' in the portion we actually read.
-        auto begin = buf.begin();
-        auto end = buf.begin() + elemsRead;
+        auto begin = buf;
+        auto end = buf + elemsRead;
         auto nulIt = std::find(begin, end, L'\0');
         if (nulIt != end)
         {
             const size_t chunkLen = static_cast<size_t>(std::distance(begin, nulIt));
-            result.append(buf.data(), chunkLen);
+            result.append(buf, chunkLen);
             return result;
         }
 
         // No NUL; append all characters read and continue until we hit maxLength.
-        result.append(buf.data(), static_cast<size_t>(elemsRead));
+        result.append(buf, static_cast<size_t>(elemsRead));
 
         cursor += bytesRead;
         remaining -= static_cast<size_t>(elemsRead);
@@ -2298,7 +3255,7 @@ bool MemoryUtilities::External::IsValidProcessHandle(const HANDLE& hProcess, con
     if (requireQueryRights)
     {
         MEMORY_BASIC_INFORMATION mbi{};
-        if (VirtualQueryEx(hProcess, nullptr, &mbi, sizeof(mbi)) != sizeof(mbi))
+        if (GetActiveBackend().QueryMemory(hProcess, nullptr, &mbi, sizeof(mbi)) != sizeof(mbi))
             return false;
     }
 
@@ -2315,12 +3272,15 @@ bool MemoryUtilities::External::IsValidProcessHandle(const HANDLE& hProcess)
 
 bool MemoryUtilities::External::IsValidPtr(const HANDLE& hProcess, const void* memoryPtr)
 {
+    CRANCHYLIB_INSTRUMENT_SCOPE(E_InstrumentedOperation::Validation);
+    CRANCHYLIB_INSTRUMENT_COUNT(E_InstrumentationCounter::ValidationCalls, 1);
+
     if (!IsValidProcessHandle(hProcess)) // Process handle must be valid and suitable. Return False if it's not.
         return false;
 
     MEMORY_BASIC_INFORMATION mbi{};
 
-    if (VirtualQueryEx(hProcess, memoryPtr, &mbi, sizeof(mbi)) != sizeof(mbi)) // Try to request (query) information about the given memory region, return False if attempt fails.
+    if (GetActiveBackend().QueryMemory(hProcess, memoryPtr, &mbi, sizeof(mbi)) != sizeof(mbi)) // Try to request (query) information about the given memory region, return False if attempt fails.
         return false;
 
     if (mbi.State != MEM_COMMIT) // Memory region must be committed (actually backed by physical memory). Return False if it's not.
@@ -2399,6 +3359,8 @@ void* MemoryUtilities::External::PtrFollowPointerChain(const HANDLE& hProcess, c
 
 uintptr_t MemoryUtilities::External::AddressFollowPointerChain(const HANDLE& hProcess, const uintptr_t& memoryAddress, const std::vector<uintptr_t>& memoryOffsets)
 {
+    CRANCHYLIB_TRACE_SCOPE("pointer", "External::AddressFollowPointerChain", memoryOffsets.size());
+
     uintptr_t newMemoryAddress = memoryAddress;
     size_t offsetsCount = memoryOffsets.size();
 
@@ -2413,8 +3375,8 @@ uintptr_t MemoryUtilities::External::AddressFollowPointerChain(const HANDLE& hPr
         /* Read the next pointer value from memory and add the current offset to advance to the next address in the chain. */
         uintptr_t nextPtr = 0;
         SIZE_T bytesRead = 0;
-        if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(newMemoryAddress),
-                               &nextPtr, sizeof(nextPtr), &bytesRead) 
+        if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(newMemoryAddress),
+                                           &nextPtr, sizeof(nextPtr), &bytesRead)
             || bytesRead != sizeof(nextPtr))
             return 0x0;
 
@@ -2444,8 +3406,8 @@ bool MemoryUtilities::External::GetBool(const HANDLE& hProcess, const uintptr_t&
     /* Read and return the boolean value from the target address. */
     bool value = false;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return false;
 
@@ -2470,16 +3432,16 @@ bool MemoryUtilities::External::SetBool(const HANDLE& hProcess, const uintptr_t&
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetBool, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetBool, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetBool, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2499,8 +3461,8 @@ bool MemoryUtilities::External::PatchBool(const HANDLE& hProcess, const uintptr_
     /* Verify that the current value matches the expected one. */
     bool current = false;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -2512,16 +3474,16 @@ bool MemoryUtilities::External::PatchBool(const HANDLE& hProcess, const uintptr_
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetBool = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetBool, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetBool, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetBool, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2541,8 +3503,8 @@ bool MemoryUtilities::External::IndirectGetBool(const HANDLE& hProcess, const ui
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -2552,8 +3514,8 @@ bool MemoryUtilities::External::IndirectGetBool(const HANDLE& hProcess, const ui
     /* Read and return the boolean value from the target address. */
     bool value = false;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return false;
 
@@ -2575,8 +3537,8 @@ bool MemoryUtilities::External::IndirectSetBool(const HANDLE& hProcess, const ui
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -2589,16 +3551,16 @@ bool MemoryUtilities::External::IndirectSetBool(const HANDLE& hProcess, const ui
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetBool, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetBool, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetBool, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2618,8 +3580,8 @@ bool MemoryUtilities::External::IndirectPatchBool(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -2628,8 +3590,8 @@ bool MemoryUtilities::External::IndirectPatchBool(const HANDLE& hProcess, const
 
     /* Verify that the current value matches the expected one. */
     bool current = false;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-        &current, sizeof(current), &bytesRead) || bytesRead != sizeof(current))
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead) || bytesRead != sizeof(current))
         return false;
 
     if (current != from) // Only patch if the current value matches 'from'.
@@ -2640,16 +3602,16 @@ bool MemoryUtilities::External::IndirectPatchBool(const HANDLE& hProcess, const
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetBool = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new boolean value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetBool, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetBool, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetBool, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetBool, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2672,8 +3634,8 @@ int8_t MemoryUtilities::External::GetInt8(const HANDLE& hProcess, const uintptr_
     /* Read and return the 8-bit integer from the target address. */
     int8_t value = -1;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -2698,16 +3660,16 @@ bool MemoryUtilities::External::SetInt8(const HANDLE& hProcess, const uintptr_t&
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2727,8 +3689,8 @@ bool MemoryUtilities::External::PatchInt8(const HANDLE& hProcess, const uintptr_
     /* Verify that the current value matches the expected one. */
     int8_t current = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -2740,16 +3702,16 @@ bool MemoryUtilities::External::PatchInt8(const HANDLE& hProcess, const uintptr_
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2769,8 +3731,8 @@ int8_t MemoryUtilities::External::IndirectGetInt8(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) || bytesRead != sizeof(dataAddress))
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead) || bytesRead != sizeof(dataAddress))
         return -1;
 
     if (!IsValidAddress(hProcess, dataAddress))
@@ -2779,8 +3741,8 @@ int8_t MemoryUtilities::External::IndirectGetInt8(const HANDLE& hProcess, const
     /* Read and return the 8-bit integer from the target address. */
     int8_t value = -1;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -2802,8 +3764,8 @@ bool MemoryUtilities::External::IndirectSetInt8(const HANDLE& hProcess, const ui
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -2816,16 +3778,16 @@ bool MemoryUtilities::External::IndirectSetInt8(const HANDLE& hProcess, const ui
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2845,8 +3807,8 @@ bool MemoryUtilities::External::IndirectPatchInt8(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) 
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -2855,8 +3817,8 @@ bool MemoryUtilities::External::IndirectPatchInt8(const HANDLE& hProcess, const
 
     /* Verify that the current value matches the expected one. */
     int8_t current = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -2868,16 +3830,16 @@ bool MemoryUtilities::External::IndirectPatchInt8(const HANDLE& hProcess, const
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2900,8 +3862,8 @@ int16_t MemoryUtilities::External::GetInt16(const HANDLE& hProcess, const uintpt
     /* Read and return the 16-bit integer from the target address. */
     int16_t value = -1;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -2926,16 +3888,16 @@ bool MemoryUtilities::External::SetInt16(const HANDLE& hProcess, const uintptr_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2955,8 +3917,8 @@ bool MemoryUtilities::External::PatchInt16(const HANDLE& hProcess, const uintptr
     /* Verify that the current value matches the expected one. */
     int16_t current = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -2968,16 +3930,16 @@ bool MemoryUtilities::External::PatchInt16(const HANDLE& hProcess, const uintptr
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -2997,8 +3959,8 @@ int16_t MemoryUtilities::External::IndirectGetInt16(const HANDLE& hProcess, cons
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead) || bytesRead != sizeof(dataAddress))
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead) || bytesRead != sizeof(dataAddress))
         return -1;
 
     if (!IsValidAddress(hProcess, dataAddress))
@@ -3007,8 +3969,8 @@ int16_t MemoryUtilities::External::IndirectGetInt16(const HANDLE& hProcess, cons
     /* Read and return the 16-bit integer from the target address. */
     int16_t value = -1;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -3030,8 +3992,8 @@ bool MemoryUtilities::External::IndirectSetInt16(const HANDLE& hProcess, const u
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3044,16 +4006,16 @@ bool MemoryUtilities::External::IndirectSetInt16(const HANDLE& hProcess, const u
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3073,8 +4035,8 @@ bool MemoryUtilities::External::IndirectPatchInt16(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3083,8 +4045,8 @@ bool MemoryUtilities::External::IndirectPatchInt16(const HANDLE& hProcess, const
 
     /* Verify that the current value matches the expected one. */
     int16_t current = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3096,16 +4058,16 @@ bool MemoryUtilities::External::IndirectPatchInt16(const HANDLE& hProcess, const
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3128,8 +4090,8 @@ int32_t MemoryUtilities::External::GetInt32(const HANDLE& hProcess, const uintpt
     /* Read and return the 32-bit integer from the target address. */
     int32_t value = -1;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -3154,16 +4116,16 @@ bool MemoryUtilities::External::SetInt32(const HANDLE& hProcess, const uintptr_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3183,8 +4145,8 @@ bool MemoryUtilities::External::PatchInt32(const HANDLE& hProcess, const uintptr
     /* Verify that the current value matches the expected one. */
     int32_t current = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3196,16 +4158,16 @@ bool MemoryUtilities::External::PatchInt32(const HANDLE& hProcess, const uintptr
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3225,8 +4187,8 @@ int32_t MemoryUtilities::External::IndirectGetInt32(const HANDLE& hProcess, cons
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return -1;
 
@@ -3236,8 +4198,8 @@ int32_t MemoryUtilities::External::IndirectGetInt32(const HANDLE& hProcess, cons
     /* Read and return the 32-bit integer from the target address. */
     int32_t value = -1;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -3259,8 +4221,8 @@ bool MemoryUtilities::External::IndirectSetInt32(const HANDLE& hProcess, const u
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3273,16 +4235,16 @@ bool MemoryUtilities::External::IndirectSetInt32(const HANDLE& hProcess, const u
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3302,8 +4264,8 @@ bool MemoryUtilities::External::IndirectPatchInt32(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3312,8 +4274,8 @@ bool MemoryUtilities::External::IndirectPatchInt32(const HANDLE& hProcess, const
 
     /* Verify that the current value matches the expected one. */
     int32_t current = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3325,16 +4287,16 @@ bool MemoryUtilities::External::IndirectPatchInt32(const HANDLE& hProcess, const
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3357,8 +4319,8 @@ int64_t MemoryUtilities::External::GetInt64(const HANDLE& hProcess, const uintpt
     /* Read and return the 64-bit integer from the target address. */
     int64_t value = -1;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -3383,16 +4345,16 @@ bool MemoryUtilities::External::SetInt64(const HANDLE& hProcess, const uintptr_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3412,8 +4374,8 @@ bool MemoryUtilities::External::PatchInt64(const HANDLE& hProcess, const uintptr
     /* Verify that the current value matches the expected one. */
     int64_t current = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3425,16 +4387,16 @@ bool MemoryUtilities::External::PatchInt64(const HANDLE& hProcess, const uintptr
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3454,8 +4416,8 @@ int64_t MemoryUtilities::External::IndirectGetInt64(const HANDLE& hProcess, cons
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return -1;
 
@@ -3465,8 +4427,8 @@ int64_t MemoryUtilities::External::IndirectGetInt64(const HANDLE& hProcess, cons
     /* Read and return the 64-bit integer from the target address. */
     int64_t value = -1;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1;
 
@@ -3488,8 +4450,8 @@ bool MemoryUtilities::External::IndirectSetInt64(const HANDLE& hProcess, const u
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3502,16 +4464,16 @@ bool MemoryUtilities::External::IndirectSetInt64(const HANDLE& hProcess, const u
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new integer value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3531,8 +4493,8 @@ bool MemoryUtilities::External::IndirectPatchInt64(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3541,8 +4503,8 @@ bool MemoryUtilities::External::IndirectPatchInt64(const HANDLE& hProcess, const
 
     /* Verify that the current value matches the expected one. */
     int64_t current = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3554,16 +4516,16 @@ bool MemoryUtilities::External::IndirectPatchInt64(const HANDLE& hProcess, const
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetInt = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new integer value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetInt, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetInt, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetInt, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3586,8 +4548,8 @@ float MemoryUtilities::External::GetFloat(const HANDLE& hProcess, const uintptr_
     /* Read and return the 32-bit floating-point value from the target address. */
     float value = -1.0f;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1.0f;
 
@@ -3612,16 +4574,16 @@ bool MemoryUtilities::External::SetFloat(const HANDLE& hProcess, const uintptr_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new floating-point value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetFloat, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetFloat, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetFloat, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3641,8 +4603,8 @@ bool MemoryUtilities::External::PatchFloat(const HANDLE& hProcess, const uintptr
     /* Verify that the current value matches the expected one. */
     float current = 0.0f;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3654,16 +4616,16 @@ bool MemoryUtilities::External::PatchFloat(const HANDLE& hProcess, const uintptr
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetFloat = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new floating-point value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetFloat, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetFloat, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetFloat, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3683,8 +4645,8 @@ float MemoryUtilities::External::IndirectGetFloat(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return -1.0f;
 
@@ -3694,8 +4656,8 @@ float MemoryUtilities::External::IndirectGetFloat(const HANDLE& hProcess, const
     /* Read and return the 32-bit floating-point value from the target address. */
     float value = -1.0f;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1.0f;
 
@@ -3717,8 +4679,8 @@ bool MemoryUtilities::External::IndirectSetFloat(const HANDLE& hProcess, const u
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3731,16 +4693,16 @@ bool MemoryUtilities::External::IndirectSetFloat(const HANDLE& hProcess, const u
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new floating-point value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetFloat, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetFloat, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetFloat, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3760,8 +4722,8 @@ bool MemoryUtilities::External::IndirectPatchFloat(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3770,8 +4732,8 @@ bool MemoryUtilities::External::IndirectPatchFloat(const HANDLE& hProcess, const
 
     /* Verify that the current value matches the expected one. */
     float current = 0.0f;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3783,16 +4745,16 @@ bool MemoryUtilities::External::IndirectPatchFloat(const HANDLE& hProcess, const
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetFloat = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new floating-point value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetFloat, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetFloat, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetFloat, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetFloat, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3815,8 +4777,8 @@ double MemoryUtilities::External::GetDouble(const HANDLE& hProcess, const uintpt
     /* Read and return the 64-bit floating-point value from the target address. */
     double value = -1.0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1.0;
 
@@ -3841,16 +4803,16 @@ bool MemoryUtilities::External::SetDouble(const HANDLE& hProcess, const uintptr_
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new floating-point value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetDouble, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetDouble, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetDouble, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3870,8 +4832,8 @@ bool MemoryUtilities::External::PatchDouble(const HANDLE& hProcess, const uintpt
     /* Verify that the current value matches the expected one. */
     double current = 0.0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -3883,16 +4845,16 @@ bool MemoryUtilities::External::PatchDouble(const HANDLE& hProcess, const uintpt
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetDouble = reinterpret_cast<LPVOID>(memoryAddress);
-    if (VirtualProtectEx(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new floating-point value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetDouble, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetDouble, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetDouble, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3912,8 +4874,8 @@ double MemoryUtilities::External::IndirectGetDouble(const HANDLE& hProcess, cons
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return -1.0;
 
@@ -3923,8 +4885,8 @@ double MemoryUtilities::External::IndirectGetDouble(const HANDLE& hProcess, cons
     /* Read and return the 64-bit floating-point value from the target address. */
     double value = -1.0;
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &value, sizeof(value), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &value, sizeof(value), &bytesRead)
         || bytesRead != sizeof(value))
         return -1.0;
 
@@ -3946,8 +4908,8 @@ bool MemoryUtilities::External::IndirectSetDouble(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3960,16 +4922,16 @@ bool MemoryUtilities::External::IndirectSetDouble(const HANDLE& hProcess, const
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new floating-point value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetDouble, &newValue, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetDouble, &newValue, byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetDouble, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -3989,8 +4951,8 @@ bool MemoryUtilities::External::IndirectPatchDouble(const HANDLE& hProcess, cons
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -3999,8 +4961,8 @@ bool MemoryUtilities::External::IndirectPatchDouble(const HANDLE& hProcess, cons
 
     /* Verify that the current value matches the expected one. */
     double current = 0.0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           &current, sizeof(current), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       &current, sizeof(current), &bytesRead)
         || bytesRead != sizeof(current))
         return false;
 
@@ -4012,16 +4974,16 @@ bool MemoryUtilities::External::IndirectPatchDouble(const HANDLE& hProcess, cons
     /* Make the memory region writable */
     DWORD oldProtect;
     LPVOID targetDouble = reinterpret_cast<LPVOID>(dataAddress);
-    if (VirtualProtectEx(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == false)
         return false;
 
     /* Write the new floating-point value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetDouble, &to, byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetDouble, &to, byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetDouble, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetDouble, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4053,6 +5015,30 @@ std::string MemoryUtilities::External::GetString(const HANDLE& hProcess, const u
     return ReadRemoteString(hProcess, memoryAddress, maxLength);
 }
 
+bool MemoryUtilities::External::GetString(const HANDLE& hProcess, const void* memoryPtr, std::string& output)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return GetString(hProcess, memoryAddress, output);
+}
+
+bool MemoryUtilities::External::GetString(const HANDLE& hProcess, const void* memoryPtr, std::string& output, size_t maxLength)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return GetString(hProcess, memoryAddress, output, maxLength);
+}
+
+bool MemoryUtilities::External::GetString(const HANDLE& hProcess, const uintptr_t& memoryAddress, std::string& output)
+{
+    /* Verify that the address is valid and read a NUL-terminated string into 'output'. */
+    return ReadRemoteString(hProcess, memoryAddress, output, 256);
+}
+
+bool MemoryUtilities::External::GetString(const HANDLE& hProcess, const uintptr_t& memoryAddress, std::string& output, size_t maxLength)
+{
+    /* Verify that the address is valid and read up to maxLength (or until NUL) into 'output'. */
+    return ReadRemoteString(hProcess, memoryAddress, output, maxLength);
+}
+
 bool MemoryUtilities::External::SetString(const HANDLE& hProcess, const void* memoryPtr, const std::string& newValue)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -4071,16 +5057,16 @@ bool MemoryUtilities::External::SetString(const HANDLE& hProcess, const uintptr_
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new string value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetStr, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4098,14 +5084,14 @@ bool MemoryUtilities::External::PatchString(const HANDLE& hProcess, const uintpt
         return false;
 
     /* Verify that the current value matches the expected one. */
-    std::vector<char> current(from.size());
+    char* current = reinterpret_cast<char*>(GetScratchBuffer(from.size()));
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           current.data(), static_cast<size_t>(current.size()), &bytesRead)
-        || bytesRead != current.size())
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       current, static_cast<size_t>(from.size()), &bytesRead)
+        || bytesRead != from.size())
         return false;
 
-    if (std::memcmp(current.data(), from.c_str(), current.size()) != 0)
+    if (std::memcmp(current, from.c_str(), from.size()) != 0)
         return false;
 
     LPVOID target = reinterpret_cast<LPVOID>(memoryAddress);
@@ -4113,16 +5099,16 @@ bool MemoryUtilities::External::PatchString(const HANDLE& hProcess, const uintpt
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new string value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4148,8 +5134,8 @@ std::string MemoryUtilities::External::IndirectGetString(const HANDLE& hProcess,
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return std::string();
 
@@ -4169,8 +5155,8 @@ std::string MemoryUtilities::External::IndirectGetString(const HANDLE& hProcess,
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return std::string();
 
@@ -4196,8 +5182,8 @@ bool MemoryUtilities::External::IndirectSetString(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -4209,14 +5195,14 @@ bool MemoryUtilities::External::IndirectSetString(const HANDLE& hProcess, const
     size_t byteSize = static_cast<size_t>(newValue.size() + 1);
 
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
 
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetStr, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4236,8 +5222,8 @@ bool MemoryUtilities::External::IndirectPatchString(const HANDLE& hProcess, cons
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -4245,13 +5231,13 @@ bool MemoryUtilities::External::IndirectPatchString(const HANDLE& hProcess, cons
         return false;
 
     /* Verify that the current value matches the expected one (first 'from.size()' bytes). */
-    std::vector<char> current(from.size());
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           current.data(), static_cast<size_t>(current.size()), &bytesRead)
-        || bytesRead != current.size())
+    char* current = reinterpret_cast<char*>(GetScratchBuffer(from.size()));
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       current, static_cast<size_t>(from.size()), &bytesRead)
+        || bytesRead != from.size())
         return false;
 
-    if (std::memcmp(current.data(), from.c_str(), current.size()) != 0)
+    if (std::memcmp(current, from.c_str(), from.size()) != 0)
         return false;
 
     LPVOID target = reinterpret_cast<LPVOID>(dataAddress);
@@ -4259,16 +5245,16 @@ bool MemoryUtilities::External::IndirectPatchString(const HANDLE& hProcess, cons
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new string value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4318,16 +5304,16 @@ bool MemoryUtilities::External::SetWString(const HANDLE& hProcess, const uintptr
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new string value. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetStr, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4345,15 +5331,15 @@ bool MemoryUtilities::External::PatchWString(const HANDLE& hProcess, const uintp
         return false;
 
     /* Verify that the current value matches the expected one. */
-    std::vector<wchar_t> current(from.size());
+    wchar_t* current = reinterpret_cast<wchar_t*>(GetScratchBuffer(from.size() * sizeof(wchar_t)));
     SIZE_T bytesRead = 0;
-    size_t expectBytes = static_cast<size_t>(current.size() * sizeof(wchar_t));
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           current.data(), expectBytes, &bytesRead)
+    size_t expectBytes = static_cast<size_t>(from.size() * sizeof(wchar_t));
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       current, expectBytes, &bytesRead)
         || bytesRead != expectBytes)
         return false;
 
-    if (std::char_traits<wchar_t>::compare(current.data(), from.c_str(), current.size()) != 0)
+    if (std::char_traits<wchar_t>::compare(current, from.c_str(), from.size()) != 0)
         return false;
 
     LPVOID target = reinterpret_cast<LPVOID>(memoryAddress);
@@ -4361,16 +5347,16 @@ bool MemoryUtilities::External::PatchWString(const HANDLE& hProcess, const uintp
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new string value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4396,8 +5382,8 @@ std::wstring MemoryUtilities::External::IndirectGetWString(const HANDLE& hProces
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return std::wstring();
 
@@ -4417,8 +5403,8 @@ std::wstring MemoryUtilities::External::IndirectGetWString(const HANDLE& hProces
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return std::wstring();
 
@@ -4444,8 +5430,8 @@ bool MemoryUtilities::External::IndirectSetWString(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -4457,14 +5443,14 @@ bool MemoryUtilities::External::IndirectSetWString(const HANDLE& hProcess, const
     size_t byteSize = static_cast<size_t>((newValue.size() + 1) * sizeof(wchar_t));
 
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, targetStr, newValue.c_str(), byteSize, &bytesWritten);
 
     DWORD tmp;
-    VirtualProtectEx(hProcess, targetStr, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, targetStr, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4484,8 +5470,8 @@ bool MemoryUtilities::External::IndirectPatchWString(const HANDLE& hProcess, con
     /* Read the data pointer from memoryAddress. */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -4493,14 +5479,14 @@ bool MemoryUtilities::External::IndirectPatchWString(const HANDLE& hProcess, con
         return false;
 
     /* Verify that the current value matches the expected one (first 'from.size()' wchar_t). */
-    std::vector<wchar_t> current(from.size());
-    size_t expectBytes = static_cast<size_t>(current.size() * sizeof(wchar_t));
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           current.data(), expectBytes, &bytesRead)
+    wchar_t* current = reinterpret_cast<wchar_t*>(GetScratchBuffer(from.size() * sizeof(wchar_t)));
+    size_t expectBytes = static_cast<size_t>(from.size() * sizeof(wchar_t));
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       current, expectBytes, &bytesRead)
         || bytesRead != expectBytes)
         return false;
 
-    if (std::char_traits<wchar_t>::compare(current.data(), from.c_str(), current.size()) != 0)
+    if (std::char_traits<wchar_t>::compare(current, from.c_str(), from.size()) != 0)
         return false;
 
     LPVOID target = reinterpret_cast<LPVOID>(dataAddress);
@@ -4508,16 +5494,16 @@ bool MemoryUtilities::External::IndirectPatchWString(const HANDLE& hProcess, con
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new string value */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, to.c_str(), byteSize, &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4541,14 +5527,36 @@ std::vector<uint8_t> MemoryUtilities::External::GetBytes(const HANDLE& hProcess,
 
     /* Read and return the bytes from the target address. */
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           buffer.data(), buffer.size(), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       buffer.data(), buffer.size(), &bytesRead)
         || bytesRead != buffer.size())
         return {};
 
     return buffer;
 }
 
+bool MemoryUtilities::External::GetBytes(const HANDLE& hProcess, const void* memoryPtr, void* buffer, size_t byteCount)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return GetBytes(hProcess, memoryAddress, buffer, byteCount);
+}
+
+bool MemoryUtilities::External::GetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount)
+{
+    /* Verify that the address is valid. */
+    if (IsValidAddress(hProcess, memoryAddress) == false || buffer == nullptr || byteCount == 0)
+        return false;
+
+    /* Read the bytes from the target address. */
+    SIZE_T bytesRead = 0;
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       buffer, byteCount, &bytesRead)
+        || bytesRead != byteCount)
+        return false;
+
+    return true;
+}
+
 bool MemoryUtilities::External::SetBytes(const HANDLE& hProcess, const void* memoryPtr, const std::vector<uint8_t>& newBytes)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -4566,16 +5574,16 @@ bool MemoryUtilities::External::SetBytes(const HANDLE& hProcess, const uintptr_t
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, newBytes.data(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, newBytes.data(), byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4598,34 +5606,185 @@ bool MemoryUtilities::External::PatchBytes(const HANDLE& hProcess, const uintptr
         return false;
 
     /* Verify that the current bytes match the expected ones. */
-    std::vector<uint8_t> current(fromBytes.size());
+    uint8_t* current = GetScratchBuffer(fromBytes.size());
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           current.data(), current.size(), &bytesRead)
-        || bytesRead != current.size())
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       current, fromBytes.size(), &bytesRead)
+        || bytesRead != fromBytes.size())
         return false;
 
-    if (!std::equal(current.begin(), current.end(), fromBytes.begin())) // Only patch if the current bytes match 'fromBytes'.
+    if (std::memcmp(current, fromBytes.data(), fromBytes.size()) != 0) // Only patch if the current bytes match 'fromBytes'.
         return false;
 
     /* Make the memory region writable */
     LPVOID target = reinterpret_cast<LPVOID>(memoryAddress);
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, static_cast<size_t>(toBytes.size()), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, static_cast<size_t>(toBytes.size()), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, toBytes.data(),
-        static_cast<size_t>(toBytes.size()), &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, toBytes.data(),
+                                             static_cast<size_t>(toBytes.size()), &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, static_cast<size_t>(toBytes.size()), oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, static_cast<size_t>(toBytes.size()), oldProtect, &tmp);
 
     return ok && bytesWritten == toBytes.size();
 }
 
+
+
+
+size_t MemoryUtilities::External::GetBytesBatch(const HANDLE& hProcess, std::vector<BatchRead>& reads, size_t maxGap)
+{
+    BatchScratch scratch;
+    return GetBytesBatch(hProcess, reads, scratch, maxGap);
+}
+
+size_t MemoryUtilities::External::GetBytesBatch(const HANDLE& hProcess, std::vector<BatchRead>& reads, BatchScratch& scratch, size_t maxGap)
+{
+    const size_t kMaxSpanSize = 0x10000; // Never coalesce more than 64 KiB into one read.
+    size_t succeededCount = 0;
+
+    for (BatchRead& read : reads)
+        read.succeeded = false;
+
+    if (reads.empty() || IsValidProcessHandle(hProcess) == false)
+        return 0;
+
+    /* Visit entries in address order without reordering the caller's vector. */
+    std::vector<size_t>& order = scratch.readOrder;
+    order.resize(reads.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&reads](size_t a, size_t b) { return reads[a].memoryAddress < reads[b].memoryAddress; });
+
+    std::vector<uint8_t>& spanBuffer = scratch.spanBuffer;
+    size_t first = 0;
+    while (first < order.size())
+    {
+        /* Grow the span while the next entry starts within 'maxGap' bytes of the current span end. */
+        const uintptr_t spanStart = reads[order[first]].memoryAddress;
+        uintptr_t spanEnd = spanStart + reads[order[first]].byteCount;
+        size_t last = first + 1;
+        while (last < order.size())
+        {
+            const BatchRead& next = reads[order[last]];
+            const uintptr_t nextEnd = std::max<uintptr_t>(spanEnd, next.memoryAddress + next.byteCount);
+            if (next.memoryAddress > spanEnd + maxGap || nextEnd - spanStart > kMaxSpanSize)
+                break;
+
+            spanEnd = nextEnd;
+            ++last;
+        }
+
+        /* One read for the whole span, then scatter the bytes back to every entry. */
+        const size_t spanSize = static_cast<size_t>(spanEnd - spanStart);
+        spanBuffer.resize(spanSize);
+        SIZE_T bytesRead = 0;
+        bool spanRead = spanSize != 0
+                        && GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(spanStart),
+                                                         spanBuffer.data(), spanSize, &bytesRead)
+                        && bytesRead == spanSize;
+
+        for (size_t i = first; i < last; ++i)
+        {
+            BatchRead& read = reads[order[i]];
+            if (read.byteCount == 0 || read.buffer == nullptr)
+                continue;
+
+            if (spanRead)
+            {
+                std::memcpy(read.buffer, spanBuffer.data() + (read.memoryAddress - spanStart), read.byteCount);
+                read.succeeded = true;
+            }
+            else // Part of the span is unreadable, fall back to reading this entry on its own.
+            {
+                bytesRead = 0;
+                read.succeeded = GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(read.memoryAddress),
+                                                               read.buffer, read.byteCount, &bytesRead)
+                                 && bytesRead == read.byteCount;
+            }
+
+            if (read.succeeded)
+                ++succeededCount;
+        }
+
+        first = last;
+    }
+
+    return succeededCount;
+}
+
+size_t MemoryUtilities::External::AddressFollowPointerChainBatch(const HANDLE& hProcess, std::vector<BatchPointerChain>& chains)
+{
+    BatchScratch scratch;
+    return AddressFollowPointerChainBatch(hProcess, chains, scratch);
+}
+
+size_t MemoryUtilities::External::AddressFollowPointerChainBatch(const HANDLE& hProcess, std::vector<BatchPointerChain>& chains, BatchScratch& scratch)
+{
+    CRANCHYLIB_TRACE_SCOPE("pointer", "External::AddressFollowPointerChainBatch", chains.size());
+
+    size_t maxChainLength = 0;
+    for (BatchPointerChain& chain : chains)
+    {
+        chain.resolvedAddress = chain.memoryAddress;
+        chain.succeeded = true;
+        if (chain.memoryOffsets != nullptr)
+            maxChainLength = std::max<size_t>(maxChainLength, chain.memoryOffsets->size());
+    }
+
+    /* 'readOrder' and 'spanBuffer' belong to GetBytesBatch below, the chain walk only uses the other members. */
+    std::vector<BatchRead>& reads = scratch.chainReads;
+    std::vector<uintptr_t>& pointerValues = scratch.pointerValues;
+    std::vector<size_t>& readChains = scratch.readChains;
+    pointerValues.resize(chains.size());
+
+    for (size_t level = 0; level < maxChainLength; ++level)
+    {
+        /* Gather the pointer of this level for every chain that is still alive and long enough. */
+        reads.clear();
+        readChains.clear();
+        for (size_t i = 0; i < chains.size(); ++i)
+        {
+            const BatchPointerChain& chain = chains[i];
+            if (chain.succeeded == false || chain.memoryOffsets == nullptr || level >= chain.memoryOffsets->size())
+                continue;
+
+            BatchRead read;
+            read.memoryAddress = chain.resolvedAddress;
+            read.byteCount = sizeof(uintptr_t);
+            read.buffer = &pointerValues[i];
+            reads.push_back(read);
+            readChains.push_back(i);
+        }
+
+        GetBytesBatch(hProcess, reads, scratch);
+
+        /* Read the next pointer value and add the current offset to advance to the next address in the chain. */
+        for (size_t r = 0; r < reads.size(); ++r)
+        {
+            BatchPointerChain& chain = chains[readChains[r]];
+            if (reads[r].succeeded == false)
+                chain.succeeded = false;
+            else
+                chain.resolvedAddress = pointerValues[readChains[r]] + (*chain.memoryOffsets)[level];
+        }
+    }
+
+    size_t succeededCount = 0;
+    for (const BatchPointerChain& chain : chains)
+    {
+        if (chain.succeeded)
+            ++succeededCount;
+    }
+
+    return succeededCount;
+}
+
 std::vector<uint8_t> MemoryUtilities::External::IndirectGetBytes(const HANDLE& hProcess, const void* memoryPtr, size_t byteCount)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -4641,8 +5800,8 @@ std::vector<uint8_t> MemoryUtilities::External::IndirectGetBytes(const HANDLE& h
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return {};
 
@@ -4653,14 +5812,47 @@ std::vector<uint8_t> MemoryUtilities::External::IndirectGetBytes(const HANDLE& h
 
     /* Read and return the bytes from the target address. */
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           buffer.data(), buffer.size(), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       buffer.data(), buffer.size(), &bytesRead)
         || bytesRead != buffer.size())
         return {};
 
     return buffer;
 }
 
+bool MemoryUtilities::External::IndirectGetBytes(const HANDLE& hProcess, const void* memoryPtr, void* buffer, size_t byteCount)
+{
+    uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
+    return IndirectGetBytes(hProcess, memoryAddress, buffer, byteCount);
+}
+
+bool MemoryUtilities::External::IndirectGetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount)
+{
+    /* Verify that the address is valid. */
+    if (IsValidAddress(hProcess, memoryAddress) == false || buffer == nullptr || byteCount == 0)
+        return false;
+
+    /* Read the data pointer from memoryAddress */
+    uintptr_t dataAddress = 0;
+    SIZE_T bytesRead = 0;
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
+        || bytesRead != sizeof(dataAddress))
+        return false;
+
+    if (IsValidAddress(hProcess, dataAddress) == false)
+        return false;
+
+    /* Read the bytes from the target address. */
+    bytesRead = 0;
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       buffer, byteCount, &bytesRead)
+        || bytesRead != byteCount)
+        return false;
+
+    return true;
+}
+
 bool MemoryUtilities::External::IndirectSetBytes(const HANDLE& hProcess, const void* memoryPtr, const std::vector<uint8_t>& newBytes)
 {
     uintptr_t memoryAddress = reinterpret_cast<uintptr_t>(memoryPtr);
@@ -4676,8 +5868,8 @@ bool MemoryUtilities::External::IndirectSetBytes(const HANDLE& hProcess, const u
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -4689,16 +5881,16 @@ bool MemoryUtilities::External::IndirectSetBytes(const HANDLE& hProcess, const u
 
     /* Make the memory region writable. */
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, byteSize, PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes. */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, newBytes.data(), byteSize, &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, newBytes.data(), byteSize, &bytesWritten);
 
     /* Restore the original protection. */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, byteSize, oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, byteSize, oldProtect, &tmp);
 
     return ok && bytesWritten == byteSize;
 }
@@ -4720,8 +5912,8 @@ bool MemoryUtilities::External::IndirectPatchBytes(const HANDLE& hProcess, const
     /* Read the data pointer from memoryAddress */
     uintptr_t dataAddress = 0;
     SIZE_T bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
-                           &dataAddress, sizeof(dataAddress), &bytesRead)
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(memoryAddress),
+                                       &dataAddress, sizeof(dataAddress), &bytesRead)
         || bytesRead != sizeof(dataAddress))
         return false;
 
@@ -4733,30 +5925,30 @@ bool MemoryUtilities::External::IndirectPatchBytes(const HANDLE& hProcess, const
         return false;
 
     /* Verify that the current bytes match the expected ones. */
-    std::vector<uint8_t> current(fromBytes.size());
+    uint8_t* current = GetScratchBuffer(fromBytes.size());
     bytesRead = 0;
-    if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
-                           current.data(), current.size(), &bytesRead)
-        || bytesRead != current.size())
+    if (!GetActiveBackend().ReadMemory(hProcess, reinterpret_cast<LPCVOID>(dataAddress),
+                                       current, fromBytes.size(), &bytesRead)
+        || bytesRead != fromBytes.size())
         return false;
 
-    if (!std::equal(current.begin(), current.end(), fromBytes.begin())) // Only patch if the current bytes match 'fromBytes'.
+    if (std::memcmp(current, fromBytes.data(), fromBytes.size()) != 0) // Only patch if the current bytes match 'fromBytes'.
         return false;
 
     /* Make the memory region writable */
     LPVOID target = reinterpret_cast<LPVOID>(dataAddress);
     DWORD oldProtect;
-    if (VirtualProtectEx(hProcess, target, static_cast<size_t>(toBytes.size()), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
+    if (GetActiveBackend().ProtectMemory(hProcess, target, static_cast<size_t>(toBytes.size()), PAGE_EXECUTE_READWRITE, &oldProtect) == FALSE)
         return false;
 
     /* Write the new bytes */
     SIZE_T bytesWritten = 0;
-    BOOL ok = WriteProcessMemory(hProcess, target, toBytes.data(),
-        static_cast<size_t>(toBytes.size()), &bytesWritten);
+    BOOL ok = GetActiveBackend().WriteMemory(hProcess, target, toBytes.data(),
+                                             static_cast<size_t>(toBytes.size()), &bytesWritten);
 
     /* Restore the original protection */
     DWORD tmp;
-    VirtualProtectEx(hProcess, target, static_cast<size_t>(toBytes.size()), oldProtect, &tmp);
+    GetActiveBackend().ProtectMemory(hProcess, target, static_cast<size_t>(toBytes.size()), oldProtect, &tmp);
 
     return ok && bytesWritten == toBytes.size();
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 #include <optional>
+#include <memory_resource>
 #include <Psapi.h>
 
 
@@ -12,6 +16,21 @@
 
 namespace MemoryUtilities
 {
+	/**
+	* @brief Pattern whose bytes each carry a mask: a memory byte 'b' matches position i when (b & masks[i]) == values[i].
+	*        0xFF is an exact byte, 0x00 a wildcard, 0xF0 / 0x0F keep one nibble. Values are stored already masked.
+	*/
+	struct MaskedPattern
+	{
+		std::vector<uint8_t> values;
+		std::vector<uint8_t> masks;
+	};
+
+
+
+
+
+
 	class Convertion
 	{
 	public:
@@ -33,8 +52,108 @@ namespace MemoryUtilities
 		* @brief Converts a hexadecimal string to vector of bytes.  
 		* @param memoryPattern - A string mask of hexadecimal byte values (with wildcards). 
 		* @return A vector of optional<uint8_t>, where wildcards ("??") are represented by std::nullopt. Any parsing error results in an empty vector.
+		*         Nibble wildcards and masks can't be expressed this way and count as errors, see MemoryPattern_ToMaskedPattern.
 		*/
 		static std::vector<std::optional<uint8_t>> MemoryPattern_ToBytesPattern(const std::string& memoryPattern);
+		/**
+		* @brief Converts a hexadecimal string to a masked pattern. Besides "48" and "??" it understands nibble wildcards ("4?", "?B")
+		*        and masks narrowing the preceding byte, attached or as a token of their own ("8B/F0", "48 8B /F0").
+		* @param memoryPattern - A string mask of hexadecimal byte values (with wildcards and masks).
+		* @return The pattern; any parsing error results in an empty one.
+		*/
+		static MaskedPattern MemoryPattern_ToMaskedPattern(const std::string& memoryPattern);
+		static MaskedPattern BytesPattern_ToMaskedPattern(const std::vector<std::optional<uint8_t>>& bytesPattern);
+		/**
+		* @brief Formats a masked pattern as text MemoryPattern_ToMaskedPattern reads back: "48 8B ?? 4? 8B/F0".
+		*/
+		static std::string MaskedPattern_ToMemoryPattern(const MaskedPattern& maskedPattern);
+
+
+		/**
+		* @brief Computes a fast, non-cryptographic 64-bit hash of a memory block (SSE2 accelerated on x86/x64).
+		* @param data - Pointer to the first byte of the block.
+		* @param size - Number of bytes to hash.
+		* @return 64-bit hash value. Scalar and SIMD code paths produce identical values for identical input.
+		*/
+		static uint64_t Bytes_ToHash64(const void* data, size_t size);
+	};
+
+
+
+
+
+
+	enum class E_ScanStatus
+	{
+		Completed,		 // Ran to the end, or a first-match scan found its match.
+		Cancelled,		 // Stopped by ScanOptions::cancellationToken.
+		DeadlineExceeded // Stopped by ScanOptions::deadline.
+	};
+
+
+	/**
+	* @brief Cooperative stop flag, set by one thread and polled by the scan running on another.
+	*/
+	class CancellationToken
+	{
+	public:
+		void Cancel() { cancelled.store(true, std::memory_order_relaxed); }
+		void Reset() { cancelled.store(false, std::memory_order_relaxed); }
+		bool IsCancellationRequested() const { return cancelled.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<bool> cancelled{ false };
+	};
+
+
+	/**
+	* @brief Progress of a running scan or sweep, see ScanOptions::progressCallback.
+	* @param bytesProcessed - Bytes scanned or captured so far.
+	* @param bytesTotal - Bytes the whole operation covers.
+	* @param regionsDone - Regions finished so far.
+	* @param regionsTotal - Regions the whole operation covers.
+	*/
+	struct ScanProgress
+	{
+		uint64_t bytesProcessed = 0;
+		uint64_t bytesTotal		= 0;
+		size_t	 regionsDone	= 0;
+		size_t	 regionsTotal	= 0;
+	};
+
+
+	/**
+	* @brief Limits for long scans and sweeps. They are checked between chunks of 'chunkSize' bytes, so a cancellation
+	*        or an expired deadline stops the operation within a millisecond or so; whatever was found until then is kept.
+	* @param cancellationToken - Token to poll; nullptr if the operation can't be cancelled.
+	* @param deadline - Point in time at which the operation gives up; time_point::max() for none.
+	* @param progressCallback - Called on the scanning thread after every chunk; may be empty.
+	* @param chunkSize - Bytes processed between two checks.
+	*/
+	struct ScanOptions
+	{
+		const CancellationToken*				 cancellationToken = nullptr;
+		std::chrono::steady_clock::time_point	 deadline		   = (std::chrono::steady_clock::time_point::max)();
+		std::function<void(const ScanProgress&)> progressCallback;
+		size_t									 chunkSize		   = 256 * 1024;
+
+		/**
+		* @brief Reports 'progress', then checks the cancellation token and the deadline. Called by the scans between chunks.
+		* @return false if the operation must stop; 'status' then says why.
+		*/
+		bool Continue(const ScanProgress& progress, E_ScanStatus& status) const;
+	};
+
+
+	/**
+	* @brief Result of a fuzzy pattern scan.
+	* @param address - Where the pattern starts.
+	* @param mismatches - Number of concrete pattern bytes that differ from memory there; wildcards never count.
+	*/
+	struct FuzzyMatch
+	{
+		uintptr_t address	 = 0x0;
+		size_t	  mismatches = 0;
 	};
 
 
@@ -120,6 +239,51 @@ namespace MemoryUtilities
 		* @brief [EXPERIMENTAL] Function wasn't properly tested just yet and is more of an theoretical idea.
 		*/
 		static uintptr_t ScanForMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern);
+		/**
+		* @brief Finds the first match of a masked pattern, e.g. one with nibble wildcards. Candidates are found and verified
+		*        16 bytes at a time with the mask applied (SSE2), so masks cost the same as plain bytes.
+		* @return Address of the first match, or 0x0.
+		*/
+		static uintptr_t ScanForMaskedPattern(const uint8_t* startingAddress, size_t size, const MaskedPattern& maskedPattern);
+		/**
+		* @brief Same as above, but cancellable, bounded by a deadline and reporting progress (see ScanOptions).
+		* @param match - Receives the address of the first match, or 0x0 if none was found before the scan ended or stopped.
+		*/
+		static E_ScanStatus ScanForBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+												const ScanOptions& options, uintptr_t& match);
+
+		/**
+		* @brief Finds every match of 'bytesPattern' inside the region, overlapping ones included.
+		* @param matches - Receives the match addresses in ascending order. Backing it with a MemoryArena keeps millions of results
+		*                  out of the general heap and lets the next scan reuse the same memory.
+		* @return Number of matches appended to 'matches'.
+		*/
+		static size_t	 ScanForAllBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern, std::pmr::vector<uintptr_t>& matches);
+		static size_t	 ScanForAllMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern, std::pmr::vector<uintptr_t>& matches);
+		static size_t	 ScanForAllMaskedPattern(const uint8_t* startingAddress, size_t size, const MaskedPattern& maskedPattern, std::pmr::vector<uintptr_t>& matches);
+		/**
+		* @brief Same as above, but cancellable, bounded by a deadline and reporting progress (see ScanOptions).
+		*        Matches found before the scan stopped stay in 'matches'.
+		*/
+		static E_ScanStatus ScanForAllBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+												   std::pmr::vector<uintptr_t>& matches, const ScanOptions& options);
+
+		/**
+		* @brief Finds every place where 'bytesPattern' matches with at most 'maxMismatches' differing bytes, for signatures that broke
+		*        because an instruction or two changed. Uses a bit-parallel Shift-Add filter, so the cost barely depends on 'maxMismatches'.
+		* @param maxMismatches - Highest number of mismatched concrete bytes a match may have; 0 behaves like an exact scan.
+		* @param maxResults - Keep only the best this many matches; 0 keeps all of them.
+		* @return Matches ranked by mismatch count, then by address.
+		*/
+		static std::vector<FuzzyMatch> FuzzyScanForBytesPattern(const uint8_t* startingAddress, size_t size, const std::vector<std::optional<uint8_t>>& bytesPattern,
+																size_t maxMismatches, size_t maxResults = 0);
+		static std::vector<FuzzyMatch> FuzzyScanForMemoryPattern(const uint8_t* startingAddress, size_t size, const std::string& memoryPattern,
+																 size_t maxMismatches, size_t maxResults = 0);
+		/**
+		* @brief Same as above for a masked pattern; a byte mismatches when it differs in the bits its mask keeps.
+		*/
+		static std::vector<FuzzyMatch> FuzzyScanForMaskedPattern(const uint8_t* startingAddress, size_t size, const MaskedPattern& maskedPattern,
+																 size_t maxMismatches, size_t maxResults = 0);
 
 
 		/**
@@ -130,6 +294,16 @@ namespace MemoryUtilities
 		* @brief [EXPERIMENTAL] Function wasn't properly tested just yet and is more of an theoretical idea.
 		*/
 		static uintptr_t SearchForMemoryPattern(const std::string& memoryPattern);
+		/**
+		* @brief Scans the main module image like SearchForBytesPattern, but cancellable, bounded by a deadline and reporting progress.
+		* @param match - Receives the address of the first match, or 0x0.
+		*/
+		static E_ScanStatus SearchForBytesPattern(const std::vector<std::optional<uint8_t>>& bytesPattern, const ScanOptions& options, uintptr_t& match);
+		/**
+		* @brief Fuzzy scan (see FuzzyScanForBytesPattern) over the main module image.
+		*/
+		static std::vector<FuzzyMatch> FuzzySearchForBytesPattern(const std::vector<std::optional<uint8_t>>& bytesPattern, size_t maxMismatches, size_t maxResults = 0);
+		static std::vector<FuzzyMatch> FuzzySearchForMemoryPattern(const std::string& memoryPattern, size_t maxMismatches, size_t maxResults = 0);
 
 
 
@@ -307,6 +481,11 @@ namespace MemoryUtilities
 		static std::string GetString(const void* memoryPtr, size_t maxLength);
 		static std::string GetString(const uintptr_t& memoryAddress);
 		static std::string GetString(const uintptr_t& memoryAddress, size_t maxLength);
+		/* Same, but into a caller-owned string whose capacity is reused, so polling loops don't allocate. */
+		static bool		   GetString(const void* memoryPtr, std::string& output);
+		static bool		   GetString(const void* memoryPtr, std::string& output, size_t maxLength);
+		static bool		   GetString(const uintptr_t& memoryAddress, std::string& output);
+		static bool		   GetString(const uintptr_t& memoryAddress, std::string& output, size_t maxLength);
 
 		static bool		   SetString(const void* memoryPtr, const std::string& newValue);
 		static bool		   SetString(const uintptr_t& memoryAddress, const std::string& newValue);
@@ -359,6 +538,9 @@ namespace MemoryUtilities
 		/* For when 'memoryAddress' contains the actual value. */
 		static std::vector<uint8_t> GetBytes(const void* memoryPtr, size_t byteCount);
 		static std::vector<uint8_t> GetBytes(const uintptr_t& memoryAddress, size_t byteCount);
+		/* Same, but into caller-owned memory of at least 'byteCount' bytes, so polling loops don't allocate. */
+		static bool					GetBytes(const void* memoryPtr, void* buffer, size_t byteCount);
+		static bool					GetBytes(const uintptr_t& memoryAddress, void* buffer, size_t byteCount);
 
 		static bool					SetBytes(const void* memoryPtr, const std::vector<uint8_t>& newBytes);
 		static bool					SetBytes(const uintptr_t& memoryAddress, const std::vector<uint8_t>& newBytes);
@@ -370,6 +552,8 @@ namespace MemoryUtilities
 		/* For when 'memoryAddress' contains the address that leads to the value. */
 		static std::vector<uint8_t> IndirectGetBytes(const void* memoryPtr, size_t byteCount);
 		static std::vector<uint8_t> IndirectGetBytes(const uintptr_t& memoryAddress, size_t byteCount);
+		static bool					IndirectGetBytes(const void* memoryPtr, void* buffer, size_t byteCount);
+		static bool					IndirectGetBytes(const uintptr_t& memoryAddress, void* buffer, size_t byteCount);
 
 		static bool					IndirectSetBytes(const void* memoryPtr, const std::vector<uint8_t>& newBytes);
 		static bool					IndirectSetBytes(const uintptr_t& memoryAddress, const std::vector<uint8_t>& newBytes);
@@ -389,12 +573,41 @@ namespace MemoryUtilities
 		// Search Tags: #external, #exe, #pid, #process, #readprocessmemory, #writeprocessmemory, #handle.
 	private:
 		static std::string ReadRemoteString(const HANDLE& hProcess, const uintptr_t memoryAddress, size_t maxLength = 256);
+		static bool ReadRemoteString(const HANDLE& hProcess, const uintptr_t memoryAddress, std::string& output, size_t maxLength);
 		static std::wstring ReadRemoteWString(const HANDLE& hProcess, const uintptr_t memoryAddress, size_t maxLength = 256);
 
 
 
 
 	public:
+		/**
+		* @brief OS primitives every External function goes through. Signatures match the Win32 functions they stand in for,
+		*        so the default backend is simply ReadProcessMemory, WriteProcessMemory, VirtualProtectEx and VirtualQueryEx.
+		*        A custom backend can count or trace calls, or serve reads from another source (shared memory, a dump file, a remote agent).
+		*/
+		struct Backend
+		{
+			BOOL   (WINAPI* ReadMemory)(HANDLE hProcess, LPCVOID baseAddress, LPVOID buffer, SIZE_T size, SIZE_T* bytesRead);
+			BOOL   (WINAPI* WriteMemory)(HANDLE hProcess, LPVOID baseAddress, LPCVOID buffer, SIZE_T size, SIZE_T* bytesWritten);
+			BOOL   (WINAPI* ProtectMemory)(HANDLE hProcess, LPVOID address, SIZE_T size, DWORD newProtect, PDWORD oldProtect);
+			SIZE_T (WINAPI* QueryMemory)(HANDLE hProcess, LPCVOID address, PMEMORY_BASIC_INFORMATION buffer, SIZE_T length);
+		};
+
+		/**
+		* @return Backend made of the Win32 functions; with CRANCHYLIB_INSTRUMENTATION they're wrapped to record counters and latencies.
+		*/
+		static Backend GetDefaultBackend();
+		/**
+		* @return Backend currently used by External (and by the engines built on top of it).
+		*/
+		static const Backend& GetBackend();
+		/**
+		* @brief Replaces the backend. Calls already in flight aren't synchronized with the swap, so install it before other threads use External.
+		* @return true if the backend was installed; false if any of its functions is null.
+		*/
+		static bool SetBackend(const Backend& backend);
+
+
 		/**
 		* @brief Determines whether a given process HANDLE is valid and suitable for memory queries.
 		* @param hProcess - Process HANDLE to check.
@@ -657,6 +870,11 @@ namespace MemoryUtilities
 		static std::string GetString(const HANDLE& hProcess, const void* memoryPtr, size_t maxLength);
 		static std::string GetString(const HANDLE& hProcess, const uintptr_t& memoryAddress);
 		static std::string GetString(const HANDLE& hProcess, const uintptr_t& memoryAddress, size_t maxLength);
+		/* Same, but into a caller-owned string whose capacity is reused, so polling loops don't allocate. */
+		static bool		   GetString(const HANDLE& hProcess, const void* memoryPtr, std::string& output);
+		static bool		   GetString(const HANDLE& hProcess, const void* memoryPtr, std::string& output, size_t maxLength);
+		static bool		   GetString(const HANDLE& hProcess, const uintptr_t& memoryAddress, std::string& output);
+		static bool		   GetString(const HANDLE& hProcess, const uintptr_t& memoryAddress, std::string& output, size_t maxLength);
 
 		static bool		   SetString(const HANDLE& hProcess, const void* memoryPtr, const std::string& newValue);
 		static bool		   SetString(const HANDLE& hProcess, const uintptr_t& memoryAddress, const std::string& newValue);
@@ -711,6 +929,9 @@ namespace MemoryUtilities
 		/* For when 'memoryAddress' contains the actual value. */
 		static std::vector<uint8_t> GetBytes(const HANDLE& hProcess, const void* memoryPtr, size_t byteCount);
 		static std::vector<uint8_t> GetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, size_t byteCount);
+		/* Same, but into caller-owned memory of at least 'byteCount' bytes, so polling loops don't allocate. */
+		static bool					GetBytes(const HANDLE& hProcess, const void* memoryPtr, void* buffer, size_t byteCount);
+		static bool					GetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount);
 
 		static bool					SetBytes(const HANDLE& hProcess, const void* memoryPtr, const std::vector<uint8_t>& newBytes);
 		static bool					SetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, const std::vector<uint8_t>& newBytes);
@@ -722,11 +943,84 @@ namespace MemoryUtilities
 		/* For when 'memoryAddress' contains the address that leads to the value. */
 		static std::vector<uint8_t> IndirectGetBytes(const HANDLE& hProcess, const void* memoryPtr, size_t byteCount);
 		static std::vector<uint8_t> IndirectGetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, size_t byteCount);
+		static bool					IndirectGetBytes(const HANDLE& hProcess, const void* memoryPtr, void* buffer, size_t byteCount);
+		static bool					IndirectGetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, void* buffer, size_t byteCount);
 
 		static bool					IndirectSetBytes(const HANDLE& hProcess, const void* memoryPtr, const std::vector<uint8_t>& newBytes);
 		static bool					IndirectSetBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, const std::vector<uint8_t>& newBytes);
 
 		static bool					IndirectPatchBytes(const HANDLE& hProcess, const void* memoryPtr, const std::vector<uint8_t>& fromBytes, const std::vector<uint8_t>& toBytes);
 		static bool					IndirectPatchBytes(const HANDLE& hProcess, const uintptr_t& memoryAddress, const std::vector<uint8_t>& fromBytes, const std::vector<uint8_t>& toBytes);
+
+
+
+
+		/**
+		* @brief Single entry of a batched read, see GetBytesBatch.
+		* @param memoryAddress - Address of the first byte to read.
+		* @param byteCount - Number of bytes to read.
+		* @param buffer - Destination buffer, at least 'byteCount' bytes long.
+		* @param succeeded - Set by GetBytesBatch, true if the entry was read in full.
+		*/
+		struct BatchRead
+		{
+			uintptr_t memoryAddress = 0x0;
+			size_t    byteCount		= 0;
+			void*	  buffer		= nullptr;
+			bool	  succeeded		= false;
+		};
+
+		/**
+		* @brief Reads many values with as few ReadProcessMemory calls as possible. Entries that lie close to each other
+		*        are coalesced into a single read; if a coalesced read fails, its entries are retried one by one.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @param reads - Entries to read. Order is preserved, only 'succeeded' and the destination buffers are written.
+		* @param maxGap - Largest distance (in bytes) between two entries that still allows them to share a read.
+		* @return Number of entries that were read in full.
+		*/
+		static size_t GetBytesBatch(const HANDLE& hProcess, std::vector<BatchRead>& reads, size_t maxGap = 256);
+
+
+		/**
+		* @brief Working memory of the batch functions. Passing the same one to every call reuses its capacity, so polling loops
+		*        don't allocate; one instance must not be used by two calls at the same time.
+		*/
+		struct BatchScratch
+		{
+			std::vector<size_t>	   readOrder;
+			std::vector<uint8_t>   spanBuffer;
+			std::vector<BatchRead> chainReads;
+			std::vector<uintptr_t> pointerValues;
+			std::vector<size_t>	   readChains;
+		};
+
+		/* Same, but with caller-owned working memory. */
+		static size_t GetBytesBatch(const HANDLE& hProcess, std::vector<BatchRead>& reads, BatchScratch& scratch, size_t maxGap = 256);
+
+
+		/**
+		* @brief Single entry of a batched pointer chain resolution, see AddressFollowPointerChainBatch.
+		* @param memoryAddress - Address the chain starts at.
+		* @param memoryOffsets - Offsets to apply, same semantics as AddressFollowPointerChain. 'nullptr' or empty means no dereference.
+		* @param resolvedAddress - Set by AddressFollowPointerChainBatch to the final address.
+		* @param succeeded - Set by AddressFollowPointerChainBatch, true if every pointer along the chain was read.
+		*/
+		struct BatchPointerChain
+		{
+			uintptr_t					  memoryAddress	  = 0x0;
+			const std::vector<uintptr_t>* memoryOffsets	  = nullptr;
+			uintptr_t					  resolvedAddress = 0x0;
+			bool						  succeeded		  = false;
+		};
+
+		/**
+		* @brief Follows many pointer chains at once. Chains are walked one level at a time and every pointer of a level
+		*        is fetched through a single GetBytesBatch call, so N chains of depth D cost about D coalesced reads.
+		* @param hProcess - Process HANDLE in whose address space to operate.
+		* @param chains - Chains to resolve. Only 'resolvedAddress' and 'succeeded' are written.
+		* @return Number of chains resolved successfully.
+		*/
+		static size_t AddressFollowPointerChainBatch(const HANDLE& hProcess, std::vector<BatchPointerChain>& chains);
+		static size_t AddressFollowPointerChainBatch(const HANDLE& hProcess, std::vector<BatchPointerChain>& chains, BatchScratch& scratch);
 	};
 };
\ No newline at end of file
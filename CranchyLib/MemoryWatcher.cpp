@@ -0,0 +1,340 @@
+#include "MemoryWatcher.h"
+
+#include <algorithm>
+
+#include "MemoryTracing.h"
+
+
+
+
+
+
+size_t MemoryUtilities::GetValueTypeSize(E_ValueType valueType)
+{
+    switch (valueType)
+    {
+    case E_ValueType::Bool:   return sizeof(bool);
+    case E_ValueType::Int8:   return sizeof(int8_t);
+    case E_ValueType::Int16:  return sizeof(int16_t);
+    case E_ValueType::Int32:  return sizeof(int32_t);
+    case E_ValueType::Int64:  return sizeof(int64_t);
+    case E_ValueType::Float:  return sizeof(float);
+    case E_ValueType::Double: return sizeof(double);
+    default:                  return 0;
+    }
+}
+
+
+
+
+
+
+MemoryUtilities::Watcher::Watcher(size_t eventQueueCapacity) : eventQueue(eventQueueCapacity)
+{
+}
+
+MemoryUtilities::Watcher::~Watcher()
+{
+    Stop();
+}
+
+
+
+
+bool MemoryUtilities::Watcher::Start(const HANDLE& hProcess)
+{
+    if (External::IsValidProcessHandle(hProcess) == false)
+        return false;
+
+    /* A worker stopped from one of its own callbacks winds down by itself; it must be gone before another one starts. */
+    if (workerThread.joinable() && running.load() == false)
+    {
+        if (workerThread.get_id() == std::this_thread::get_id())
+            return false;
+
+        workerThread.join();
+    }
+
+    if (running.exchange(true)) // Already running.
+        return false;
+
+    this->hProcess = hProcess;
+    workerThread = std::thread(&Watcher::WorkerLoop, this);
+    return true;
+}
+
+void MemoryUtilities::Watcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(watchesMutex);
+        running = false;
+    }
+
+    /* From a callback the worker can't join itself; it leaves its loop once the callback returns, and is joined by the next
+       Start(), Stop() or the destructor. */
+    wakeCondition.notify_all();
+    if (workerThread.joinable() && workerThread.get_id() != std::this_thread::get_id())
+        workerThread.join();
+}
+
+bool MemoryUtilities::Watcher::IsRunning() const
+{
+    return running.load();
+}
+
+
+
+
+MemoryUtilities::Watcher::WatchId MemoryUtilities::Watcher::AddWatch(const uintptr_t& memoryAddress, E_ValueType valueType, std::chrono::milliseconds pollInterval, size_t byteCount)
+{
+    return AddWatch(memoryAddress, {}, valueType, pollInterval, byteCount);
+}
+
+MemoryUtilities::Watcher::WatchId MemoryUtilities::Watcher::AddWatch(const uintptr_t& memoryAddress, const std::vector<uintptr_t>& memoryOffsets, E_ValueType valueType, std::chrono::milliseconds pollInterval, size_t byteCount)
+{
+    /* Fixed size types ignore 'byteCount', raw bytes must fit into an event. */
+    size_t valueSize = (valueType == E_ValueType::Bytes) ? byteCount : GetValueTypeSize(valueType);
+    if (memoryAddress == 0x0 || valueSize == 0 || valueSize > MaxValueSize || pollInterval.count() <= 0)
+        return InvalidWatch;
+
+    Watch watch;
+    watch.memoryAddress = memoryAddress;
+    watch.memoryOffsets = memoryOffsets;
+    watch.valueType = valueType;
+    watch.valueSize = valueSize;
+    watch.pollInterval = pollInterval;
+    watch.nextDue = std::chrono::steady_clock::now();
+
+    WatchId watchId;
+    {
+        std::lock_guard<std::mutex> lock(watchesMutex);
+        watchId = nextWatchId++;
+        watch.id = watchId;
+        watches.push_back(std::move(watch));
+        watchesChanged = true;
+    }
+
+    /* Wake the polling thread so the new watch gets its first value right away. */
+    wakeCondition.notify_all();
+    return watchId;
+}
+
+bool MemoryUtilities::Watcher::RemoveWatch(WatchId watchId)
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    auto it = std::find_if(watches.begin(), watches.end(), [watchId](const Watch& watch) { return watch.id == watchId; });
+    if (it == watches.end())
+        return false;
+
+    watches.erase(it);
+    watchesChanged = true;
+    return true;
+}
+
+void MemoryUtilities::Watcher::ClearWatches()
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    watches.clear();
+    watchesChanged = true;
+}
+
+
+
+
+void MemoryUtilities::Watcher::SetCallback(std::function<void(const ChangeEvent&)> callback)
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    eventCallback = std::move(callback);
+}
+
+bool MemoryUtilities::Watcher::PopEvent(ChangeEvent& outEvent)
+{
+    return eventQueue.Pop(outEvent);
+}
+
+uint64_t MemoryUtilities::Watcher::GetDroppedEventCount() const
+{
+    return droppedEventCount.load();
+}
+
+MemoryUtilities::Watcher::WatchStatistics MemoryUtilities::Watcher::GetStatistics(WatchId watchId) const
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    for (const Watch& watch : watches)
+    {
+        if (watch.id == watchId)
+            return watch.statistics;
+    }
+
+    return WatchStatistics();
+}
+
+
+
+
+void MemoryUtilities::Watcher::WorkerLoop()
+{
+    const auto kIdleWait = std::chrono::milliseconds(100);
+
+    std::unique_lock<std::mutex> lock(watchesMutex);
+    while (running.load())
+    {
+        watchesChanged = false;
+        PollDueWatches(lock, std::chrono::steady_clock::now());
+
+        /* Callbacks run without the lock held, so they're free to add or remove watches. */
+        if (pendingEvents.empty() == false)
+        {
+            lock.unlock();
+            DeliverEvents();
+            lock.lock();
+        }
+
+        /* Sleep until the earliest watch is due, or until a watch is added or the engine is stopped. */
+        auto wakeTime = std::chrono::steady_clock::now() + kIdleWait;
+        for (const Watch& watch : watches)
+        {
+            wakeTime = std::min<std::chrono::steady_clock::time_point>(wakeTime, watch.nextDue);
+        }
+
+        wakeCondition.wait_until(lock, wakeTime, [this]() { return running.load() == false || watchesChanged; });
+    }
+}
+
+void MemoryUtilities::Watcher::PollDueWatches(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point now)
+{
+    /* Caller must hold 'watchesMutex' through 'lock'; it is released while the other process is read. */
+    CRANCHYLIB_TRACE_SCOPE("sweep", "Watcher::PollDueWatches", 0);
+
+    /* Copy what the reads need, so watches can be added or removed while they're in flight. */
+    size_t dueCount = 0;
+    for (const Watch& watch : watches)
+    {
+        if (watch.nextDue > now)
+            continue;
+
+        if (dueCount == dueWatches.size())
+            dueWatches.emplace_back();
+
+        DueWatch& due = dueWatches[dueCount++];
+        due.id = watch.id;
+        due.memoryAddress = watch.memoryAddress;
+        due.memoryOffsets.assign(watch.memoryOffsets.begin(), watch.memoryOffsets.end());
+        due.valueSize = watch.valueSize;
+    }
+
+    if (dueCount == 0)
+        return;
+
+    lock.unlock();
+
+    /* Resolve every pointer path together, one batched read per path level. */
+    chains.clear();
+    for (size_t i = 0; i < dueCount; ++i)
+    {
+        External::BatchPointerChain chain;
+        chain.memoryAddress = dueWatches[i].memoryAddress;
+        chain.memoryOffsets = &dueWatches[i].memoryOffsets;
+        chains.push_back(chain);
+    }
+    External::AddressFollowPointerChainBatch(hProcess, chains);
+
+    /* Read every resolved value in one coalesced batch. */
+    batch.clear();
+    for (size_t i = 0; i < dueCount; ++i)
+    {
+        DueWatch& due = dueWatches[i];
+        due.resolvedAddress = chains[i].resolvedAddress;
+        due.readFailed = chains[i].succeeded == false;
+        if (due.readFailed)
+            continue;
+
+        External::BatchRead read;
+        read.memoryAddress = due.resolvedAddress;
+        read.byteCount = due.valueSize;
+        read.buffer = due.readValue;
+        batch.push_back(read);
+    }
+    External::GetBytesBatch(hProcess, batch);
+
+    const auto completedAt = std::chrono::steady_clock::now();
+    lock.lock();
+
+    size_t batchIndex = 0;
+    for (size_t i = 0; i < dueCount; ++i)
+    {
+        DueWatch& due = dueWatches[i];
+        if (due.readFailed == false && batch[batchIndex++].succeeded == false)
+            due.readFailed = true;
+
+        /* Ids only grow and removal keeps the order, so the watches stay sorted by id. Skip any removed mid-read. */
+        auto it = std::lower_bound(watches.begin(), watches.end(), due.id, [](const Watch& watch, WatchId watchId) { return watch.id < watchId; });
+        if (it == watches.end() || it->id != due.id)
+            continue;
+
+        Watch& watch = *it;
+
+        /* Latency is measured from the moment the poll was scheduled for, so scheduler lag is included. */
+        WatchStatistics& statistics = watch.statistics;
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(completedAt - watch.nextDue);
+        statistics.pollCount++;
+        statistics.lastLatency = latency;
+        statistics.maxLatency = std::max<std::chrono::nanoseconds>(statistics.maxLatency, latency);
+        watch.totalLatency += latency;
+        statistics.averageLatency = watch.totalLatency / static_cast<int64_t>(statistics.pollCount);
+
+        if (due.readFailed)
+        {
+            statistics.failedReadCount++;
+        }
+        else
+        {
+            if (watch.hasValue && std::memcmp(watch.lastValue, due.readValue, watch.valueSize) != 0)
+            {
+                ChangeEvent changeEvent;
+                changeEvent.watchId = watch.id;
+                changeEvent.memoryAddress = due.resolvedAddress;
+                changeEvent.valueType = watch.valueType;
+                changeEvent.valueSize = watch.valueSize;
+                std::memcpy(changeEvent.previousValue, watch.lastValue, watch.valueSize);
+                std::memcpy(changeEvent.currentValue, due.readValue, watch.valueSize);
+                changeEvent.timestamp = completedAt;
+                pendingEvents.push_back(changeEvent);
+
+                statistics.changeCount++;
+            }
+
+            std::memcpy(watch.lastValue, due.readValue, watch.valueSize);
+            watch.hasValue = true;
+        }
+
+        /* Schedule the next poll; whole intervals that already passed count as missed deadlines. */
+        const auto overdue = now - watch.nextDue;
+        const uint64_t missedIntervals = static_cast<uint64_t>(overdue / watch.pollInterval);
+        statistics.missedDeadlineCount += missedIntervals;
+        watch.nextDue += watch.pollInterval * static_cast<int64_t>(missedIntervals + 1);
+    }
+}
+
+void MemoryUtilities::Watcher::DeliverEvents()
+{
+    std::function<void(const ChangeEvent&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(watchesMutex);
+        callback = eventCallback;
+    }
+
+    for (const ChangeEvent& changeEvent : pendingEvents)
+    {
+        if (callback)
+        {
+            callback(changeEvent);
+        }
+        else if (eventQueue.Push(changeEvent) == false) // Queue is full, the consumer isn't keeping up.
+        {
+            droppedEventCount++;
+        }
+    }
+
+    pendingEvents.clear();
+}
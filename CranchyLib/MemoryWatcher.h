@@ -0,0 +1,242 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MemoryUtilities.h"
+#include "RingBuffer.h"
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	enum class E_ValueType
+	{
+		Bool,
+		Int8,
+		Int16,
+		Int32,
+		Int64,
+		Float,
+		Double,
+		Bytes   /// Raw bytes, size is given explicitly.
+	};
+
+	/**
+	* @brief Returns the size in bytes of a fixed size value type.
+	* @return Size of the type, or 0 for E_ValueType::Bytes.
+	*/
+	size_t GetValueTypeSize(E_ValueType valueType);
+
+
+
+
+
+
+	class Watcher
+	{
+		// Description: Polls many values of a 3'rd party process from one background thread. Every tick, all due reads
+		//              (including pointer path levels) are coalesced into batched reads, and changed values are delivered
+		//              either through a callback or a lock-free queue.
+		// Search Tags: #external, #watch, #monitor, #poll, #changes, #readprocessmemory.
+	public:
+		using WatchId = uint32_t;
+		static constexpr WatchId InvalidWatch = 0;
+		static constexpr size_t  MaxValueSize = 32;
+
+
+		/**
+		* @brief Describes a single value change.
+		* @param watchId - Watch that produced the event.
+		* @param memoryAddress - Address the value was read from (final address when following a pointer path).
+		* @param valueType - Type the watch was registered with.
+		* @param valueSize - Number of meaningful bytes in 'previousValue' and 'currentValue'.
+		* @param timestamp - Moment the new value was read.
+		*/
+		struct ChangeEvent
+		{
+			WatchId		watchId						 = InvalidWatch;
+			uintptr_t	memoryAddress				 = 0x0;
+			E_ValueType valueType					 = E_ValueType::Bytes;
+			size_t		valueSize					 = 0;
+			uint8_t		previousValue[MaxValueSize]	 = { 0 };
+			uint8_t		currentValue[MaxValueSize]	 = { 0 };
+			std::chrono::steady_clock::time_point timestamp;
+
+			template<typename T>
+			T GetPrevious() const
+			{
+				static_assert(sizeof(T) <= MaxValueSize, "Type is larger than a watched value.");
+				T value{};
+				std::memcpy(&value, previousValue, sizeof(T));
+				return value;
+			}
+
+			template<typename T>
+			T GetCurrent() const
+			{
+				static_assert(sizeof(T) <= MaxValueSize, "Type is larger than a watched value.");
+				T value{};
+				std::memcpy(&value, currentValue, sizeof(T));
+				return value;
+			}
+		};
+
+
+		/**
+		* @brief Per-watch counters.
+		* @param pollCount - Number of times the value was polled.
+		* @param changeCount - Number of change events produced.
+		* @param failedReadCount - Polls where the value (or a pointer along its path) couldn't be read.
+		* @param missedDeadlineCount - Whole poll intervals skipped because the engine fell behind.
+		* @param lastLatency - Time between the scheduled poll time and the value being compared, for the last poll.
+		* @param maxLatency - Worst latency observed.
+		* @param averageLatency - Mean latency over all polls.
+		*/
+		struct WatchStatistics
+		{
+			uint64_t pollCount			 = 0;
+			uint64_t changeCount		 = 0;
+			uint64_t failedReadCount	 = 0;
+			uint64_t missedDeadlineCount = 0;
+			std::chrono::nanoseconds lastLatency{ 0 };
+			std::chrono::nanoseconds maxLatency{ 0 };
+			std::chrono::nanoseconds averageLatency{ 0 };
+		};
+
+
+
+
+		/**
+		* @param eventQueueCapacity - Number of change events the lock-free queue can hold before new ones are dropped.
+		*/
+		explicit Watcher(size_t eventQueueCapacity = 4096);
+		~Watcher();
+		Watcher(const Watcher&) = delete;
+		Watcher& operator=(const Watcher&) = delete;
+
+
+
+
+		/**
+		* @brief Starts the background polling thread.
+		* @param hProcess - Process HANDLE to poll, must stay open until Stop() is called.
+		* @return true if the thread was started; false if the handle is invalid or the watcher is already running.
+		*/
+		bool Start(const HANDLE& hProcess);
+		/**
+		* @brief Stops polling. May be called from a callback; the polling thread then finishes on its own once the callback returns.
+		*/
+		void Stop();
+		bool IsRunning() const;
+
+
+
+
+		/**
+		* @brief Registers a value that lives directly at 'memoryAddress'.
+		* @param valueType - Type of the value; for E_ValueType::Bytes, 'byteCount' gives the size.
+		* @param pollInterval - How often the value should be read.
+		* @param byteCount - Size of a E_ValueType::Bytes value (1..MaxValueSize), ignored for other types.
+		* @return Id of the new watch, or 'InvalidWatch' if the parameters are invalid.
+		*/
+		WatchId AddWatch(const uintptr_t& memoryAddress, E_ValueType valueType, std::chrono::milliseconds pollInterval, size_t byteCount = 0);
+		/**
+		* @brief Registers a value found by following a pointer path, with the same semantics as External::AddressFollowPointerChain.
+		*        The path is re-resolved on every poll, so the watch follows the value when the pointers change.
+		* @return Id of the new watch, or 'InvalidWatch' if the parameters are invalid.
+		*/
+		WatchId AddWatch(const uintptr_t& memoryAddress, const std::vector<uintptr_t>& memoryOffsets, E_ValueType valueType, std::chrono::milliseconds pollInterval, size_t byteCount = 0);
+
+		bool RemoveWatch(WatchId watchId);
+		void ClearWatches();
+
+
+
+
+		/**
+		* @brief Sets a function that receives change events on the polling thread. While a callback is set, events aren't queued.
+		*        The callback may add or remove watches; pass an empty function to go back to queueing.
+		*/
+		void SetCallback(std::function<void(const ChangeEvent&)> callback);
+
+		/**
+		* @brief Takes the oldest queued change event. Must only be called from one consumer thread at a time.
+		* @return true if an event was returned; false if the queue is empty.
+		*/
+		bool PopEvent(ChangeEvent& outEvent);
+
+		uint64_t GetDroppedEventCount() const;
+		WatchStatistics GetStatistics(WatchId watchId) const;
+
+
+
+
+	private:
+		struct Watch
+		{
+			WatchId				   id			 = InvalidWatch;
+			uintptr_t			   memoryAddress = 0x0;
+			std::vector<uintptr_t> memoryOffsets;
+			E_ValueType			   valueType	 = E_ValueType::Bytes;
+			size_t				   valueSize	 = 0;
+			std::chrono::nanoseconds			  pollInterval{ 0 };
+			std::chrono::steady_clock::time_point nextDue;
+
+			bool	  hasValue = false;
+			uint8_t	  lastValue[MaxValueSize] = { 0 };
+
+			WatchStatistics			 statistics;
+			std::chrono::nanoseconds totalLatency{ 0 };
+		};
+
+
+		/* What one poll of a watch reads, copied out of 'watches' so the reads run without the lock held. */
+		struct DueWatch
+		{
+			WatchId				   id			 = InvalidWatch;
+			uintptr_t			   memoryAddress = 0x0;
+			std::vector<uintptr_t> memoryOffsets;
+			size_t				   valueSize	 = 0;
+
+			uintptr_t resolvedAddress = 0x0;
+			bool	  readFailed	  = false;
+			uint8_t	  readValue[MaxValueSize] = { 0 };
+		};
+
+
+		void WorkerLoop();
+		void PollDueWatches(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point now);
+		void DeliverEvents();
+
+
+		HANDLE							hProcess = nullptr;
+		std::thread						workerThread;
+		std::atomic<bool>				running{ false };
+
+		mutable std::mutex				watchesMutex;
+		std::condition_variable			wakeCondition;
+		bool							watchesChanged = false;
+		std::vector<Watch>				watches;
+		WatchId							nextWatchId = 1;
+		std::function<void(const ChangeEvent&)> eventCallback;
+
+		/* Scratch state reused between ticks, only touched by the polling thread. */
+		std::vector<DueWatch>			   dueWatches;
+		std::vector<External::BatchPointerChain> chains;
+		std::vector<External::BatchRead>   batch;
+		std::vector<ChangeEvent>		   pendingEvents;
+
+		SpscRingBuffer<ChangeEvent>		   eventQueue;
+		std::atomic<uint64_t>			   droppedEventCount{ 0 };
+	};
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+
+
+
+
+
+namespace MemoryUtilities
+{
+	/**
+	* @brief Lock-free, fixed capacity queue for exactly one producer thread and one consumer thread.
+	*        Capacity is rounded up to a power of two; when the queue is full, Push() fails instead of blocking.
+	*/
+	template<typename T>
+	class SpscRingBuffer
+	{
+	public:
+		explicit SpscRingBuffer(size_t capacity)
+		{
+			size_t roundedCapacity = 2;
+			while (roundedCapacity < capacity)
+				roundedCapacity <<= 1;
+
+			slots.reset(new T[roundedCapacity]);
+			mask = roundedCapacity - 1;
+		}
+
+		SpscRingBuffer(const SpscRingBuffer&) = delete;
+		SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+
+
+
+		/* Producer side. */
+		bool Push(const T& value)
+		{
+			const size_t tail = tailIndex.load(std::memory_order_relaxed);
+			if (tail - cachedHeadIndex > mask) // Looks full, refresh our view of the consumer before giving up.
+			{
+				cachedHeadIndex = headIndex.load(std::memory_order_acquire);
+				if (tail - cachedHeadIndex > mask)
+					return false;
+			}
+
+			slots[tail & mask] = value;
+			tailIndex.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+
+		/* Consumer side. */
+		bool Pop(T& outValue)
+		{
+			const size_t head = headIndex.load(std::memory_order_relaxed);
+			if (head == cachedTailIndex) // Looks empty, refresh our view of the producer before giving up.
+			{
+				cachedTailIndex = tailIndex.load(std::memory_order_acquire);
+				if (head == cachedTailIndex)
+					return false;
+			}
+
+			outValue = slots[head & mask];
+			headIndex.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+
+
+
+		/* Approximate when called concurrently with Push/Pop. */
+		size_t Size() const
+		{
+			return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire);
+		}
+
+		size_t Capacity() const
+		{
+			return mask + 1;
+		}
+
+
+
+
+	private:
+		std::unique_ptr<T[]> slots;
+		size_t				 mask = 0;
+
+		/* Producer and consumer indices live on separate cache lines to avoid false sharing. */
+		alignas(64) std::atomic<size_t> tailIndex{ 0 };
+		size_t							cachedHeadIndex = 0; // Producer's last seen consumer index.
+		alignas(64) std::atomic<size_t> headIndex{ 0 };
+		size_t							cachedTailIndex = 0; // Consumer's last seen producer index.
+	};
+}
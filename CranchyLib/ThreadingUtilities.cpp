@@ -0,0 +1,345 @@
+#include "ThreadingUtilities.h"
+
+#include <algorithm>
+#include <chrono>
+
+
+
+
+
+
+namespace
+{
+    /* Identifies pool workers, so tasks they submit go to their own deque. */
+    thread_local const ThreadingUtilities::ThreadPool* currentPool = nullptr;
+    thread_local size_t currentWorkerIndex = 0;
+
+    std::mutex sharedPoolMutex;
+    std::unique_ptr<ThreadingUtilities::ThreadPool> sharedPool;
+    size_t sharedPoolThreadCount = 0;
+    bool sharedPoolPinToCores = false;
+}
+
+
+
+
+
+
+ThreadingUtilities::ThreadPool::ThreadPool(size_t threadCount, bool pinToCores)
+{
+    if (threadCount == 0)
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    for (size_t i = 0; i <= threadCount; ++i)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    const size_t processorCount = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1), sizeof(DWORD_PTR) * 8);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+
+        if (pinToCores)
+            SetThreadAffinityMask(workers.back().native_handle(), static_cast<DWORD_PTR>(1) << (i % processorCount));
+    }
+}
+
+ThreadingUtilities::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+
+    sleepCondition.notify_all();
+    for (std::thread& worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+
+
+
+void ThreadingUtilities::ThreadPool::Submit(Task task)
+{
+    /* Workers keep their own tasks local; everyone else goes through the injection queue. */
+    const size_t queueIndex = currentPool == this ? currentWorkerIndex : queues.size() - 1;
+    size_t queueDepth;
+    {
+        /* Counted before the task becomes visible, so the worker that takes it can never decrement first and wrap the counter. */
+        WorkerQueue& queue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.queueMutex);
+        queueDepth = pendingTaskCount.fetch_add(1) + 1;
+        queue.tasks.push_back(std::move(task));
+    }
+
+    size_t observedMaximum = maximumQueueDepth.load(std::memory_order_relaxed);
+    while (queueDepth > observedMaximum && maximumQueueDepth.compare_exchange_weak(observedMaximum, queueDepth, std::memory_order_relaxed) == false)
+    {
+    }
+
+    submittedCount.fetch_add(1, std::memory_order_relaxed);
+
+    /* Taking the lock orders the notification after a worker's predicate check, so the wakeup can't be lost. */
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+}
+
+bool ThreadingUtilities::ThreadPool::RunPendingTask()
+{
+    Task task;
+
+    /* A worker helping inside a TaskGroup::Wait() prefers its own deque, as WorkerLoop does. */
+    if (currentPool == this && TryTakeTask(currentWorkerIndex, task))
+    {
+        ExecuteTask(task);
+        return true;
+    }
+
+    for (size_t i = queues.size(); i-- > 0;)
+    {
+        if (TryTakeTask(i, task))
+        {
+            ExecuteTask(task);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+
+size_t ThreadingUtilities::ThreadPool::GetThreadCount() const
+{
+    return workers.size();
+}
+
+ThreadingUtilities::ThreadPoolStatistics ThreadingUtilities::ThreadPool::GetStatistics() const
+{
+    ThreadPoolStatistics statistics;
+    statistics.threadCount = workers.size();
+    statistics.queueDepth = pendingTaskCount.load(std::memory_order_relaxed);
+    statistics.maximumQueueDepth = maximumQueueDepth.load(std::memory_order_relaxed);
+    statistics.tasksSubmitted = submittedCount.load(std::memory_order_relaxed);
+    statistics.tasksExecuted = executedCount.load(std::memory_order_relaxed);
+    statistics.tasksStolen = stolenCount.load(std::memory_order_relaxed);
+    statistics.stealAttempts = stealAttemptCount.load(std::memory_order_relaxed);
+
+    return statistics;
+}
+
+
+
+
+bool ThreadingUtilities::ThreadPool::TryTakeTask(size_t queueIndex, Task& task)
+{
+    WorkerQueue& queue = *queues[queueIndex];
+    const bool ownQueue = currentPool == this && currentWorkerIndex == queueIndex;
+
+    std::lock_guard<std::mutex> lock(queue.queueMutex);
+    if (queue.tasks.empty())
+        return false;
+
+    /* Owners work LIFO for cache locality; thieves and the injection queue take the oldest task. */
+    if (ownQueue)
+    {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+    }
+    else
+    {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+    }
+
+    pendingTaskCount.fetch_sub(1);
+    return true;
+}
+
+void ThreadingUtilities::ThreadPool::ExecuteTask(Task& task)
+{
+    task();
+    task = nullptr;
+    executedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ThreadingUtilities::ThreadPool::WorkerLoop(size_t workerIndex)
+{
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    const size_t workerCount = queues.size() - 1; // 'workers' may still be filling up while the first workers start.
+    const size_t injectionQueue = workerCount;
+    size_t victim = workerIndex;
+
+    while (true)
+    {
+        Task task;
+        bool found = TryTakeTask(workerIndex, task) || TryTakeTask(injectionQueue, task);
+
+        /* Steal, starting after the last victim so thieves don't all hit the same deque. */
+        for (size_t attempt = 1; found == false && attempt <= workerCount; ++attempt)
+        {
+            victim = (victim + 1) % workerCount;
+            if (victim == workerIndex)
+                continue;
+
+            stealAttemptCount.fetch_add(1, std::memory_order_relaxed);
+            if (TryTakeTask(victim, task))
+            {
+                stolenCount.fetch_add(1, std::memory_order_relaxed);
+                found = true;
+            }
+        }
+
+        if (found)
+        {
+            ExecuteTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() { return pendingTaskCount.load() != 0 || stopping; });
+
+        /* The destructor only returns once every queued task has run. */
+        if (stopping && pendingTaskCount.load() == 0)
+            return;
+    }
+}
+
+
+
+
+
+
+ThreadingUtilities::TaskGroup::TaskGroup() : pool(GetSharedPool())
+{
+}
+
+ThreadingUtilities::TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool)
+{
+}
+
+ThreadingUtilities::TaskGroup::~TaskGroup()
+{
+    Wait();
+}
+
+
+
+
+void ThreadingUtilities::TaskGroup::Run(Task task)
+{
+    pendingCount.fetch_add(1);
+
+    pool.Submit([this, task = std::move(task)]()
+    {
+        if (cancelled.load(std::memory_order_relaxed) == false)
+            task();
+
+        /* The waiter may destroy the group as soon as it sees zero, so notify under the lock. */
+        std::lock_guard<std::mutex> lock(waitMutex);
+        if (pendingCount.fetch_sub(1) == 1)
+            waitCondition.notify_all();
+    });
+}
+
+bool ThreadingUtilities::TaskGroup::Wait()
+{
+    while (pendingCount.load() != 0)
+    {
+        /* Help with queued work (ours or anyone's) instead of blocking a thread the pool might need. */
+        if (pool.RunPendingTask())
+            continue;
+
+        std::unique_lock<std::mutex> lock(waitMutex);
+        waitCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return pendingCount.load() == 0; });
+    }
+
+    /* Synchronize with the last task's unlock before the group can go away. */
+    std::lock_guard<std::mutex> lock(waitMutex);
+    return cancelled.load() == false;
+}
+
+
+
+
+void ThreadingUtilities::TaskGroup::Cancel()
+{
+    cancelled.store(true);
+}
+
+bool ThreadingUtilities::TaskGroup::IsCancelled() const
+{
+    return cancelled.load(std::memory_order_relaxed);
+}
+
+ThreadingUtilities::ThreadPool& ThreadingUtilities::TaskGroup::GetPool() const
+{
+    return pool;
+}
+
+
+
+
+
+
+ThreadingUtilities::ThreadPool& ThreadingUtilities::GetSharedPool()
+{
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    if (sharedPool == nullptr)
+        sharedPool = std::make_unique<ThreadPool>(sharedPoolThreadCount, sharedPoolPinToCores);
+
+    return *sharedPool;
+}
+
+bool ThreadingUtilities::ConfigureSharedPool(size_t threadCount, bool pinToCores)
+{
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    if (sharedPool != nullptr)
+        return false;
+
+    sharedPoolThreadCount = threadCount;
+    sharedPoolPinToCores = pinToCores;
+    return true;
+}
+
+
+
+
+bool ThreadingUtilities::ParallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body)
+{
+    TaskGroup group;
+    return ParallelFor(group, begin, end, grainSize, body);
+}
+
+bool ThreadingUtilities::ParallelFor(TaskGroup& group, size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body)
+{
+    if (begin >= end)
+        return group.Wait();
+
+    const size_t count = end - begin;
+    if (grainSize == 0)
+        grainSize = std::max<size_t>(1, count / (group.GetPool().GetThreadCount() * 4));
+
+    /* The last range runs on the calling thread, which would otherwise just wait. */
+    size_t rangeBegin = begin;
+    while (end - rangeBegin > grainSize)
+    {
+        const size_t rangeEnd = rangeBegin + grainSize;
+        group.Run([&body, rangeBegin, rangeEnd]() { body(rangeBegin, rangeEnd); });
+        rangeBegin = rangeEnd;
+    }
+
+    if (group.IsCancelled() == false)
+        body(rangeBegin, end);
+
+    return group.Wait();
+}
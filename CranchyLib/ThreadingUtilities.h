@@ -0,0 +1,192 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+
+
+
+class ThreadingUtilities
+{
+	// Description: Library-wide work-stealing scheduler. Every worker owns a deque: it pushes and pops its own tasks at the back and
+	//              steals from the front of the others' when it runs dry; tasks submitted from outside the pool go through a shared
+	//              injection queue. Parallel paths of the library run on the shared pool instead of spawning their own threads.
+	//              Tasks mustn't throw.
+	// Search Tags: #threading, #threadpool, #workstealing, #parallel, #parallelfor, #taskgroup, #scheduler.
+public:
+	using Task = std::function<void()>;
+
+
+	/**
+	* @brief Scheduler counters for tuning.
+	* @param threadCount - Number of worker threads.
+	* @param queueDepth - Tasks queued right now, over every deque.
+	* @param maximumQueueDepth - Highest 'queueDepth' seen.
+	* @param tasksSubmitted - Tasks handed to the pool.
+	* @param tasksExecuted - Tasks run, by workers or by threads helping while they wait on a TaskGroup.
+	* @param tasksStolen - Tasks a worker took from another worker's deque.
+	* @param stealAttempts - Times a worker looked into another worker's deque.
+	*/
+	struct ThreadPoolStatistics
+	{
+		size_t	 threadCount	   = 0;
+		size_t	 queueDepth		   = 0;
+		size_t	 maximumQueueDepth = 0;
+		uint64_t tasksSubmitted	   = 0;
+		uint64_t tasksExecuted	   = 0;
+		uint64_t tasksStolen	   = 0;
+		uint64_t stealAttempts	   = 0;
+	};
+
+
+
+
+
+
+	class ThreadPool
+	{
+	public:
+		/**
+		* @param threadCount - Number of worker threads; 0 picks the number of logical processors.
+		* @param pinToCores - Pins worker N to logical processor N (modulo the processor count).
+		*/
+		explicit ThreadPool(size_t threadCount = 0, bool pinToCores = false);
+		/**
+		* @brief Runs every task still queued, then joins the workers.
+		*/
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+
+
+
+		void Submit(Task task);
+		/**
+		* @brief Runs one queued task on the calling thread, if there is any. Lets waiting threads help instead of blocking.
+		* @return true if a task was run.
+		*/
+		bool RunPendingTask();
+
+
+		size_t GetThreadCount() const;
+		ThreadPoolStatistics GetStatistics() const;
+
+
+
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex		 queueMutex;
+			std::deque<Task> tasks;
+		};
+
+
+		bool TryTakeTask(size_t queueIndex, Task& task);
+		void ExecuteTask(Task& task);
+		void WorkerLoop(size_t workerIndex);
+
+
+		std::vector<std::unique_ptr<WorkerQueue>> queues; // One per worker, then the injection queue.
+		std::vector<std::thread>				  workers;
+
+		std::mutex				sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<size_t>		pendingTaskCount{ 0 };
+		std::atomic<bool>		stopping{ false };
+
+		std::atomic<size_t>		maximumQueueDepth{ 0 };
+		std::atomic<uint64_t>	submittedCount{ 0 };
+		std::atomic<uint64_t>	executedCount{ 0 };
+		std::atomic<uint64_t>	stolenCount{ 0 };
+		std::atomic<uint64_t>	stealAttemptCount{ 0 };
+	};
+
+
+
+
+
+
+	class TaskGroup
+	{
+	public:
+		/**
+		* @brief Group running on the shared pool.
+		*/
+		TaskGroup();
+		explicit TaskGroup(ThreadPool& pool);
+		/**
+		* @brief Waits for every task of the group.
+		*/
+		~TaskGroup();
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+
+
+
+		/**
+		* @brief Queues 'task' on the pool. Tasks that haven't started when the group is cancelled are skipped.
+		*/
+		void Run(Task task);
+		/**
+		* @brief Blocks until every task of the group finished or was skipped; the calling thread runs queued tasks meanwhile.
+		* @return false if the group was cancelled.
+		*/
+		bool Wait();
+
+		/**
+		* @brief Skips every task that hasn't started yet. Running tasks can poll IsCancelled() to stop early.
+		*/
+		void Cancel();
+		bool IsCancelled() const;
+
+		ThreadPool& GetPool() const;
+
+
+
+
+	private:
+		ThreadPool&				pool;
+		std::atomic<size_t>		pendingCount{ 0 };
+		std::atomic<bool>		cancelled{ false };
+		std::mutex				waitMutex;
+		std::condition_variable waitCondition;
+	};
+
+
+
+
+
+
+	/**
+	* @brief Shared pool used by the library's parallel code paths. Created on first use.
+	*/
+	static ThreadPool& GetSharedPool();
+	/**
+	* @brief Sets the size and pinning of the shared pool. Only possible before its first use.
+	* @return false if the shared pool already exists.
+	*/
+	static bool ConfigureSharedPool(size_t threadCount, bool pinToCores = false);
+
+
+
+
+	/**
+	* @brief Splits [begin, end) into ranges of about 'grainSize' elements and calls 'body(rangeBegin, rangeEnd)' for each on the pool.
+	*        'grainSize' 0 makes about four ranges per worker. Returns when every range is done.
+	* @return false if 'group' was cancelled before every range ran.
+	*/
+	static bool ParallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+	static bool ParallelFor(TaskGroup& group, size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+};